@@ -0,0 +1,206 @@
+//! Benchmarks of the augmented Lagrangian and penalty method (ALM/PM)
+//!
+//! Run with `cargo bench --bench alm`
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput};
+use optimization_engine::{alm::*, constraints::*, core::ExitStatus, panoc::*, *};
+
+mod common;
+
+const TOLERANCE: f64 = 1e-5;
+const LBFGS_MEMORY: usize = 5;
+const INITIAL_PENALTY: f64 = 10.0;
+const DIMENSIONS: [usize; 3] = [3, 10, 50];
+
+/// Cost function, f(u) = 0.5 ||u||^2 + sum(u)
+fn f(u: &[f64], cost: &mut f64) -> FunctionCallResult {
+    *cost = 0.5 * matrix_operations::norm2_squared(u) + matrix_operations::sum(u);
+    Ok(())
+}
+
+/// Gradient of the cost function
+fn df(u: &[f64], grad: &mut [f64]) -> FunctionCallResult {
+    grad.iter_mut()
+        .zip(u.iter())
+        .for_each(|(grad_i, u_i)| *grad_i = u_i + 1.0);
+    Ok(())
+}
+
+/// ALM-type constraints, F1(u) = (sum of u_i for even i, sum of u_i for odd i)
+fn f1(u: &[f64], f1u: &mut [f64]) -> FunctionCallResult {
+    f1u[0] = u.iter().step_by(2).sum();
+    f1u[1] = u.iter().skip(1).step_by(2).sum();
+    Ok(())
+}
+
+/// Product JF1(u)' d
+fn jf1t(_u: &[f64], d: &[f64], res: &mut [f64]) -> FunctionCallResult {
+    res.iter_mut()
+        .enumerate()
+        .for_each(|(i, res_i)| *res_i = d[i % 2]);
+    Ok(())
+}
+
+/// PM-type constraints, F2(u) = sum(u) + 0.5 (which is compatible with F1(u) in C)
+fn f2(u: &[f64], res: &mut [f64]) -> FunctionCallResult {
+    res[0] = matrix_operations::sum(u) + 0.5;
+    Ok(())
+}
+
+/// Product JF2(u)' d
+fn jf2t(_u: &[f64], d: &[f64], res: &mut [f64]) -> FunctionCallResult {
+    res.iter_mut().for_each(|res_i| *res_i = d[0]);
+    Ok(())
+}
+
+/// ALM/PM optimizer for the problem `$problem` which uses the cache `$cache`;
+/// every solve starts with the same penalty parameter
+macro_rules! alm_optimizer {
+    ($cache:expr, $problem:expr) => {
+        AlmOptimizer::new($cache, $problem)
+            .with_max_outer_iterations(20)
+            .with_epsilon_tolerance(TOLERANCE)
+            .with_delta_tolerance(1e-4)
+            .with_initial_penalty(INITIAL_PENALTY)
+    };
+}
+
+/// Reports the allocations and benchmarks the ALM/PM solver for a problem,
+/// which is constructed by `$make_problem` (once per solve)
+///
+/// Every timed solve uses a new cache (which is constructed outside of the
+/// timed code), so that it does not depend on the penalty parameter and the
+/// Lagrange multipliers of the previous solves
+macro_rules! bench_alm {
+    ($group:expr, $id:expr, $nx:expr, $n1:expr, $n2:expr, $make_problem:expr) => {{
+        let make_problem = $make_problem;
+        let make_cache = || AlmCache::new(PANOCCache::new($nx, TOLERANCE, LBFGS_MEMORY), $n1, $n2);
+        let u0 = vec![0.1; $nx];
+        let id = format!("alm/{}/{}", $id, $nx);
+
+        // the benchmark is only meaningful if the solver converges
+        let mut alm_cache = make_cache();
+        let mut u = u0.clone();
+        let status = alm_optimizer!(&mut alm_cache, make_problem())
+            .solve(&mut u)
+            .unwrap_or_else(|e| panic!("{}: the solver failed ({:?})", id, e));
+        assert_eq!(
+            ExitStatus::Converged,
+            status.exit_status(),
+            "{}: the solver did not converge",
+            id
+        );
+
+        common::report_allocations(&id, || {
+            alm_cache.reset();
+            let mut u = u0.clone();
+            let _ = alm_optimizer!(&mut alm_cache, make_problem()).solve(&mut u);
+        });
+        $group.bench_function(BenchmarkId::new($id, $nx), |bench| {
+            bench.iter_batched_ref(
+                || (make_cache(), u0.clone()),
+                |(alm_cache, u)| alm_optimizer!(alm_cache, make_problem()).solve(u),
+                BatchSize::SmallInput,
+            )
+        });
+    }};
+}
+
+fn bench_alm(c: &mut Criterion) {
+    let mut group = c.benchmark_group("alm");
+    group.throughput(Throughput::Elements(1));
+    for &nx in &DIMENSIONS {
+        // No F1 and no F2 (ALM/PM reduces to PANOC)
+        bench_alm!(group, "plain", nx, 0, 0, || {
+            AlmProblem::new(
+                Ball2::new(None, 10.0),
+                NO_SET,
+                NO_SET,
+                |u: &[f64], _xi: &[f64], cost: &mut f64| f(u, cost),
+                |u: &[f64], _xi: &[f64], grad: &mut [f64]| df(u, grad),
+                NO_MAPPING,
+                NO_MAPPING,
+                0,
+                0,
+            )
+        });
+
+        // ALM-type constraints only: F1(u) in C
+        let factory_f1 = AlmFactory::new(
+            f,
+            df,
+            Some(f1),
+            Some(jf1t),
+            NO_MAPPING,
+            NO_JACOBIAN_MAPPING,
+            Some(Ball2::new(None, 0.5)),
+            0,
+        );
+        bench_alm!(group, "f1", nx, 2, 0, || {
+            AlmProblem::new(
+                Ball2::new(None, 10.0),
+                Some(Ball2::new(None, 0.5)),
+                Some(BallInf::new(None, 1e12)),
+                |u: &[f64], xi: &[f64], cost: &mut f64| factory_f1.psi(u, xi, cost),
+                |u: &[f64], xi: &[f64], grad: &mut [f64]| factory_f1.d_psi(u, xi, grad),
+                Some(f1),
+                NO_MAPPING,
+                2,
+                0,
+            )
+        });
+
+        // PM-type constraints only: F2(u) = 0
+        let factory_f2 = AlmFactory::new(
+            f,
+            df,
+            NO_MAPPING,
+            NO_JACOBIAN_MAPPING,
+            Some(f2),
+            Some(jf2t),
+            NO_SET,
+            1,
+        );
+        bench_alm!(group, "f2", nx, 0, 1, || {
+            AlmProblem::new(
+                NoConstraints::new(),
+                NO_SET,
+                NO_SET,
+                |u: &[f64], xi: &[f64], cost: &mut f64| factory_f2.psi(u, xi, cost),
+                |u: &[f64], xi: &[f64], grad: &mut [f64]| factory_f2.d_psi(u, xi, grad),
+                NO_MAPPING,
+                Some(f2),
+                0,
+                1,
+            )
+        });
+
+        // Both F1 and F2
+        let factory_f1_f2 = AlmFactory::new(
+            f,
+            df,
+            Some(f1),
+            Some(jf1t),
+            Some(f2),
+            Some(jf2t),
+            Some(Ball2::new(None, 0.5)),
+            1,
+        );
+        bench_alm!(group, "f1_f2", nx, 2, 1, || {
+            AlmProblem::new(
+                NoConstraints::new(),
+                Some(Ball2::new(None, 0.5)),
+                Some(BallInf::new(None, 1e12)),
+                |u: &[f64], xi: &[f64], cost: &mut f64| factory_f1_f2.psi(u, xi, cost),
+                |u: &[f64], xi: &[f64], grad: &mut [f64]| factory_f1_f2.d_psi(u, xi, grad),
+                Some(f1),
+                Some(f2),
+                2,
+                1,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_alm);
+criterion_main!(benches);
@@ -0,0 +1,73 @@
+//! Utilities that are shared by the benchmarks
+//!
+//! Apart from the timing statistics of [criterion] (throughput and the
+//! distribution of the execution time), the benchmarks report the number
+//! of heap allocations per call, which is measured using a counting global
+//! allocator.
+//!
+//! Note that allocations cannot be counted when a different global allocator
+//! is used (features `jem` and `rp`).
+//!
+//! [criterion]: https://docs.rs/criterion
+#![allow(dead_code)]
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// Number of calls used to compute the average number of allocations
+const NUM_CALLS_ALLOCATIONS: usize = 100;
+
+/// Total number of allocations (and reallocations) since the start
+static NUM_ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+/// Global allocator that counts the allocations (delegates to the system allocator)
+pub struct CountingAllocator;
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        NUM_ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+        NUM_ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc_zeroed(layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        NUM_ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+}
+
+#[cfg(not(any(feature = "jem", feature = "rp")))]
+#[global_allocator]
+static COUNTING_ALLOCATOR: CountingAllocator = CountingAllocator;
+
+/// Average number of heap allocations per call of `f`
+///
+/// Returns `None` if allocations are not counted (features `jem` or `rp`)
+pub fn allocations_per_call<F: FnMut()>(mut f: F) -> Option<f64> {
+    if cfg!(any(feature = "jem", feature = "rp")) {
+        return None;
+    }
+    f(); // warm up (e.g., lazily allocated memory)
+    let allocations_before = NUM_ALLOCATIONS.load(Ordering::Relaxed);
+    for _ in 0..NUM_CALLS_ALLOCATIONS {
+        f();
+    }
+    let allocations = NUM_ALLOCATIONS.load(Ordering::Relaxed) - allocations_before;
+    Some(allocations as f64 / NUM_CALLS_ALLOCATIONS as f64)
+}
+
+/// Prints the average number of heap allocations per call of `f`
+pub fn report_allocations<F: FnMut()>(id: &str, f: F) {
+    match allocations_per_call(f) {
+        Some(allocations) => println!("{:<50} allocations/call: {:.2}", id, allocations),
+        None => println!("{:<50} allocations/call: n/a", id),
+    }
+}
@@ -0,0 +1,204 @@
+//! Benchmarks of PANOC and FBS
+//!
+//! Run with `cargo bench --bench panoc`
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput};
+use optimization_engine::{constraints::*, fbs::*, panoc::*, *};
+use std::cell::RefCell;
+use std::num::NonZeroUsize;
+
+mod common;
+
+const TOLERANCE: f64 = 1e-6;
+const LBFGS_MEMORY: usize = 10;
+const MAX_ITER: usize = 500;
+
+/// Generalised Rosenbrock function with parameters `a` and `b`
+fn rosenbrock_cost(a: f64, b: f64, u: &[f64], cost: &mut f64) -> FunctionCallResult {
+    *cost = u
+        .windows(2)
+        .map(|w| (a - w[0]).powi(2) + b * (w[1] - w[0].powi(2)).powi(2))
+        .sum();
+    Ok(())
+}
+
+/// Gradient of the generalised Rosenbrock function
+fn rosenbrock_grad(a: f64, b: f64, u: &[f64], grad: &mut [f64]) -> FunctionCallResult {
+    grad.iter_mut().for_each(|g| *g = 0.0);
+    for i in 0..u.len() - 1 {
+        let r = u[i + 1] - u[i].powi(2);
+        grad[i] += -2.0 * (a - u[i]) - 4.0 * b * u[i] * r;
+        grad[i + 1] += 2.0 * b * r;
+    }
+    Ok(())
+}
+
+/// NMPC-style problem: single shooting over a horizon of `u.len()` steps for
+/// the nonlinear system x1+ = x1 + ts x2, x2+ = x2 + ts (u - sin x1), with a
+/// quadratic cost; the gradient is computed with the adjoint method
+struct NmpcProblem {
+    states: RefCell<Vec<[f64; 2]>>,
+}
+
+const NMPC_TS: f64 = 0.1;
+const NMPC_Q: f64 = 1.0;
+const NMPC_R: f64 = 0.1;
+const NMPC_QN: f64 = 10.0;
+const NMPC_X0: [f64; 2] = [1.0, 0.0];
+
+impl NmpcProblem {
+    fn new(horizon: usize) -> Self {
+        NmpcProblem {
+            states: RefCell::new(vec![[0.0; 2]; horizon + 1]),
+        }
+    }
+
+    fn simulate(&self, u: &[f64]) {
+        let mut states = self.states.borrow_mut();
+        states[0] = NMPC_X0;
+        for (k, u_k) in u.iter().enumerate() {
+            let [x1, x2] = states[k];
+            states[k + 1] = [x1 + NMPC_TS * x2, x2 + NMPC_TS * (u_k - x1.sin())];
+        }
+    }
+
+    fn cost(&self, u: &[f64], cost: &mut f64) -> FunctionCallResult {
+        self.simulate(u);
+        let states = self.states.borrow();
+        let horizon = u.len();
+        *cost = u
+            .iter()
+            .zip(states.iter())
+            .map(|(u_k, x_k)| NMPC_Q * (x_k[0].powi(2) + x_k[1].powi(2)) + NMPC_R * u_k.powi(2))
+            .sum::<f64>()
+            + NMPC_QN * (states[horizon][0].powi(2) + states[horizon][1].powi(2));
+        Ok(())
+    }
+
+    fn grad(&self, u: &[f64], grad: &mut [f64]) -> FunctionCallResult {
+        self.simulate(u);
+        let states = self.states.borrow();
+        let horizon = u.len();
+        let mut lambda = [
+            2.0 * NMPC_QN * states[horizon][0],
+            2.0 * NMPC_QN * states[horizon][1],
+        ];
+        for k in (0..horizon).rev() {
+            let [x1, x2] = states[k];
+            grad[k] = 2.0 * NMPC_R * u[k] + NMPC_TS * lambda[1];
+            lambda = [
+                2.0 * NMPC_Q * x1 + lambda[0] - NMPC_TS * x1.cos() * lambda[1],
+                2.0 * NMPC_Q * x2 + NMPC_TS * lambda[0] + lambda[1],
+            ];
+        }
+        Ok(())
+    }
+}
+
+fn bench_panoc_rosenbrock(c: &mut Criterion) {
+    let mut group = c.benchmark_group("panoc/rosenbrock");
+    group.throughput(Throughput::Elements(1));
+    for &n in &[2_usize, 10, 50] {
+        let (a, b) = (1.0, 100.0);
+        let f = |u: &[f64], cost: &mut f64| rosenbrock_cost(a, b, u, cost);
+        let df = |u: &[f64], grad: &mut [f64]| rosenbrock_grad(a, b, u, grad);
+        let bounds = Ball2::new(None, 1.0);
+        let mut cache = PANOCCache::new(n, TOLERANCE, LBFGS_MEMORY);
+        let u0 = vec![-0.5; n];
+
+        common::report_allocations(&format!("panoc/rosenbrock/{}", n), || {
+            let mut u = u0.clone();
+            let problem = Problem::new(&bounds, df, f);
+            let mut panoc = PANOCOptimizer::new(problem, &mut cache).with_max_iter(MAX_ITER);
+            panoc.solve(&mut u).unwrap();
+        });
+        group.bench_function(BenchmarkId::from_parameter(n), |bench| {
+            bench.iter_batched_ref(
+                || u0.clone(),
+                |u| {
+                    let problem = Problem::new(&bounds, df, f);
+                    let mut panoc =
+                        PANOCOptimizer::new(problem, &mut cache).with_max_iter(MAX_ITER);
+                    panoc.solve(u).unwrap()
+                },
+                BatchSize::SmallInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+fn bench_panoc_nmpc(c: &mut Criterion) {
+    let mut group = c.benchmark_group("panoc/nmpc");
+    group.throughput(Throughput::Elements(1));
+    for &horizon in &[10_usize, 50, 100] {
+        let nmpc = NmpcProblem::new(horizon);
+        let f = |u: &[f64], cost: &mut f64| nmpc.cost(u, cost);
+        let df = |u: &[f64], grad: &mut [f64]| nmpc.grad(u, grad);
+        let bounds = BallInf::new(None, 1.0);
+        let mut cache = PANOCCache::new(horizon, TOLERANCE, LBFGS_MEMORY);
+        let u0 = vec![0.0; horizon];
+
+        common::report_allocations(&format!("panoc/nmpc/{}", horizon), || {
+            let mut u = u0.clone();
+            let problem = Problem::new(&bounds, df, f);
+            let mut panoc = PANOCOptimizer::new(problem, &mut cache).with_max_iter(MAX_ITER);
+            panoc.solve(&mut u).unwrap();
+        });
+        group.bench_function(BenchmarkId::from_parameter(horizon), |bench| {
+            bench.iter_batched_ref(
+                || u0.clone(),
+                |u| {
+                    let problem = Problem::new(&bounds, df, f);
+                    let mut panoc =
+                        PANOCOptimizer::new(problem, &mut cache).with_max_iter(MAX_ITER);
+                    panoc.solve(u).unwrap()
+                },
+                BatchSize::SmallInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+fn bench_fbs(c: &mut Criterion) {
+    let mut group = c.benchmark_group("fbs/quadratic");
+    group.throughput(Throughput::Elements(1));
+    for &n in &[2_usize, 10, 50] {
+        // f(u) = 0.5 ||u||^2 + sum(u) subject to ||u|| <= 0.5
+        let f = |u: &[f64], cost: &mut f64| -> FunctionCallResult {
+            *cost = 0.5 * matrix_operations::norm2_squared(u) + matrix_operations::sum(u);
+            Ok(())
+        };
+        let df = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+            grad.iter_mut()
+                .zip(u.iter())
+                .for_each(|(grad_i, u_i)| *grad_i = u_i + 1.0);
+            Ok(())
+        };
+        let bounds = Ball2::new(None, 0.5);
+        let mut cache = FBSCache::new(NonZeroUsize::new(n).unwrap(), 0.5, TOLERANCE);
+        let u0 = vec![0.0; n];
+
+        common::report_allocations(&format!("fbs/quadratic/{}", n), || {
+            let mut u = u0.clone();
+            let problem = Problem::new(&bounds, df, f);
+            let mut fbs = FBSOptimizer::new(problem, &mut cache).with_max_iter(MAX_ITER);
+            fbs.solve(&mut u).unwrap();
+        });
+        group.bench_function(BenchmarkId::from_parameter(n), |bench| {
+            bench.iter_batched_ref(
+                || u0.clone(),
+                |u| {
+                    let problem = Problem::new(&bounds, df, f);
+                    let mut fbs = FBSOptimizer::new(problem, &mut cache).with_max_iter(MAX_ITER);
+                    fbs.solve(u).unwrap()
+                },
+                BatchSize::SmallInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_panoc_rosenbrock, bench_panoc_nmpc, bench_fbs);
+criterion_main!(benches);
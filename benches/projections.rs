@@ -0,0 +1,162 @@
+//! Benchmarks of the projections on the constraint sets
+//!
+//! Run with `cargo bench --bench projections`
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput};
+use optimization_engine::constraints::*;
+use rand::{rngs::StdRng, Rng, SeedableRng};
+
+mod common;
+
+const DIMENSIONS: [usize; 4] = [4, 16, 128, 1024];
+
+/// Random vector with elements in [-scale, scale]; the seed is fixed
+fn random_vector(rng: &mut StdRng, n: usize, scale: f64) -> Vec<f64> {
+    (0..n).map(|_| rng.gen_range(-scale..scale)).collect()
+}
+
+/// Reports the allocations and benchmarks the projection of `x` on `set`
+fn bench_projection<C: Constraint>(
+    group: &mut criterion::BenchmarkGroup<criterion::measurement::WallTime>,
+    name: &str,
+    set: &C,
+    x: &[f64],
+) {
+    group.throughput(Throughput::Elements(x.len() as u64));
+    common::report_allocations(&format!("projections/{}/{}", name, x.len()), || {
+        let mut z = x.to_vec();
+        set.project(&mut z);
+    });
+    group.bench_with_input(BenchmarkId::new(name, x.len()), x, |bench, x| {
+        bench.iter_batched_ref(|| x.to_vec(), |z| set.project(z), BatchSize::SmallInput)
+    });
+}
+
+fn bench_projections(c: &mut Criterion) {
+    let mut rng = StdRng::seed_from_u64(42);
+    let mut group = c.benchmark_group("projections");
+    for &n in &DIMENSIONS {
+        let x = random_vector(&mut rng, n, 10.0);
+
+        bench_projection(&mut group, "simplex", &Simplex::new(1.0), &x);
+        bench_projection(&mut group, "ball1", &Ball1::new(None, 1.0), &x);
+        bench_projection(&mut group, "ball2", &Ball2::new(None, 1.0), &x);
+        bench_projection(&mut group, "soc", &SecondOrderCone::new(1.0), &x);
+        bench_projection(
+            &mut group,
+            "epigraph_squared_norm",
+            &EpigraphSquaredNorm::new(),
+            &x,
+        );
+
+        // Affine space {x: Ax = b} with a random 2-by-n matrix A
+        let a = random_vector(&mut rng, 2 * n, 1.0);
+        let b = random_vector(&mut rng, 2, 1.0);
+        bench_projection(&mut group, "affine_space", &AffineSpace::new(a, b), &x);
+
+        // Affine space with a banded n/2-by-n matrix A (three nonzeros per row),
+        // stored as a dense and as a sparse matrix
+        let m = n / 2;
+        let mut row_ptr = vec![0];
+        let mut col_idx = Vec::new();
+        for i in 0..m {
+            col_idx.extend((2 * i..usize::min(2 * i + 3, n)).collect::<Vec<usize>>());
+            row_ptr.push(col_idx.len());
+        }
+        let values = random_vector(&mut rng, col_idx.len(), 1.0);
+        let b = random_vector(&mut rng, m, 1.0);
+        let mut a_dense = vec![0.0; m * n];
+        for i in 0..m {
+            for p in row_ptr[i]..row_ptr[i + 1] {
+                a_dense[i * n + col_idx[p]] = values[p];
+            }
+        }
+        bench_projection(
+            &mut group,
+            "affine_space_banded",
+            &AffineSpace::new(a_dense, b.clone()),
+            &x,
+        );
+        bench_projection(
+            &mut group,
+            "sparse_affine_space_banded",
+            &SparseAffineSpace::from_csr(n, row_ptr, col_idx, values, b),
+            &x,
+        );
+
+        // Finite set with 100 random points
+        let points: Vec<Vec<f64>> = (0..100).map(|_| random_vector(&mut rng, n, 10.0)).collect();
+        let points_refs: Vec<&[f64]> = points.iter().map(|p| p.as_slice()).collect();
+        bench_projection(&mut group, "finite_set", &FiniteSet::new(&points_refs), &x);
+
+        // Cartesian product of a ball, a ball-inf and a simplex
+        let cartesian_product = CartesianProduct::new()
+            .add_constraint(n / 4, Ball2::new(None, 1.0))
+            .add_constraint(n / 2, BallInf::new(None, 1.0))
+            .add_constraint(n, Simplex::new(1.0));
+        bench_projection(&mut group, "cartesian_product", &cartesian_product, &x);
+        let static_cartesian_product = StaticCartesianProduct::new(
+            &[n / 4, n / 2, n],
+            (
+                Ball2::new(None, 1.0),
+                BallInf::new(None, 1.0),
+                Simplex::new(1.0),
+            ),
+        );
+        bench_projection(
+            &mut group,
+            "static_cartesian_product",
+            &static_cartesian_product,
+            &x,
+        );
+    }
+
+    // 256 small blocks in R^3 (e.g., friction cones), as a Cartesian product
+    // of the blocks and as a homogeneous product (structure of arrays)
+    let num_blocks = 256;
+    let x = random_vector(&mut rng, 3 * num_blocks, 10.0);
+    let cones = (0..num_blocks).fold(
+        CartesianProduct::new_with_capacity(num_blocks),
+        |cones, k| cones.add_constraint(3 * (k + 1), SecondOrderCone::new(0.5)),
+    );
+    bench_projection(&mut group, "cartesian_product_soc3", &cones, &x);
+    bench_projection(
+        &mut group,
+        "homogeneous_product_soc3",
+        &HomogeneousCartesianProduct::new(SecondOrderCone::new(0.5), num_blocks),
+        &x,
+    );
+    let epigraphs = (0..num_blocks).fold(
+        CartesianProduct::new_with_capacity(num_blocks),
+        |epigraphs, k| epigraphs.add_constraint(3 * (k + 1), EpigraphSquaredNorm::new()),
+    );
+    bench_projection(&mut group, "cartesian_product_epigraph3", &epigraphs, &x);
+    bench_projection(
+        &mut group,
+        "homogeneous_product_epigraph3",
+        &HomogeneousCartesianProduct::new(EpigraphSquaredNorm::new(), num_blocks),
+        &x,
+    );
+
+    // Finite set with 10^4 random points in 3 dimensions, with and without index
+    let points: Vec<Vec<f64>> = (0..10000)
+        .map(|_| random_vector(&mut rng, 3, 10.0))
+        .collect();
+    let points_refs: Vec<&[f64]> = points.iter().map(|p| p.as_slice()).collect();
+    let x = random_vector(&mut rng, 3, 10.0);
+    bench_projection(
+        &mut group,
+        "finite_set_10k",
+        &FiniteSet::new(&points_refs),
+        &x,
+    );
+    bench_projection(
+        &mut group,
+        "indexed_finite_set_10k",
+        &IndexedFiniteSet::new(&points_refs),
+        &x,
+    );
+    group.finish();
+}
+
+criterion_group!(benches, bench_projections);
+criterion_main!(benches);
@@ -1,3 +1,4 @@
 from .optimizer_builder import *
 from .problem import *
 from .set_y_calculator import *
+from .solver_host_builder import *
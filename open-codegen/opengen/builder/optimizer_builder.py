@@ -1,5 +1,7 @@
 import subprocess
 import shutil
+import hashlib
+import json
 import yaml
 
 import opengen.config as og_cfg
@@ -21,8 +23,11 @@ _AUTOGEN_ALM_MAPPING_F1_FNAME = 'auto_casadi_mapping_f1.c'
 _AUTOGEN_PRECONDITIONING_FNAME = 'auto_preconditioning_functions.c'
 _PYTHON_BINDINGS_PREFIX = 'python_bindings_'
 _TCP_IFACE_PREFIX = 'tcp_iface_'
+_SHM_IFACE_PREFIX = 'shm_iface_'
+_BENCHMARK_PREFIX = 'benchmark_'
 _ICASADI_PREFIX = 'icasadi_'
 _ROS_PREFIX = 'ros_node_'
+_BUILD_CACHE_FNAME = '.opengen_build_cache.json'
 
 # Template files
 _OPTIMIZER_RS = "optimizer.rs.jinja"
@@ -35,6 +40,73 @@ def make_dir_if_not_exists(directory):
         os.makedirs(directory)
 
 
+def write_if_changed(path, content):
+    """Writes `content` to the file at `path`, unless the file already has
+    this content, so that its modification time (which cargo uses to decide
+    what to recompile) is kept
+
+    :return: True iff the file was written
+    """
+    if os.path.isfile(path):
+        with open(path, "r") as fh:
+            if fh.read() == content:
+                return False
+    with open(path, "w") as fh:
+        fh.write(content)
+    return True
+
+
+def _fingerprint_data(obj):
+    """Converts `obj` (e.g., a CasADi expression, a set of constraints or a
+    configuration) to data which can be serialised to JSON deterministically"""
+    if obj is None or isinstance(obj, (bool, int, str)):
+        return obj
+    if isinstance(obj, float):
+        return repr(obj)
+    if isinstance(obj, dict):
+        return {str(k): _fingerprint_data(v) for k, v in obj.items()}
+    if isinstance(obj, (list, tuple)):
+        return [_fingerprint_data(v) for v in obj]
+    if isinstance(obj, (cs.SX, cs.MX, cs.DM)):
+        return str(obj)
+    if hasattr(obj, 'tolist'):
+        return _fingerprint_data(obj.tolist())  # numpy arrays and scalars
+    if callable(obj):
+        return getattr(obj, '__qualname__', type(obj).__name__)
+    if hasattr(obj, '__dict__'):
+        return {'type': type(obj).__name__, 'data': _fingerprint_data(vars(obj))}
+    return repr(obj)
+
+
+def _directory_fingerprint(directory):
+    """Content hash of all files in `directory` (except for build outputs)"""
+    sha = hashlib.sha256()
+    for root, dirs, files in os.walk(directory):
+        dirs[:] = sorted(d for d in dirs if d not in ('target', '__pycache__'))
+        for name in sorted(files):
+            path = os.path.join(root, name)
+            sha.update(os.path.relpath(path, directory).encode())
+            with open(path, 'rb') as fh:
+                sha.update(fh.read())
+    return sha.hexdigest()
+
+
+def _open_sources_fingerprint(local_path):
+    """Content hash of the sources of a local version of OpEn (its manifest
+    and the Rust sources), which the compiled optimizer depends on"""
+    sha = hashlib.sha256()
+    for name in ('Cargo.toml', 'build.rs'):
+        path = os.path.join(local_path, name)
+        if os.path.isfile(path):
+            with open(path, 'rb') as fh:
+                sha.update(name.encode())
+                sha.update(fh.read())
+    src_dir = os.path.join(local_path, 'src')
+    if os.path.isdir(src_dir):
+        sha.update(_directory_fingerprint(src_dir).encode())
+    return sha.hexdigest()
+
+
 class OpEnOptimizerBuilder:
     """Builder for code generation
 
@@ -126,6 +198,33 @@ class OpEnOptimizerBuilder:
 
         return command
 
+    def __make_build_env(self, subdir=None):
+        """
+        Environment of the cargo build (with the shared target directory, if any)
+
+        """
+        env = dict(os.environ)
+        shared_target_dir = self.__build_config.shared_target_dir
+        if shared_target_dir is not None:
+            env['CARGO_TARGET_DIR'] = shared_target_dir if subdir is None \
+                else os.path.join(shared_target_dir, subdir)
+        return env
+
+    def __cargo_output_dir(self, crate_dir, subdir=None):
+        """
+        Directory where cargo places the artifacts of the crate at `crate_dir`
+
+        """
+        shared_target_dir = self.__build_config.shared_target_dir
+        if shared_target_dir is None:
+            cargo_target_dir = os.path.join(crate_dir, 'target')
+        else:
+            cargo_target_dir = shared_target_dir if subdir is None \
+                else os.path.join(shared_target_dir, subdir)
+        if self.__build_config.target_system is not None:
+            cargo_target_dir = os.path.join(cargo_target_dir, self.__build_config.target_system)
+        return os.path.join(cargo_target_dir, self.__build_config.build_mode.lower())
+
     def __target_dir(self):
         """
 
@@ -200,8 +299,7 @@ class OpEnOptimizerBuilder:
             meta=self.__meta)
         icasadi_cargo_allocator_path = os.path.abspath(
             os.path.join(self.__icasadi_target_dir(), "Cargo.toml"))
-        with open(icasadi_cargo_allocator_path, "w") as fh:
-            fh.write(icasadi_cargo_output_template)
+        write_if_changed(icasadi_cargo_allocator_path, icasadi_cargo_output_template)
 
     def __generate_icasadi_c_interface(self):
         """
@@ -218,8 +316,7 @@ class OpEnOptimizerBuilder:
             solver_config=self.__solver_config)
         cint_icallocator_path = os.path.abspath(
             os.path.join(self.__icasadi_target_dir(), "extern", "interface.c"))
-        with open(cint_icallocator_path, "w") as fh:
-            fh.write(cint_output_template)
+        write_if_changed(cint_icallocator_path, cint_output_template)
 
     def __generate_icasadi_lib(self):
         """
@@ -232,11 +329,11 @@ class OpEnOptimizerBuilder:
             'icasadi_lib.rs', 'icasadi')
         icasadi_lib_output_template = icasadi_lib_template.render(meta=self.__meta,
                                                                   problem=self.__problem,
-                                                                  build_config=self.__build_config)
+                                                                  build_config=self.__build_config,
+                                                                  solver_config=self.__solver_config)
         icasadi_lib_rs_path = os.path.abspath(
             os.path.join(self.__icasadi_target_dir(), "src", "lib.rs"))
-        with open(icasadi_lib_rs_path, "w") as fh:
-            fh.write(icasadi_lib_output_template)
+        write_if_changed(icasadi_lib_rs_path, icasadi_lib_output_template)
 
     def __generate_cargo_toml(self):
         """
@@ -254,12 +351,12 @@ class OpEnOptimizerBuilder:
             activate_clib_generation=self.__build_config.build_c_bindings)
         cargo_toml_path = os.path.abspath(
             os.path.join(target_dir, "Cargo.toml"))
-        with open(cargo_toml_path, "w") as fh:
-            fh.write(cargo_output_template)
+        write_if_changed(cargo_toml_path, cargo_output_template)
 
     def __generate_memory_code(self,
                                cost=None,
                                grad=None,
+                               cost_and_grad=None,
                                f1=None,
                                f2=None,
                                w_cost_fn=None,
@@ -278,21 +375,21 @@ class OpEnOptimizerBuilder:
         casadi_mem_template = OpEnOptimizerBuilder.__get_template(
             'casadi_memory.h', 'icasadi')
         casadi_mem_output_template = casadi_mem_template.render(
-            cost=cost, grad=grad,
+            cost=cost, grad=grad, cost_and_grad=cost_and_grad,
             f1=f1, f2=f2,
             w_cost=w_cost_fn, w1=w_constraint_f1_fn, w2=w_constraint_f2_fn, init_penalty=init_penalty_fn,
             build_config=self.__build_config,
             meta=self.__meta)
         memory_path = os.path.abspath(
             os.path.join(self.__icasadi_target_dir(), "extern", "casadi_memory.h"))
-        with open(memory_path, "w") as fh:
-            fh.write(casadi_mem_output_template)
+        write_if_changed(memory_path, casadi_mem_output_template)
 
     def __construct_function_psi(self):
         """
         Construct function psi and its gradient
 
-        :return: cs.Function objects: psi_fun, grad_psi_fun
+        :return: cs.Function objects: psi_fun, grad_psi_fun, psi_and_grad_fun (the
+            latter is a function with outputs psi and its gradient)
         """
         self.__logger.info("Defining function psi(u, xi, p) and its gradient")
         problem = self.__problem
@@ -336,7 +433,9 @@ class OpEnOptimizerBuilder:
         psi_fun = cs.Function(meta.cost_function_name, [u, xi, theta], [psi])
         grad_psi_fun = cs.Function(
             meta.grad_function_name, [u, xi, theta], [jac_psi])
-        return psi_fun, grad_psi_fun
+        psi_and_grad_fun = cs.Function(
+            meta.cost_and_grad_function_name, [u, xi, theta], [psi, jac_psi])
+        return psi_fun, grad_psi_fun, psi_and_grad_fun
 
     def __construct_mapping_f1_function(self) -> cs.Function:
         self.__logger.info("Defining function F1(u, p)")
@@ -419,7 +518,7 @@ class OpEnOptimizerBuilder:
         phi = problem.cost_function
         symbol_type = cs.MX.sym if isinstance(u, cs.MX) else cs.SX.sym
 
-        gen_code = cs.CodeGenerator(_AUTOGEN_PRECONDITIONING_FNAME)
+        gen_code = cs.CodeGenerator(_AUTOGEN_PRECONDITIONING_FNAME, self.__casadi_codegen_options())
 
         jac_cost = OpEnOptimizerBuilder.__casadi_norm_infinity(
             cs.jacobian(phi, u).T)
@@ -489,6 +588,15 @@ class OpEnOptimizerBuilder:
 
         return w_cost_fn, w_constraint_f1_fn, w_constraint_f2_fn, init_penalty_fn
 
+    def __casadi_codegen_options(self):
+        """Options of CasADi's code generator
+
+        In single precision, CasADi generates code with `casadi_real=float`
+        """
+        if self.__solver_config.single_precision:
+            return {"casadi_real": "float"}
+        return {}
+
     def __generate_casadi_code(self):
         """Generates CasADi C code"""
         self.__logger.info("Defining CasADi functions and generating C code")
@@ -496,12 +604,19 @@ class OpEnOptimizerBuilder:
         meta = self.__meta
 
         # -----------------------------------------------------------------------
-        psi_fun, grad_psi_fun = self.__construct_function_psi()
+        psi_fun, grad_psi_fun, psi_and_grad_fun = self.__construct_function_psi()
         cost_file_name = meta.cost_function_name + ".c"
         grad_file_name = meta.grad_function_name + ".c"
         self.__logger.info("Function psi and its gradient (C code)")
-        psi_fun.generate(cost_file_name)
-        grad_psi_fun.generate(grad_file_name)
+        psi_fun.generate(cost_file_name, self.__casadi_codegen_options())
+        # The fused function (psi and its gradient) goes in the same file as the gradient
+        grad_code = cs.CodeGenerator(grad_file_name, self.__casadi_codegen_options())
+        grad_code.add(grad_psi_fun)
+        if self.__solver_config.fused_cost_and_gradient:
+            grad_code.add(psi_and_grad_fun)
+        else:
+            psi_and_grad_fun = None
+        grad_code.generate()
         icasadi_extern_dir = os.path.join(
             self.__icasadi_target_dir(), "extern")
         shutil.move(cost_file_name, os.path.join(
@@ -513,7 +628,7 @@ class OpEnOptimizerBuilder:
         mapping_f1_fun = self.__construct_mapping_f1_function()
         f1_file_name = meta.alm_mapping_f1_function_name + ".c"
         self.__logger.info("Mapping F1 (C code)")
-        mapping_f1_fun.generate(f1_file_name)
+        mapping_f1_fun.generate(f1_file_name, self.__casadi_codegen_options())
         # Move auto-generated file to target folder
         shutil.move(f1_file_name,
                     os.path.join(icasadi_extern_dir, _AUTOGEN_ALM_MAPPING_F1_FNAME))
@@ -522,7 +637,7 @@ class OpEnOptimizerBuilder:
         mapping_f2_fun = self.__construct_mapping_f2_function()
         f2_file_name = meta.constraint_penalty_function_name + ".c"
         self.__logger.info("Mapping F2 (C code)")
-        mapping_f2_fun.generate(f2_file_name)
+        mapping_f2_fun.generate(f2_file_name, self.__casadi_codegen_options())
         # Move auto-generated file to target folder
         shutil.move(f2_file_name,
                     os.path.join(icasadi_extern_dir, _AUTOGEN_PNLT_CONSTRAINTS_FNAME))
@@ -531,7 +646,7 @@ class OpEnOptimizerBuilder:
         (w_cost_fn, w_constraint_f1_fn, w_constraint_f2_fn,
          init_penalty_fn) = self.__generate_code_preconditioning()
 
-        self.__generate_memory_code(psi_fun, grad_psi_fun,
+        self.__generate_memory_code(psi_fun, grad_psi_fun, psi_and_grad_fun,
                                     mapping_f1_fun, mapping_f2_fun,
                                     w_cost_fn,
                                     w_constraint_f1_fn,
@@ -549,12 +664,12 @@ class OpEnOptimizerBuilder:
             meta=self.__meta,
             problem=self.__problem,
             activate_clib_generation=self.__build_config.build_c_bindings,
+            static_memory_bytes=self.__static_memory_bytes(),
             float=float)
         target_source_path = os.path.join(target_dir, "src")
         target_scr_lib_rs_path = os.path.join(target_source_path, "lib.rs")
         make_dir_if_not_exists(target_source_path)
-        with open(target_scr_lib_rs_path, "w") as fh:
-            fh.write(optimizer_rs_output_template)
+        write_if_changed(target_scr_lib_rs_path, optimizer_rs_output_template)
 
     def __generate_build_rs(self):
         self.__logger.info("Generating build.rs for target optimizer")
@@ -565,13 +680,12 @@ class OpEnOptimizerBuilder:
             meta=self.__meta,
             activate_clib_generation=self.__build_config.build_c_bindings)
         target_build_lib_rs_path = os.path.join(target_dir, "build.rs")
-        with open(target_build_lib_rs_path, "w") as fh:
-            fh.write(build_rs_output_template)
+        write_if_changed(target_build_lib_rs_path, build_rs_output_template)
 
     def __build_optimizer(self):
         target_dir = os.path.abspath(self.__target_dir())
         command = self.__make_build_command()
-        p = subprocess.Popen(command, cwd=target_dir)
+        p = subprocess.Popen(command, cwd=target_dir, env=self.__make_build_env())
         process_completion = p.wait()
         if process_completion != 0:
             raise Exception('Rust build failed')
@@ -584,15 +698,13 @@ class OpEnOptimizerBuilder:
         python_bindings_dir = os.path.join(
             target_dir, python_bindings_dir_name)
         command = self.__make_build_command()
-        p = subprocess.Popen(command, cwd=python_bindings_dir)
+        p = subprocess.Popen(command, cwd=python_bindings_dir,
+                             env=self.__make_build_env('python'))
         process_completion = p.wait()
         if process_completion != 0:
             raise Exception('Rust build of Python bindings failed')
 
-        if self.__build_config.build_mode.lower() == 'release':
-            build_dir = os.path.join(python_bindings_dir, 'target', 'release')
-        else:
-            build_dir = os.path.join(python_bindings_dir, 'target', 'debug')
+        build_dir = self.__cargo_output_dir(python_bindings_dir, 'python')
 
         pltform_extension_dict = {'linux': ('.so', '.so'),
                                   'darwin': ('.dylib', '.so'),
@@ -618,11 +730,202 @@ class OpEnOptimizerBuilder:
         tcp_iface_dir_name = _TCP_IFACE_PREFIX + optimizer_name
         tcp_iface_dir = os.path.join(target_dir, tcp_iface_dir_name)
         command = self.__make_build_command()
-        p = subprocess.Popen(command, cwd=tcp_iface_dir)
+        p = subprocess.Popen(command, cwd=tcp_iface_dir, env=self.__make_build_env())
         process_completion = p.wait()
         if process_completion != 0:
             raise Exception('Rust build of TCP interface failed')
 
+    def __build_shm_iface(self):
+        self.__logger.info("Building the shared-memory interface")
+        target_dir = os.path.abspath(self.__target_dir())
+        shm_iface_dir = os.path.join(target_dir, _SHM_IFACE_PREFIX + self.__meta.optimizer_name)
+        command = self.__make_build_command()
+        p = subprocess.Popen(command, cwd=shm_iface_dir, env=self.__make_build_env())
+        process_completion = p.wait()
+        if process_completion != 0:
+            raise Exception('Rust build of shared-memory interface failed')
+
+    def __build_benchmark(self):
+        self.__logger.info("Building the latency benchmark")
+        target_dir = os.path.abspath(self.__target_dir())
+        benchmark_dir = os.path.join(target_dir, _BENCHMARK_PREFIX + self.__meta.optimizer_name)
+        command = self.__make_build_command()
+        p = subprocess.Popen(command, cwd=benchmark_dir, env=self.__make_build_env())
+        process_completion = p.wait()
+        if process_completion != 0:
+            raise Exception('Rust build of latency benchmark failed')
+
+    def __static_memory_bytes(self):
+        """Size of the static memory arena of the solver in bytes
+
+        Unless it is given by the build configuration, the size is estimated
+        from the memory allocated by the PANOC and ALM caches (including the
+        L-BFGS buffer), the preconditioning weights, the iteration trace, the
+        sets U and C (which are constructed with the cache) and the solver status,
+        plus a margin for the alignment of each allocation and for the
+        allocations of the standard library
+
+        :return: size in bytes, or None if no static memory is used
+        """
+        if not self.__build_config.static_memory:
+            return None
+        if self.__build_config.static_memory_bytes is not None:
+            return self.__build_config.static_memory_bytes
+        n = self.__problem.dim_decision_variables()
+        n1 = self.__problem.dim_constraints_aug_lagrangian()
+        n2 = self.__problem.dim_constraints_penalty() or 0
+        n_p = self.__problem.dim_parameters()
+        mem = self.__solver_config.lbfgs_memory
+        float_bytes = 4 if self.__solver_config.single_precision else 8
+        num_floats = (16 + 2 * (mem + 1)) * n + 4 * (n1 + n2) + n_p + 2 * mem + 64
+        num_allocations = 2 * mem + 64
+        size = float_bytes * num_floats + 16 * num_allocations
+        size = size + self.__set_memory_bytes(self.__problem.constraints)
+        size = size + self.__set_memory_bytes(self.__problem.alm_set_c)
+        size = size + 72 * (self.__solver_config.trace_capacity or 0)
+        size = size + size // 4 + 8192
+        return 1024 * ((size + 1023) // 1024)
+
+    def __set_memory_bytes(self, set_):
+        """Memory which is allocated for a set of the generated solver: the
+        data and factorisation of affine spaces, their projection workspace and
+        the index vectors of Cartesian products
+
+        :param set_: set (or None)
+
+        :return: size in bytes
+        """
+        if isinstance(set_, og_cstr.CartesianProduct):
+            return 32 * len(set_.constraints) \
+                + sum(self.__set_memory_bytes(set_i) for set_i in set_.constraints)
+        if isinstance(set_, og_cstr.AffineSpace):
+            m = len(set_.vector_b)
+            if set_.is_sparse:
+                # the factor of AA' may be dense; factorising it also needs
+                # the elimination graph (sets of indices)
+                nnz = len(set_.csr_values)
+                return 16 * (nnz + m) + 64 * m * m + 64 * m
+            n = len(set_.matrix_a) // m
+            # A, AA' (while factorising) and its factor, b, the permutation
+            # and the projection workspace
+            return 8 * (m * n + 2 * m * m + 4 * m)
+        return 0
+
+    def __casadi_fingerprint(self):
+        """Content hash of everything the CasADi C code depends on: the problem
+        (cost, constraints, mappings), the metadata (function names), the
+        solver options that change the generated functions and the version of
+        opengen and its templates
+
+        :return: hexadecimal SHA-256 hash
+        """
+        solver_config = self.__solver_config
+        data = {
+            'opengen': pkg_resources.require("opengen")[0].version,
+            'icasadi': _directory_fingerprint(og_dfn.original_icasadi_dir()),
+            'templates': _directory_fingerprint(og_dfn.templates_dir()),
+            'meta': self.__meta.to_dict(),
+            'problem': self.__problem,
+            'solver': {'preconditioning': solver_config.preconditioning,
+                       'single_precision': solver_config.single_precision,
+                       'fused_cost_and_gradient': solver_config.fused_cost_and_gradient},
+        }
+        serialised = json.dumps(_fingerprint_data(data), sort_keys=True)
+        return hashlib.sha256(serialised.encode()).hexdigest()
+
+    def __build_fingerprint(self, casadi_fingerprint):
+        """Content hash of everything the compiled artifacts depend on
+
+        :return: hexadecimal SHA-256 hash
+        """
+        build_dict = self.__build_config.to_dict()
+        build_dict.pop('rebuild')
+        local_path = self.__build_config.local_path
+        data = {
+            'casadi': casadi_fingerprint,
+            'solver': self.__solver_config.to_dict(),
+            'build': build_dict,
+            'static_memory_bytes': self.__static_memory_bytes(),
+            # variants with the same name in different build directories
+            # share the artifacts of a shared target directory
+            'target_dir': self.__target_dir(),
+            'open_sources': None if local_path is None else _open_sources_fingerprint(local_path),
+        }
+        serialised = json.dumps(_fingerprint_data(data), sort_keys=True)
+        return hashlib.sha256(serialised.encode()).hexdigest()
+
+    def __build_cache_path(self):
+        return os.path.join(self.__target_dir(), _BUILD_CACHE_FNAME)
+
+    def __load_build_cache(self):
+        """Fingerprints of the previous build (empty if the build cache is
+        not active or there is no previous build)"""
+        if not self.__build_config.build_cache:
+            return {}
+        try:
+            with open(self.__build_cache_path(), 'r') as fh:
+                return json.load(fh)
+        except (OSError, ValueError):
+            return {}
+
+    def __save_build_cache(self, fingerprints):
+        if self.__build_config.build_cache:
+            with open(self.__build_cache_path(), 'w') as fh:
+                json.dump(fingerprints, fh)
+
+    def __built_crates(self):
+        """Crates which are compiled by the build, as pairs `(crate_dir, subdir)`,
+        where `subdir` is the subdirectory of the shared target directory"""
+        target_dir = self.__target_dir()
+        optimizer_name = self.__meta.optimizer_name
+        crates = [(target_dir, None)]
+        if self.__build_config.tcp_interface_config is not None:
+            crates.append((os.path.join(target_dir, _TCP_IFACE_PREFIX + optimizer_name), None))
+        if self.__build_config.shm_interface_config is not None:
+            crates.append((os.path.join(target_dir, _SHM_IFACE_PREFIX + optimizer_name), None))
+        if self.__build_config.benchmark_config is not None:
+            crates.append((os.path.join(target_dir, _BENCHMARK_PREFIX + optimizer_name), None))
+        if self.__build_config.build_python_bindings:
+            crates.append((os.path.join(target_dir, _PYTHON_BINDINGS_PREFIX + optimizer_name), 'python'))
+        return crates
+
+    def __build_stamp_path(self, crate_dir, subdir):
+        """File next to the artifacts of a crate which records the build
+        fingerprint of its last build; since the stamp is named after the
+        crate, a build of another variant with the same name (in a shared
+        target directory) overwrites it"""
+        return os.path.join(self.__cargo_output_dir(crate_dir, subdir),
+                            '.opengen_build_' + os.path.basename(crate_dir))
+
+    def __save_build_stamps(self, build_fingerprint):
+        if self.__build_config.build_cache:
+            for (crate_dir, subdir) in self.__built_crates():
+                with open(self.__build_stamp_path(crate_dir, subdir), 'w') as fh:
+                    fh.write(build_fingerprint)
+
+    def __artifacts_up_to_date(self, build_fingerprint):
+        """Whether the artifacts of the last build exist and were built from
+        `build_fingerprint` (they may have been removed, e.g., by `cargo clean`,
+        or overwritten by another variant in a shared target directory)"""
+        optimizer_name = self.__meta.optimizer_name
+        library = os.path.join(self.__cargo_output_dir(self.__target_dir()),
+                               'lib{}.rlib'.format(optimizer_name))
+        if not os.path.isfile(library):
+            return False
+        if self.__build_config.build_python_bindings:
+            extension = '.pyd' if sys.platform == 'win32' else '.so'
+            bindings = os.path.join(self.__target_dir(), optimizer_name + extension)
+            if not os.path.isfile(bindings):
+                return False
+        for (crate_dir, subdir) in self.__built_crates():
+            try:
+                with open(self.__build_stamp_path(crate_dir, subdir), 'r') as fh:
+                    if fh.read() != build_fingerprint:
+                        return False
+            except OSError:
+                return False
+        return True
+
     def __initialize(self):
         self.__logger.info("--- Initialising builder: '%s'" %
                            self.__meta.optimizer_name)
@@ -641,6 +944,37 @@ class OpEnOptimizerBuilder:
                 if isinstance(alm_set_c, og_cstr.Rectangle) and not alm_set_c.is_orthant():
                     raise NotImplementedError("ALM-type constraints with general rectrangles will be supported soon. "
                                               "For now we only support orthans (e.g., F1(u, p) <= 0).")
+        if self.__solver_config.horizon_shift:
+            nu = self.__problem.dim_decision_variables()
+            if self.__solver_config.stage_dim * self.__solver_config.horizon != nu:
+                raise ValueError("Horizon shifting: the number of decision variables (%d) must be equal to "
+                                 "stage_dim * horizon" % nu)
+        if self.__build_config.static_memory:
+            if self.__build_config.tcp_interface_config is not None \
+                    or self.__build_config.shm_interface_config is not None \
+                    or self.__build_config.ros_config is not None \
+                    or self.__build_config.build_python_bindings:
+                raise ValueError("Static memory cannot be combined with a TCP or shared-memory "
+                                 "interface, ROS packages or Python bindings")
+            if self.__build_config.allocator != og_cfg.RustAllocator.DefaultAllocator:
+                raise ValueError("Static memory cannot be combined with a custom allocator")
+            if self.__build_config.benchmark_config is not None:
+                raise ValueError("Static memory cannot be combined with a latency benchmark")
+        benchmark_config = self.__build_config.benchmark_config
+        if benchmark_config is not None:
+            n_p = self.__problem.dim_parameters()
+            if benchmark_config.parameter_lower is not None \
+                    and len(benchmark_config.parameter_lower) != n_p:
+                raise ValueError("Benchmark: the parameter ranges must have length %d" % n_p)
+            if n_p > 0 and benchmark_config.parameter_lower is None \
+                    and benchmark_config.trajectory_file is None:
+                raise ValueError("Benchmark: parameter ranges or a parameter trajectory must be provided")
+        if self.__solver_config.single_precision:
+            sets = [self.__problem.constraints, self.__problem.alm_set_c, self.__problem.alm_set_y]
+            if isinstance(self.__problem.constraints, og_cstr.CartesianProduct):
+                sets += self.__problem.constraints.constraints
+            if any(isinstance(s, og_cstr.AffineSpace) for s in sets):
+                raise NotImplementedError("Affine spaces are not supported in single precision")
 
     def __generate_code_python_bindings(self):
         self.__logger.info("Generating code for Python bindings")
@@ -663,8 +997,7 @@ class OpEnOptimizerBuilder:
             meta=self.__meta)
         target_python_rs_path = os.path.join(
             python_bindings_source_dir, "lib.rs")
-        with open(target_python_rs_path, "w") as fh:
-            fh.write(python_rs_output_template)
+        write_if_changed(target_python_rs_path, python_rs_output_template)
 
         # generate Cargo.toml for python_bindings
         python_rs_template = OpEnOptimizerBuilder.__get_template(
@@ -673,8 +1006,7 @@ class OpEnOptimizerBuilder:
             meta=self.__meta,
             build_config=self.__build_config)
         target_python_rs_path = os.path.join(python_bindings_dir, "Cargo.toml")
-        with open(target_python_rs_path, "w") as fh:
-            fh.write(python_rs_output_template)
+        write_if_changed(target_python_rs_path, python_rs_output_template)
 
         # move cargo_config into .cargo/config
         target_cargo_config_dir = os.path.join(python_bindings_dir, '.cargo')
@@ -706,8 +1038,7 @@ class OpEnOptimizerBuilder:
             meta=self.__meta,
             tcp_server_config=self.__build_config.tcp_interface_config)
         target_tcp_rs_path = os.path.join(tcp_iface_source_dir, "main.rs")
-        with open(target_tcp_rs_path, "w") as fh:
-            fh.write(tcp_rs_output_template)
+        write_if_changed(target_tcp_rs_path, tcp_rs_output_template)
 
         # generate Cargo.toml for tcp_iface
         tcp_rs_template = OpEnOptimizerBuilder.__get_template(
@@ -716,8 +1047,71 @@ class OpEnOptimizerBuilder:
             meta=self.__meta,
             build_config=self.__build_config)
         target_tcp_rs_path = os.path.join(tcp_iface_dir, "Cargo.toml")
-        with open(target_tcp_rs_path, "w") as fh:
-            fh.write(tcp_rs_output_template)
+        write_if_changed(target_tcp_rs_path, tcp_rs_output_template)
+
+    def __generate_code_shm_interface(self):
+        self.__logger.info(
+            "Generating code for the shared-memory interface (shm_iface/src/main.rs)")
+        target_dir = self.__target_dir()
+        shm_iface_dir = os.path.join(target_dir, _SHM_IFACE_PREFIX + self.__meta.optimizer_name)
+        shm_iface_source_dir = os.path.join(shm_iface_dir, "src")
+
+        # make shm_iface/ and shm_iface/src
+        make_dir_if_not_exists(shm_iface_dir)
+        make_dir_if_not_exists(shm_iface_source_dir)
+
+        # generate main.rs for shm_iface
+        shm_rs_template = OpEnOptimizerBuilder.__get_template(
+            'shm_server.rs', 'shm')
+        shm_rs_output_template = shm_rs_template.render(
+            meta=self.__meta,
+            shm_server_config=self.__build_config.shm_interface_config)
+        write_if_changed(os.path.join(shm_iface_source_dir, "main.rs"), shm_rs_output_template)
+
+        # generate Cargo.toml for shm_iface
+        shm_cargo_template = OpEnOptimizerBuilder.__get_template(
+            'shm_server_cargo.toml', 'shm')
+        shm_cargo_output_template = shm_cargo_template.render(
+            meta=self.__meta,
+            build_config=self.__build_config)
+        write_if_changed(os.path.join(shm_iface_dir, "Cargo.toml"), shm_cargo_output_template)
+
+        # generate the C client (header-only)
+        shm_client_template = OpEnOptimizerBuilder.__get_template(
+            'shm_client.h', 'shm')
+        shm_client_output_template = shm_client_template.render(
+            meta=self.__meta,
+            problem=self.__problem,
+            shm_server_config=self.__build_config.shm_interface_config)
+        write_if_changed(os.path.join(shm_iface_dir, self.__meta.optimizer_name + "_shm_client.h"),
+                         shm_client_output_template)
+
+    def __generate_code_benchmark(self):
+        self.__logger.info(
+            "Generating code for the latency benchmark (benchmark/src/main.rs)")
+        target_dir = self.__target_dir()
+        benchmark_dir = os.path.join(target_dir, _BENCHMARK_PREFIX + self.__meta.optimizer_name)
+        benchmark_source_dir = os.path.join(benchmark_dir, "src")
+
+        # make benchmark/ and benchmark/src
+        make_dir_if_not_exists(benchmark_dir)
+        make_dir_if_not_exists(benchmark_source_dir)
+
+        # generate main.rs for the benchmark
+        benchmark_template = OpEnOptimizerBuilder.__get_template(
+            'benchmark.rs', 'benchmark')
+        benchmark_output_template = benchmark_template.render(
+            meta=self.__meta,
+            benchmark_config=self.__build_config.benchmark_config)
+        write_if_changed(os.path.join(benchmark_source_dir, "main.rs"), benchmark_output_template)
+
+        # generate Cargo.toml for the benchmark
+        benchmark_template = OpEnOptimizerBuilder.__get_template(
+            'benchmark_cargo.toml', 'benchmark')
+        benchmark_output_template = benchmark_template.render(
+            meta=self.__meta,
+            build_config=self.__build_config)
+        write_if_changed(os.path.join(benchmark_dir, "Cargo.toml"), benchmark_output_template)
 
     def __generate_yaml_data_file(self):
         self.__logger.info("Generating YAML configuration file")
@@ -733,6 +1127,11 @@ class OpEnOptimizerBuilder:
 
         tcp_details = None if tcp_config is None \
             else {'ip': tcp_config.bind_ip, 'port': tcp_config.bind_port}
+        shm_config = self.__build_config.shm_interface_config
+        shm_details = None if shm_config is None \
+            else {'path': shm_config.path or '/dev/shm/open_' + metadata.optimizer_name,
+                  'spin_iterations': shm_config.spin_iterations,
+                  'idle_sleep_micros': shm_config.idle_sleep_micros}
         metadata_details = {'optimizer_name': metadata.optimizer_name,
                             'version': metadata.version,
                             'authors': metadata.authors,
@@ -741,9 +1140,11 @@ class OpEnOptimizerBuilder:
                          'opengen_version': opengen_version,
                          'build_dir': build_config.build_dir,
                          'build_mode': build_config.build_mode,
-                         'target_system': build_config.target_system
+                         'target_system': build_config.target_system,
+                         'shared_target_dir': build_config.shared_target_dir
                          }
         solver_details = {'lbfgs_memory': solver_config.lbfgs_memory,
+                          'anderson_memory': solver_config.anderson_memory,
                           'tolerance': solver_config.tolerance,
                           'constraints_tolerance': solver_config.constraints_tolerance,
                           'penalty_weight_update_factor': solver_config.penalty_weight_update_factor,
@@ -751,7 +1152,8 @@ class OpEnOptimizerBuilder:
                           'max_inner_iterations': solver_config.max_inner_iterations,
                           'max_duration_micros': solver_config.max_duration_micros
                           }
-        details = {'meta': metadata_details, 'tcp': tcp_details, 'build': build_details,
+        details = {'meta': metadata_details, 'tcp': tcp_details, 'shm': shm_details,
+                   'build': build_details,
                    'solver': solver_details,
                    "_comment": "auto-generated file; do not modify"}
         with open(target_yaml_file_path, 'w') as outfile:
@@ -779,8 +1181,7 @@ class OpEnOptimizerBuilder:
             build_config=self.__build_config,
             problem=self.__problem)
         cbind_target_path = os.path.join(target_dir, "example_optimizer.c")
-        with open(cbind_target_path, "w") as fh:
-            fh.write(cbind_output_template)
+        write_if_changed(cbind_target_path, cbind_output_template)
 
     def __generate_c_bindings_makefile(self):
         self.__logger.info(
@@ -792,8 +1193,7 @@ class OpEnOptimizerBuilder:
             = cbind_makefile_template.render(meta=self.__meta,
                                              build_config=self.__build_config)
         cbind_makefile_target_path = os.path.join(target_dir, "CMakeLists.txt")
-        with open(cbind_makefile_target_path, "w") as fh:
-            fh.write(cbind_makefile_output_template)
+        write_if_changed(cbind_makefile_target_path, cbind_makefile_output_template)
 
     def __info(self):
         info = {
@@ -851,12 +1251,21 @@ class OpEnOptimizerBuilder:
         self.__initialize()                      # initialize default value (if not provided)
         self.__check_user_provided_parameters()  # check the provided parameters
         self.__prepare_target_project()          # create folders; init cargo project
-        self.__copy_icasadi_to_target()          # copy icasadi/ files to target dir
+
+        # with the build cache, unchanged steps are skipped
+        build_cache = self.__load_build_cache()
+        casadi_fingerprint = self.__casadi_fingerprint()
+        casadi_up_to_date = build_cache.get('casadi') == casadi_fingerprint
+        if casadi_up_to_date:
+            self.__logger.info("CasADi code is up to date (build cache)")
+        else:
+            self.__copy_icasadi_to_target()      # copy icasadi/ files to target dir
         self.__generate_icasadi_cargo_toml()     # generate icasadi's Cargo.toml file
         self.__generate_cargo_toml()             # generate Cargo.toml using template
         self.__generate_icasadi_lib()            # generate icasadi lib.rs
         # generate all necessary CasADi C files:
-        self.__generate_casadi_code()
+        if not casadi_up_to_date:
+            self.__generate_casadi_code()
         #                                        #   - auto_casadi_cost.c
         #                                        #   - auto_casadi_grad.c
         #                                        #   - auto_casadi_mapping_f1.c
@@ -867,18 +1276,41 @@ class OpEnOptimizerBuilder:
         self.__generate_main_project_code()
         self.__generate_build_rs()               # generate build.rs file
         self.__generate_yaml_data_file()         # create YAML file with metadata
-        self.__casadi_make_static()              # make casadi functions static
-
-        if not self.__generate_not_build:
+        if not casadi_up_to_date:
+            self.__casadi_make_static()          # make casadi functions static
+        # until the build succeeds, only the CasADi code is known to be up to date
+        self.__save_build_cache({'casadi': casadi_fingerprint})
+
+        build_fingerprint = self.__build_fingerprint(casadi_fingerprint)
+        build_up_to_date = not self.__generate_not_build \
+            and build_cache.get('build') == build_fingerprint \
+            and self.__artifacts_up_to_date(build_fingerprint)
+        if build_up_to_date:
+            self.__logger.info("Compiled optimizer is up to date (build cache)")
+        do_build = not self.__generate_not_build and not build_up_to_date
+
+        if do_build:
             self.__logger.info("Building optimizer")
             self.__build_optimizer()             # build overall project
 
         if self.__build_config.tcp_interface_config is not None:
             self.__logger.info("Generating TCP/IP server")
             self.__generate_code_tcp_interface()
-            if not self.__generate_not_build:
+            if do_build:
                 self.__build_tcp_iface()
 
+        if self.__build_config.shm_interface_config is not None:
+            self.__logger.info("Generating shared-memory server")
+            self.__generate_code_shm_interface()
+            if do_build:
+                self.__build_shm_iface()
+
+        if self.__build_config.benchmark_config is not None:
+            self.__logger.info("Generating latency benchmark")
+            self.__generate_code_benchmark()
+            if do_build:
+                self.__build_benchmark()
+
         if self.__build_config.build_c_bindings:
             self.__logger.info("Generating C/C++ bindings")
             self.__generate_c_bindings_example()
@@ -887,9 +1319,14 @@ class OpEnOptimizerBuilder:
         if self.__build_config.build_python_bindings:
             self.__logger.info("Generating Python bindings")
             self.__generate_code_python_bindings()
-            if not self.__generate_not_build:
+            if do_build:
                 self.__build_python_bindings()
 
+        if do_build:
+            self.__save_build_stamps(build_fingerprint)
+        if do_build or build_up_to_date:
+            self.__save_build_cache({'casadi': casadi_fingerprint, 'build': build_fingerprint})
+
         if self.__build_config.ros_config is not None:
             ros_builder = RosBuilder(
                 self.__meta,
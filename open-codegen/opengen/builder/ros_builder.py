@@ -114,10 +114,11 @@ class RosBuilder:
             os.path.abspath(
                 os.path.join(
                     target_ros_dir, 'extern_lib', lib_file_name))
+        cargo_target_dir = self.__build_config.shared_target_dir \
+            or os.path.join(self.__target_dir(), 'target')
         original_lib_file = os.path.abspath(
             os.path.join(
-                self.__target_dir(),
-                'target',
+                cargo_target_dir,
                 self.__build_config.build_mode,
                 lib_file_name))
         shutil.copyfile(original_lib_file, target_lib_file_name)
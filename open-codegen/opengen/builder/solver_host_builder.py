@@ -0,0 +1,216 @@
+import opengen.config as og_cfg
+import opengen.definitions as og_dfn
+
+import os
+import subprocess
+import logging
+import jinja2
+import yaml
+import pkg_resources
+
+_SOLVER_HOST_PREFIX = 'solver_host_'
+
+
+def make_dir_if_not_exists(directory):
+    if not os.path.exists(directory):
+        os.makedirs(directory)
+
+
+def get_host_template(name):
+    file_loader = jinja2.FileSystemLoader(og_dfn.templates_subdir('host'))
+    env = jinja2.Environment(loader=file_loader, autoescape=True)
+    return env.get_template(name)
+
+
+class HostedSolverConfiguration:
+    """
+    Optimizer which is hosted by a solver host (see `SolverHostBuilder`)
+
+    For internal use
+    """
+
+    def __init__(self, name, path, priority, num_instances):
+        self.name = name
+        self.path = path
+        self.priority = priority
+        self.num_instances = num_instances
+
+    def to_dict(self):
+        return {
+            "name": self.name,
+            "path": self.path,
+            "priority": self.priority,
+            "num_instances": self.num_instances
+        }
+
+
+class SolverHostBuilder:
+    """
+    Code generation for a solver host
+
+    A solver host is a TCP server which hosts several optimizers, which have
+    been generated (with :class:`~opengen.builder.optimizer_builder.OpEnOptimizerBuilder`)
+    beforehand, and solves all of them on one shared pool of worker threads.
+    Every request names the optimizer which should serve it; when several
+    requests wait for a worker, the request of the optimizer with the highest
+    priority is served first.
+    """
+
+    def __init__(self, host_name, build_configuration=og_cfg.BuildConfiguration()):
+        """Constructor of SolverHostBuilder
+
+        :param host_name: name of the host; the host is generated in
+            `{build_dir}/{host_name}`
+        :param build_configuration: instance of :class:`~opengen.config.build_config.BuildConfiguration`;
+            the build directory, the build mode, the version of OpEn, the shared
+            target directory and the TCP server configuration (IP, port and
+            number of workers) are used
+
+        :raises ValueError: if `host_name` is not a valid name
+
+        :return: New instance of :class:`~opengen.builder.solver_host_builder.SolverHostBuilder`.
+        """
+        if not host_name.isidentifier():
+            raise ValueError("invalid host name (it must be a valid identifier)")
+        self.__host_name = host_name
+        self.__build_config = build_configuration
+        self.__solvers = []
+        self.__generate_not_build = False
+        self.__logger = logging.getLogger('opengen.builder.SolverHostBuilder')
+        stream_handler = logging.StreamHandler()
+        stream_handler.setLevel(1)
+        c_format = logging.Formatter('[%(levelname)s] <<HOST>> %(message)s')
+        stream_handler.setFormatter(c_format)
+        self.__logger.setLevel(1)
+        self.__logger.handlers.clear()
+        self.__logger.addHandler(stream_handler)
+
+    def with_solver(self, optimizer_path, priority=0, num_instances=1):
+        """Adds an optimizer to the host
+
+        :param optimizer_path: path of a generated optimizer (the folder which
+            contains `optimizer.yml`); the optimizer is served under its name
+        :param priority: priority of the optimizer; requests of optimizers
+            with a higher priority are served first (default: 0)
+        :param num_instances: number of instances of the optimizer, that is,
+            the maximum number of its requests which are solved concurrently
+            (default: 1); this prevents, e.g., the background solves of a
+            planner from occupying all workers
+
+        :raises ValueError: if the optimizer does not exist, if it has already
+            been added, or if `priority` or `num_instances` is invalid
+
+        :returns: Current builder object
+        """
+        if not isinstance(priority, int) or priority < 0:
+            raise ValueError("the priority must be a nonnegative integer")
+        if not isinstance(num_instances, int) or num_instances < 1:
+            raise ValueError("the number of instances must be a positive integer")
+        optimizer_path = os.path.abspath(optimizer_path)
+        yaml_file = os.path.join(optimizer_path, "optimizer.yml")
+        if not os.path.isfile(yaml_file):
+            raise ValueError("there is no optimizer at %s" % optimizer_path)
+        with open(yaml_file, 'r') as stream:
+            optimizer_details = yaml.safe_load(stream)
+        name = optimizer_details['meta']['optimizer_name']
+        if any(solver.name == name for solver in self.__solvers):
+            raise ValueError("optimizer %s has already been added" % name)
+        self.__solvers.append(HostedSolverConfiguration(name, optimizer_path, priority, num_instances))
+        return self
+
+    def with_generate_not_build_flag(self, flag):
+        """Whether to build (or just generate code)
+
+        :param flag: generate and not build
+
+        :returns: Current builder object
+        """
+        self.__generate_not_build = flag
+        return self
+
+    @property
+    def solvers(self):
+        """Optimizers of the host, as a list of dictionaries (name, path,
+        priority, number of instances)
+
+        :return: optimizers of the host
+        """
+        return [solver.to_dict() for solver in self.__solvers]
+
+    def __target_dir(self):
+        return os.path.abspath(
+            os.path.join(self.__build_config.build_dir, self.__host_name))
+
+    def __host_crate_dir(self):
+        return os.path.join(self.__target_dir(), _SOLVER_HOST_PREFIX + self.__host_name)
+
+    def __tcp_config(self):
+        return self.__build_config.tcp_interface_config or og_cfg.TcpServerConfiguration()
+
+    def __generate_host_code(self):
+        self.__logger.info("Generating code for solver host %s", self.__host_name)
+        crate_dir = self.__host_crate_dir()
+        make_dir_if_not_exists(os.path.join(crate_dir, "src"))
+
+        template = get_host_template('solver_host.rs')
+        output_template = template.render(host_name=self.__host_name,
+                                          solvers=self.__solvers,
+                                          tcp_server_config=self.__tcp_config())
+        with open(os.path.join(crate_dir, "src", "main.rs"), "w") as fh:
+            fh.write(output_template)
+
+        template = get_host_template('solver_host_cargo.toml')
+        output_template = template.render(host_name=self.__host_name,
+                                          solvers=self.__solvers,
+                                          build_config=self.__build_config)
+        with open(os.path.join(crate_dir, "Cargo.toml"), "w") as fh:
+            fh.write(output_template)
+
+    def __generate_yaml_data_file(self):
+        # same structure as in `optimizer.yml`, so that the host can be used
+        # with `OptimizerTcpManager`
+        build_config = self.__build_config
+        tcp_config = self.__tcp_config()
+        details = {'meta': {'optimizer_name': self.__host_name},
+                   'tcp': {'ip': tcp_config.bind_ip,
+                           'port': tcp_config.bind_port,
+                           'crate_dir': _SOLVER_HOST_PREFIX + self.__host_name},
+                   'build': {'open_version': build_config.open_version,
+                             'opengen_version': pkg_resources.require("opengen")[0].version,
+                             'build_dir': build_config.build_dir,
+                             'build_mode': build_config.build_mode,
+                             'shared_target_dir': build_config.shared_target_dir},
+                   'host': {'solvers': self.solvers},
+                   "_comment": "auto-generated file; do not modify"}
+        with open(os.path.join(self.__target_dir(), "optimizer.yml"), 'w') as outfile:
+            yaml.dump(details, outfile, Dumper=yaml.Dumper)
+
+    def __build_host(self):
+        self.__logger.info("Building the solver host")
+        command = ['cargo', 'build', '-q']
+        if self.__build_config.build_mode.lower() == 'release':
+            command.append('--release')
+        env = dict(os.environ)
+        if self.__build_config.shared_target_dir is not None:
+            env['CARGO_TARGET_DIR'] = self.__build_config.shared_target_dir
+        p = subprocess.Popen(command, cwd=self.__host_crate_dir(), env=env)
+        process_completion = p.wait()
+        if process_completion != 0:
+            raise Exception('Rust build of solver host failed')
+
+    def build(self):
+        """Generate code and build the solver host
+
+        :raises ValueError: if no optimizers have been added
+        :raises Exception: if the build process fails
+
+        :returns: path of the host (to be used with `OptimizerTcpManager`)
+        """
+        if not self.__solvers:
+            raise ValueError("no optimizers have been added to the host")
+        make_dir_if_not_exists(self.__target_dir())
+        self.__generate_host_code()
+        self.__generate_yaml_data_file()
+        if not self.__generate_not_build:
+            self.__build_host()
+        return self.__target_dir()
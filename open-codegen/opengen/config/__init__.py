@@ -2,4 +2,6 @@ from .meta import *
 from .solver_config import *
 from .build_config import *
 from .tcp_server_config import *
+from .shm_server_config import *
 from .ros_config import *
+from .benchmark_config import *
@@ -0,0 +1,148 @@
+import math
+import os
+
+
+class BenchmarkConfiguration:
+    """Configuration of the latency benchmark of the generated optimizer"""
+
+    def __init__(self, num_runs=1000, seed=1):
+        """Configuration of the latency benchmark
+
+        The generated benchmark, `benchmark_{optimizer_name}`, solves the
+        problem `num_runs` times for parameters that are drawn uniformly at
+        random from the parameter ranges (see `with_parameter_ranges`) or
+        replayed from a recorded parameter trajectory (see `with_trajectory`),
+        with and without warm start (see `with_warm_start_modes`), and reports
+        percentiles of the solve time, the distribution of the number of inner
+        and outer iterations and the exit statuses of the solver
+
+        :param num_runs: number of solver runs per warm-start mode; the
+            default is 1000
+
+        :param seed: seed of the generator of the random parameters; the
+            default is 1
+
+        :raises ValueError: if `num_runs` is not a positive integer, or if
+            `seed` is not a nonnegative integer
+
+        :returns: new instance of BenchmarkConfiguration, which can then be
+            provided to an instance of `BuildConfiguration` via `with_benchmark`
+        """
+        if not isinstance(num_runs, int) or num_runs < 1:
+            raise ValueError("the number of runs must be a positive integer")
+        if not isinstance(seed, int) or seed < 0 or seed >= 2**64:
+            raise ValueError("the seed must be a nonnegative 64-bit integer")
+        self.__num_runs = num_runs
+        self.__seed = seed
+        self.__parameter_lower = None
+        self.__parameter_upper = None
+        self.__trajectory_file = None
+        self.__warm_start_modes = ["cold", "warm"]
+
+    # ---------- GETTERS ---------------------------------------------
+
+    @property
+    def num_runs(self):
+        """Number of solver runs per warm-start mode, as int"""
+        return self.__num_runs
+
+    @property
+    def seed(self):
+        """Seed of the generator of the random parameters, as int"""
+        return self.__seed
+
+    @property
+    def parameter_lower(self):
+        """Lower bounds of the parameter ranges (list of float or None)"""
+        return self.__parameter_lower
+
+    @property
+    def parameter_upper(self):
+        """Upper bounds of the parameter ranges (list of float or None)"""
+        return self.__parameter_upper
+
+    @property
+    def trajectory_file(self):
+        """Absolute path of the file with the parameter trajectory (or None)"""
+        return self.__trajectory_file
+
+    @property
+    def warm_start_modes(self):
+        """Warm-start modes to benchmark (list of "cold" and/or "warm")"""
+        return self.__warm_start_modes
+
+    # ---------- SETTERS ---------------------------------------------
+
+    def with_parameter_ranges(self, lower, upper):
+        """Ranges of the random parameters
+
+        Every run uses a parameter that is drawn uniformly at random from the
+        box `[lower, upper]`; use `lower[i] == upper[i]` for fixed parameters.
+
+        :param lower: lower bounds of the parameters (list of float)
+        :param upper: upper bounds of the parameters (list of float)
+
+        :raises ValueError: if `lower` and `upper` have different lengths,
+            are not finite, or if `lower[i] > upper[i]` for some `i`
+
+        :return: current instance of BenchmarkConfiguration
+        """
+        lower = [float(x) for x in lower]
+        upper = [float(x) for x in upper]
+        if len(lower) != len(upper):
+            raise ValueError("lower and upper must have the same length")
+        if not all(math.isfinite(x) for x in lower + upper):
+            raise ValueError("the parameter ranges must be finite")
+        if any(lo > hi for lo, hi in zip(lower, upper)):
+            raise ValueError("lower must be less than or equal to upper")
+        self.__parameter_lower = lower
+        self.__parameter_upper = upper
+        return self
+
+    def with_trajectory(self, trajectory_file):
+        """Replay a recorded parameter trajectory
+
+        The file contains one parameter vector per line, whose elements are
+        separated by commas or whitespace; empty lines and lines starting
+        with `#` are ignored. The trajectory is replayed cyclically, so that
+        the warm-started runs reproduce the warm starts of the application.
+        The trajectory takes precedence over the parameter ranges; the file
+        is read when the benchmark runs, and it can also be given on the
+        command line (`--trajectory`).
+
+        :param trajectory_file: path of the trajectory file (relative to the
+            current working directory)
+
+        :return: current instance of BenchmarkConfiguration
+        """
+        self.__trajectory_file = os.path.abspath(trajectory_file)
+        return self
+
+    def with_warm_start_modes(self, warm_start_modes):
+        """Warm-start modes to benchmark
+
+        In mode "cold" every run starts from zero, with a freshly initialised
+        solver; in mode "warm" every run starts from the solution, the Lagrange
+        multipliers and the penalty parameter of the previous run.
+
+        :param warm_start_modes: list of modes ("cold" and/or "warm")
+
+        :raises ValueError: if the list is empty or contains an unknown mode
+
+        :return: current instance of BenchmarkConfiguration
+        """
+        warm_start_modes = list(warm_start_modes)
+        if not warm_start_modes or any(m not in ("cold", "warm") for m in warm_start_modes):
+            raise ValueError("the warm-start modes must be a nonempty list of 'cold' and/or 'warm'")
+        self.__warm_start_modes = list(dict.fromkeys(warm_start_modes))
+        return self
+
+    def to_dict(self):
+        return {
+            "num_runs": self.__num_runs,
+            "seed": self.__seed,
+            "parameter_lower": self.__parameter_lower,
+            "parameter_upper": self.__parameter_upper,
+            "trajectory_file": self.__trajectory_file,
+            "warm_start_modes": self.__warm_start_modes,
+        }
@@ -1,7 +1,10 @@
 from opengen.config.tcp_server_config import TcpServerConfiguration
+from opengen.config.shm_server_config import ShmServerConfiguration
 from opengen.config.ros_config import RosConfiguration
+from opengen.config.benchmark_config import BenchmarkConfiguration
 import random
 import string
+import os
 from enum import Enum
 
 
@@ -58,8 +61,16 @@ class BuildConfiguration:
         self.__build_python_bindings = False
         self.__ros_config = None
         self.__tcp_interface_config = None
+        self.__shm_interface_config = None
+        self.__benchmark_config = None
         self.__local_path = None
         self.__allocator = RustAllocator.DefaultAllocator
+        self.__instrumentation = False
+        self.__instrumentation_timing = False
+        self.__static_memory = False
+        self.__static_memory_bytes = None
+        self.__build_cache = False
+        self.__shared_target_dir = None
 
     # ---------- GETTERS ---------------------------------------------
 
@@ -127,6 +138,20 @@ class BuildConfiguration:
         """
         return self.__tcp_interface_config
 
+    @property
+    def shm_interface_config(self) -> ShmServerConfiguration:
+        """
+        Configuration of the shared-memory interface (None: no shared-memory interface)
+        """
+        return self.__shm_interface_config
+
+    @property
+    def benchmark_config(self) -> BenchmarkConfiguration:
+        """
+        Configuration of the latency benchmark (None: no benchmark)
+        """
+        return self.__benchmark_config
+
     @property
     def ros_config(self) -> RosConfiguration:
         """ROS package configuration
@@ -142,6 +167,68 @@ class BuildConfiguration:
         """
         return self.__allocator
 
+    @property
+    def instrumentation(self):
+        """
+        Whether the solver counts the executions of its phases
+        """
+        return self.__instrumentation
+
+    @property
+    def instrumentation_timing(self):
+        """
+        Whether the solver measures the time spent in each of its phases
+        """
+        return self.__instrumentation_timing
+
+    @property
+    def static_memory(self):
+        """
+        Whether the generated solver allocates its memory from a static arena
+        """
+        return self.__static_memory
+
+    @property
+    def static_memory_bytes(self):
+        """
+        Size of the static memory arena in bytes (if `None`, it is estimated
+        from the problem dimensions)
+        """
+        return self.__static_memory_bytes
+
+    @property
+    def build_cache(self):
+        """
+        Whether code generation and compilation are skipped for unchanged
+        artifacts
+        """
+        return self.__build_cache
+
+    @property
+    def shared_target_dir(self):
+        """
+        Cargo target directory which is shared by different optimizers
+        (absolute path), or `None`
+        """
+        return self.__shared_target_dir
+
+    @property
+    def open_features(self):
+        """
+        Features of `optimization_engine` which are activated in the
+        generated solver (depending on the allocator and the instrumentation)
+        """
+        features = []
+        if self.__allocator == RustAllocator.JemAlloc:
+            features += ["jem"]
+        elif self.__allocator == RustAllocator.RpAlloc:
+            features += ["rp"]
+        if self.__instrumentation_timing:
+            features += ["instrumentation-timing"]
+        elif self.__instrumentation:
+            features += ["instrumentation"]
+        return features
+
     # ---------- SETTERS ---------------------------------------------
 
     def with_rebuild(self, do_rebuild):
@@ -270,6 +357,32 @@ class BuildConfiguration:
         self.__tcp_interface_config = tcp_interface_config
         return self
 
+    def with_shm_interface_config(self, shm_interface_config=ShmServerConfiguration()):
+        """
+        Activates the generation of a shared-memory server,
+        `shm_iface_{optimizer_name}`, and of its C client,
+        `shm_iface_{optimizer_name}/{optimizer_name}_shm_client.h`, for clients
+        which run on the same host (Linux or macOS)
+
+        :param shm_interface_config: configuration of the shared-memory server
+
+        :return: current instance of BuildConfiguration
+        """
+        self.__shm_interface_config = shm_interface_config
+        return self
+
+    def with_benchmark(self, benchmark_config=BenchmarkConfiguration()):
+        """
+        Activates the generation of a latency benchmark binary,
+        `benchmark_{optimizer_name}`, in the target directory
+
+        :param benchmark_config: configuration of the benchmark
+
+        :return: current instance of BuildConfiguration
+        """
+        self.__benchmark_config = benchmark_config
+        return self
+
     def with_allocator(self, allocator: RustAllocator):
         """Specify a Rust memory allocator. 
 
@@ -286,6 +399,92 @@ class BuildConfiguration:
         self.__allocator = allocator
         return self
 
+    def with_instrumentation(self, instrumentation=True, timing=False):
+        """Instrument the phases of the solver
+
+        If activated, the solver counts how many times each phase of the
+        algorithm (cost and gradient evaluations, projections, L-BFGS updates,
+        line search iterations, etc) is executed, and, if `timing` is `True`,
+        it measures the time spent in each phase. These statistics are returned
+        together with the solver status. Without instrumentation the solver
+        does not record anything.
+
+        :param instrumentation: whether to count the executions of the phases
+        :param timing: whether to measure the time spent in each phase (this
+           implies `instrumentation`)
+
+        :return: current instance of BuildConfiguration
+        """
+        self.__instrumentation = instrumentation or timing
+        self.__instrumentation_timing = timing
+        return self
+
+    def with_static_memory(self, static_memory=True, size_bytes=None):
+        """Allocate the memory of the solver from a static arena
+
+        If activated, the generated solver uses a bump allocator over a
+        statically allocated buffer (`optimization_engine::static_memory::StaticArena`)
+        as its global memory allocator, so it does not need a heap. The solver
+        allocates all its memory when it is initialised, so the size of the
+        buffer can be estimated from the problem dimensions; if you create
+        several solver caches (e.g., a `SolverPool`), you should specify the
+        size explicitly.
+
+        This option cannot be combined with a TCP interface, ROS packages,
+        Python bindings or a custom allocator.
+
+        :param static_memory: whether to use a static memory arena
+        :param size_bytes: size of the arena in bytes (optional); if not
+           provided, it is estimated from the problem dimensions
+
+        :raises ValueError: if `size_bytes` is not a positive integer
+
+        :return: current instance of BuildConfiguration
+        """
+        if size_bytes is not None and (not isinstance(size_bytes, int) or size_bytes <= 0):
+            raise ValueError("size_bytes must be a positive integer")
+        self.__static_memory = static_memory
+        self.__static_memory_bytes = size_bytes
+        return self
+
+    def with_build_cache(self, build_cache=True):
+        """Skip the steps of the build whose inputs have not changed
+
+        If activated, the builder stores content hashes of the problem (cost,
+        constraints and mappings), the configurations and the templates in the
+        target directory. When the optimizer is built again, the CasADi code
+        is regenerated only if the problem or the relevant solver options have
+        changed, generated files are rewritten only if their content changes
+        (so that cargo does not recompile unchanged crates), and the cargo
+        builds are skipped altogether if nothing (including the sources of a
+        local version of OpEn) has changed and the artifacts of the previous
+        build still exist and have not been overwritten by another variant
+        with the same name in a shared target directory.
+
+        :param build_cache: whether to use the build cache
+
+        :return: current instance of BuildConfiguration
+        """
+        self.__build_cache = build_cache
+        return self
+
+    def with_shared_target_dir(self, target_dir):
+        """Cargo target directory which is shared by different optimizers
+
+        When many variants of an optimizer are built (e.g., in parameter
+        sweeps), a shared target directory allows them to reuse the compiled
+        dependencies (e.g., `optimization_engine`). The variants must have
+        different names. The Python bindings use the subdirectory `python`.
+
+        :param target_dir: path of the target directory (relative to the
+            current working directory), or `None` for a target directory in
+            each generated project
+
+        :return: current instance of BuildConfiguration
+        """
+        self.__shared_target_dir = None if target_dir is None else os.path.abspath(target_dir)
+        return self
+
     def to_dict(self):
         build_dict = {
             "target_system": self.__target_system,
@@ -295,9 +494,19 @@ class BuildConfiguration:
             "open_version": self.__open_version,
             "build_c_bindings": self.__build_c_bindings,
             "build_python_bindings": self.__build_python_bindings,
+            "instrumentation": self.__instrumentation,
+            "instrumentation_timing": self.__instrumentation_timing,
+            "static_memory": self.__static_memory,
+            "static_memory_bytes": self.__static_memory_bytes,
+            "build_cache": self.__build_cache,
+            "shared_target_dir": self.__shared_target_dir,
         }
         if self.__tcp_interface_config is not None:
             build_dict["tcp_interface_config"] = self.__tcp_interface_config.to_dict()
+        if self.__shm_interface_config is not None:
+            build_dict["shm_interface_config"] = self.__shm_interface_config.to_dict()
+        if self.__benchmark_config is not None:
+            build_dict["benchmark_config"] = self.__benchmark_config.to_dict()
         if self.__ros_config is not None:
             build_dict["ros_config"] = self.__ros_config.to_dict()
         return build_dict
@@ -41,6 +41,7 @@ class OptimizerMeta:
         self.__optimizer_author_list = optimizer_authors
         self.__cost_function_name = None
         self.__grad_cost_function_name = None
+        self.__cost_and_grad_function_name = None
         self.__constraint_penalty_function = None
         self.__alm_constraints_mapping_f1 = None
         self.__preconditioning_file_name = None
@@ -54,6 +55,7 @@ class OptimizerMeta:
         optimizer_name = self.__optimizer_name
         self.__cost_function_name = 'open_phi_' + optimizer_name
         self.__grad_cost_function_name = 'open_grad_phi_' + optimizer_name
+        self.__cost_and_grad_function_name = 'open_phi_and_grad_' + optimizer_name
         self.__constraint_penalty_function = 'open_mapping_f2_' + optimizer_name
         self.__alm_constraints_mapping_f1 = 'open_mapping_f1_' + optimizer_name
         self.__preconditioning_file_name = 'open_preconditioning_' + optimizer_name
@@ -72,6 +74,10 @@ class OptimizerMeta:
     def grad_function_name(self):
         return self.__grad_cost_function_name
 
+    @property
+    def cost_and_grad_function_name(self):
+        return self.__cost_and_grad_function_name
+
     @property
     def constraint_penalty_function_name(self):
         return self.__constraint_penalty_function
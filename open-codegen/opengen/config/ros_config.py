@@ -18,6 +18,8 @@ class RosConfiguration:
         self.__params_topic_queue_size = 100
         self.__publisher_subtopic = "result"
         self.__subscriber_subtopic = "parameters"
+        self.__solve_on_request = False
+        self.__warm_start = True
 
     @property
     def package_name(self):
@@ -84,6 +86,22 @@ class RosConfiguration:
         """
         return self.__params_topic_queue_size
 
+    @property
+    def solve_on_request(self):
+        """Whether the node solves the problem only when new parameters are received
+
+        :return: solve-on-request flag, defaults to `False`
+        """
+        return self.__solve_on_request
+
+    @property
+    def warm_start(self):
+        """Whether the node warm-starts the solver with its previous solution
+
+        :return: warm-start flag, defaults to `True`
+        """
+        return self.__warm_start
+
     def with_package_name(self, pkg_name):
         """
         Set the package name, which is the same as the name
@@ -133,6 +151,38 @@ class RosConfiguration:
         self.__rate = rate
         return self
 
+    def with_solve_on_request(self, solve_on_request=True):
+        """
+        Specify whether the ROS node should solve the problem only when a
+        new message is posted on the parameters topic (event-driven mode),
+        instead of re-solving at a fixed rate. In event-driven mode, the
+        rate is not used. This can be configured after the package is
+        generated, in `config/open_params.yaml`.
+
+        :param solve_on_request: whether to solve only on request, defaults to `True`
+        :type solve_on_request: bool
+
+        :return: current object
+        """
+        self.__solve_on_request = solve_on_request
+        return self
+
+    def with_warm_start(self, warm_start=True):
+        """
+        Specify whether the ROS node should use the previous solution and
+        vector of Lagrange multipliers as initial guesses for the next
+        solve (unless an initial guess is provided in the request). This
+        can be configured after the package is generated, in
+        `config/open_params.yaml`.
+
+        :param warm_start: whether to warm-start the solver, defaults to `True`
+        :type warm_start: bool
+
+        :return: current object
+        """
+        self.__warm_start = warm_start
+        return self
+
     def with_description(self, description):
         """
         Set the description of the ROS package
@@ -203,5 +253,7 @@ class RosConfiguration:
             "result_topic_queue_size": self.__result_topic_queue_size,
             "params_topic_queue_size": self.__params_topic_queue_size,
             "publisher_subtopic": self.__publisher_subtopic,
-            "subscriber_subtopic": self.__subscriber_subtopic
+            "subscriber_subtopic": self.__subscriber_subtopic,
+            "solve_on_request": self.__solve_on_request,
+            "warm_start": self.__warm_start
         }
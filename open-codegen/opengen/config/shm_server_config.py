@@ -0,0 +1,77 @@
+import os
+
+
+class ShmServerConfiguration:
+    """Shared-memory server configuration"""
+
+    def __init__(self, path=None, spin_iterations=10000, idle_sleep_micros=50):
+        """Configuration of the shared-memory server
+
+        The shared-memory server, `shm_iface_{optimizer_name}`, serves a
+        single client on the same host through a memory-mapped file, which
+        holds the parameter, the decision variables, the Lagrange multipliers
+        and the status of the solver; there is no serialisation and no system
+        call per request
+
+        :param path: path of the shared-memory file; the default is
+            `/dev/shm/open_{optimizer_name}`
+
+        :param spin_iterations: number of times that the server and the
+            clients poll the shared memory (busy-waiting) before they start
+            sleeping between polls; a larger value reduces the latency, but
+            keeps a core busy for longer. The default is 10000.
+
+        :param idle_sleep_micros: time (in microseconds) for which the server
+            and the clients sleep between polls once they have stopped
+            busy-waiting, so that an idle server does not keep a core busy.
+            A request which arrives while the server sleeps is served up to
+            `idle_sleep_micros` later (plus the timer slack of the OS, which
+            is about 50 microseconds on Linux). With 0, they yield the CPU
+            instead of sleeping, which keeps the latency low, but also keeps
+            a core busy for as long as the server runs. The default is 50.
+
+        :raises ValueError: if `spin_iterations` or `idle_sleep_micros` is not
+            a nonnegative integer
+
+        :returns: new instance of ShmServerConfiguration, which can then be
+            provided to an instance of `BuildConfiguration` via
+            `with_shm_interface_config`
+        """
+        if not isinstance(spin_iterations, int) or spin_iterations < 0:
+            raise ValueError("the number of spin iterations must be a nonnegative integer")
+        if not isinstance(idle_sleep_micros, int) or idle_sleep_micros < 0:
+            raise ValueError("the idle sleep time must be a nonnegative integer")
+        self.__path = None if path is None else os.path.abspath(path)
+        self.__spin_iterations = spin_iterations
+        self.__idle_sleep_micros = idle_sleep_micros
+
+    @property
+    def path(self):
+        """Path of the shared-memory file (None: default path)
+
+        :return: path of the file
+        """
+        return self.__path
+
+    @property
+    def spin_iterations(self):
+        """Number of polls before sleeping between polls, as int
+
+        :return: number of spin iterations
+        """
+        return self.__spin_iterations
+
+    @property
+    def idle_sleep_micros(self):
+        """Time between polls (in microseconds) after the busy-waiting, as int
+
+        :return: idle sleep time
+        """
+        return self.__idle_sleep_micros
+
+    def to_dict(self):
+        return {
+            "path": self.__path,
+            "spin_iterations": self.__spin_iterations,
+            "idle_sleep_micros": self.__idle_sleep_micros
+        }
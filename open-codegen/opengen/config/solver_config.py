@@ -27,6 +27,15 @@ class SolverConfiguration:
         self.__cbfgs_epsilon = None
         self.__cbfgs_sy_epsilon = None
         self.__do_preconditioning = False  # alpha version of preconditioning: optional
+        self.__preconditioning_reuse_threshold = None
+        self.__preconditioning_reuse_max_solves = 1
+        self.__stage_dim = None
+        self.__horizon = None
+        self.__single_precision = False
+        self.__fused_cost_and_gradient = False
+        self.__lbfgs_warm_start = "cold"
+        self.__anderson_memory = None
+        self.__trace_capacity = None
 
     # --------- GETTERS -----------------------------
 
@@ -110,6 +119,87 @@ class SolverConfiguration:
         """
         return self.__do_preconditioning
 
+    @property
+    def preconditioning_reuse_threshold(self):
+        """Relative change of the parameter up to which the preconditioning
+        weights of a previous solve are reused
+
+        :return: threshold, or None if the weights are recomputed at every solve
+        """
+        return self.__preconditioning_reuse_threshold
+
+    @property
+    def preconditioning_reuse_max_solves(self):
+        """Maximum number of solves for which the preconditioning weights are used
+
+        :return: number of solves
+        """
+        return self.__preconditioning_reuse_max_solves
+
+    @property
+    def stage_dim(self):
+        """Dimension of each stage of the decision variables (for horizon shifting)
+
+        :return: stage dimension or `None` if horizon shifting is not active
+        """
+        return self.__stage_dim
+
+    @property
+    def horizon(self):
+        """Number of stages of the decision variables (for horizon shifting)
+
+        :return: horizon length or `None` if horizon shifting is not active
+        """
+        return self.__horizon
+
+    @property
+    def horizon_shift(self):
+        """Whether a shifted warm start is generated
+
+        :return: True iff a stage dimension and a horizon have been provided
+        """
+        return self.__stage_dim is not None and self.__horizon is not None
+
+    @property
+    def single_precision(self):
+        """Whether the generated solver works in single precision (f32)
+
+        :return: True iff single precision is active
+        """
+        return self.__single_precision
+
+    @property
+    def fused_cost_and_gradient(self):
+        """Whether a function which computes the cost and its gradient together is generated
+
+        :return: True iff the fused function is generated
+        """
+        return self.__fused_cost_and_gradient
+
+    @property
+    def lbfgs_warm_start(self):
+        """Warm-start policy of the inner solver
+
+        :return: "cold", "outer_iterations" or "solves"
+        """
+        return self.__lbfgs_warm_start
+
+    @property
+    def anderson_memory(self):
+        """Memory of Anderson acceleration in the inner solver
+
+        :return: memory, or None if the inner solver uses L-BFGS directions
+        """
+        return self.__anderson_memory
+
+    @property
+    def trace_capacity(self):
+        """Capacity of the trace of the iterations of the solver
+
+        :return: maximum number of records, or None if no trace is recorded
+        """
+        return self.__trace_capacity
+
     # --------- SETTERS -----------------------------
 
     def with_sufficient_decrease_coefficient(self, sufficient_decrease_coefficient):
@@ -321,6 +411,166 @@ class SolverConfiguration:
         self.__do_preconditioning = do_preconditioning
         return self
 
+    def with_preconditioning_reuse(self, relative_threshold=0.05, max_solves=10):
+        """Reuse the preconditioning weights and the initial penalty across solves
+
+        By default, every solve recomputes the preconditioning weights and
+        the initial penalty (see `with_preconditioning`). When the parameter
+        changes only a little between consecutive solves (e.g., in MPC), the
+        weights of a previous solve can be reused: they are recomputed only
+        if the parameter, `p`, has moved away from the parameter at which they
+        were computed, `p_w`, by more than the relative threshold, that is,
+        if `||p - p_w||_inf > relative_threshold * max(||p_w||_inf, 1)`, or
+        if they have been used for `max_solves` solves. The weights are stored
+        in each instance of the solver.
+
+        This has no effect unless preconditioning is active.
+
+        :param relative_threshold: relative change of the parameter (or None
+            to recompute the weights at every solve); default: 0.05
+        :param max_solves: maximum number of solves that use the same weights;
+            default: 10
+
+        :raises: ValueError if the threshold is negative or `max_solves` is
+            not a positive integer
+
+        :returns: the current object
+        """
+        if relative_threshold is not None and relative_threshold < 0:
+            raise ValueError("The relative threshold must be nonnegative")
+        if not isinstance(max_solves, int) or max_solves < 1:
+            raise ValueError("The maximum number of solves must be a positive integer")
+        self.__preconditioning_reuse_threshold = \
+            None if relative_threshold is None else float(relative_threshold)
+        self.__preconditioning_reuse_max_solves = max_solves
+        return self
+
+    def with_horizon_shift(self, stage_dim, horizon):
+        """Activates the shifted warm start (e.g., for MPC)
+
+        If the decision variables consist of `horizon` stages of dimension
+        `stage_dim`, for instance, the inputs of an MPC problem over its
+        prediction horizon, the generated optimizer provides the method
+        `solve_shifted`. This method uses the previous solution, shifted by one
+        stage (the last stage is repeated), as initial guess, together with the
+        previous Lagrange multipliers and penalty parameter.
+
+        :param stage_dim: dimension of each stage
+        :param horizon: number of stages (the number of decision variables must
+            be equal to `stage_dim * horizon`)
+
+        :returns: the current object
+
+        :raises: Exception if `stage_dim` or `horizon` is not a positive integer
+        """
+        if int(stage_dim) != stage_dim or stage_dim <= 0:
+            raise Exception("stage dimension must be a positive integer")
+        if int(horizon) != horizon or horizon <= 0:
+            raise Exception("horizon must be a positive integer")
+        self.__stage_dim = int(stage_dim)
+        self.__horizon = int(horizon)
+        return self
+
+    def with_single_precision(self, single_precision=True):
+        """Generates a solver that works in single precision (f32)
+
+        The CasADi functions are compiled with `casadi_real=float` and the
+        solver works with single-precision numbers internally; the interface
+        of the generated optimizer (Rust, C, Python, TCP) still uses double
+        precision. This halves the memory traffic of the solver, but the
+        tolerances should not be too tight (typically, not below `1e-4`).
+
+        Affine spaces are not supported in single precision.
+
+        :param single_precision: whether to use single precision (default: `True`)
+
+        :returns: the current object
+        """
+        self.__single_precision = single_precision
+        return self
+
+    def with_fused_cost_and_gradient(self, fused=True):
+        """Generates a function which computes the cost and its gradient together
+
+        PANOC evaluates the cost and its gradient at the same point in every
+        iteration of its line search. With this option, CasADi generates one
+        function with both outputs, so the subexpressions they share (e.g., the
+        simulation of the system dynamics in MPC) are computed once.
+
+        :param fused: whether to generate the fused function (default: `True`)
+
+        :returns: the current object
+        """
+        self.__fused_cost_and_gradient = fused
+        return self
+
+    def with_lbfgs_warm_start(self, policy="outer_iterations"):
+        """Keeps the L-BFGS buffer and the Lipschitz constant of the inner solver
+
+        By default, every inner problem starts with an empty L-BFGS buffer and a new
+        estimate of the Lipschitz constant. With a warm start, the inner solver reuses
+        these from the previous inner problem, if that converged; outdated L-BFGS pairs
+        are discarded automatically.
+
+        :param policy: "cold" (no warm start), "outer_iterations" (warm start from one
+            outer iteration to the next) or "solves" (also from one call of the solver
+            to the next one); default: "outer_iterations"
+
+        :raises: ValueError if the policy is not one of the above
+
+        :returns: the current object
+        """
+        if policy not in ("cold", "outer_iterations", "solves"):
+            raise ValueError("policy must be 'cold', 'outer_iterations' or 'solves'")
+        self.__lbfgs_warm_start = policy
+        return self
+
+    def with_anderson_acceleration(self, memory=5):
+        """Use Anderson acceleration instead of L-BFGS in the inner solver
+
+        The inner solver (PANOC) then computes its directions by Anderson
+        acceleration of the forward-backward iterations, combining the last
+        `memory` iterates. This can be beneficial on strongly convex, but badly
+        scaled, problems, where L-BFGS directions are often rejected by the
+        line search.
+
+        :param memory: number of previous iterates that are combined (or None
+            to use L-BFGS directions); default: 5
+
+        :raises: ValueError if the memory is not a positive integer
+
+        :returns: the current object
+        """
+        if memory is not None and (not isinstance(memory, int) or memory < 1):
+            raise ValueError("The Anderson memory must be a positive integer")
+        self.__anderson_memory = memory
+        return self
+
+    def with_trace(self, capacity=1000):
+        """Record a trace of the iterations of every solve
+
+        The solver records, at every inner iteration, the step size (gamma),
+        the line-search parameter (tau), the norm of the fixed-point residual,
+        the cost, the number of line-search backtracks, the penalty parameter
+        and the infeasibility into a ring buffer of `capacity` records, which
+        is allocated when the solver is initialised (so, recording the trace
+        does not allocate memory). After a solve, the trace holds the last
+        `capacity` iterations of that solve; it is available in the Rust API
+        (`solver_cache.alm_cache().trace()`), the C bindings and the TCP
+        interface (`SolverStatus.trace`).
+
+        :param capacity: maximum number of records (or None for no trace);
+            default: 1000
+
+        :raises: ValueError if the capacity is not a positive integer
+
+        :returns: the current object
+        """
+        if capacity is not None and (not isinstance(capacity, int) or capacity < 1):
+            raise ValueError("The trace capacity must be a positive integer")
+        self.__trace_capacity = capacity
+        return self
+
     def to_dict(self):
         return {
             "tolerance": self.__tolerance,
@@ -337,5 +587,14 @@ class SolverConfiguration:
             "cbfgs_alpha": self.__cbfgs_alpha,
             "cbfgs_epsilon": self.__cbfgs_epsilon,
             "cbfgs_sy_epsilon": self.__cbfgs_sy_epsilon,
-            "do_preconditioning": self.__do_preconditioning
+            "do_preconditioning": self.__do_preconditioning,
+            "preconditioning_reuse_threshold": self.__preconditioning_reuse_threshold,
+            "preconditioning_reuse_max_solves": self.__preconditioning_reuse_max_solves,
+            "stage_dim": self.__stage_dim,
+            "horizon": self.__horizon,
+            "single_precision": self.__single_precision,
+            "fused_cost_and_gradient": self.__fused_cost_and_gradient,
+            "lbfgs_warm_start": self.__lbfgs_warm_start,
+            "anderson_memory": self.__anderson_memory,
+            "trace_capacity": self.__trace_capacity
         }
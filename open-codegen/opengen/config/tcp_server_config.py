@@ -1,7 +1,8 @@
 class TcpServerConfiguration:
     """TCP server configuration"""
 
-    def __init__(self, bind_ip='127.0.0.1', bind_port=8333):
+    def __init__(self, bind_ip='127.0.0.1', bind_port=8333, num_workers=1, max_queue_size=16,
+                 solution_cache_size=0):
         """Configuration of the TCP server
 
         :param bind_ip: IP address of generated TCP server. The default
@@ -14,11 +15,40 @@ class TcpServerConfiguration:
             used by other services and you should also avoid ephemeral ports
             (32768 to 65535 on Linux, 1025 to 5000 on Windows)
 
+        :param num_workers: Number of worker threads of the generated TCP server.
+            Every worker owns its own solver instance, so up to `num_workers`
+            requests are served in parallel. The default is 1.
+
+        :param max_queue_size: Maximum number of accepted connections that are
+            waiting for a worker. When the queue is full, the server stops
+            accepting new connections until a worker becomes available. The
+            default is 16.
+
+        :param solution_cache_size: Capacity of the cache of recent solutions,
+            which is shared by the workers. When a client does not provide a
+            warm start, the solver is warm started with the cached solution
+            (decision variables, Lagrange multipliers and penalty) of the
+            nearest parameter; converged solutions are added to the cache
+            and, when it is full, the least recently used one is evicted.
+            The default is 0 (no cache).
+
+        :raises Exception: if `num_workers` or `max_queue_size` is not a positive integer,
+            or if `solution_cache_size` is not a nonnegative integer
+
         :returns: new instance of TcpServerConfiguration, which can then be
             provided to an instance of `OpEnOptimizerBuilder` via `enable_tcp_interface`
         """
+        if not isinstance(num_workers, int) or num_workers < 1:
+            raise Exception("the number of workers must be a positive integer")
+        if not isinstance(max_queue_size, int) or max_queue_size < 1:
+            raise Exception("the maximum queue size must be a positive integer")
+        if not isinstance(solution_cache_size, int) or solution_cache_size < 0:
+            raise Exception("the solution cache size must be a nonnegative integer")
         self.__bind_ip = bind_ip
         self.__bind_port = bind_port
+        self.__num_workers = num_workers
+        self.__max_queue_size = max_queue_size
+        self.__solution_cache_size = solution_cache_size
 
     @property
     def bind_ip(self):
@@ -36,8 +66,35 @@ class TcpServerConfiguration:
         """
         return self.__bind_port
 
+    @property
+    def num_workers(self):
+        """Number of worker threads of the TCP server, as int
+
+        :return: number of workers
+        """
+        return self.__num_workers
+
+    @property
+    def max_queue_size(self):
+        """Maximum number of connections waiting for a worker, as int
+
+        :return: maximum queue size
+        """
+        return self.__max_queue_size
+
+    @property
+    def solution_cache_size(self):
+        """Capacity of the cache of recent solutions (0: no cache), as int
+
+        :return: solution cache size
+        """
+        return self.__solution_cache_size
+
     def to_dict(self):
         return {
             "ip": self.__bind_ip,
-            "port": self.__bind_port
+            "port": self.__bind_port,
+            "num_workers": self.__num_workers,
+            "max_queue_size": self.__max_queue_size,
+            "solution_cache_size": self.__solution_cache_size
         }
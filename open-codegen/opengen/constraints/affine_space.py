@@ -9,20 +9,43 @@ class AffineSpace(Constraint):
 
     A constraint of the form :math:`Ax = b`, where :math:`A` and :math:`b` are 
     a matrix and a vector of appropriate dimensions
+
+    Matrix :math:`A` can be either a dense matrix (e.g., a numpy array) or
+    a scipy sparse matrix; in the latter case, the generated solver uses a
+    sparse Cholesky factorisation of :math:`AA^\\intercal`, which is much faster
+    for large sparse (e.g., banded) matrices
     """
 
     def __init__(self, A, b):
         """Constructor for an affine space
 
+        :param A: matrix A (dense or scipy sparse matrix)
+        :param b: vector b
+
         :return: new instance of AffineSpace
         """
-        self.__A = A.flatten('C')
+        # scipy sparse matrices are detected without importing scipy
+        self.__is_sparse = hasattr(A, 'tocsr')
+        if self.__is_sparse:
+            a_csr = A.tocsr()
+            a_csr.sort_indices()
+            self.__A = None
+            self.__sparse_a = a_csr
+            self.__num_columns = a_csr.shape[1]
+            self.__csr_row_ptr = [int(i) for i in a_csr.indptr]
+            self.__csr_col_idx = [int(j) for j in a_csr.indices]
+            self.__csr_values = [float(a_ij) for a_ij in a_csr.data]
+        else:
+            self.__A = A.flatten('C')
+            self.__num_columns = A.shape[1] if len(np.shape(A)) == 2 else None
         self.__b = b
 
     @property
     def matrix_a(self):
-        """Matrix A
+        """Matrix A (row-wise data of the dense matrix)
         """
+        if self.__is_sparse:
+            return np.asarray(self.__sparse_a.todense()).flatten('C')
         return self.__A
 
     @property
@@ -31,6 +54,36 @@ class AffineSpace(Constraint):
         """
         return self.__b
 
+    @property
+    def is_sparse(self):
+        """Whether matrix A is sparse
+        """
+        return self.__is_sparse
+
+    @property
+    def num_columns(self):
+        """Number of columns of A
+        """
+        return self.__num_columns
+
+    @property
+    def csr_row_ptr(self):
+        """Row pointers of sparse matrix A (CSR format)
+        """
+        return self.__csr_row_ptr if self.__is_sparse else None
+
+    @property
+    def csr_col_idx(self):
+        """Column indices of the nonzeros of sparse matrix A (CSR format)
+        """
+        return self.__csr_col_idx if self.__is_sparse else None
+
+    @property
+    def csr_values(self):
+        """Nonzero values of sparse matrix A (CSR format)
+        """
+        return self.__csr_values if self.__is_sparse else None
+
     def distance_squared(self, u):
         """Squared distance to affine space
 
@@ -52,6 +52,29 @@ class CartesianProduct(constraint.Constraint):
 
         self.__segments = segments
         self.__constraints = constraints
+        self.__parallel_num_threads = None
+        self.__parallel_min_dimension = None
+
+    def with_parallel_projection(self, num_threads, min_dimension=100000):
+        """Compute the projection in parallel in the generated solver
+
+        The sets are split into groups that are projected on different threads,
+        provided the dimension of the Cartesian product is at least `min_dimension`;
+        because of the cost of starting threads, this is only beneficial for
+        high-dimensional products
+
+        :param num_threads: maximum number of threads
+        :param min_dimension: minimum dimension for the projection to be parallel
+
+        :return: current instance of CartesianProduct
+        """
+        if not isinstance(num_threads, int) or num_threads < 1:
+            raise ValueError("num_threads must be a positive integer")
+        if not isinstance(min_dimension, int) or min_dimension < 0:
+            raise ValueError("min_dimension must be a nonnegative integer")
+        self.__parallel_num_threads = num_threads
+        self.__parallel_min_dimension = min_dimension
+        return self
 
     @property
     def constraints(self):
@@ -68,6 +91,46 @@ class CartesianProduct(constraint.Constraint):
         """
         return self.__segments
 
+    @property
+    def parallel_num_threads(self):
+        """
+        :return: maximum number of threads of the parallel projection, or None
+            if the projection is sequential
+        """
+        return self.__parallel_num_threads
+
+    @property
+    def parallel_min_dimension(self):
+        """
+        :return: minimum dimension for the projection to be computed in parallel
+        """
+        return self.__parallel_min_dimension
+
+    def static_product_tree(self, max_arity=12):
+        """
+        Nesting of the sets in the (statically typed) Cartesian product of the
+        generated solver, where every product consists of at most `max_arity` sets
+
+        :param max_arity: maximum number of sets of a (non-nested) product
+
+        :return: list of pairs `(idx, node)`, where `idx` is the index (relative
+            to the start of the enclosing product) where the segment of `node` ends
+            and `node` is either the index of a set (starting at 1) or a list
+            of such pairs (nested product)
+        """
+        # nodes are triples (start, end, node) with absolute indices
+        nodes = []
+        start = 0
+        for i, segment in enumerate(self.__segments):
+            nodes.append((start, segment + 1, i + 1))
+            start = segment + 1
+        while len(nodes) > max_arity:
+            nodes = [(group[0][0], group[-1][1],
+                      [(end - group[0][0], node) for (_, end, node) in group])
+                     for group in [nodes[k:k + max_arity]
+                                   for k in range(0, len(nodes), max_arity)]]
+        return [(end, node) for (_, end, node) in nodes]
+
     def segment_dimension(self, i):
         """
         Dimension of segment `i`
@@ -0,0 +1 @@
+from .optimizer_shm_manager import *
@@ -0,0 +1,336 @@
+import yaml
+import os
+import mmap
+import platform
+import struct
+import subprocess
+import logging
+import time
+import pkg_resources
+from threading import Thread
+from ..tcp.solver_response import SolverResponse
+
+
+_SHM_MAGIC = 0x314D48534E45504F  # "OPENSHM1"
+_SHM_LAYOUT_VERSION = 1
+_SHM_HEADER_SIZE = 256
+_SHM_COMMAND_SOLVE = 1
+_SHM_COMMAND_KILL = 2
+_SHM_FLAG_INITIAL_Y = 2
+_SHM_FLAG_INITIAL_PENALTY = 4
+_SHM_FLAG_DEADLINE = 8
+_SHM_EXIT_STATUS = ['Converged', 'NotConvergedIterations', 'NotConvergedOutOfTime']
+_SHM_ERROR_MESSAGES = {1000: "Invalid request",
+                       2000: "Problem solution failed (solver error)"}
+
+# offsets of the fields of the header (see shm_iface_{name}/src/main.rs)
+_OFFSET_MAGIC = 0
+_OFFSET_DIMENSIONS = 8          # layout version, np, nu, n1, server pid
+_OFFSET_REQUEST_SEQ = 64
+_OFFSET_REQUEST = 72            # command, flags, initial penalty, deadline
+_OFFSET_RESPONSE_SEQ = 128
+_OFFSET_RESPONSE = 136          # exit status, error code, iterations, ...
+_RESPONSE_FORMAT = '=QQQQ6d'
+
+# architectures whose memory model does not reorder stores with other stores,
+# nor loads with other loads
+_SHM_SUPPORTED_MACHINES = ('x86_64', 'amd64')
+
+
+def _aligned_size(num_values):
+    return (8 * num_values + 63) // 64 * 64
+
+
+class OptimizerShmManager:
+    """Client for the shared-memory interface of parametric optimizers
+
+    This class is used to start and stop a shared-memory server, which has
+    been generated by `opengen` (see `BuildConfiguration.with_shm_interface`),
+    and to call it from a process on the same host.
+
+    The parameter, the decision variables and the Lagrange multipliers are
+    exposed as memoryviews of the shared memory (see
+    :class:`~opengen.shm.optimizer_shm_manager.OptimizerShmManager.parameter`,
+    :class:`~opengen.shm.optimizer_shm_manager.OptimizerShmManager.solution` and
+    :class:`~opengen.shm.optimizer_shm_manager.OptimizerShmManager.lagrange_multipliers`),
+    so that the client can write its data directly into the buffers of the
+    solver and read the solution without copies.
+
+    A server serves a single client. The handshake consists of plain loads
+    and stores of the shared memory, which are not reordered only on x86-64,
+    so this client refuses to run on other architectures (use the C client,
+    which uses atomic operations, there).
+    """
+
+    def __init__(self, optimizer_path=None, path=None):
+        """
+        Constructs instance of `OptimizerShmManager`
+
+        :param optimizer_path: path to auto-generated optimizer (the folder that
+            contains ``optimizer.yml``); it is needed to start the server and
+            to obtain the default path of the shared-memory file
+        :type optimizer_path: str
+
+        :param path: path of the shared-memory file, which overrides the one
+            of the generated optimizer; if `optimizer_path` is not provided, the
+            manager can connect to a running server, but cannot start it
+        :type path: str
+
+        :raises Exception: if the machine is not x86-64, or if neither
+            `optimizer_path` nor `path` is provided
+
+        :return: New instance of :class:`~opengen.shm.optimizer_shm_manager.OptimizerShmManager`
+        """
+        machine = platform.machine().lower()
+        if machine not in _SHM_SUPPORTED_MACHINES:
+            raise Exception("the Python shared-memory client requires x86-64 (this is %s); "
+                            "use the C client instead" % (machine or "unknown"))
+        self.__optimizer_path = optimizer_path
+        self.__region = None
+        self.__mmap = None
+        self.__offsets = None
+        self.__views = None
+        if optimizer_path is not None:
+            yaml_file = os.path.join(optimizer_path, "optimizer.yml")
+            with open(yaml_file, 'r') as stream:
+                self.__optimizer_details = yaml.safe_load(stream)
+            if self.__optimizer_details.get('shm') is None:
+                raise Exception("the optimizer has no shared-memory interface")
+            if path is not None:
+                self.__optimizer_details['shm']['path'] = path
+
+            opengen_version = self.__optimizer_details['build']['opengen_version']
+            current_opengen_version = pkg_resources.require("opengen")[0].version
+            if current_opengen_version != opengen_version:
+                logging.warn(
+                    'the target optimizer was build with a different version of opengen (%s)' % opengen_version)
+                logging.warn('you are running opengen version %s' % current_opengen_version)
+        elif path is not None:
+            self.__optimizer_details = {"shm": {"path": path, "spin_iterations": 10000,
+                                                "idle_sleep_micros": 50}}
+        else:
+            raise Exception("Illegal arguments")
+
+        logging.info("Shared-memory file: %s", self.__optimizer_details['shm']['path'])
+
+    @property
+    def details(self):
+        return self.__optimizer_details
+
+    def __region_is_ready(self):
+        path = self.__optimizer_details['shm']['path']
+        try:
+            with open(path, 'rb') as f:
+                magic, = struct.unpack('=Q', f.read(8))
+            return magic == _SHM_MAGIC
+        except (OSError, struct.error):
+            return False
+
+    def start(self, timeout=60.0):
+        """Starts the shared-memory server
+
+        The server starts on a separate thread, so this method does not block
+        the execution of the caller's programme once the server is ready.
+
+        :param timeout: maximum time (in seconds) to wait for the server to
+            initialise the shared memory, defaults to 60
+
+        :raises Exception: if no optimizer path has been provided, if a server
+            is already running or if the server does not start in time
+        """
+        if self.__optimizer_path is None:
+            raise Exception("No optimizer path provided - cannot start the server")
+        if self.__region_is_ready():
+            raise Exception("A server is already using %s" % self.__optimizer_details['shm']['path'])
+
+        def threaded_start():
+            optimizer_details = self.__optimizer_details
+            command = ['cargo', 'run', '-q']
+            command += ["--release"] if optimizer_details['build']['build_mode'] == 'release' else []
+            command += ['--', '--path=%s' % optimizer_details['shm']['path'],
+                        '--spin-iterations=%d' % optimizer_details['shm']['spin_iterations'],
+                        '--idle-sleep-micros=%d' % optimizer_details['shm']['idle_sleep_micros']]
+            shm_iface_directory = os.path.join(
+                self.__optimizer_path, "shm_iface_" + optimizer_details['meta']['optimizer_name'])
+            env = dict(os.environ)
+            shared_target_dir = optimizer_details['build'].get('shared_target_dir')
+            if shared_target_dir is not None:
+                env['CARGO_TARGET_DIR'] = shared_target_dir
+            p = subprocess.Popen(command, cwd=shm_iface_directory, env=env)
+            p.wait()
+
+        logging.info("Starting shared-memory server thread")
+        thread = Thread(target=threaded_start)
+        thread.start()
+
+        logging.info("Waiting for server to start")
+        tic = time.time()
+        while not self.__region_is_ready():
+            if time.time() - tic > timeout:
+                raise Exception("the shared-memory server did not start")
+            time.sleep(0.01)
+        self.__connect()
+
+    def __connect(self):
+        if self.__mmap is not None:
+            return
+        path = self.__optimizer_details['shm']['path']
+        with open(path, 'r+b') as f:
+            self.__mmap = mmap.mmap(f.fileno(), 0)
+        region = memoryview(self.__mmap)
+        magic, = struct.unpack_from('=Q', region, _OFFSET_MAGIC)
+        layout_version, n_p, n_u, n1 = struct.unpack_from('=4Q', region, _OFFSET_DIMENSIONS)
+        if magic != _SHM_MAGIC or layout_version != _SHM_LAYOUT_VERSION:
+            region.release()
+            self.__mmap.close()
+            self.__mmap = None
+            raise Exception("%s is not a shared-memory region of an optimizer" % path)
+        p_offset = _SHM_HEADER_SIZE
+        u_offset = p_offset + _aligned_size(n_p)
+        y_offset = u_offset + _aligned_size(n_u)
+        self.__region = region
+        self.__offsets = (p_offset, u_offset, y_offset)
+        self.__views = (region[p_offset:p_offset + 8 * n_p].cast('d'),
+                        region[u_offset:u_offset + 8 * n_u].cast('d'),
+                        region[y_offset:y_offset + 8 * n1].cast('d'))
+
+    @property
+    def parameter(self):
+        """Parameter vector in the shared memory
+
+        :return: writable memoryview of the parameter (of type `float`)
+        """
+        self.__connect()
+        return self.__views[0]
+
+    @property
+    def solution(self):
+        """Decision variables in the shared memory
+
+        Before a call, this is the initial guess; after the call, it holds the
+        solution, so, unless the client modifies it, every call is warm
+        started with the previous solution
+
+        :return: writable memoryview of the decision variables (of type `float`)
+        """
+        self.__connect()
+        return self.__views[1]
+
+    @property
+    def lagrange_multipliers(self):
+        """Lagrange multipliers in the shared memory
+
+        Before a call with `initial_y=True`, this is the initial vector of
+        Lagrange multipliers; after the call, it holds the Lagrange multipliers
+        of the solution
+
+        :return: writable memoryview of the Lagrange multipliers (of type `float`)
+        """
+        self.__connect()
+        return self.__views[2]
+
+    def __request(self, command, flags=0, initial_penalty=0.0, deadline_micros=0):
+        region = self.__region
+        seq, = struct.unpack_from('=Q', region, _OFFSET_RESPONSE_SEQ)
+        seq += 1
+        struct.pack_into('=QQdQ', region, _OFFSET_REQUEST, command, flags,
+                         float(initial_penalty), int(deadline_micros))
+        # the sequence number is written last, which submits the request
+        struct.pack_into('=Q', region, _OFFSET_REQUEST_SEQ, seq)
+        spin_iterations = self.__optimizer_details['shm']['spin_iterations']
+        idle_sleep = self.__optimizer_details['shm']['idle_sleep_micros'] / 1e6
+        polls = 0
+        while struct.unpack_from('=Q', region, _OFFSET_RESPONSE_SEQ)[0] != seq:
+            polls += 1
+            if polls > spin_iterations:
+                time.sleep(idle_sleep)
+
+    def call(self, p=None, initial_guess=None, initial_y=None, initial_penalty=None,
+             deadline_micros=None, copy_solution=True) -> SolverResponse:
+        """Calls the server
+
+        :param p: vector of parameters, which is written into the shared memory;
+            if it is `None`, the parameter in the shared memory is used (see
+            :class:`~opengen.shm.optimizer_shm_manager.OptimizerShmManager.parameter`)
+        :type p: list of `float`
+
+        :param initial_guess: initial guess vector; if it is `None`, the
+            decision variables in the shared memory are used, that is, the
+            previous solution
+        :type initial_guess: list of `float`
+
+        :param initial_y: initial vector of Lagrange multipliers, or `True` to
+            use the Lagrange multipliers in the shared memory
+        :type initial_y: list of `float` or `True`
+
+        :param initial_penalty: initial penalty parameter
+        :type initial_penalty: float
+
+        :param deadline_micros: deadline of this call in microseconds,
+            defaults to None (the maximum duration of the solver is used)
+        :type deadline_micros: int
+
+        :param copy_solution: whether the solution and the Lagrange multipliers
+            of the response are copied into lists (default: `True`); otherwise,
+            they are the memoryviews of the shared memory, which are
+            overwritten by the next call
+        :type copy_solution: bool
+
+        :return: SolverResponse object
+        :rtype: :class:`~opengen.tcp.solver_response.SolverResponse`
+        """
+        self.__connect()
+        _p_view, u_view, y_view = self.__views
+        arrays = (p, initial_guess, None if initial_y is True else initial_y)
+        for view, offset, array in zip(self.__views, self.__offsets, arrays):
+            if array is not None:
+                if len(array) != len(view):
+                    raise ValueError("incompatible dimensions (expected %d, got %d)"
+                                     % (len(view), len(array)))
+                struct.pack_into('=%dd' % len(view), self.__region, offset, *array)
+        flags = 0
+        flags |= _SHM_FLAG_INITIAL_Y if initial_y is not None else 0
+        flags |= _SHM_FLAG_INITIAL_PENALTY if initial_penalty is not None else 0
+        flags |= _SHM_FLAG_DEADLINE if deadline_micros is not None else 0
+        self.__request(_SHM_COMMAND_SOLVE, flags,
+                       initial_penalty if initial_penalty is not None else 0.0,
+                       deadline_micros if deadline_micros is not None else 0)
+
+        (exit_code, error_code, num_outer_iterations, num_inner_iterations,
+         last_problem_norm_fpr, delta_y_norm_over_c, f2_norm, penalty, cost,
+         solve_time_ms) = struct.unpack_from(_RESPONSE_FORMAT, self.__region, _OFFSET_RESPONSE)
+        if error_code != 0:
+            return SolverResponse({"type": "Error", "code": error_code,
+                                   "message": _SHM_ERROR_MESSAGES.get(error_code, "unknown error")})
+        return SolverResponse({"exit_status": _SHM_EXIT_STATUS[exit_code],
+                               "num_outer_iterations": num_outer_iterations,
+                               "num_inner_iterations": num_inner_iterations,
+                               "last_problem_norm_fpr": last_problem_norm_fpr,
+                               "delta_y_norm_over_c": delta_y_norm_over_c,
+                               "f2_norm": f2_norm,
+                               "solve_time_ms": solve_time_ms,
+                               "penalty": penalty,
+                               "cost": cost,
+                               "solution": u_view.tolist() if copy_solution else u_view,
+                               "lagrange_multipliers": y_view.tolist() if copy_solution else y_view})
+
+    def kill(self):
+        """Kills the server"""
+        logging.info("Killing server")
+        self.__connect()
+        self.__request(_SHM_COMMAND_KILL)
+        self.close()
+
+    def close(self):
+        """Unmaps the shared memory (the server keeps running)
+
+        The shared memory is mapped again automatically if needed.
+        """
+        if self.__mmap is not None:
+            for view in self.__views:
+                view.release()
+            self.__region.release()
+            self.__mmap.close()
+            self.__mmap = None
+            self.__region = None
+            self.__views = None
@@ -6,12 +6,27 @@ import json
 import logging
 import time
 import math
+import struct
 import pkg_resources
 from threading import Thread
 from retry import retry
 from .solver_response import SolverResponse
 
 
+_BINARY_PROTOCOL_MAGIC = b'OPNB'
+_BINARY_REQUEST_RUN = 1
+_BINARY_REQUEST_PING = 2
+_BINARY_REQUEST_KILL = 3
+_BINARY_RESPONSE_SOLUTION = 0
+_BINARY_RESPONSE_ERROR = 1
+_BINARY_RESPONSE_PONG = 2
+_BINARY_FLAG_INITIAL_GUESS = 1
+_BINARY_FLAG_INITIAL_Y = 2
+_BINARY_FLAG_INITIAL_PENALTY = 4
+_BINARY_FLAG_DEADLINE = 8
+_BINARY_EXIT_STATUS = ['Converged', 'NotConvergedIterations', 'NotConvergedOutOfTime']
+
+
 class OptimizerTcpManager:
     """Client for TCP interface of parametric optimizers
 
@@ -19,7 +34,7 @@ class OptimizerTcpManager:
     has been generated by `opengen`.
     """
 
-    def __init__(self, optimizer_path=None, ip=None, port=None):
+    def __init__(self, optimizer_path=None, ip=None, port=None, binary_protocol=False):
         """
         Constructs instance of `OptimizerTcpManager`
 
@@ -51,9 +66,18 @@ class OptimizerTcpManager:
         :param port: see ip
         :type port: int
 
+        :param binary_protocol: whether to communicate with the server using the
+            binary protocol over a persistent connection instead of JSON (default:
+            `False`); this is faster, but the connection occupies one worker of
+            the server until it is closed with
+            :class:`~opengen.tcp.optimizer_tcp_manager.OptimizerTcpManager.close`
+        :type binary_protocol: bool
+
         :return: New instance of :class:`~opengen.tcp.optimizer_tcp_manager.OptimizerTcpManager`
         """
         self.__optimizer_path = optimizer_path
+        self.__binary_protocol = binary_protocol
+        self.__binary_socket = None
         if optimizer_path is not None:
             # create attribute (including IP and port)
             self.__optimizer_details = None
@@ -120,11 +144,87 @@ class OptimizerTcpManager:
         conn_socket.close()
         return data.decode()
 
+    def __recv_exact(self, conn_socket, num_bytes):
+        data = b''
+        while len(data) < num_bytes:
+            data_chunk = conn_socket.recv(num_bytes - len(data))
+            if not data_chunk:
+                raise Exception("connection closed by the server")
+            data += data_chunk
+        return data
+
+    def __send_receive_binary(self, payload):
+        if self.__binary_socket is None:
+            conn_socket = self.__obtain_socket_connection()
+            conn_socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            conn_socket.sendall(_BINARY_PROTOCOL_MAGIC)
+            self.__binary_socket = conn_socket
+        self.__binary_socket.sendall(struct.pack('<I', len(payload)) + payload)
+        if payload[0] == _BINARY_REQUEST_KILL:
+            return None
+        response_length, = struct.unpack(
+            '<I', self.__recv_exact(self.__binary_socket, 4))
+        return self.__recv_exact(self.__binary_socket, response_length)
+
+    @staticmethod
+    def __unpack_f64_array(data, offset):
+        length, = struct.unpack_from('<I', data, offset)
+        offset += 4
+        values = list(struct.unpack_from('<%dd' % length, data, offset))
+        return values, offset + 8 * length
+
+    @staticmethod
+    def __decode_binary_response(data):
+        response_type = data[0]
+        if response_type == _BINARY_RESPONSE_PONG:
+            return {"Pong": struct.unpack_from('<i', data, 1)[0]}
+        if response_type == _BINARY_RESPONSE_ERROR:
+            code, message_length = struct.unpack_from('<iI', data, 1)
+            message = data[9:9 + message_length].decode()
+            return {"type": "Error", "code": code, "message": message}
+        (exit_code, num_outer_iterations, num_inner_iterations,
+         last_problem_norm_fpr, delta_y_norm_over_c, f2_norm, solve_time_ms,
+         penalty, cost, queue_wait_ms) = struct.unpack_from('<BQQ7d', data, 1)
+        offset = 1 + struct.calcsize('<BQQ7d')
+        solution, offset = OptimizerTcpManager.__unpack_f64_array(data, offset)
+        lagrange_multipliers, offset = OptimizerTcpManager.__unpack_f64_array(data, offset)
+        response = {"exit_status": _BINARY_EXIT_STATUS[exit_code],
+                "num_outer_iterations": num_outer_iterations,
+                "num_inner_iterations": num_inner_iterations,
+                "last_problem_norm_fpr": last_problem_norm_fpr,
+                "delta_y_norm_over_c": delta_y_norm_over_c,
+                "f2_norm": f2_norm,
+                "solve_time_ms": solve_time_ms,
+                "queue_wait_ms": queue_wait_ms,
+                "penalty": penalty,
+                "solution": solution,
+                "lagrange_multipliers": lagrange_multipliers,
+                "cost": cost}
+        if len(data) > offset:
+            # the server has a solution cache
+            cache_hit, iterations_saved = struct.unpack_from('<BQ', data, offset)
+            response["cache_hit"] = bool(cache_hit)
+            response["iterations_saved"] = iterations_saved
+        return response
+
+    def close(self):
+        """Closes the persistent connection of the binary protocol (if any)
+
+        The connection is opened again automatically if needed.
+        """
+        if self.__binary_socket is not None:
+            self.__binary_socket.close()
+            self.__binary_socket = None
+
     def ping(self):
         """Pings the server
 
         Pings the server to check whether it is up and running
         """
+        if self.__binary_protocol:
+            data = self.__send_receive_binary(
+                struct.pack('<Bi', _BINARY_REQUEST_PING, 1))
+            return OptimizerTcpManager.__decode_binary_response(data)
         request = '{"Ping":1}'
         data = self.__send_receive_data(request)
         return json.loads(data)
@@ -175,11 +275,15 @@ class OptimizerTcpManager:
             command = ['cargo', 'run', '-q']
             command += ["--release"] if optimizer_details['build']['build_mode'] == 'release' else []
             command += ['--', '--port=%d' % port, '--ip=%s' % ip]
-            tcp_dir_name = "tcp_iface_" + \
-                optimizer_details['meta']['optimizer_name']
+            tcp_dir_name = optimizer_details['tcp'].get(
+                'crate_dir', "tcp_iface_" + optimizer_details['meta']['optimizer_name'])
             tcp_iface_directory = os.path.join(
                 self.__optimizer_path, tcp_dir_name)
-            p = subprocess.Popen(command, cwd=tcp_iface_directory)
+            env = dict(os.environ)
+            shared_target_dir = optimizer_details['build'].get('shared_target_dir')
+            if shared_target_dir is not None:
+                env['CARGO_TARGET_DIR'] = shared_target_dir
+            p = subprocess.Popen(command, cwd=tcp_iface_directory, env=env)
             p.wait()
 
         # start the server in a separate thread
@@ -196,6 +300,10 @@ class OptimizerTcpManager:
     def kill(self):
         """Kills the server"""
         logging.info("Killing server")
+        if self.__binary_protocol:
+            self.__send_receive_binary(struct.pack('<B', _BINARY_REQUEST_KILL))
+            self.close()
+            return
         request = '{"Kill":1}'
         self.__send_receive_data(request)
 
@@ -203,7 +311,9 @@ class OptimizerTcpManager:
              initial_y=None,
              initial_penalty=None,
              buffer_len=4096,
-             max_data_size=1048576) -> SolverResponse:
+             max_data_size=1048576,
+             deadline_micros=None,
+             solver=None) -> SolverResponse:
         """Calls the server
 
         Consumes the parametric optimizer by providing a parameter vector
@@ -229,16 +339,38 @@ class OptimizerTcpManager:
             from the TCP server, defaults to 1048576
         :type max_data_size: int
 
+        :param deadline_micros: deadline of this call in microseconds; the
+            solver returns the best iterate found before the deadline,
+            defaults to None (the maximum duration of the solver is used)
+        :type deadline_micros: int
+
+        :param solver: name of the optimizer which should serve the request;
+            this is required by a solver host (see
+            :class:`~opengen.builder.solver_host_builder.SolverHostBuilder`)
+            and must not be provided otherwise, defaults to None
+        :type solver: str
+
+        :raises ValueError: if `solver` is provided and the binary protocol is used
+
         :return: SolverResponse object
         :rtype: :class:`~opengen.tcp.solver_response.SolverResponse`
 
         """
         # Make request
         logging.debug("Sending request to TCP/IP server")
+        if self.__binary_protocol:
+            if solver is not None:
+                raise ValueError("a solver host does not support the binary protocol")
+            return self.__call_binary(p, initial_guess, initial_y, initial_penalty,
+                                      deadline_micros)
+
         run_message = '{"Run" : {"parameter": ['
         run_message += ','.join(map(str, p))
         run_message += ']'
 
+        if solver is not None:
+            run_message += ', "solver": ' + json.dumps(solver)
+
         if initial_guess is not None:
             run_message += ', "initial_guess": ['
             run_message += ','.join(map(str, initial_guess))
@@ -253,6 +385,26 @@ class OptimizerTcpManager:
             run_message += ', "initial_penalty": ' + \
                 str(float(initial_penalty))
 
+        if deadline_micros is not None:
+            run_message += ', "deadline_micros": ' + str(int(deadline_micros))
+
         run_message += '}}'
         data = self.__send_receive_data(run_message, buffer_len, max_data_size)
         return SolverResponse(json.loads(data))
+
+    def __call_binary(self, p, initial_guess, initial_y, initial_penalty, deadline_micros):
+        flags = 0
+        flags |= _BINARY_FLAG_INITIAL_GUESS if initial_guess is not None else 0
+        flags |= _BINARY_FLAG_INITIAL_Y if initial_y is not None else 0
+        flags |= _BINARY_FLAG_INITIAL_PENALTY if initial_penalty is not None else 0
+        flags |= _BINARY_FLAG_DEADLINE if deadline_micros is not None else 0
+        payload = struct.pack('<BB', _BINARY_REQUEST_RUN, flags)
+        for array in (p, initial_guess, initial_y):
+            if array is not None:
+                payload += struct.pack('<I%dd' % len(array), len(array), *array)
+        if initial_penalty is not None:
+            payload += struct.pack('<d', float(initial_penalty))
+        if deadline_micros is not None:
+            payload += struct.pack('<Q', int(deadline_micros))
+        data = self.__send_receive_binary(payload)
+        return SolverResponse(OptimizerTcpManager.__decode_binary_response(data))
@@ -24,6 +24,9 @@ class SolverError:
         - **1700**: Wrong dimension of Lagrange multipliers
         - **2000**: Problem solution failed (solver error)
         - **3003**: Parameter vector has wrong length
+        - **4000**: Unknown solver (solver host)
+        - **4001**: The server is shutting down (solver host)
+        - **4002**: The solver panicked (solver host)
 
         :return: Error code
         """
@@ -85,6 +85,15 @@ class SolverStatus:
         """
         return self.__dict__["__solve_time_ms"]
 
+    @property
+    def queue_wait_ms(self):
+        """Time the request waited in the queue of the server before
+        a worker started processing it
+
+        :return: Queueing time in milliseconds
+        """
+        return self.__dict__["__queue_wait_ms"]
+
     @property
     def penalty(self):
         """Last penalty at the solution
@@ -116,6 +125,58 @@ class SolverStatus:
         """
         return self.__dict__["__cost"]
 
+    @property
+    def statistics(self):
+        """Number of executions and duration of each phase of the solver
+
+        This is only available if the solver is built with instrumentation
+        (see `BuildConfiguration.with_instrumentation`) and the JSON protocol
+        is used.
+
+        :return: Dictionary with the names of the phases as keys (e.g.,
+           ``cost_evaluation``, ``half_step``, ``linesearch``) and dictionaries
+           with entries ``count`` and ``time_ms`` as values, or `None`
+        """
+        return self.__dict__.get("__statistics")
+
+    @property
+    def cache_hit(self):
+        """Whether the solver was warm started from the cache of recent solutions
+
+        This is only available if the TCP server has a solution cache
+        (see `TcpServerConfiguration`).
+
+        :return: `True` if the cache provided the initial guess, `False` if
+           it did not, or `None` if the server has no solution cache
+        """
+        return self.__dict__.get("__cache_hit")
+
+    @property
+    def iterations_saved(self):
+        """Estimated number of inner iterations saved by the cache of recent solutions
+
+        This is only available if the TCP server has a solution cache
+        (see `TcpServerConfiguration`).
+
+        :return: Number of inner iterations, or `None`
+        """
+        return self.__dict__.get("__iterations_saved")
+
+    @property
+    def trace(self):
+        """Trace of the last iterations of the solve
+
+        This is only available if the solver records a trace (see
+        `SolverConfiguration.with_trace`) and the JSON protocol is used.
+
+        :return: List of records (oldest first), that is, dictionaries with
+           entries ``outer_iteration``, ``inner_iteration``, ``gamma``,
+           ``tau``, ``norm_fpr``, ``cost``, ``linesearch_backtracks``,
+           ``penalty`` and ``infeasibility`` (``None`` if not available),
+           or `None`
+        """
+        return self.__dict__.get("__trace")
+
     def __repr__(self):
         return "Solver Status Report:\n" + \
             f"Exit status....... {self.exit_status}\n" + \
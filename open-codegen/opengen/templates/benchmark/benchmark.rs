@@ -0,0 +1,354 @@
+///
+/// Auto-generated latency benchmark for optimizer: {{ meta.optimizer_name }}
+///
+/// The benchmark solves the problem repeatedly for parameters that are
+/// either drawn uniformly at random from a box or replayed from a recorded
+/// parameter trajectory, with and without warm start, and reports the
+/// distribution of the solve time, the number of iterations and the exit
+/// status of the solver
+///
+use optimization_engine::core::ExitStatus;
+use serde::Serialize;
+
+#[macro_use]
+extern crate clap;
+
+use std::{
+    collections::BTreeMap,
+    fs,
+    time::Instant,
+};
+
+use clap::{Arg, App};
+
+use {{ meta.optimizer_name }}::*;
+
+/// Number of solver runs per warm-start mode
+/// Can be overriden by the user
+const NUM_RUNS_DEFAULT: usize = {{ benchmark_config.num_runs }};
+
+/// Seed of the pseudo-random number generator
+/// Can be overriden by the user
+const SEED_DEFAULT: u64 = {{ benchmark_config.seed }};
+
+/// Lower bounds of the parameter ranges (empty if no ranges were given)
+const PARAMETER_LOWER: &[f64] = &[{{ benchmark_config.parameter_lower | join(', ') if benchmark_config.parameter_lower is not none }}];
+
+/// Upper bounds of the parameter ranges (empty if no ranges were given)
+const PARAMETER_UPPER: &[f64] = &[{{ benchmark_config.parameter_upper | join(', ') if benchmark_config.parameter_upper is not none }}];
+
+/// File with a recorded parameter trajectory (one parameter per line)
+/// Can be overriden by the user
+{% if benchmark_config.trajectory_file is not none -%}
+const TRAJECTORY_FILE_DEFAULT: Option<&str> = Some(r#"{{ benchmark_config.trajectory_file | safe }}"#);
+{% else -%}
+const TRAJECTORY_FILE_DEFAULT: Option<&str> = None;
+{% endif %}
+/// Warm-start modes to benchmark
+const WARM_START_MODES: &[WarmStartMode] = &[{% for mode in benchmark_config.warm_start_modes %}WarmStartMode::{{ mode | capitalize }}{{ ", " if not loop.last }}{% endfor %}];
+
+#[derive(Clone, Copy, Debug)]
+enum WarmStartMode {
+    /// Every run starts from zero, with a fresh solver cache
+    Cold,
+    /// Every run starts from the solution, the Lagrange multipliers and
+    /// the penalty parameter of the previous run
+    Warm,
+}
+
+impl WarmStartMode {
+    fn name(self) -> &'static str {
+        match self {
+            WarmStartMode::Cold => "cold",
+            WarmStartMode::Warm => "warm",
+        }
+    }
+}
+
+/// Summary of a sample (percentiles are computed with the nearest-rank method)
+#[derive(Serialize, Debug)]
+struct Summary {
+    min: f64,
+    mean: f64,
+    p50: f64,
+    p90: f64,
+    p99: f64,
+    max: f64,
+}
+
+impl Summary {
+    fn new(sample: &[f64]) -> Summary {
+        if sample.is_empty() {
+            return Summary { min: 0.0, mean: 0.0, p50: 0.0, p90: 0.0, p99: 0.0, max: 0.0 };
+        }
+        let mut sorted = sample.to_vec();
+        sorted.sort_by(|a, b| a.partial_cmp(b).unwrap());
+        let n = sorted.len();
+        let percentile = |q: f64| sorted[((q * n as f64).ceil() as usize).max(1).min(n) - 1];
+        Summary {
+            min: sorted[0],
+            mean: sorted.iter().sum::<f64>() / n as f64,
+            p50: percentile(0.50),
+            p90: percentile(0.90),
+            p99: percentile(0.99),
+            max: sorted[n - 1],
+        }
+    }
+}
+
+/// Benchmark results for one warm-start mode
+#[derive(Serialize, Debug)]
+struct ModeReport {
+    warm_start: &'static str,
+    runs: usize,
+    errors: usize,
+    solve_time_us: Summary,
+    inner_iterations: Summary,
+    outer_iterations: Summary,
+    exit_status: BTreeMap<String, usize>,
+}
+
+/// Benchmark report
+#[derive(Serialize, Debug)]
+struct Report {
+    optimizer: &'static str,
+    version: &'static str,
+    parameter_source: String,
+    num_runs: usize,
+    modes: Vec<ModeReport>,
+}
+
+/// Xorshift64* pseudo-random number generator
+///
+/// The benchmark must be reproducible across platforms and must not
+/// depend on additional crates, so we use this simple generator
+struct Rng(u64);
+
+impl Rng {
+    fn new(seed: u64) -> Rng {
+        // the state must be nonzero
+        Rng((seed ^ 0x9E37_79B9_7F4A_7C15) | 1)
+    }
+
+    /// Returns a number uniformly distributed in [0, 1)
+    fn next_f64(&mut self) -> f64 {
+        self.0 ^= self.0 >> 12;
+        self.0 ^= self.0 << 25;
+        self.0 ^= self.0 >> 27;
+        let x = self.0.wrapping_mul(0x2545_F491_4F6C_DD1D);
+        (x >> 11) as f64 / (1u64 << 53) as f64
+    }
+}
+
+/// Draws `num_runs` parameters uniformly at random from the parameter ranges
+fn random_parameters(num_runs: usize, seed: u64) -> Vec<Vec<f64>> {
+    let mut rng = Rng::new(seed);
+    (0..num_runs)
+        .map(|_| {
+            PARAMETER_LOWER
+                .iter()
+                .zip(PARAMETER_UPPER.iter())
+                .map(|(lo, hi)| lo + (hi - lo) * rng.next_f64())
+                .collect()
+        })
+        .collect()
+}
+
+/// Reads a parameter trajectory from a file
+///
+/// Every line contains one parameter vector, whose elements are separated by
+/// commas or whitespace; empty lines and lines starting with `#` are ignored
+fn read_trajectory(path: &str) -> Result<Vec<Vec<f64>>, String> {
+    let contents = fs::read_to_string(path).map_err(|e| format!("cannot read {}: {}", path, e))?;
+    let mut trajectory = Vec::new();
+    for (line_number, line) in contents.lines().enumerate() {
+        let line = line.trim();
+        if line.is_empty() || line.starts_with('#') {
+            continue;
+        }
+        let p = line
+            .split(|c: char| c == ',' || c.is_whitespace())
+            .filter(|s| !s.is_empty())
+            .map(|s| s.parse::<f64>())
+            .collect::<Result<Vec<f64>, _>>()
+            .map_err(|e| format!("{}:{}: {}", path, line_number + 1, e))?;
+        if p.len() != {{meta.optimizer_name|upper}}_NUM_PARAMETERS {
+            return Err(format!(
+                "{}:{}: expected {} parameters, found {}",
+                path,
+                line_number + 1,
+                {{meta.optimizer_name|upper}}_NUM_PARAMETERS,
+                p.len()
+            ));
+        }
+        trajectory.push(p);
+    }
+    if trajectory.is_empty() {
+        return Err(format!("{}: empty trajectory", path));
+    }
+    Ok(trajectory)
+}
+
+/// Solves the problem for every parameter in `parameters`
+fn run_mode(mode: WarmStartMode, parameters: &[Vec<f64>]) -> ModeReport {
+    let mut cache = initialize_solver();
+    let mut u = vec![0.0; {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES];
+    let mut y0: Option<Vec<f64>> = None;
+    let mut c0: Option<f64> = None;
+    let mut solve_times = Vec::with_capacity(parameters.len());
+    let mut inner_iterations = Vec::with_capacity(parameters.len());
+    let mut outer_iterations = Vec::with_capacity(parameters.len());
+    let mut exit_status = BTreeMap::new();
+    let mut errors = 0;
+
+    for p in parameters {
+        if let WarmStartMode::Cold = mode {
+            // not timed: the cold solve must not reuse any solver state
+            cache = initialize_solver();
+            u.iter_mut().for_each(|ui| *ui = 0.0);
+        }
+        let tic = Instant::now();
+        let result = solve(p, &mut cache, &mut u, &y0, &c0);
+        let elapsed = tic.elapsed();
+        solve_times.push(elapsed.as_secs_f64() * 1e6);
+        match result {
+            Ok(status) => {
+                inner_iterations.push(status.num_inner_iterations() as f64);
+                outer_iterations.push(status.num_outer_iterations() as f64);
+                let status_name = match status.exit_status() {
+                    ExitStatus::Converged => "Converged",
+                    ExitStatus::NotConvergedIterations => "NotConvergedIterations",
+                    ExitStatus::NotConvergedOutOfTime => "NotConvergedOutOfTime",
+                };
+                *exit_status.entry(status_name.to_string()).or_insert(0) += 1;
+                if let WarmStartMode::Warm = mode {
+                    y0 = status.lagrange_multipliers().clone();
+                    c0 = Some(status.penalty());
+                }
+            }
+            Err(_) => {
+                errors += 1;
+                *exit_status.entry("Error".to_string()).or_insert(0) += 1;
+                u.iter_mut().for_each(|ui| *ui = 0.0);
+                y0 = None;
+                c0 = None;
+            }
+        }
+    }
+
+    ModeReport {
+        warm_start: mode.name(),
+        runs: parameters.len(),
+        errors,
+        solve_time_us: Summary::new(&solve_times),
+        inner_iterations: Summary::new(&inner_iterations),
+        outer_iterations: Summary::new(&outer_iterations),
+        exit_status,
+    }
+}
+
+/// Prints a human-readable summary of the report
+fn print_report(report: &Report) {
+    println!("Benchmark of {} v{} ({}, {} runs)", report.optimizer, report.version, report.parameter_source, report.num_runs);
+    for mode in &report.modes {
+        let t = &mode.solve_time_us;
+        println!("[{}]", mode.warm_start);
+        println!("  solve time (us)       : p50 = {:.1}, p90 = {:.1}, p99 = {:.1}, max = {:.1}, mean = {:.1}", t.p50, t.p90, t.p99, t.max, t.mean);
+        let (i, o) = (&mode.inner_iterations, &mode.outer_iterations);
+        println!("  inner iterations      : min = {}, p50 = {}, p99 = {}, max = {}, mean = {:.1}", i.min, i.p50, i.p99, i.max, i.mean);
+        println!("  outer iterations      : min = {}, p50 = {}, p99 = {}, max = {}, mean = {:.1}", o.min, o.p50, o.p99, o.max, o.mean);
+        for (status, count) in &mode.exit_status {
+            println!("  {:<22}: {} ({:.1}%)", status, count, 100.0 * *count as f64 / mode.runs.max(1) as f64);
+        }
+    }
+}
+
+fn main() {
+    let matches = App::new("OpEn Benchmark [{{meta.optimizer_name}}]")
+        .version("{{meta.version}}")
+        .author("{{meta.authors | join(', ')}}")
+        .about("Latency benchmark of OpEn optimizer")
+        .arg(Arg::with_name("runs")
+                 .short("n")
+                 .long("runs")
+                 .takes_value(true)
+                 .help("Number of runs per warm-start mode"))
+        .arg(Arg::with_name("seed")
+                 .short("s")
+                 .long("seed")
+                 .takes_value(true)
+                 .help("Seed of the random parameter generator"))
+        .arg(Arg::with_name("trajectory")
+                 .short("t")
+                 .long("trajectory")
+                 .takes_value(true)
+                 .help("Replay the parameter trajectory in this file"))
+        .arg(Arg::with_name("output")
+                 .short("o")
+                 .long("output")
+                 .takes_value(true)
+                 .help("Write the report as JSON to this file"))
+        .arg(Arg::with_name("json")
+                 .long("json")
+                 .help("Print the report as JSON instead of text"))
+        .arg(Arg::with_name("max-p99-micros")
+                 .long("max-p99-micros")
+                 .takes_value(true)
+                 .help("Exit with status 1 if the p99 solve time of a mode exceeds this value"))
+        .get_matches();
+    let num_runs = value_t!(matches, "runs", usize).unwrap_or(NUM_RUNS_DEFAULT).max(1);
+    let seed = value_t!(matches, "seed", u64).unwrap_or(SEED_DEFAULT);
+    let trajectory_file = matches.value_of("trajectory").or(TRAJECTORY_FILE_DEFAULT);
+
+    let (parameters, parameter_source) = match trajectory_file {
+        Some(path) => match read_trajectory(path) {
+            // replay the trajectory (cyclically) for `num_runs` runs
+            Ok(trajectory) => (
+                trajectory.iter().cycle().take(num_runs).cloned().collect::<Vec<_>>(),
+                format!("trajectory {}", path),
+            ),
+            Err(message) => {
+                eprintln!("error: {}", message);
+                std::process::exit(2);
+            }
+        },
+        None => (random_parameters(num_runs, seed), format!("random, seed {}", seed)),
+    };
+
+    let report = Report {
+        optimizer: "{{meta.optimizer_name}}",
+        version: "{{meta.version}}",
+        parameter_source,
+        num_runs,
+        modes: WARM_START_MODES.iter().map(|&mode| run_mode(mode, &parameters)).collect(),
+    };
+
+    let report_json = serde_json::to_string_pretty(&report).unwrap();
+    if matches.is_present("json") {
+        println!("{}", report_json);
+    } else {
+        print_report(&report);
+    }
+    if let Some(path) = matches.value_of("output") {
+        if let Err(e) = fs::write(path, &report_json) {
+            eprintln!("error: cannot write {}: {}", path, e);
+            std::process::exit(2);
+        }
+    }
+    if let Ok(max_p99_micros) = value_t!(matches, "max-p99-micros", f64) {
+        let slow_modes: Vec<_> = report
+            .modes
+            .iter()
+            .filter(|mode| mode.solve_time_us.p99 > max_p99_micros)
+            .collect();
+        for mode in &slow_modes {
+            eprintln!(
+                "latency regression: p99 solve time of {} runs is {:.1}us (limit: {:.1}us)",
+                mode.warm_start, mode.solve_time_us.p99, max_p99_micros
+            );
+        }
+        if !slow_modes.is_empty() {
+            std::process::exit(1);
+        }
+    }
+}
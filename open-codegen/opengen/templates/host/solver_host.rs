@@ -0,0 +1,322 @@
+///
+/// Auto-generated solver host: {{ host_name }}
+///
+/// TCP server which hosts several optimizers ({{ solvers | map(attribute='name') | join(', ') }})
+/// and solves them on a shared pool of worker threads (see
+/// `optimization_engine::alm::SolverHost`). A request names the solver
+/// which should serve it:
+///
+///     {"Run" : {"solver": "...", "parameter": [...], ...}}
+///
+/// and, when several requests are waiting for a worker, the request of the
+/// solver with the highest priority is served first.
+///
+use optimization_engine::alm::*;
+use serde::{Deserialize, Serialize};
+
+#[macro_use]
+extern crate clap;
+
+use std::{
+    io::{self, prelude::Read, Write},
+    net::{TcpListener, TcpStream},
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        Arc,
+    },
+    thread,
+    time::Duration,
+};
+
+use clap::{App, Arg};
+
+#[macro_use]
+extern crate log;
+
+/// IP of server (use 0.0.0.0 to bind to any IP)
+/// Can be overriden by the user
+const BIND_IP_DEFAULT: &str = "{{tcp_server_config.bind_ip}}";
+
+/// Port
+/// Can be overriden by the user
+const BIND_PORT_DEFAULT: u32 = {{tcp_server_config.bind_port}};
+
+/// Number of worker threads, which are shared by all solvers
+/// Can be overriden by the user
+const NUM_WORKERS_DEFAULT: usize = {{tcp_server_config.num_workers}};
+
+/// Size of read buffer
+const READ_BUFFER_SIZE: usize = 1024;
+
+/// Configuration of the server (provided by the user as command-line
+/// parameters)
+#[derive(Debug)]
+struct HostServerConfiguration<'a> {
+    /// Bind IP
+    ip: &'a str,
+    /// Port
+    port: u32,
+    /// Number of worker threads
+    num_workers: usize,
+}
+
+#[derive(Deserialize, Debug)]
+struct ExecutionParameter {
+    /// Name of the solver
+    solver: String,
+    /// Parameter
+    parameter: Vec<f64>,
+    /// Initial guess (can be null)
+    initial_guess: Option<Vec<f64>>,
+    /// Initial Lagrange multipliers (can be null)
+    initial_lagrange_multipliers: Option<Vec<f64>>,
+    /// Initial penalty parameter, c0
+    initial_penalty: Option<f64>,
+    /// Deadline of this request in microseconds, which includes the time
+    /// that the request waits for a worker; if it is not provided, the
+    /// maximum duration of the solver is used
+    deadline_micros: Option<u64>,
+}
+
+/// Request from the client
+#[derive(Deserialize, Debug)]
+enum ClientRequest {
+    /// Command: run solver
+    Run(ExecutionParameter),
+    /// Command: ping (check if server is up)
+    Ping(i32),
+    /// Command: kill gracefully
+    Kill(i32),
+}
+
+/// Solution and solution status of optimizer
+#[derive(Serialize, Debug)]
+struct OptimizerSolution<'a> {
+    exit_status: String,
+    num_outer_iterations: usize,
+    num_inner_iterations: usize,
+    last_problem_norm_fpr: f64,
+    delta_y_norm_over_c: f64,
+    f2_norm: f64,
+    solve_time_ms: f64,
+    penalty: f64,
+    solution: &'a [f64],
+    lagrange_multipliers: &'a [f64],
+    cost: f64,
+    queue_wait_ms: f64,
+}
+
+/// Registers the instances of all solvers with the host
+fn register_solvers(host: &SolverHost) {
+    {%- for solver in solvers %}
+    let instances: Vec<Box<dyn HostedSolver>> = (0..{{ solver.num_instances }})
+        .map(|_| Box::new({{ solver.name }}::hosted_solver()) as Box<dyn HostedSolver>)
+        .collect();
+    host.register("{{ solver.name }}", {{ solver.priority }}, instances)
+        .expect("cannot register solver {{ solver.name }}");
+    {%- endfor %}
+}
+
+fn pong(stream: &mut std::net::TcpStream, code: i32) -> io::Result<()> {
+    let error_message = format!(
+        {% raw %}"{{\n\t\"Pong\" : {}\n}}\n"{% endraw %},
+        code
+    );
+    stream.write_all(error_message.as_bytes())
+}
+
+/// Writes an error to the communication stream
+fn write_error_message(stream: &mut std::net::TcpStream, code: i32, error_msg: &str) -> io::Result<()> {
+    let error_message = format!(
+        {% raw %}"{{\n\t\"type\" : \"Error\", \n\t\"code\" : {}, \n\t\"message\" : \"{}\"\n}}\n"{% endraw %},
+        code,
+        error_msg
+    );
+    warn!("Invalid request {:?}", code);
+    stream.write_all(error_message.as_bytes())
+}
+
+/// Writes an error of the host to the communication stream
+fn write_host_error(stream: &mut std::net::TcpStream, error: HostError) -> io::Result<()> {
+    match error {
+        HostError::UnknownSolver => write_error_message(stream, 4000, "unknown solver"),
+        HostError::WrongNumberOfParameters => write_error_message(stream, 3003, "wrong number of parameters"),
+        HostError::WrongInitialGuess => write_error_message(stream, 1600, "Initial guess has incompatible dimensions"),
+        HostError::WrongLagrangeMultipliers => write_error_message(stream, 1700, "wrong dimension of Langrange multipliers"),
+        HostError::SolverPanicked => write_error_message(stream, 4002, "the solver panicked"),
+        _ => write_error_message(stream, 4001, "the server is shutting down"),
+    }
+}
+
+/// Serializes the solution and solution status and returns it
+/// to the client
+fn return_solution_to_client(
+    status: &AlmOptimizerStatus,
+    solution: &[f64],
+    queue_wait: Duration,
+    stream: &mut std::net::TcpStream,
+) -> io::Result<()> {
+    let empty_vec : [f64; 0] = Default::default();
+    let solution: OptimizerSolution = OptimizerSolution {
+        exit_status: format!("{:?}", status.exit_status()),
+        num_outer_iterations: status.num_outer_iterations(),
+        num_inner_iterations: status.num_inner_iterations(),
+        last_problem_norm_fpr: status.last_problem_norm_fpr(),
+        delta_y_norm_over_c: status.delta_y_norm_over_c(),
+        f2_norm: status.f2_norm(),
+        penalty: status.penalty(),
+        lagrange_multipliers: if let Some(y) = &status.lagrange_multipliers() { y } else { &empty_vec },
+        solve_time_ms: (status.solve_time().as_nanos() as f64) / 1e6,
+        solution,
+        cost: status.cost(),
+        queue_wait_ms: (queue_wait.as_nanos() as f64) / 1e6,
+    };
+    let solution_json = serde_json::to_vec(&solution).unwrap();
+    stream.write_all(&solution_json)
+}
+
+/// Submits an execution request to the host and waits for the response
+fn execution_handler(host: &SolverHost, execution_parameter: ExecutionParameter, stream: &mut TcpStream) -> io::Result<()> {
+    let mut request = HostRequest::new(execution_parameter.parameter);
+    if let Some(u0) = execution_parameter.initial_guess {
+        request = request.with_initial_guess(u0);
+    }
+    if let Some(y0) = execution_parameter.initial_lagrange_multipliers {
+        request = request.with_initial_lagrange_multipliers(y0);
+    }
+    if let Some(c0) = execution_parameter.initial_penalty {
+        request = request.with_initial_penalty(c0);
+    }
+    if let Some(micros) = execution_parameter.deadline_micros {
+        request = request.with_deadline(Duration::from_micros(micros));
+    }
+    match host.solve(&execution_parameter.solver, request) {
+        Ok(response) => match response.status() {
+            Ok(status) => return_solution_to_client(status, response.solution(), response.queue_wait(), stream),
+            Err(_) => write_error_message(stream, 2000, "Problem solution failed (solver error)"),
+        },
+        Err(error) => write_host_error(stream, error),
+    }
+}
+
+/// Reads a request from a connection and serves it
+///
+/// Errors of the connection are logged and the connection is dropped.
+///
+/// Returns `true` if the client has requested the server to quit
+fn connection_handler(host: &SolverHost, stream: &mut TcpStream) -> bool {
+    match serve_connection(host, stream) {
+        Ok(kill_requested) => kill_requested,
+        Err(error) => {
+            warn!("Dropping connection: {}", error);
+            false
+        }
+    }
+}
+
+fn serve_connection(host: &SolverHost, stream: &mut TcpStream) -> io::Result<bool> {
+    // The client closes its write side once it has sent the request
+    let mut buffer = Vec::with_capacity(READ_BUFFER_SIZE);
+    stream.read_to_end(&mut buffer)?;
+
+    let received_request: serde_json::Result<ClientRequest> = serde_json::from_slice(&buffer);
+    trace!("Received new request");
+    match received_request {
+        Ok(request_content) => match request_content {
+            ClientRequest::Run(execution_param) => {
+                trace!("Running solver {}", execution_param.solver);
+                execution_handler(host, execution_param, stream)?;
+            }
+            ClientRequest::Kill(kill_code) => {
+                info!("Quitting on request (kill code: {})", kill_code);
+                return Ok(true);
+            }
+            ClientRequest::Ping(ping_code) => {
+                info!("Ping received");
+                pong(stream, ping_code)?;
+            }
+        },
+        Err(_) => {
+            write_error_message(stream, 1000, "Invalid request")?;
+        }
+    }
+    Ok(false)
+}
+
+fn run_server(config: &HostServerConfiguration) {
+    let listener = TcpListener::bind(format!("{}:{}", config.ip, config.port)).unwrap();
+    let mut wake_up_address = listener.local_addr().unwrap();
+    if wake_up_address.ip().is_unspecified() {
+        wake_up_address.set_ip(std::net::Ipv4Addr::LOCALHOST.into());
+    }
+
+    info!("Initializing {} worker(s)...", config.num_workers);
+    let host = Arc::new(SolverHost::new(config.num_workers));
+    register_solvers(&host);
+    info!("Done (solvers: {})", host.solver_names().join(", "));
+
+    // Every connection is served by its own thread, which only waits for the
+    // host; the solves run on the workers of the host
+    let kill_requested = Arc::new(AtomicBool::new(false));
+    let mut connections = Vec::new();
+    info!("listening started, ready to accept connections at {}:{}", config.ip, config.port);
+    for stream in listener.incoming() {
+        if kill_requested.load(Ordering::SeqCst) {
+            break;
+        }
+        let mut stream = match stream {
+            Ok(stream) => stream,
+            Err(error) => {
+                warn!("Could not accept connection: {}", error);
+                continue;
+            }
+        };
+        let host = Arc::clone(&host);
+        let kill_requested = Arc::clone(&kill_requested);
+        connections.push(thread::spawn(move || {
+            if connection_handler(&host, &mut stream) {
+                kill_requested.store(true, Ordering::SeqCst);
+                // wake up the listener, which is blocked in `accept`
+                let _ = TcpStream::connect(wake_up_address);
+            }
+        }));
+        connections.retain(|connection| !connection.is_finished());
+    }
+
+    // Serve the requests that are still pending
+    for connection in connections {
+        if connection.join().is_err() {
+            error!("A connection thread has panicked");
+        }
+    }
+}
+
+fn main() {
+    let matches = App::new("OpEn Solver Host [{{host_name}}]")
+        .about("TCP interface of several OpEn optimizers with a shared pool of workers")
+        .arg(Arg::with_name("ip")
+                 .short("ip")
+                 .long("ip")
+                 .takes_value(true)
+                 .help("TCP server bind IP (0.0.0.0 for no restrictions)"))
+        .arg(Arg::with_name("port")
+                 .short("p")
+                 .long("port")
+                 .takes_value(true)
+                 .help("TCP server port"))
+        .arg(Arg::with_name("workers")
+                 .short("w")
+                 .long("workers")
+                 .takes_value(true)
+                 .help("Number of worker threads (shared by all solvers)"))
+        .get_matches();
+    let port = value_t!(matches, "port", u32).unwrap_or(BIND_PORT_DEFAULT);
+    let ip = matches.value_of("ip").unwrap_or(BIND_IP_DEFAULT);
+    let num_workers = value_t!(matches, "workers", usize).unwrap_or(NUM_WORKERS_DEFAULT).max(1);
+    let server_config = HostServerConfiguration {ip, port, num_workers};
+
+    pretty_env_logger::init();
+    info!("{:?}", server_config);
+    run_server(&server_config);
+    info!("Exiting... (adios!)");
+}
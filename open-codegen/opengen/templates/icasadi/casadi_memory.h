@@ -33,6 +33,15 @@
 #define GRAD_SZ_IW_{{ meta.optimizer_name | upper}} {{ grad.sz_iw() }}
 #define GRAD_SZ_W_{{ meta.optimizer_name | upper}} {{ grad.sz_w() }}
 #define GRAD_SZ_RES_{{ meta.optimizer_name | upper}} {{ grad.sz_res() }}
+{% if cost_and_grad %}
+/*
+ * Sizes of the fused cost-and-gradient function
+ */
+#define COST_AND_GRAD_SZ_ARG_{{ meta.optimizer_name | upper}} {{ cost_and_grad.sz_arg() }}
+#define COST_AND_GRAD_SZ_IW_{{ meta.optimizer_name | upper}} {{ cost_and_grad.sz_iw() }}
+#define COST_AND_GRAD_SZ_W_{{ meta.optimizer_name | upper}} {{ cost_and_grad.sz_w() }}
+#define COST_AND_GRAD_SZ_RES_{{ meta.optimizer_name | upper}} {{ cost_and_grad.sz_res() }}
+{% endif %}
 
 /*
  * F1 sizes
@@ -26,38 +26,118 @@ const NUM_CONSTRAINTS_TYPE_ALM: usize = {{ problem.dim_constraints_aug_lagrangia
 /// Number of penalty constraints (dimension of F2, i.e., n2)
 const NUM_CONSTRAINTS_TYPE_PENALTY: usize = {{ problem.dim_constraints_penalty() or 0 }};
 
-use libc::{c_double, c_int};  // might need to include: c_longlong, c_void
+use libc::c_int;  // might need to include: c_longlong, c_void
+
+/// Floating-point type of the CasADi functions (`casadi_real`)
+{% if solver_config.single_precision -%}
+pub type Real = f32;
+use libc::c_float as c_real;
+{%- else -%}
+pub type Real = f64;
+use libc::c_double as c_real;
+{%- endif %}
+
+/// Opaque type of the workspace which is defined in `interface.c`
+#[repr(C)]
+struct WorkspaceC {
+    _private: [u8; 0],
+}
 
 // C interface (Function API exactly as provided by CasADi)
 extern "C" {
-    fn init_interface_{{ meta.optimizer_name }}();
+    fn workspace_new_{{ meta.optimizer_name }}() -> *mut WorkspaceC;
+    fn workspace_free_{{ meta.optimizer_name }}(ws: *mut WorkspaceC);
+    fn init_interface_{{ meta.optimizer_name }}(ws: *mut WorkspaceC);
     fn cost_function_{{ meta.optimizer_name }}(
-        arg: *const *const c_double,
-        casadi_results: *mut *mut c_double) -> c_int;
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
+        casadi_results: *mut *mut c_real) -> c_int;
     fn grad_cost_function_{{ meta.optimizer_name }}(
-        arg: *const *const c_double,
-        casadi_results: *mut *mut c_double)
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
+        casadi_results: *mut *mut c_real)
+        -> c_int;
+    {% if solver_config.fused_cost_and_gradient %}
+    fn cost_and_grad_function_{{ meta.optimizer_name }}(
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
+        casadi_results: *mut *mut c_real)
         -> c_int;
+    {% endif %}
     fn mapping_f1_function_{{ meta.optimizer_name }}(
-        arg: *const *const c_double,
-        casadi_results: *mut *mut c_double,
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
+        casadi_results: *mut *mut c_real,
     ) -> c_int;
     fn mapping_f2_function_{{ meta.optimizer_name }}(
-        arg: *const *const c_double,
-        casadi_results: *mut *mut c_double,
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
+        casadi_results: *mut *mut c_real,
     ) -> c_int;
     // Compute all preconditioning parameters
     fn preconditioning_www_{{ meta.optimizer_name }} (
-        arg: *const *const c_double,
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
     ) -> c_int;
     fn init_penalty_function_{{ meta.optimizer_name }}(
-        arg: *const *const c_double,
-        ipnlt: *mut *mut c_double,
+        ws: *mut WorkspaceC,
+        arg: *const *const c_real,
+        ipnlt: *mut *mut c_real,
     ) -> c_int;
-    fn get_w_cost_{{ meta.optimizer_name }}() -> c_double;
+    fn get_w_cost_{{ meta.optimizer_name }}(ws: *const WorkspaceC) -> c_real;
 } // END of extern C
 
 
+// -----------------------------------------------------------
+//  Workspace
+// -----------------------------------------------------------
+
+/// Workspace of the CasADi functions
+///
+/// Holds all memory that the CasADi-generated functions need, as well
+/// as the preconditioning parameters. Every instance of the solver
+/// should own its own workspace; different workspaces can be used
+/// concurrently from different threads.
+///
+/// The workspace is modified by the C functions even when it is passed
+/// by reference, so it is `Send`, but not `Sync`: a workspace must not
+/// be used by two threads at the same time.
+pub struct CasadiWorkspace {
+    ws: *mut WorkspaceC,
+}
+
+impl CasadiWorkspace {
+    /// Allocates a new workspace (all preconditioning parameters are set to 1)
+    ///
+    /// # Panics
+    ///
+    /// The method panics if the memory cannot be allocated
+    pub fn new() -> Self {
+        let ws = unsafe { workspace_new_{{ meta.optimizer_name }}() };
+        assert!(!ws.is_null(), "cannot allocate CasADi workspace");
+        CasadiWorkspace { ws }
+    }
+}
+
+impl Default for CasadiWorkspace {
+    fn default() -> Self {
+        CasadiWorkspace::new()
+    }
+}
+
+impl Drop for CasadiWorkspace {
+    fn drop(&mut self) {
+        unsafe {
+            workspace_free_{{ meta.optimizer_name }}(self.ws);
+        }
+    }
+}
+
+// The workspace is owned exclusively by this object, so it can be
+// moved to another thread
+unsafe impl Send for CasadiWorkspace {}
+
+
 // -----------------------------------------------------------
 //  *MAIN* API Functions in Rust
 // -----------------------------------------------------------
@@ -65,18 +145,18 @@ extern "C" {
 ///
 /// Getter function for w_cost
 ///
-pub fn get_w_cost() -> f64 {
+pub fn get_w_cost(workspace: &CasadiWorkspace) -> Real {
     unsafe {
-        get_w_cost_{{ meta.optimizer_name }}() as f64
+        get_w_cost_{{ meta.optimizer_name }}(workspace.ws) as Real
     }
 }
 
 ///
 /// Initialise the interface by setting all preconditioning parameters to 1
 ///
-pub fn init_{{ meta.optimizer_name }}() {
+pub fn init_{{ meta.optimizer_name }}(workspace: &CasadiWorkspace) {
     unsafe {
-        init_interface_{{ meta.optimizer_name }}();
+        init_interface_{{ meta.optimizer_name }}(workspace.ws);
     }
 }
 
@@ -90,7 +170,8 @@ pub fn init_{{ meta.optimizer_name }}() {
 ///     let p = [1.0, -1.0];
 ///     let xi = [100.0, 0.0, 1.5., 3.0];
 ///     let mut cost_value = 0.0;
-///     icasadi::cost(&u, &xi, &p, &mut cost_value);
+///     let workspace = icasadi::CasadiWorkspace::new();
+///     icasadi::cost(&workspace, &u, &xi, &p, &mut cost_value);
 /// }
 /// ```
 ///
@@ -100,7 +181,7 @@ pub fn init_{{ meta.optimizer_name }}() {
 /// - `u.len() == NUM_DECISION_VARIABLES`
 /// - `static_params.len() == NUM_STATIC_PARAMETERS`
 ///
-pub fn cost(u: &[f64], xi: &[f64], static_params: &[f64], cost_value: &mut f64) -> i32 {
+pub fn cost(workspace: &CasadiWorkspace, u: &[Real], xi: &[Real], static_params: &[Real], cost_value: &mut Real) -> i32 {
     assert_eq!(u.len(), NUM_DECISION_VARIABLES, "wrong length of `u`");
     assert_eq!(
         static_params.len(),
@@ -109,10 +190,11 @@ pub fn cost(u: &[f64], xi: &[f64], static_params: &[f64], cost_value: &mut f64)
     );
 
     let arguments = &[u.as_ptr(), xi.as_ptr(), static_params.as_ptr()];
-    let cost = &mut [cost_value as *mut c_double];
+    let cost = &mut [cost_value as *mut c_real];
 
     unsafe {
         cost_function_{{ meta.optimizer_name }}(
+            workspace.ws,
             arguments.as_ptr(),
             cost.as_mut_ptr(),
         ) as i32
@@ -129,7 +211,8 @@ pub fn cost(u: &[f64], xi: &[f64], static_params: &[f64], cost_value: &mut f64)
 ///     let p = [1.0, -1.0];
 ///     let xi = [100.0, 0.0, 1.5., 3.0];
 ///     let mut jac = [0.0; 10];
-///     icasadi::grad(&u, &xi, &p, &mut jac);
+///     let workspace = icasadi::CasadiWorkspace::new();
+///     icasadi::grad(&workspace, &u, &xi, &p, &mut jac);
 /// }
 /// ```
 ///
@@ -140,7 +223,7 @@ pub fn cost(u: &[f64], xi: &[f64], static_params: &[f64], cost_value: &mut f64)
 /// - `static_params.len() == icasadi::num_static_parameters()`
 /// - `cost_jacobian.len() == icasadi::num_decision_variables()`
 ///
-pub fn grad(u: &[f64], xi: &[f64], static_params: &[f64], cost_jacobian: &mut [f64]) -> i32 {
+pub fn grad(workspace: &CasadiWorkspace, u: &[Real], xi: &[Real], static_params: &[Real], cost_jacobian: &mut [Real]) -> i32 {
     assert_eq!(u.len(), NUM_DECISION_VARIABLES, "wrong length of `u`");
     assert_eq!(
         static_params.len(),
@@ -158,11 +241,56 @@ pub fn grad(u: &[f64], xi: &[f64], static_params: &[f64], cost_jacobian: &mut [f
 
     unsafe {
         grad_cost_function_{{ meta.optimizer_name }}(
+            workspace.ws,
             arguments.as_ptr(),
             grad.as_mut_ptr()
         ) as i32
     }
 }
+{% if solver_config.fused_cost_and_gradient %}
+///
+/// Consume the function that computes the cost and its gradient together,
+/// which has been generated by CasADi
+///
+/// # Panics
+/// This method panics if the following conditions are not satisfied
+///
+/// - `u.len() == icasadi::num_decision_variables()`
+/// - `static_params.len() == icasadi::num_static_parameters()`
+/// - `cost_jacobian.len() == icasadi::num_decision_variables()`
+///
+pub fn cost_and_grad(
+    workspace: &CasadiWorkspace,
+    u: &[Real],
+    xi: &[Real],
+    static_params: &[Real],
+    cost_value: &mut Real,
+    cost_jacobian: &mut [Real],
+) -> i32 {
+    assert_eq!(u.len(), NUM_DECISION_VARIABLES, "wrong length of `u`");
+    assert_eq!(
+        static_params.len(),
+        NUM_STATIC_PARAMETERS,
+        "wrong length of `static_params`"
+    );
+    assert_eq!(
+        cost_jacobian.len(),
+        NUM_DECISION_VARIABLES,
+        "wrong length of `cost_jacobian`"
+    );
+
+    let arguments = &[u.as_ptr(), xi.as_ptr(), static_params.as_ptr()];
+    let results = &mut [cost_value as *mut Real, cost_jacobian.as_mut_ptr()];
+
+    unsafe {
+        cost_and_grad_function_{{ meta.optimizer_name }}(
+            workspace.ws,
+            arguments.as_ptr(),
+            results.as_mut_ptr()
+        ) as i32
+    }
+}
+{% endif %}
 
 
 /// Consume mapping F1, which has been generated by CasADi
@@ -171,6 +299,7 @@ pub fn grad(u: &[f64], xi: &[f64], static_params: &[f64], cost_jacobian: &mut [f
 ///
 /// ## Arguments
 ///
+/// - `workspace`: CasADi workspace
 /// - `u`: (in) decision variables
 /// - `p`: (in) vector of parameters
 /// - `f1`: (out) value F2(u, p)
@@ -180,9 +309,10 @@ pub fn grad(u: &[f64], xi: &[f64], static_params: &[f64], cost_jacobian: &mut [f
 /// Returns `0` iff the computation is successful
 ///
 pub fn mapping_f1(
-    u: &[f64],
-    static_params: &[f64],
-    f1: &mut [f64],
+    workspace: &CasadiWorkspace,
+    u: &[Real],
+    static_params: &[Real],
+    f1: &mut [Real],
 ) -> i32 {
     assert_eq!(
         u.len(),
@@ -204,6 +334,7 @@ pub fn mapping_f1(
 
     unsafe {
          mapping_f1_function_{{ meta.optimizer_name }}(
+            workspace.ws,
             arguments.as_ptr(),
             constraints.as_mut_ptr()
         ) as i32
@@ -216,6 +347,7 @@ pub fn mapping_f1(
 ///
 /// ## Arguments
 ///
+/// - `workspace`: CasADi workspace
 /// - `u`: (in) decision variables
 /// - `p`: (in) vector of parameters
 /// - `f2`: (out) value F2(u, p)
@@ -224,9 +356,10 @@ pub fn mapping_f1(
 ///
 /// Returns `0` iff the computation is successful
 pub fn mapping_f2(
-    u: &[f64],
-    static_params: &[f64],
-    f2: &mut [f64],
+    workspace: &CasadiWorkspace,
+    u: &[Real],
+    static_params: &[Real],
+    f2: &mut [Real],
 ) -> i32 {
     assert_eq!(
         u.len(),
@@ -248,6 +381,7 @@ pub fn mapping_f2(
 
     unsafe {
          mapping_f2_function_{{ meta.optimizer_name }}(
+            workspace.ws,
             arguments.as_ptr(),
             constraints.as_mut_ptr()
         ) as i32
@@ -257,12 +391,13 @@ pub fn mapping_f2(
 
 
 pub fn precondition(
-    u: &[f64],
-    static_params: &[f64],
+    workspace: &CasadiWorkspace,
+    u: &[Real],
+    static_params: &[Real],
 ) -> i32 {
     let arguments = &[u.as_ptr(), static_params.as_ptr()];
     unsafe {
-         preconditioning_www_{{ meta.optimizer_name }}(arguments.as_ptr()) as i32
+         preconditioning_www_{{ meta.optimizer_name }}(workspace.ws, arguments.as_ptr()) as i32
     }
 }
 
@@ -270,16 +405,18 @@ pub fn precondition(
 ///
 /// Make sure that you have called init_{{ meta.optimizer_name }}
 pub fn initial_penalty(
-    u: &[f64],
-    static_params: &[f64],
-    rho_init: &mut f64,) -> i32 {
+    workspace: &CasadiWorkspace,
+    u: &[Real],
+    static_params: &[Real],
+    rho_init: &mut Real,) -> i32 {
 
     // preconditioning_init_penalty_function_{{ meta.optimizer_name }}
     let arguments = &[u.as_ptr(), static_params.as_ptr()];
-    let ip = &mut [rho_init as *mut c_double];
+    let ip = &mut [rho_init as *mut c_real];
 
     unsafe {
          init_penalty_function_{{ meta.optimizer_name }}(
+            workspace.ws,
             arguments.as_ptr(),
             ip.as_mut_ptr(),
         ) as i32
@@ -296,7 +433,8 @@ mod tests {
         let p = [0.1; NUM_STATIC_PARAMETERS];
         let xi = [2.0; NUM_CONSTRAINTS_TYPE_ALM+1];
         let mut cost = 0.0;
-        assert_eq!(0, super::cost(&u, &xi, &p, &mut cost));
+        let workspace = CasadiWorkspace::new();
+        assert_eq!(0, super::cost(&workspace, &u, &xi, &p, &mut cost));
     }
 
     #[test]
@@ -305,15 +443,33 @@ mod tests {
         let p = [0.1; NUM_STATIC_PARAMETERS];
         let xi = [10.0; NUM_CONSTRAINTS_TYPE_ALM+1];
         let mut grad = [0.0; NUM_DECISION_VARIABLES];
-        assert_eq!(0, super::grad(&u, &xi, &p, &mut grad));
+        let workspace = CasadiWorkspace::new();
+        assert_eq!(0, super::grad(&workspace, &u, &xi, &p, &mut grad));
+    }
+    {% if solver_config.fused_cost_and_gradient %}
+    #[test]
+    fn tst_call_cost_and_grad() {
+        let u = [0.1; NUM_DECISION_VARIABLES];
+        let p = [0.1; NUM_STATIC_PARAMETERS];
+        let xi = [10.0; NUM_CONSTRAINTS_TYPE_ALM+1];
+        let (mut cost, mut grad) = (0.0, [0.0; NUM_DECISION_VARIABLES]);
+        let (mut cost_expected, mut grad_expected) = (0.0, [0.0; NUM_DECISION_VARIABLES]);
+        let workspace = CasadiWorkspace::new();
+        assert_eq!(0, super::cost_and_grad(&workspace, &u, &xi, &p, &mut cost, &mut grad));
+        assert_eq!(0, super::cost(&workspace, &u, &xi, &p, &mut cost_expected));
+        assert_eq!(0, super::grad(&workspace, &u, &xi, &p, &mut grad_expected));
+        assert_eq!(cost_expected, cost);
+        assert_eq!(grad_expected, grad);
     }
+    {% endif %}
 
     #[test]
     fn tst_f1() {
         let u = [0.1; NUM_DECISION_VARIABLES];
         let p = [0.1; NUM_STATIC_PARAMETERS];
         let mut f1up = [0.0; NUM_CONSTRAINTS_TYPE_ALM];
-        assert_eq!(0, super::mapping_f1(&u, &p, &mut f1up));
+        let workspace = CasadiWorkspace::new();
+        assert_eq!(0, super::mapping_f1(&workspace, &u, &p, &mut f1up));
     }
 
     #[test]
@@ -321,19 +477,56 @@ mod tests {
         let u = [0.1; NUM_DECISION_VARIABLES];
         let p = [0.1; NUM_STATIC_PARAMETERS];
         let mut f2up = [0.0; NUM_CONSTRAINTS_TYPE_PENALTY];
-        assert_eq!(0, super::mapping_f2(&u, &p, &mut f2up));
+        let workspace = CasadiWorkspace::new();
+        assert_eq!(0, super::mapping_f2(&workspace, &u, &p, &mut f2up));
     }
 
     #[test]
     fn tst_compute_rho_init() {
         let u = [1.5; NUM_DECISION_VARIABLES];
         let p = [2.0; NUM_STATIC_PARAMETERS];
-        let mut rh0 : f64 = 0.;
-        init_{{ meta.optimizer_name }}();
-        assert_eq!(0, precondition(&u, &p));
-        assert_eq!(0, initial_penalty(&u, &p, &mut rh0));
+        let mut rh0 : Real = 0.;
+        let workspace = CasadiWorkspace::new();
+        init_{{ meta.optimizer_name }}(&workspace);
+        assert_eq!(0, precondition(&workspace, &u, &p));
+        assert_eq!(0, initial_penalty(&workspace, &u, &p, &mut rh0));
         println!("rho = {}", rh0);
     }
 
+    #[test]
+    fn tst_independent_workspaces() {
+        let u = [1.5; NUM_DECISION_VARIABLES];
+        let p = [2.0; NUM_STATIC_PARAMETERS];
+        let workspace_1 = CasadiWorkspace::new();
+        let workspace_2 = CasadiWorkspace::new();
+        assert_eq!(0, precondition(&workspace_1, &u, &p));
+        // preconditioning the first workspace does not affect the second one
+        assert_eq!(1.0, get_w_cost(&workspace_2));
+    }
+
+    #[test]
+    fn tst_concurrent_cost() {
+        let handles: Vec<_> = (0..4)
+            .map(|i| {
+                std::thread::spawn(move || {
+                    let workspace = CasadiWorkspace::new();
+                    let u = [0.1 * i as Real; NUM_DECISION_VARIABLES];
+                    let p = [0.1; NUM_STATIC_PARAMETERS];
+                    let xi = [2.0; NUM_CONSTRAINTS_TYPE_ALM+1];
+                    let mut cost = 0.0;
+                    let mut cost_again = 0.0;
+                    for _ in 0..100 {
+                        assert_eq!(0, super::cost(&workspace, &u, &xi, &p, &mut cost));
+                    }
+                    assert_eq!(0, super::cost(&workspace, &u, &xi, &p, &mut cost_again));
+                    assert_eq!(cost, cost_again);
+                })
+            })
+            .collect();
+        for handle in handles {
+            handle.join().unwrap();
+        }
+    }
+
 }
 
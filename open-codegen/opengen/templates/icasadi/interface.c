@@ -56,7 +56,7 @@
 
 
 #ifndef casadi_real
-#define casadi_real double
+#define casadi_real {{ 'float' if solver_config.single_precision else 'double' }}
 #endif
 
 #ifndef casadi_int
@@ -85,6 +85,17 @@ extern int {{meta.grad_function_name  or 'grad_phi'}}(
     casadi_int* iw,
     casadi_real* w,
     void* mem);
+{% if solver_config.fused_cost_and_gradient %}
+/*
+ * CasADi interface for the cost and its gradient (fused)
+ */
+extern int {{ meta.cost_and_grad_function_name }}(
+    const casadi_real** arg,
+    casadi_real** res,
+    casadi_int* iw,
+    casadi_real* w,
+    void* mem);
+{% endif %}
 
 /*
  * CasADi interface for the gradient of mapping F1
@@ -148,171 +159,6 @@ extern int {{meta.initial_penalty_function_name}}(
     void* mem);
 
 
-/* ------WORKSPACES------------------------------------------------------------- */
-
-/*
- * Integer workspaces
- */
-#if COST_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_cost[COST_SZ_IW_{{ meta.optimizer_name | upper}}];  /* cost (int )  */
-#else
-static casadi_int *allocated_i_workspace_cost = NULL;
-#endif
-
-#if GRAD_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_grad[GRAD_SZ_IW_{{ meta.optimizer_name | upper}}];  /* grad (int )  */
-#else
-static casadi_int *allocated_i_workspace_grad = NULL;
-#endif
-
-#if F1_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_f1[F1_SZ_IW_{{ meta.optimizer_name | upper}}];      /* f1 (int )    */
-#else
-static casadi_int *allocated_i_workspace_f1 = NULL;
-#endif
-
-#if F2_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_f2[F2_SZ_IW_{{ meta.optimizer_name | upper}}];      /* f2 (int )    */
-#else
-static casadi_int *allocated_i_workspace_f2 = NULL;
-#endif
-
-#if W_COST_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_w_cost[W_COST_SZ_IW_{{ meta.optimizer_name | upper}}];      /* w_cost (int )    */
-#else
-static casadi_int *allocated_i_workspace_w_cost = NULL;
-#endif
-
-#if W1_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_w1[W1_SZ_IW_{{ meta.optimizer_name | upper}}];      /* w1 (int )    */
-#else
-static casadi_int *allocated_i_workspace_w1 = NULL;
-#endif
-
-#if W2_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_w2[W2_SZ_IW_{{ meta.optimizer_name | upper}}];      /* w2 (int )    */
-#else
-static casadi_int *allocated_i_workspace_w2 = NULL;
-#endif
-
-#if INIT_PENALTY_SZ_IW_{{ meta.optimizer_name | upper}} > 0
-static casadi_int allocated_i_workspace_init_penalty[INIT_PENALTY_SZ_IW_{{ meta.optimizer_name | upper}}];      /* init_penalty (int )    */
-#else
-static casadi_int *allocated_i_workspace_init_penalty = NULL;
-#endif
-
-
-/*
- * Real workspaces
- */
-#if COST_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_cost[COST_SZ_W_{{ meta.optimizer_name | upper}}];  /* cost (real)  */
-#else
-static casadi_real *allocated_r_workspace_cost = NULL;
-#endif
-
-
-#if GRAD_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_grad[GRAD_SZ_W_{{ meta.optimizer_name | upper}}];  /* grad (real ) */
-#else
-static casadi_real *allocated_r_workspace_grad = NULL;
-#endif
-
-#if F1_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_f1[F1_SZ_W_{{ meta.optimizer_name | upper}}];      /* f1 (real )   */
-#else
-static casadi_real *allocated_r_workspace_f1 = NULL;
-#endif
-
-#if F2_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_f2[F2_SZ_W_{{ meta.optimizer_name | upper}}];      /* f2 (real )   */
-#else
-static casadi_real *allocated_r_workspace_f2 = NULL;
-#endif
-
-#if W_COST_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_w_cost[W_COST_SZ_W_{{ meta.optimizer_name | upper}}];      /* w_cost (real )   */
-#else
-static casadi_real *allocated_r_workspace_w_cost = NULL;
-#endif
-
-#if W1_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_w1[W1_SZ_W_{{ meta.optimizer_name | upper}}];      /* w1 (real )   */
-#else
-static casadi_real *allocated_r_workspace_w1 = NULL;
-#endif
-
-#if W2_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_w2[W2_SZ_W_{{ meta.optimizer_name | upper}}];      /* w2 (real )   */
-#else
-static casadi_real *allocated_r_workspace_w2 = NULL;
-#endif
-
-#if INIT_PENALTY_SZ_W_{{ meta.optimizer_name | upper}} > 0
-static casadi_real allocated_r_workspace_init_penalty[INIT_PENALTY_SZ_W_{{ meta.optimizer_name | upper}}];      /* init_penalty (real )   */
-#else
-static casadi_real *allocated_r_workspace_init_penalty = NULL;
-#endif
-
-/*
- * Result workspaces
- */
-#if COST_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_cost[COST_SZ_RES_{{ meta.optimizer_name | upper}}];       /* cost (res )  */
-#else
-static casadi_real **result_space_cost = NULL;
-#endif
-
-#if GRAD_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_grad[GRAD_SZ_RES_{{ meta.optimizer_name | upper}}];        /* grad (res )  */
-#else
-static casadi_real **result_space_grad = NULL;
-#endif
-
-
-#if F1_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_f1[F1_SZ_RES_{{ meta.optimizer_name | upper}}];            /* f1 (res )    */
-#else
-static casadi_real **result_space_f1 = NULL;
-#endif
-
-
-#if F2_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_f2[F2_SZ_RES_{{ meta.optimizer_name | upper}}];            /* f2 (res )    */
-#else
-static casadi_real **result_space_f2 = NULL;
-#endif
-
-
-#if W_COST_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_w_cost[W_COST_SZ_RES_{{ meta.optimizer_name | upper}}];            /* w_cost (res )    */
-#else
-static casadi_real **result_space_w_cost = NULL;
-#endif
-
-
-#if W1_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_w1[W1_SZ_RES_{{ meta.optimizer_name | upper}}];            /* w1 (res )    */
-#else
-static casadi_real **result_space_w1 = NULL;
-#endif
-
-
-#if W2_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_w2[W2_SZ_RES_{{ meta.optimizer_name | upper}}];            /* w2 (res )    */
-#else
-static casadi_real **result_space_w2 = NULL;
-#endif
-
-
-#if INIT_PENALTY_SZ_RES_{{ meta.optimizer_name | upper}} > 0
-static casadi_real *result_space_init_penalty[INIT_PENALTY_SZ_RES_{{ meta.optimizer_name | upper}}];            /* init_penalty (res )    */
-#else
-static casadi_real **result_space_init_penalty = NULL;
-#endif
-
-
-
 /* ------U, XI, P, W------------------------------------------------------------ */
 
 /*
@@ -364,38 +210,125 @@ static casadi_real **result_space_init_penalty = NULL;
 #define IDX_W2_{{ meta.optimizer_name | upper}} IDX_W1_{{ meta.optimizer_name | upper}} + N1_{{ meta.optimizer_name | upper}}
 #define N_UXIPW_{{ meta.optimizer_name | upper}} IDX_W2_{{ meta.optimizer_name | upper}} + N2_{{ meta.optimizer_name | upper}}
 
-static casadi_real uxip_space[N_UXIPW_{{ meta.optimizer_name | upper}}];
+
+/* ------WORKSPACES------------------------------------------------------------- */
+
+/*
+ * Length of a workspace array; CasADi may report a size of zero, but
+ * C does not allow arrays of length zero, so we allocate one element
+ */
+#define WS_LEN_{{ meta.optimizer_name | upper}}(sz) ((sz) > 0 ? (sz) : 1)
+
+/*
+ * Workspace of one instance of the solver
+ *
+ * All memory that CasADi needs to evaluate the cost, the gradient, the
+ * mappings F1 and F2 and the preconditioning functions is stored here,
+ * together with uxip_space, which also holds the preconditioning weights.
+ * Nothing is shared between two instances, so different instances can be
+ * used concurrently from different threads. A single instance must not
+ * be used by two threads at the same time.
+ */
+typedef struct {
+    /* Integer workspaces */
+    casadi_int i_workspace_cost[WS_LEN_{{ meta.optimizer_name | upper}}(COST_SZ_IW_{{ meta.optimizer_name | upper}})];
+    casadi_int i_workspace_grad[WS_LEN_{{ meta.optimizer_name | upper}}(GRAD_SZ_IW_{{ meta.optimizer_name | upper}})];
+{% if solver_config.fused_cost_and_gradient %}    casadi_int i_workspace_cost_and_grad[WS_LEN_{{ meta.optimizer_name | upper}}(COST_AND_GRAD_SZ_IW_{{ meta.optimizer_name | upper}})];
+{% endif %}
+    casadi_int i_workspace_f1[WS_LEN_{{ meta.optimizer_name | upper}}(F1_SZ_IW_{{ meta.optimizer_name | upper}})];
+    casadi_int i_workspace_f2[WS_LEN_{{ meta.optimizer_name | upper}}(F2_SZ_IW_{{ meta.optimizer_name | upper}})];
+    casadi_int i_workspace_w_cost[WS_LEN_{{ meta.optimizer_name | upper}}(W_COST_SZ_IW_{{ meta.optimizer_name | upper}})];
+    casadi_int i_workspace_w1[WS_LEN_{{ meta.optimizer_name | upper}}(W1_SZ_IW_{{ meta.optimizer_name | upper}})];
+    casadi_int i_workspace_w2[WS_LEN_{{ meta.optimizer_name | upper}}(W2_SZ_IW_{{ meta.optimizer_name | upper}})];
+    casadi_int i_workspace_init_penalty[WS_LEN_{{ meta.optimizer_name | upper}}(INIT_PENALTY_SZ_IW_{{ meta.optimizer_name | upper}})];
+
+    /* Real workspaces */
+    casadi_real r_workspace_cost[WS_LEN_{{ meta.optimizer_name | upper}}(COST_SZ_W_{{ meta.optimizer_name | upper}})];
+    casadi_real r_workspace_grad[WS_LEN_{{ meta.optimizer_name | upper}}(GRAD_SZ_W_{{ meta.optimizer_name | upper}})];
+{% if solver_config.fused_cost_and_gradient %}    casadi_real r_workspace_cost_and_grad[WS_LEN_{{ meta.optimizer_name | upper}}(COST_AND_GRAD_SZ_W_{{ meta.optimizer_name | upper}})];
+{% endif %}
+    casadi_real r_workspace_f1[WS_LEN_{{ meta.optimizer_name | upper}}(F1_SZ_W_{{ meta.optimizer_name | upper}})];
+    casadi_real r_workspace_f2[WS_LEN_{{ meta.optimizer_name | upper}}(F2_SZ_W_{{ meta.optimizer_name | upper}})];
+    casadi_real r_workspace_w_cost[WS_LEN_{{ meta.optimizer_name | upper}}(W_COST_SZ_W_{{ meta.optimizer_name | upper}})];
+    casadi_real r_workspace_w1[WS_LEN_{{ meta.optimizer_name | upper}}(W1_SZ_W_{{ meta.optimizer_name | upper}})];
+    casadi_real r_workspace_w2[WS_LEN_{{ meta.optimizer_name | upper}}(W2_SZ_W_{{ meta.optimizer_name | upper}})];
+    casadi_real r_workspace_init_penalty[WS_LEN_{{ meta.optimizer_name | upper}}(INIT_PENALTY_SZ_W_{{ meta.optimizer_name | upper}})];
+
+    /* Result workspaces */
+    casadi_real *result_space_cost[WS_LEN_{{ meta.optimizer_name | upper}}(COST_SZ_RES_{{ meta.optimizer_name | upper}})];
+    casadi_real *result_space_grad[WS_LEN_{{ meta.optimizer_name | upper}}(GRAD_SZ_RES_{{ meta.optimizer_name | upper}})];
+{% if solver_config.fused_cost_and_gradient %}    casadi_real *result_space_cost_and_grad[WS_LEN_{{ meta.optimizer_name | upper}}(COST_AND_GRAD_SZ_RES_{{ meta.optimizer_name | upper}})];
+{% endif %}
+    casadi_real *result_space_f1[WS_LEN_{{ meta.optimizer_name | upper}}(F1_SZ_RES_{{ meta.optimizer_name | upper}})];
+    casadi_real *result_space_f2[WS_LEN_{{ meta.optimizer_name | upper}}(F2_SZ_RES_{{ meta.optimizer_name | upper}})];
+    casadi_real *result_space_w_cost[WS_LEN_{{ meta.optimizer_name | upper}}(W_COST_SZ_RES_{{ meta.optimizer_name | upper}})];
+    casadi_real *result_space_w1[WS_LEN_{{ meta.optimizer_name | upper}}(W1_SZ_RES_{{ meta.optimizer_name | upper}})];
+    casadi_real *result_space_w2[WS_LEN_{{ meta.optimizer_name | upper}}(W2_SZ_RES_{{ meta.optimizer_name | upper}})];
+    casadi_real *result_space_init_penalty[WS_LEN_{{ meta.optimizer_name | upper}}(INIT_PENALTY_SZ_RES_{{ meta.optimizer_name | upper}})];
+
+    /* Space for (u, xi, p, w) */
+    casadi_real uxip_space[N_UXIPW_{{ meta.optimizer_name | upper}}];
+} workspace_{{ meta.optimizer_name }};
+
+/**
+ * Size of the workspace in bytes
+ */
+size_t workspace_size_{{ meta.optimizer_name }}(void) {
+    return sizeof(workspace_{{ meta.optimizer_name }});
+}
 
 /**
  * Return scaling factor of cost function (getter)
  */
-casadi_real get_w_cost_{{ meta.optimizer_name }}(void) {
-    return uxip_space[IDX_WC_{{ meta.optimizer_name | upper}}];
+casadi_real get_w_cost_{{ meta.optimizer_name }}(const workspace_{{ meta.optimizer_name }} *ws) {
+    return ws->uxip_space[IDX_WC_{{ meta.optimizer_name | upper}}];
 }
 
 /**
  * This function should be called upon initialisation. The sets all w's to 1.
  */
-void init_interface_{{ meta.optimizer_name }}(void) {
+void init_interface_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws) {
     unsigned int i;
     unsigned int offset = IDX_WC_{{ meta.optimizer_name | upper}};
     unsigned int len = N1_{{ meta.optimizer_name | upper}} + N2_{{ meta.optimizer_name | upper}} + 1;
     for (i = 0; i < len; i++) {
-        uxip_space[offset + i] = 1.0;
+        ws->uxip_space[offset + i] = 1.0;
+    }
+}
+
+/**
+ * Allocate a new workspace and initialise it (all w's are set to 1)
+ *
+ * Returns NULL if the memory cannot be allocated. The workspace must
+ * be deallocated using `workspace_free_{{ meta.optimizer_name }}`.
+ */
+workspace_{{ meta.optimizer_name }} *workspace_new_{{ meta.optimizer_name }}(void) {
+    workspace_{{ meta.optimizer_name }} *ws = (workspace_{{ meta.optimizer_name }} *) calloc(1, sizeof(workspace_{{ meta.optimizer_name }}));
+    if (ws != NULL) {
+        init_interface_{{ meta.optimizer_name }}(ws);
     }
+    return ws;
+}
+
+/**
+ * Deallocate a workspace which was allocated with `workspace_new_{{ meta.optimizer_name }}`
+ */
+void workspace_free_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws) {
+    free(ws);
 }
 
 /**
  * Copy (u, xi, p) into uxip_space
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, xi, p}`, where `u`, `xi` and `p` are pointer-to-double
  */
-static void copy_args_into_uxip_space(const casadi_real** arg) {
+static void copy_args_into_uxip_space(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg) {
     unsigned int i;
-    for (i=0; i<NU_{{ meta.optimizer_name | upper}}; i++)  uxip_space[i] = arg[0][i];  /* copy u  */
-    for (i=0; i<NXI_{{ meta.optimizer_name | upper}}; i++) uxip_space[IDX_XI_{{ meta.optimizer_name | upper}}+i] = arg[1][i];  /* copy xi */
-    for (i=0; i<NP_{{ meta.optimizer_name | upper}}; i++)  uxip_space[IDX_P_{{ meta.optimizer_name | upper}}+i] = arg[2][i];  /* copy p  */
+    for (i=0; i<NU_{{ meta.optimizer_name | upper}}; i++)  ws->uxip_space[i] = arg[0][i];  /* copy u  */
+    for (i=0; i<NXI_{{ meta.optimizer_name | upper}}; i++) ws->uxip_space[IDX_XI_{{ meta.optimizer_name | upper}}+i] = arg[1][i];  /* copy xi */
+    for (i=0; i<NP_{{ meta.optimizer_name | upper}}; i++)  ws->uxip_space[IDX_P_{{ meta.optimizer_name | upper}}+i] = arg[2][i];  /* copy p  */
 }
 
 
@@ -403,12 +336,13 @@ static void copy_args_into_uxip_space(const casadi_real** arg) {
  * Copy (u, p) into uxip_space
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, p}`, where `u` and `p` are pointer-to-double
  */
-static void copy_args_into_up_space(const casadi_real** arg) {
+static void copy_args_into_up_space(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg) {
     unsigned int i;
-    for (i=0; i<NU_{{ meta.optimizer_name | upper}}; i++) uxip_space[i] = arg[0][i];  /* copy u  */
-    for (i=0; i<NP_{{ meta.optimizer_name | upper}}; i++) uxip_space[IDX_P_{{ meta.optimizer_name | upper}}+i] = arg[1][i];  /* copy p  */
+    for (i=0; i<NU_{{ meta.optimizer_name | upper}}; i++) ws->uxip_space[i] = arg[0][i];  /* copy u  */
+    for (i=0; i<NP_{{ meta.optimizer_name | upper}}; i++) ws->uxip_space[IDX_P_{{ meta.optimizer_name | upper}}+i] = arg[1][i];  /* copy p  */
 }
 
 
@@ -416,22 +350,23 @@ static void copy_args_into_up_space(const casadi_real** arg) {
  * Cost function
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, xi, p}`, where `u`, `xi`, and `p` are pointer-to-double
  * - `res = {cost}`, where `cost` is a pointer-to-double
  */
-int cost_function_{{ meta.optimizer_name }}(const casadi_real** arg, casadi_real** res) {
+int cost_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg, casadi_real** res) {
     const casadi_real* args__[COST_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-             {uxip_space,  /* :u  */
-              uxip_space + IDX_XI_{{ meta.optimizer_name | upper}},   /* :xi  */
-              uxip_space + IDX_P_{{ meta.optimizer_name | upper}} };  /* :p  */
-    copy_args_into_uxip_space(arg);
+             {ws->uxip_space,  /* :u  */
+              ws->uxip_space + IDX_XI_{{ meta.optimizer_name | upper}},   /* :xi  */
+              ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}} };  /* :p  */
+    copy_args_into_uxip_space(ws, arg);
 
-    result_space_cost[0] = res[0];
+    ws->result_space_cost[0] = res[0];
     return {{meta.cost_function_name or 'phi'}}(
         args__,
-        result_space_cost,
-        allocated_i_workspace_cost,
-        allocated_r_workspace_cost,
+        ws->result_space_cost,
+        ws->i_workspace_cost,
+        ws->r_workspace_cost,
         (void*) 0);
 }
 
@@ -440,52 +375,79 @@ int cost_function_{{ meta.optimizer_name }}(const casadi_real** arg, casadi_real
  * Gradient function
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, xi, p}`, where `u`, `xi`, and `p` are pointer-to-double
  * - `res = {grad}`, where `grad` is a pointer-to-double
  */
-int grad_cost_function_{{ meta.optimizer_name }}(const casadi_real** arg, casadi_real** res) {
+int grad_cost_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg, casadi_real** res) {
     const casadi_real* args__[GRAD_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            { uxip_space,  /* :u  */
-              uxip_space + IDX_XI_{{ meta.optimizer_name | upper}},  /* :xi  */
-              uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
-    copy_args_into_uxip_space(arg);
-    result_space_grad[0] = res[0];
+            { ws->uxip_space,  /* :u  */
+              ws->uxip_space + IDX_XI_{{ meta.optimizer_name | upper}},  /* :xi  */
+              ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
+    copy_args_into_uxip_space(ws, arg);
+    ws->result_space_grad[0] = res[0];
     return {{meta.grad_function_name  or 'grad_phi'}}(
         args__,
-        result_space_grad,
-        allocated_i_workspace_grad,
-        allocated_r_workspace_grad,
+        ws->result_space_grad,
+        ws->i_workspace_grad,
+        ws->r_workspace_grad,
+        (void*) 0);
+}
+{% if solver_config.fused_cost_and_gradient %}
+/**
+ * Cost function and its gradient (fused)
+ *
+ * Input arguments:
+ * - `ws`: workspace of this instance
+ * - `arg = {u, xi, p}`, where `u`, `xi`, and `p` are pointer-to-double
+ * - `res = {cost, grad}`, where `cost` and `grad` are pointer-to-double
+ */
+int cost_and_grad_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg, casadi_real** res) {
+    const casadi_real* args__[COST_AND_GRAD_SZ_ARG_{{ meta.optimizer_name | upper}}] =
+            { ws->uxip_space,  /* :u  */
+              ws->uxip_space + IDX_XI_{{ meta.optimizer_name | upper}},  /* :xi  */
+              ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
+    copy_args_into_uxip_space(ws, arg);
+    ws->result_space_cost_and_grad[0] = res[0];
+    ws->result_space_cost_and_grad[1] = res[1];
+    return {{ meta.cost_and_grad_function_name }}(
+        args__,
+        ws->result_space_cost_and_grad,
+        ws->i_workspace_cost_and_grad,
+        ws->r_workspace_cost_and_grad,
         (void*) 0);
 }
+{% endif %}
 
 /**
  * Mapping F1
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, p}`, where `u` and `p` are pointer-to-double
  * - `res = {F1}`, where `F1` is a pointer-to-double
  */
-int mapping_f1_function_{{ meta.optimizer_name }}(const casadi_real** arg, casadi_real** res) {
+int mapping_f1_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg, casadi_real** res) {
     /* Array of pointers to where (u, p) are stored */
     const casadi_real* args__[F1_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            {uxip_space,  /* :u   */
-            uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p  */
+            {ws->uxip_space,  /* :u   */
+            ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p  */
     /* Copy given data to variable `uxip_space` */
-    copy_args_into_up_space(arg);
+    copy_args_into_up_space(ws, arg);
     /*
      * The result should be written in result_space_f1
-     * (memory has been allocated - see beginning of this file)
+     * (memory has been allocated in the workspace)
      */
-    result_space_f1[0] = res[0];
+    ws->result_space_f1[0] = res[0];
     /*
      * Call auto-generated function {{meta.alm_mapping_f1_function_name}}
      * Implemented in: icasadi/extern/auto_casadi_mapping_f1.c
      */
     return {{meta.alm_mapping_f1_function_name}}(
         args__,
-        result_space_f1,
-        allocated_i_workspace_f1,
-        allocated_r_workspace_f1,
+        ws->result_space_f1,
+        ws->i_workspace_f1,
+        ws->r_workspace_f1,
         (void*) 0);
 }
 
@@ -494,30 +456,31 @@ int mapping_f1_function_{{ meta.optimizer_name }}(const casadi_real** arg, casad
  * Mapping F2
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, p}`, where `u` and `p` are pointer-to-double
  * - `res = {F1}`, where `F1` is a pointer-to-double
  */
-int mapping_f2_function_{{ meta.optimizer_name }}(const casadi_real** arg, casadi_real** res) {
+int mapping_f2_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg, casadi_real** res) {
     /* Array of pointers to where (u, p) are stored */
     const casadi_real* args__[F2_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            {uxip_space,  /* :u   */
-             uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
+            {ws->uxip_space,  /* :u   */
+             ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
     /* Copy given data to variable `uxip_space` */
-    copy_args_into_up_space(arg);
+    copy_args_into_up_space(ws, arg);
     /*
      * The result should be written in result_space_f2
-     * (memory has been allocated - see beginning of this file)
+     * (memory has been allocated in the workspace)
      */
-    result_space_f2[0] = res[0];
+    ws->result_space_f2[0] = res[0];
     /*
      * Call auto-generated function {{meta.constraint_penalty_function_name}}
      * Implemented in: icasadi/extern/auto_casadi_mapping_f2.c
      */
     return {{meta.constraint_penalty_function_name}}(
         args__,
-        result_space_f2,
-        allocated_i_workspace_f2,
-        allocated_r_workspace_f2,
+        ws->result_space_f2,
+        ws->i_workspace_f2,
+        ws->r_workspace_f2,
         (void*) 0);
 }
 
@@ -525,29 +488,30 @@ int mapping_f2_function_{{ meta.optimizer_name }}(const casadi_real** arg, casad
  * Interface to auto-generated CasADi function for w_cost(u, p)
  *
  * Input arguments:
+ *  - ws  = workspace of this instance
  *  - arg = {u, theta}
  */
-static int preconditioning_w_cost_function_{{ meta.optimizer_name }}(const casadi_real** arg) {
+static int preconditioning_w_cost_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg) {
     /* Array of pointers to where (u, p) are stored */
     const casadi_real* args__[W_COST_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            {uxip_space,  /* :u   */
-             uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
+            {ws->uxip_space,  /* :u   */
+             ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
     /* Copy given data to variable `uxip_space` */
-    copy_args_into_up_space(arg);
+    copy_args_into_up_space(ws, arg);
     /*
      * The result should be written in result_space_w_cost
-     * (memory has been allocated - see beginning of this file)
+     * (memory has been allocated in the workspace)
      */
-    result_space_w_cost[0] = uxip_space + IDX_WC_{{ meta.optimizer_name | upper}};
+    ws->result_space_w_cost[0] = ws->uxip_space + IDX_WC_{{ meta.optimizer_name | upper}};
     /*
      * Call auto-generated function {{meta.w_cost_function_name}}
      * Implemented in: icasadi/extern/auto_preconditioning_functions.c
      */
     return {{meta.w_cost_function_name}}(
         args__,
-        result_space_w_cost,
-        allocated_i_workspace_w_cost,
-        allocated_r_workspace_w_cost,
+        ws->result_space_w_cost,
+        ws->i_workspace_w_cost,
+        ws->r_workspace_w_cost,
         (void*) 0);
 }
 
@@ -555,27 +519,27 @@ static int preconditioning_w_cost_function_{{ meta.optimizer_name }}(const casad
  * Interface to auto-generated CasADi function for w1(u, p), which computes an
  * n1-dimensional vector of scaling parameters
  */
-static int preconditioning_w1_function_{{ meta.optimizer_name }}(const casadi_real** arg) {
+static int preconditioning_w1_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg) {
     /* Array of pointers to where (u, p) are stored */
     const casadi_real* args__[W1_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            {uxip_space,  /* :u   */
-             uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
+            {ws->uxip_space,  /* :u   */
+             ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
     /* Copy given data to variable `uxip_space` */
-    copy_args_into_up_space(arg);
+    copy_args_into_up_space(ws, arg);
     /*
      * The result should be written in result_space_w1
-     * (memory has been allocated - see beginning of this file)
+     * (memory has been allocated in the workspace)
      */
-    result_space_w1[0] = uxip_space + IDX_W1_{{ meta.optimizer_name | upper}};
+    ws->result_space_w1[0] = ws->uxip_space + IDX_W1_{{ meta.optimizer_name | upper}};
     /*
      * Call auto-generated function {{meta.w_f1_function_name}}
      * Implemented in: icasadi/extern/auto_preconditioning_functions.c
      */
     return {{meta.w_f1_function_name}}(
         args__,
-        result_space_w1,
-        allocated_i_workspace_w1,
-        allocated_r_workspace_w1,
+        ws->result_space_w1,
+        ws->i_workspace_w1,
+        ws->r_workspace_w1,
         (void*) 0);
 }
 
@@ -583,27 +547,27 @@ static int preconditioning_w1_function_{{ meta.optimizer_name }}(const casadi_re
  * Interface to auto-generated CasADi function for w2(u, p), which computes an
  * n2-dimensional vector of scaling parameters
  */
-static int preconditioning_w2_function_{{ meta.optimizer_name }}(const casadi_real** arg) {
+static int preconditioning_w2_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg) {
     /* Array of pointers to where (u, p) are stored */
     const casadi_real* args__[W2_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            {uxip_space,  /* :u   */
-             uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
+            {ws->uxip_space,  /* :u   */
+             ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :p   */
     /* Copy given data to variable `uxip_space` */
-    copy_args_into_up_space(arg);
+    copy_args_into_up_space(ws, arg);
     /*
      * The result should be written in result_space_w2
-     * (memory has been allocated - see beginning of this file)
+     * (memory has been allocated in the workspace)
      */
-    result_space_w2[0] = uxip_space + IDX_W2_{{ meta.optimizer_name | upper}};
+    ws->result_space_w2[0] = ws->uxip_space + IDX_W2_{{ meta.optimizer_name | upper}};
     /*
      * Call auto-generated function {{meta.w_f2_function_name}}
      * Implemented in: icasadi/extern/auto_preconditioning_functions.c
      */
     return {{meta.w_f2_function_name}}(
         args__,
-        result_space_w2,
-        allocated_i_workspace_w2,
-        allocated_r_workspace_w2,
+        ws->result_space_w2,
+        ws->i_workspace_w2,
+        ws->r_workspace_w2,
         (void*) 0);
 }
 
@@ -613,6 +577,7 @@ static int preconditioning_w2_function_{{ meta.optimizer_name }}(const casadi_re
  * caller needs to provide p, w_cost, w1 and w2
  *
  * Input arguments:
+ *  - (in )   ws = workspace of this instance
  *  - (in )   arg = {u, p}     pointers to u and p (NOT theta, just p); we don't need to provide the preconditioning
  *                             parameters because they are stored in `uxipw_space`; they are only computed once and
  *                             we don't need to move their values around
@@ -621,27 +586,27 @@ static int preconditioning_w2_function_{{ meta.optimizer_name }}(const casadi_re
  * Output arguments:
  *  - status code (0: all good)
  */
-int init_penalty_function_{{ meta.optimizer_name }}(const casadi_real** arg, casadi_real** res) {
+int init_penalty_function_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg, casadi_real** res) {
     /* Array of pointers to where (u, p) are stored */
     const casadi_real* args__[INIT_PENALTY_SZ_ARG_{{ meta.optimizer_name | upper}}] =
-            {uxip_space,  /* :u   */
-             uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :theta   */
+            {ws->uxip_space,  /* :u   */
+             ws->uxip_space + IDX_P_{{ meta.optimizer_name | upper}}};  /* :theta   */
     /* Copy given data to variable `uxip_space` */
-    copy_args_into_up_space(arg);
+    copy_args_into_up_space(ws, arg);
     /*
      * The result should be written in result_space_init_penalty
-     * (memory has been allocated - see beginning of this file)
+     * (memory has been allocated in the workspace)
      */
-    result_space_init_penalty[0] = res[0];
+    ws->result_space_init_penalty[0] = res[0];
     /*
      * Call auto-generated function {{meta.init_penalty_function_name}}
      * Implemented in: icasadi/extern/auto_preconditioning_functions.c
      */
     return {{meta.initial_penalty_function_name}}(
         args__,
-        result_space_init_penalty,
-        allocated_i_workspace_init_penalty,
-        allocated_r_workspace_init_penalty,
+        ws->result_space_init_penalty,
+        ws->i_workspace_init_penalty,
+        ws->r_workspace_init_penalty,
         (void*) 0);
 }
 
@@ -649,13 +614,14 @@ int init_penalty_function_{{ meta.optimizer_name }}(const casadi_real** arg, cas
  * Compute all preconditioning/scaling factors, w
  *
  * Input arguments:
+ * - `ws`: workspace of this instance
  * - `arg = {u, p}`, where `u` and `p` are pointer-to-double
  */
-int preconditioning_www_{{ meta.optimizer_name }}(const casadi_real** arg) {
+int preconditioning_www_{{ meta.optimizer_name }}(workspace_{{ meta.optimizer_name }} *ws, const casadi_real** arg) {
     int status_ = 0;
-    status_ += preconditioning_w1_function_{{ meta.optimizer_name }}(arg);
-    status_ += preconditioning_w2_function_{{ meta.optimizer_name }}(arg);
-    status_ += preconditioning_w_cost_function_{{ meta.optimizer_name }}(arg);
+    status_ += preconditioning_w1_function_{{ meta.optimizer_name }}(ws, arg);
+    status_ += preconditioning_w2_function_{{ meta.optimizer_name }}(ws, arg);
+    status_ += preconditioning_w_cost_function_{{ meta.optimizer_name }}(ws, arg);
     return status_;
 }
 
@@ -667,6 +633,7 @@ int preconditioning_www_{{ meta.optimizer_name }}(const casadi_real** arg) {
 
 static casadi_real u_test[NU_{{ meta.optimizer_name | upper}}];
 static casadi_real p_test[NP_{{ meta.optimizer_name | upper}}];
+static workspace_{{ meta.optimizer_name }} ws_test;
 
 static void init_up_test(void) {
     unsigned int i;
@@ -678,50 +645,50 @@ static void init_up_test(void) {
     }
 }
 
-static void print_static_array(void){
+static void print_static_array(const workspace_{{ meta.optimizer_name }} *ws){
     unsigned int i;
     for (i=0; i<NU_{{ meta.optimizer_name | upper}}; i++){
-        printf("u[%2d] = %4.2f\n", i, uxip_space[i]);
+        printf("u[%2d] = %4.2f\n", i, ws->uxip_space[i]);
     }
     for (i=0; i<NXI_{{ meta.optimizer_name | upper}}; i++){
-        printf("xi[%2d] = %4.2f\n", i, uxip_space[IDX_XI_{{ meta.optimizer_name | upper}}+i]);
+        printf("xi[%2d] = %4.2f\n", i, ws->uxip_space[IDX_XI_{{ meta.optimizer_name | upper}}+i]);
     }
     for (i=0; i<NP_{{ meta.optimizer_name | upper}}; i++){
-        printf("p[%2d] = %4.2f\n", i, uxip_space[IDX_P_{{ meta.optimizer_name | upper}}+i]);
+        printf("p[%2d] = %4.2f\n", i, ws->uxip_space[IDX_P_{{ meta.optimizer_name | upper}}+i]);
     }
-    printf("w_cost = %g\n", uxip_space[IDX_WC_{{ meta.optimizer_name | upper}}]);
+    printf("w_cost = %g\n", ws->uxip_space[IDX_WC_{{ meta.optimizer_name | upper}}]);
 #if N1_{{ meta.optimizer_name | upper}} > 0
      for (i=0; i<N1_{{ meta.optimizer_name | upper}}; i++){
-        printf("w1[%2d] = %g\n", i, uxip_space[IDX_W1_{{ meta.optimizer_name | upper}}+i]);
+        printf("w1[%2d] = %g\n", i, ws->uxip_space[IDX_W1_{{ meta.optimizer_name | upper}}+i]);
     }
 #endif /* IF N1 > 0 */
 #if N2_{{ meta.optimizer_name | upper}} > 0
      for (i=0; i<N2_{{ meta.optimizer_name | upper}}; i++){
-        printf("w2[%2d] = %g\n", i, uxip_space[IDX_W2_{{ meta.optimizer_name | upper}}+i]);
+        printf("w2[%2d] = %g\n", i, ws->uxip_space[IDX_W2_{{ meta.optimizer_name | upper}}+i]);
     }
 #endif /* IF N2 > 0 */
 }
 
-static casadi_real test_initial_penalty(void) {
+static casadi_real test_initial_penalty(workspace_{{ meta.optimizer_name }} *ws) {
     const casadi_real *args[2] = {u_test, p_test};
     casadi_real initial_penalty = -1.;
     casadi_real *res[1] = { &initial_penalty };
-    init_penalty_function_{{ meta.optimizer_name }}(args, res);
+    init_penalty_function_{{ meta.optimizer_name }}(ws, args, res);
     return initial_penalty;
 }
 
 int main(void) {
-    init_interface_{{ meta.optimizer_name }}();
+    init_interface_{{ meta.optimizer_name }}(&ws_test);
     init_up_test();
     const casadi_real *argz[2] = {u_test, p_test};
-    preconditioning_www_{{ meta.optimizer_name }}(argz);
+    preconditioning_www_{{ meta.optimizer_name }}(&ws_test, argz);
 
     /*
      * Since this is invoked after `test_w_cost`, `test_w1` and `test_w2`, the ws have been computed previously
-     * and are available in `uxipw_space`. The caller does need to provide them
+     * and are available in the workspace. The caller does need to provide them
      */
-    casadi_real rho1 = test_initial_penalty();
-    print_static_array();
+    casadi_real rho1 = test_initial_penalty(&ws_test);
+    print_static_array(&ws_test);
     printf("rho1 = %g\n", rho1);
     return 0;
 }
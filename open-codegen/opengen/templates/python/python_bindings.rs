@@ -1,10 +1,10 @@
 ///
 /// Auto-generated python bindings for optimizer: {{ meta.optimizer_name }}
 ///
-use optimization_engine::alm::*;
-
+use numpy::{PyArray1, PyArray2, PyReadonlyArray1, PyReadonlyArray2};
 use pyo3::prelude::*;
 use pyo3::wrap_pyfunction;
+use std::borrow::Cow;
 
 use {{ meta.optimizer_name }}::*;
 
@@ -12,6 +12,7 @@ use {{ meta.optimizer_name }}::*;
 fn {{ meta.optimizer_name }}(_py: Python, m: &PyModule) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(solver, m)?)?;
     m.add_class::<OptimizerSolution>()?;
+    m.add_class::<BatchSolution>()?;
     m.add_class::<Solver>()?;
     Ok(())
 }
@@ -19,7 +20,36 @@ fn {{ meta.optimizer_name }}(_py: Python, m: &PyModule) -> PyResult<()> {
 #[pyfunction]
 fn solver() -> PyResult<Solver> {
     let cache = initialize_solver();
-    Ok(Solver { cache })
+    Ok(Solver { cache, pool: None })
+}
+
+/// Vector given either as a numpy array of floats, which is read in place, or as a list
+#[derive(FromPyObject)]
+enum Vector<'py> {
+    Array(PyReadonlyArray1<'py, f64>),
+    List(Vec<f64>),
+}
+
+impl<'py> Vector<'py> {
+    /// Contents of the vector (this is a copy only if the array is not contiguous)
+    fn as_slice(&self) -> Cow<[f64]> {
+        match self {
+            Vector::Array(a) => match a.as_slice() {
+                Ok(s) => Cow::Borrowed(s),
+                Err(_) => Cow::Owned(a.as_array().iter().copied().collect()),
+            },
+            Vector::List(v) => Cow::Borrowed(v),
+        }
+    }
+}
+
+/// Contents of a 2-D array in row-major order (this is a copy only if the
+/// array is not C-contiguous)
+fn rows_as_slice<'a>(a: &'a PyReadonlyArray2<f64>) -> Cow<'a, [f64]> {
+    match a.as_slice() {
+        Ok(s) => Cow::Borrowed(s),
+        Err(_) => Cow::Owned(a.as_array().iter().copied().collect()),
+    }
 }
 
 /// Solution and solution status of optimizer
@@ -42,36 +72,72 @@ struct OptimizerSolution {
     #[pyo3(get)]
     penalty: f64,
     #[pyo3(get)]
-    solution: Vec<f64>,
+    solution: Py<PyArray1<f64>>,
     #[pyo3(get)]
-    lagrange_multipliers: Vec<f64>,
+    lagrange_multipliers: Py<PyArray1<f64>>,
     #[pyo3(get)]
     cost: f64,
 }
 
+/// Solutions and solution statuses of a batch of problems
+///
+/// Row `i` of `solution` and `lagrange_multipliers`, and entry `i` of all
+/// other properties, correspond to row `i` of the parameters
+#[pyclass]
+struct BatchSolution {
+    #[pyo3(get)]
+    exit_status: Vec<String>,
+    #[pyo3(get)]
+    num_outer_iterations: Py<PyArray1<usize>>,
+    #[pyo3(get)]
+    num_inner_iterations: Py<PyArray1<usize>>,
+    #[pyo3(get)]
+    last_problem_norm_fpr: Py<PyArray1<f64>>,
+    #[pyo3(get)]
+    f1_infeasibility: Py<PyArray1<f64>>,
+    #[pyo3(get)]
+    f2_norm: Py<PyArray1<f64>>,
+    #[pyo3(get)]
+    solve_time_ms: Py<PyArray1<f64>>,
+    #[pyo3(get)]
+    penalty: Py<PyArray1<f64>>,
+    #[pyo3(get)]
+    solution: Py<PyArray2<f64>>,
+    #[pyo3(get)]
+    lagrange_multipliers: Py<PyArray2<f64>>,
+    #[pyo3(get)]
+    cost: Py<PyArray1<f64>>,
+}
+
 #[pyclass]
 struct Solver {
-    cache: AlmCache,
+    cache: SolverCache,
+    /// Solver caches of `run_batch` (created on its first call)
+    pool: Option<SolverPool>,
 }
 
 #[pymethods]
 impl Solver {
     /// Run solver
     ///
-    #[text_signature = "($self, p, initial_guess, initial_y, initial_penalty)"]
+    /// The parameter, the initial guess and the initial Lagrange multipliers
+    /// can be lists or numpy arrays; the GIL is released while solving
+    #[pyo3(signature = (p, initial_guess=None, initial_lagrange_multipliers=None, initial_penalty=None))]
     fn run(
         &mut self,
-        p: Vec<f64>,
-        initial_guess: Option<Vec<f64>>,
-        initial_lagrange_multipliers: Option<Vec<f64>>,
+        py: Python<'_>,
+        p: Vector,
+        initial_guess: Option<Vector>,
+        initial_lagrange_multipliers: Option<Vector>,
         initial_penalty: Option<f64>,
     ) -> PyResult<Option<OptimizerSolution>> {
-        let mut u = [0.0; {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES];
+        let mut u = vec![0.0; {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES];
 
         // ----------------------------------------------------
         // Set initial value
         // ----------------------------------------------------
-        if let Some(u0) = initial_guess {
+        if let Some(u0) = &initial_guess {
+            let u0 = u0.as_slice();
             if u0.len() != {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES {
                 println!(
                     "1600 -> Initial guess has incompatible dimensions: {} != {}",
@@ -86,7 +152,8 @@ impl Solver {
         // ----------------------------------------------------
         // Check lagrange multipliers
         // ----------------------------------------------------
-        if let Some(y0) = &initial_lagrange_multipliers {
+        let y0 = initial_lagrange_multipliers.map(|y0| y0.as_slice().into_owned());
+        if let Some(y0) = &y0 {
             if y0.len() != {{meta.optimizer_name|upper}}_N1 {
                 println!(
                     "1700 -> wrong dimension of Langrange multipliers: {} != {}",
@@ -100,6 +167,7 @@ impl Solver {
         // ----------------------------------------------------
         // Check parameter
         // ----------------------------------------------------
+        let p = p.as_slice();
         if p.len() != {{meta.optimizer_name|upper}}_NUM_PARAMETERS {
             println!(
                 "3003 -> wrong number of parameters: {} != {}",
@@ -110,15 +178,10 @@ impl Solver {
         }
 
         // ----------------------------------------------------
-        // Run solver
+        // Run solver (without holding the GIL)
         // ----------------------------------------------------
-        let solver_status = solve(
-            &p,
-            &mut self.cache,
-            &mut u,
-            &initial_lagrange_multipliers,
-            &initial_penalty,
-        );
+        let cache = &mut self.cache;
+        let solver_status = py.allow_threads(|| solve(&p, cache, &mut u, &y0, &initial_penalty));
 
         match solver_status {
             Ok(status) => Ok(Some(OptimizerSolution {
@@ -129,9 +192,13 @@ impl Solver {
                 f1_infeasibility: status.delta_y_norm_over_c(),
                 f2_norm: status.f2_norm(),
                 penalty: status.penalty(),
-                lagrange_multipliers: status.lagrange_multipliers().clone().unwrap_or_default(),
+                lagrange_multipliers: PyArray1::from_vec(
+                    py,
+                    status.lagrange_multipliers().clone().unwrap_or_default(),
+                )
+                .to_owned(),
                 solve_time_ms: (status.solve_time().as_nanos() as f64) / 1e6,
-                solution: u.to_vec(),
+                solution: PyArray1::from_vec(py, u).to_owned(),
                 cost: status.cost(),
             })),
             Err(_) => {
@@ -140,4 +207,115 @@ impl Solver {
             }
         }
     }
+
+    /// Run solver on a batch of parameters in parallel
+    ///
+    /// Every row of the 2-D array `p` is a parameter; the (optional) rows of
+    /// `initial_guess` are the corresponding initial guesses. The problems are
+    /// solved by `num_workers` threads (if zero, the number of CPUs), without
+    /// holding the GIL. Instances which fail have the exit status `SolverError`.
+    #[pyo3(signature = (p, initial_guess=None, num_workers=0))]
+    fn run_batch(
+        &mut self,
+        py: Python<'_>,
+        p: PyReadonlyArray2<f64>,
+        initial_guess: Option<PyReadonlyArray2<f64>>,
+        num_workers: usize,
+    ) -> PyResult<Option<BatchSolution>> {
+        let num_instances = p.shape()[0];
+        if p.shape()[1] != {{meta.optimizer_name|upper}}_NUM_PARAMETERS {
+            println!(
+                "3003 -> wrong number of parameters: {} != {}",
+                p.shape()[1],
+                {{meta.optimizer_name|upper}}_NUM_PARAMETERS
+            );
+            return Ok(None);
+        }
+        let mut u = match &initial_guess {
+            Some(u0) => {
+                if u0.shape() != [num_instances, {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES] {
+                    println!(
+                        "1600 -> Initial guess has incompatible dimensions: {:?} != [{}, {}]",
+                        u0.shape(),
+                        num_instances,
+                        {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES
+                    );
+                    return Ok(None);
+                }
+                rows_as_slice(u0).into_owned()
+            }
+            None => vec![0.0; num_instances * {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES],
+        };
+
+        // The pool (and its caches) is kept for subsequent batches
+        let pool = match self.pool.take() {
+            Some(pool) if num_workers == 0 || pool.num_workers() == num_workers => pool,
+            _ => SolverPool::new(num_workers),
+        };
+        let pool = self.pool.insert(pool);
+        let params = rows_as_slice(&p);
+        let statuses = py.allow_threads(|| solve_batch(&params, pool, &mut u));
+
+        let mut exit_status = Vec::with_capacity(num_instances);
+        let mut num_outer_iterations = Vec::with_capacity(num_instances);
+        let mut num_inner_iterations = Vec::with_capacity(num_instances);
+        let mut last_problem_norm_fpr = Vec::with_capacity(num_instances);
+        let mut f1_infeasibility = Vec::with_capacity(num_instances);
+        let mut f2_norm = Vec::with_capacity(num_instances);
+        let mut solve_time_ms = Vec::with_capacity(num_instances);
+        let mut penalty = Vec::with_capacity(num_instances);
+        let mut lagrange_multipliers = Vec::with_capacity(num_instances * {{meta.optimizer_name|upper}}_N1);
+        let mut cost = Vec::with_capacity(num_instances);
+        for status in statuses.iter() {
+            match status {
+                Ok(status) => {
+                    exit_status.push(format!("{:?}", status.exit_status()));
+                    num_outer_iterations.push(status.num_outer_iterations());
+                    num_inner_iterations.push(status.num_inner_iterations());
+                    last_problem_norm_fpr.push(status.last_problem_norm_fpr());
+                    f1_infeasibility.push(status.delta_y_norm_over_c());
+                    f2_norm.push(status.f2_norm());
+                    solve_time_ms.push((status.solve_time().as_nanos() as f64) / 1e6);
+                    penalty.push(status.penalty());
+                    match status.lagrange_multipliers() {
+                        Some(y) => lagrange_multipliers.extend_from_slice(y),
+                        None => lagrange_multipliers.resize(lagrange_multipliers.len() + {{meta.optimizer_name|upper}}_N1, f64::NAN),
+                    }
+                    cost.push(status.cost());
+                }
+                Err(_) => {
+                    exit_status.push("SolverError".to_string());
+                    num_outer_iterations.push(0);
+                    num_inner_iterations.push(0);
+                    last_problem_norm_fpr.push(f64::NAN);
+                    f1_infeasibility.push(f64::NAN);
+                    f2_norm.push(f64::NAN);
+                    solve_time_ms.push(f64::NAN);
+                    penalty.push(f64::NAN);
+                    lagrange_multipliers.resize(lagrange_multipliers.len() + {{meta.optimizer_name|upper}}_N1, f64::NAN);
+                    cost.push(f64::NAN);
+                }
+            }
+        }
+
+        // The vectors are moved into the numpy arrays (they are not copied)
+        let to_array = |v: Vec<f64>| PyArray1::from_vec(py, v).to_owned();
+        Ok(Some(BatchSolution {
+            exit_status,
+            num_outer_iterations: PyArray1::from_vec(py, num_outer_iterations).to_owned(),
+            num_inner_iterations: PyArray1::from_vec(py, num_inner_iterations).to_owned(),
+            last_problem_norm_fpr: to_array(last_problem_norm_fpr),
+            f1_infeasibility: to_array(f1_infeasibility),
+            f2_norm: to_array(f2_norm),
+            solve_time_ms: to_array(solve_time_ms),
+            penalty: to_array(penalty),
+            solution: PyArray1::from_vec(py, u)
+                .reshape([num_instances, {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES])?
+                .to_owned(),
+            lagrange_multipliers: PyArray1::from_vec(py, lagrange_multipliers)
+                .reshape([num_instances, {{meta.optimizer_name|upper}}_N1])?
+                .to_owned(),
+            cost: to_array(cost),
+        }))
+    }
 }
@@ -4,7 +4,9 @@
  * dually licensed under the MIT and Apache v2 licences.
  *
  */
+#include <algorithm>
 #include "ros/ros.h"
+#include "ros/callback_queue.h"
 #include "{{ros.package_name}}/OptimizationResult.h"
 #include "{{ros.package_name}}/OptimizationParameters.h"
 #include "{{meta.optimizer_name}}_bindings.hpp"
@@ -22,10 +24,20 @@ class OptimizationEngineManager {
  */
 private:
     /**
-     * Optimization parameters announced on the corresponding
-     * topic ({{ros.package_name}}/parameters)
+     * Latest optimization parameters announced on the corresponding
+     * topic ({{ros.package_name}}/parameters); the message is shared
+     * with the subscriber, not copied
      */
-    {{ros.package_name}}::OptimizationParameters params;
+    {{ros.package_name}}::OptimizationParameters::ConstPtr params;
+    /**
+     * Whether a new message has been received since the last solve
+     */
+    bool has_new_request = false;
+    /**
+     * Whether the previous solution and Lagrange multipliers are used
+     * as initial guesses
+     */
+    bool warm_start = ROS_NODE_{{meta.optimizer_name|upper}}_WARM_START;
     /**
      * Object containing the result (solution and solver
      * statistics), which will be announced on {{ros.package_name}}/results
@@ -52,6 +64,11 @@ private:
      * Initial guess for the penalty parameter
      */
     double init_penalty = ROS_NODE_{{meta.optimizer_name|upper}}_DEFAULT_INITIAL_PENALTY;
+    /**
+     * Deadline of the next solve in microseconds (0: no deadline, the
+     * maximum duration of the solver is used)
+     */
+    unsigned long long deadline_micros = 0;
 
     /**
      * Publish obtained results to output topic
@@ -69,24 +86,35 @@ private:
      */
     void updateInputData()
     {
-        init_penalty = (params.initial_penalty > 1.0)
-            ? params.initial_penalty
+        has_new_request = false;
+
+        if (!warm_start) {
+            std::fill(u, u + {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES, 0.0);
+            std::fill(y, y + {{meta.optimizer_name|upper}}_N1, 0.0);
+        }
+
+        if (!params) return; /* no parameters received yet */
+
+        init_penalty = (params->initial_penalty > 1.0)
+            ? params->initial_penalty
             : ROS_NODE_{{meta.optimizer_name|upper}}_DEFAULT_INITIAL_PENALTY;
 
-        if (params.parameter.size() > 0) {
+        deadline_micros = params->deadline_micros;
+
+        if (params->parameter.size() > 0) {
             for (size_t i = 0; i < {{meta.optimizer_name|upper}}_NUM_PARAMETERS; ++i)
-                p[i] = params.parameter[i];
+                p[i] = params->parameter[i];
         }
 
-        if (params.initial_guess.size() == {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES) {
+        if (params->initial_guess.size() == {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES) {
             for (size_t i = 0; i < {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES; ++i)
-                u[i] = params.initial_guess[i];
+                u[i] = params->initial_guess[i];
         }
 
-		if (params.initial_y.size() == {{meta.optimizer_name|upper}}_N1) {
+        if (params->initial_y.size() == {{meta.optimizer_name|upper}}_N1) {
             for (size_t i = 0; i < {{meta.optimizer_name|upper}}_N1; ++i)
-                y[i] = params.initial_y[i];
-		}
+                y[i] = params->initial_y[i];
+        }
     }
 
     /**
@@ -94,6 +122,9 @@ private:
      */
     {{meta.optimizer_name}}SolverStatus solve()
     {
+        if (deadline_micros > 0)
+            return {{meta.optimizer_name}}_solve_with_deadline(cache, u, p, y, &init_penalty,
+                                                              deadline_micros);
         return {{meta.optimizer_name}}_solve(cache, u, p, y, &init_penalty);
     }
 /**
@@ -105,8 +136,13 @@ public:
      */
     OptimizationEngineManager()
     {
-	    y = new double[{{meta.optimizer_name|upper}}_N1];
+        y = new double[{{meta.optimizer_name|upper}}_N1]();
         cache = {{meta.optimizer_name}}_new();
+        /* allocate the result vectors once; they are reused in every solve */
+        results.solution.resize({{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES);
+        results.lagrange_multipliers.resize({{meta.optimizer_name|upper}}_N1);
+        results.phase_counts.resize({{meta.optimizer_name|upper}}_NUM_PHASES);
+        results.phase_times_ms.resize({{meta.optimizer_name|upper}}_NUM_PHASES);
     }
 
     /**
@@ -114,19 +150,41 @@ public:
      */
     ~OptimizationEngineManager()
     {
-		if (y!=NULL) delete[] y;
+        if (y!=NULL) delete[] y;
         {{meta.optimizer_name}}_free(cache);
     }
 
+    /**
+     * Sets whether the previous solution is used as initial guess
+     */
+    void setWarmStart(bool warm_start_enabled)
+    {
+        warm_start = warm_start_enabled;
+    }
+
+    /**
+     * Whether new parameters have been received since the last solve
+     */
+    bool hasNewRequest() const
+    {
+        return has_new_request;
+    }
+
     /**
      * Copies results from `status` to the local field `results`
+     * (and keeps the Lagrange multipliers for warm starting, unless
+     * the solver failed, in which case they are not meaningful)
      */
     void updateResults({{meta.optimizer_name}}SolverStatus& status)
     {
-        std::vector<double> sol(u, u + {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES);
-        results.solution = sol;
-        std::vector<double> y(status.lagrange, status.lagrange + {{meta.optimizer_name|upper}}_N1);
-        results.lagrange_multipliers = y;
+        bool solver_failed =
+            status.exit_status == {{meta.optimizer_name}}NotConvergedCost
+            || status.exit_status == {{meta.optimizer_name}}NotConvergedNotFiniteComputation;
+        std::copy(u, u + {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES, results.solution.begin());
+        std::copy(status.lagrange, status.lagrange + {{meta.optimizer_name|upper}}_N1,
+                  results.lagrange_multipliers.begin());
+        if (warm_start && !solver_failed)
+            std::copy(status.lagrange, status.lagrange + {{meta.optimizer_name|upper}}_N1, y);
         results.inner_iterations = status.num_inner_iterations;
         results.outer_iterations = status.num_outer_iterations;
         results.norm_fpr = status.last_problem_norm_fpr;
@@ -136,6 +194,12 @@ public:
         results.solve_time_ms = (double)status.solve_time_ns / 1000000.0;
         results.infeasibility_f2 = status.f2_norm;
         results.infeasibility_f1 = status.delta_y_norm_over_c;
+        std::copy(status.phase_counts,
+                  status.phase_counts + {{meta.optimizer_name|upper}}_NUM_PHASES,
+                  results.phase_counts.begin());
+        for (size_t i = 0; i < {{meta.optimizer_name|upper}}_NUM_PHASES; ++i) {
+            results.phase_times_ms[i] = (double)status.phase_times_ns[i] / 1000000.0;
+        }
     }
 
     /**
@@ -144,7 +208,8 @@ public:
     void mpcReceiveRequestCallback(
         const {{ros.package_name}}::OptimizationParameters::ConstPtr& msg)
     {
-        params = *msg;
+        params = msg;
+        has_new_request = true;
     }
 
     void solveAndPublish(ros::Publisher& publisher)
@@ -171,6 +236,8 @@ int main(int argc, char** argv)
 {
     std::string result_topic, params_topic;  /* parameter and result topics */
     double rate; /* rate of node (specified by parameter) */
+    bool solve_on_request; /* solve only when new parameters arrive */
+    bool warm_start; /* warm-start using the previous solution */
 
     {{ros.package_name}}::OptimizationEngineManager mng;
     ros::init(argc, argv, ROS_NODE_{{meta.optimizer_name|upper}}_NODE_NAME);
@@ -183,6 +250,11 @@ int main(int argc, char** argv)
                      std::string(ROS_NODE_{{meta.optimizer_name|upper}}_PARAMS_TOPIC));
     private_nh.param("rate", rate,
                      double(ROS_NODE_{{meta.optimizer_name|upper}}_RATE));
+    private_nh.param("solve_on_request", solve_on_request,
+                     bool(ROS_NODE_{{meta.optimizer_name|upper}}_SOLVE_ON_REQUEST));
+    private_nh.param("warm_start", warm_start,
+                     bool(ROS_NODE_{{meta.optimizer_name|upper}}_WARM_START));
+    mng.setWarmStart(warm_start);
 
     ros::Publisher mpc_pub
         = private_nh.advertise<{{ros.package_name}}::OptimizationResult>(
@@ -194,8 +266,21 @@ int main(int argc, char** argv)
             ROS_NODE_{{meta.optimizer_name|upper}}_PARAMS_TOPIC_QUEUE_SIZE,
             &{{ros.package_name}}::OptimizationEngineManager::mpcReceiveRequestCallback,
             &mng);
-    ros::Rate loop_rate(rate);
 
+    if (solve_on_request) {
+        /* block until new parameters arrive and solve once per message;
+         * if several messages arrive in the meantime, use the latest one */
+        ros::CallbackQueue* queue = ros::getGlobalCallbackQueue();
+        while (ros::ok()) {
+            queue->callAvailable(
+                ros::WallDuration(ROS_NODE_{{meta.optimizer_name|upper}}_REQUEST_WAIT_TIMEOUT));
+            if (mng.hasNewRequest())
+                mng.solveAndPublish(mpc_pub);
+        }
+        return 0;
+    }
+
+    ros::Rate loop_rate(rate);
     while (ros::ok()) {
         mng.solveAndPublish(mpc_pub);
         ros::spinOnce();
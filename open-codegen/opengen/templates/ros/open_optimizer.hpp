@@ -21,6 +21,22 @@
  */
 #define ROS_NODE_{{meta.optimizer_name|upper}}_RATE {{ros.rate}}
 
+/**
+ * Whether to solve only when new parameters are received (default)
+ */
+#define ROS_NODE_{{meta.optimizer_name|upper}}_SOLVE_ON_REQUEST {{ 'true' if ros.solve_on_request else 'false' }}
+
+/**
+ * Whether to warm-start the solver using the previous solution (default)
+ */
+#define ROS_NODE_{{meta.optimizer_name|upper}}_WARM_START {{ 'true' if ros.warm_start else 'false' }}
+
+/**
+ * Maximum time (in seconds) to wait for new parameters before checking
+ * whether the node should shut down (used when solving on request)
+ */
+#define ROS_NODE_{{meta.optimizer_name|upper}}_REQUEST_WAIT_TIMEOUT 0.1
+
 /**
  * Default result topic queue size
  */
@@ -0,0 +1,198 @@
+/*
+ * Auto-generated shared-memory client for optimizer: {{ meta.optimizer_name }}
+ *
+ * This header-only library connects to the shared-memory server of the
+ * optimizer (shm_iface_{{ meta.optimizer_name }}), which runs on the same
+ * host. The client writes the parameter (and, optionally, the initial guess
+ * and the Lagrange multipliers) directly into the shared memory, calls
+ * {{ meta.optimizer_name }}_shm_solve and reads the solution and the status
+ * of the solver from the shared memory:
+ *
+ *     {{ meta.optimizer_name }}ShmClient client;
+ *     if ({{ meta.optimizer_name }}_shm_open(&client, NULL) != 0) { ... }
+ *     client.p[0] = 1.0;
+ *     if ({{ meta.optimizer_name }}_shm_solve(&client, 0, 0.0, 0) == 0) {
+ *         ... client.u[0], client.header->num_inner_iterations ...
+ *     }
+ *     {{ meta.optimizer_name }}_shm_close(&client);
+ *
+ * A server serves a single client; the client must not modify the shared
+ * memory while a request is pending. Requires C11 (stdatomic.h) and POSIX
+ * (with -std=c11, define _POSIX_C_SOURCE, e.g., -D_POSIX_C_SOURCE=200809L).
+ */
+
+#ifndef {{ meta.optimizer_name|upper }}_SHM_CLIENT_H
+#define {{ meta.optimizer_name|upper }}_SHM_CLIENT_H
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Default path of the shared-memory file */
+#define {{ meta.optimizer_name|upper }}_SHM_PATH "{{ (shm_server_config.path or ('/dev/shm/open_' ~ meta.optimizer_name)) | safe }}"
+
+/* Number of polls of the server's response before sleeping between polls */
+#define {{ meta.optimizer_name|upper }}_SHM_SPIN_ITERATIONS {{ shm_server_config.spin_iterations }}
+
+/* Time between polls (in microseconds) after the busy-waiting (0: yield the CPU) */
+#define {{ meta.optimizer_name|upper }}_SHM_IDLE_SLEEP_MICROS {{ shm_server_config.idle_sleep_micros }}
+
+/* Dimensions of the problem */
+#define {{ meta.optimizer_name|upper }}_SHM_NUM_PARAMETERS {{ problem.dim_parameters() }}
+#define {{ meta.optimizer_name|upper }}_SHM_NUM_DECISION_VARIABLES {{ problem.dim_decision_variables() }}
+#define {{ meta.optimizer_name|upper }}_SHM_N1 {{ problem.dim_constraints_aug_lagrangian() }}
+
+/* Magic number of an initialised region ("OPENSHM1") and layout version */
+#define {{ meta.optimizer_name|upper }}_SHM_MAGIC 0x314D48534E45504FULL
+#define {{ meta.optimizer_name|upper }}_SHM_LAYOUT_VERSION 1
+
+/* Flags of {{ meta.optimizer_name }}_shm_solve */
+#define {{ meta.optimizer_name|upper }}_SHM_FLAG_INITIAL_Y 2       /* use the Lagrange multipliers in `y` */
+#define {{ meta.optimizer_name|upper }}_SHM_FLAG_INITIAL_PENALTY 4 /* use `initial_penalty` */
+#define {{ meta.optimizer_name|upper }}_SHM_FLAG_DEADLINE 8        /* use `deadline_micros` */
+
+/* Exit status (field `exit_status` of the header) */
+#define {{ meta.optimizer_name|upper }}_SHM_CONVERGED 0
+#define {{ meta.optimizer_name|upper }}_SHM_NOT_CONVERGED_ITERATIONS 1
+#define {{ meta.optimizer_name|upper }}_SHM_NOT_CONVERGED_OUT_OF_TIME 2
+#define {{ meta.optimizer_name|upper }}_SHM_ERROR 255
+
+#define {{ meta.optimizer_name|upper }}_SHM_COMMAND_SOLVE 1
+#define {{ meta.optimizer_name|upper }}_SHM_COMMAND_KILL 2
+
+/* Header of the shared-memory region (same layout as in the server) */
+typedef struct {
+    /* server (written once) */
+    _Atomic uint64_t magic;
+    uint64_t layout_version;
+    uint64_t num_parameters;
+    uint64_t num_decision_variables;
+    uint64_t n1;
+    uint64_t server_pid;
+    uint64_t reserved_server[2];
+    /* request (client) */
+    _Atomic uint64_t request_seq;
+    uint64_t command;
+    uint64_t flags;
+    double initial_penalty;
+    uint64_t deadline_micros;
+    uint64_t reserved_request[3];
+    /* response (server) */
+    _Atomic uint64_t response_seq;
+    uint64_t exit_status;
+    uint64_t error_code; /* 0: no error; 1000: invalid request; 2000: solver error */
+    uint64_t num_outer_iterations;
+    uint64_t num_inner_iterations;
+    double last_problem_norm_fpr;
+    double delta_y_norm_over_c;
+    double f2_norm;
+    double penalty;
+    double cost;
+    double solve_time_ms;
+    uint64_t reserved_response[5];
+} {{ meta.optimizer_name }}ShmHeader;
+
+_Static_assert(sizeof({{ meta.optimizer_name }}ShmHeader) == 256, "wrong size of the header");
+_Static_assert(offsetof({{ meta.optimizer_name }}ShmHeader, request_seq) == 64, "wrong layout of the header");
+_Static_assert(offsetof({{ meta.optimizer_name }}ShmHeader, response_seq) == 128, "wrong layout of the header");
+
+/* Offsets of the arrays in the region (each of them is aligned to 64 bytes) */
+#define {{ meta.optimizer_name|upper }}_SHM_ALIGNED_SIZE(n) ((8 * (size_t)(n) + 63) / 64 * 64)
+#define {{ meta.optimizer_name|upper }}_SHM_P_OFFSET sizeof({{ meta.optimizer_name }}ShmHeader)
+#define {{ meta.optimizer_name|upper }}_SHM_U_OFFSET ({{ meta.optimizer_name|upper }}_SHM_P_OFFSET + {{ meta.optimizer_name|upper }}_SHM_ALIGNED_SIZE({{ meta.optimizer_name|upper }}_SHM_NUM_PARAMETERS))
+#define {{ meta.optimizer_name|upper }}_SHM_Y_OFFSET ({{ meta.optimizer_name|upper }}_SHM_U_OFFSET + {{ meta.optimizer_name|upper }}_SHM_ALIGNED_SIZE({{ meta.optimizer_name|upper }}_SHM_NUM_DECISION_VARIABLES))
+#define {{ meta.optimizer_name|upper }}_SHM_REGION_SIZE ({{ meta.optimizer_name|upper }}_SHM_Y_OFFSET + {{ meta.optimizer_name|upper }}_SHM_ALIGNED_SIZE({{ meta.optimizer_name|upper }}_SHM_N1))
+
+/* Connection to the server */
+typedef struct {
+    {{ meta.optimizer_name }}ShmHeader *header; /* request and status of the last solve */
+    double *p;                  /* parameter (input) */
+    double *u;                  /* initial guess (input) and solution (output) */
+    double *y;                  /* Lagrange multipliers (input, optional, and output) */
+} {{ meta.optimizer_name }}ShmClient;
+
+/*
+ * Maps the shared memory of a running server (path: NULL for the default)
+ *
+ * Returns 0 on success, or -1 if the file cannot be mapped or it is not the
+ * region of a server of this optimizer
+ */
+static inline int {{ meta.optimizer_name }}_shm_open({{ meta.optimizer_name }}ShmClient *client, const char *path) {
+    int fd = open(path ? path : {{ meta.optimizer_name|upper }}_SHM_PATH, O_RDWR);
+    if (fd < 0) return -1;
+    void *base = mmap(NULL, {{ meta.optimizer_name|upper }}_SHM_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+    {{ meta.optimizer_name }}ShmHeader *header = ({{ meta.optimizer_name }}ShmHeader *) base;
+    if (atomic_load_explicit(&header->magic, memory_order_acquire) != {{ meta.optimizer_name|upper }}_SHM_MAGIC
+            || header->layout_version != {{ meta.optimizer_name|upper }}_SHM_LAYOUT_VERSION
+            || header->num_parameters != {{ meta.optimizer_name|upper }}_SHM_NUM_PARAMETERS
+            || header->num_decision_variables != {{ meta.optimizer_name|upper }}_SHM_NUM_DECISION_VARIABLES
+            || header->n1 != {{ meta.optimizer_name|upper }}_SHM_N1) {
+        munmap(base, {{ meta.optimizer_name|upper }}_SHM_REGION_SIZE);
+        return -1;
+    }
+    client->header = header;
+    client->p = (double *) ((char *) base + {{ meta.optimizer_name|upper }}_SHM_P_OFFSET);
+    client->u = (double *) ((char *) base + {{ meta.optimizer_name|upper }}_SHM_U_OFFSET);
+    client->y = (double *) ((char *) base + {{ meta.optimizer_name|upper }}_SHM_Y_OFFSET);
+    return 0;
+}
+
+/* Submits a request and waits for the response of the server */
+static inline void {{ meta.optimizer_name }}_shm_request({{ meta.optimizer_name }}ShmClient *client, uint64_t command) {
+    {{ meta.optimizer_name }}ShmHeader *header = client->header;
+    uint64_t seq = atomic_load_explicit(&header->response_seq, memory_order_acquire) + 1;
+    header->command = command;
+    atomic_store_explicit(&header->request_seq, seq, memory_order_release);
+    const struct timespec idle_sleep = {
+        {{ meta.optimizer_name|upper }}_SHM_IDLE_SLEEP_MICROS / 1000000,
+        ({{ meta.optimizer_name|upper }}_SHM_IDLE_SLEEP_MICROS % 1000000) * 1000L
+    };
+    unsigned long polls = 0;
+    while (atomic_load_explicit(&header->response_seq, memory_order_acquire) != seq) {
+        if (++polls <= {{ meta.optimizer_name|upper }}_SHM_SPIN_ITERATIONS) continue;
+        if ({{ meta.optimizer_name|upper }}_SHM_IDLE_SLEEP_MICROS == 0) sched_yield();
+        else nanosleep(&idle_sleep, NULL);
+    }
+}
+
+/*
+ * Solves the problem for the parameter `p`, starting from `u`, and stores
+ * the solution in `u` and the Lagrange multipliers in `y`
+ *
+ * `flags` is a combination of {{ meta.optimizer_name|upper }}_SHM_FLAG_*; `initial_penalty` and
+ * `deadline_micros` are used only if the corresponding flags are set
+ *
+ * Returns 0 on success (then, see `client->header->exit_status`), or the
+ * error code of the server
+ */
+static inline int {{ meta.optimizer_name }}_shm_solve({{ meta.optimizer_name }}ShmClient *client, uint64_t flags,
+                                 double initial_penalty, uint64_t deadline_micros) {
+    {{ meta.optimizer_name }}ShmHeader *header = client->header;
+    header->flags = flags;
+    header->initial_penalty = initial_penalty;
+    header->deadline_micros = deadline_micros;
+    {{ meta.optimizer_name }}_shm_request(client, {{ meta.optimizer_name|upper }}_SHM_COMMAND_SOLVE);
+    return (int) header->error_code;
+}
+
+/* Stops the server and unmaps the shared memory */
+static inline void {{ meta.optimizer_name }}_shm_kill({{ meta.optimizer_name }}ShmClient *client) {
+    {{ meta.optimizer_name }}_shm_request(client, {{ meta.optimizer_name|upper }}_SHM_COMMAND_KILL);
+    munmap(client->header, {{ meta.optimizer_name|upper }}_SHM_REGION_SIZE);
+    client->header = NULL;
+}
+
+/* Unmaps the shared memory (the server keeps running) */
+static inline void {{ meta.optimizer_name }}_shm_close({{ meta.optimizer_name }}ShmClient *client) {
+    munmap(client->header, {{ meta.optimizer_name|upper }}_SHM_REGION_SIZE);
+    client->header = NULL;
+}
+
+#endif /* {{ meta.optimizer_name|upper }}_SHM_CLIENT_H */
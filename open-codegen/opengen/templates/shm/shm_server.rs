@@ -0,0 +1,360 @@
+///
+/// Auto-generated shared-memory server for optimizer: {{ meta.optimizer_name }}
+///
+/// The server maps a file (by default, in `/dev/shm`) into memory and serves
+/// the requests of a single client which runs on the same host. The region
+/// consists of a header, which holds the request and the status of the last
+/// solve, followed by the parameter, `p`, the decision variables, `u`, and the
+/// Lagrange multipliers, `y`:
+///
+/// - the client writes `p` (and, optionally, `u` and `y`) directly into the
+///   region, then increments `request_seq`
+/// - the server solves the problem in place, that is, reading `p` from the
+///   region and using `u` (in the region) as the initial guess and to store
+///   the solution, writes `y` and the status fields and then sets
+///   `response_seq` equal to `request_seq`
+///
+/// The handshake is lock-free: the sequence numbers are stored with release
+/// and loaded with acquire semantics, and both sides busy-wait for
+/// `spin_iterations` polls, then they sleep for `idle_sleep_micros` between
+/// polls. The client must not modify the region while a request is pending.
+///
+use optimization_engine::{alm::AlmOptimizerStatus, core::ExitStatus, SolverError};
+
+#[macro_use]
+extern crate clap;
+
+use std::{
+    fs::{self, OpenOptions},
+    os::unix::io::AsRawFd,
+    ptr,
+    sync::atomic::{AtomicU64, Ordering},
+    thread,
+    time::Duration,
+};
+
+use clap::{App, Arg};
+
+use {{ meta.optimizer_name }}::*;
+
+#[macro_use]
+extern crate log;
+
+/// Path of the shared-memory file
+/// Can be overriden by the user
+const SHM_PATH_DEFAULT: &str = r#"{{ (shm_server_config.path or ('/dev/shm/open_' ~ meta.optimizer_name)) | safe }}"#;
+
+/// Number of polls of the request sequence number before the server starts
+/// sleeping between polls
+/// Can be overriden by the user
+const SPIN_ITERATIONS_DEFAULT: u64 = {{ shm_server_config.spin_iterations }};
+
+/// Time between polls (in microseconds) once the server has stopped
+/// busy-waiting (0: yield the CPU instead)
+/// Can be overriden by the user
+const IDLE_SLEEP_MICROS_DEFAULT: u64 = {{ shm_server_config.idle_sleep_micros }};
+
+/// Magic number of an initialised region ("OPENSHM1")
+const SHM_MAGIC: u64 = 0x314D_4853_4E45_504F;
+
+/// Version of the layout of the region
+const SHM_LAYOUT_VERSION: u64 = 1;
+
+/// Commands
+const COMMAND_SOLVE: u64 = 1;
+const COMMAND_KILL: u64 = 2;
+
+/// Flags of a solve request (as in the binary TCP protocol; the initial
+/// guess is always the vector `u` in the region)
+const FLAG_INITIAL_Y: u64 = 2;
+const FLAG_INITIAL_PENALTY: u64 = 4;
+const FLAG_DEADLINE: u64 = 8;
+
+/// Exit status of a request which could not be processed
+const EXIT_STATUS_ERROR: u64 = 255;
+
+/// Offsets of the arrays in the region (each of them is aligned to 64 bytes)
+const fn aligned_size(num_values: usize) -> usize {
+    (8 * num_values + 63) / 64 * 64
+}
+const P_OFFSET: usize = std::mem::size_of::<ShmHeader>();
+const U_OFFSET: usize = P_OFFSET + aligned_size({{meta.optimizer_name|upper}}_NUM_PARAMETERS);
+const Y_OFFSET: usize = U_OFFSET + aligned_size({{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES);
+const REGION_SIZE: usize = Y_OFFSET + aligned_size({{meta.optimizer_name|upper}}_N1);
+
+/// Header of the shared-memory region
+///
+/// The fields are grouped in cache lines: the fields of the server (written
+/// once), of the request (written by the client) and of the response (written
+/// by the server); see `{{ meta.optimizer_name }}_shm_client.h` for the
+/// same layout in C. Since the client writes into the region concurrently,
+/// all fields are atomic (`f64` values are stored as their bits); apart from
+/// the sequence numbers and the magic number, they are accessed with relaxed
+/// ordering
+#[repr(C, align(64))]
+struct ShmHeader {
+    magic: AtomicU64,
+    layout_version: AtomicU64,
+    num_parameters: AtomicU64,
+    num_decision_variables: AtomicU64,
+    n1: AtomicU64,
+    server_pid: AtomicU64,
+    _reserved_server: [u64; 2],
+    // request (client)
+    request_seq: AtomicU64,
+    command: AtomicU64,
+    flags: AtomicU64,
+    initial_penalty: AtomicU64,
+    deadline_micros: AtomicU64,
+    _reserved_request: [u64; 3],
+    // response (server)
+    response_seq: AtomicU64,
+    exit_status: AtomicU64,
+    error_code: AtomicU64,
+    num_outer_iterations: AtomicU64,
+    num_inner_iterations: AtomicU64,
+    last_problem_norm_fpr: AtomicU64,
+    delta_y_norm_over_c: AtomicU64,
+    f2_norm: AtomicU64,
+    penalty: AtomicU64,
+    cost: AtomicU64,
+    solve_time_ms: AtomicU64,
+    _reserved_response: [u64; 5],
+}
+
+impl ShmHeader {
+    fn get(field: &AtomicU64) -> u64 {
+        field.load(Ordering::Relaxed)
+    }
+
+    fn set(field: &AtomicU64, value: u64) {
+        field.store(value, Ordering::Relaxed)
+    }
+
+    fn set_f64(field: &AtomicU64, value: f64) {
+        field.store(value.to_bits(), Ordering::Relaxed)
+    }
+
+    /// Sets the status of a request which could not be processed
+    fn set_error(&self, error_code: u64) {
+        ShmHeader::set(&self.exit_status, EXIT_STATUS_ERROR);
+        ShmHeader::set(&self.error_code, error_code);
+    }
+}
+
+/// Memory-mapped region (unmapped and removed on drop)
+struct ShmRegion {
+    base: *mut u8,
+    path: String,
+}
+
+impl ShmRegion {
+    /// Creates (or truncates) the file at `path` and maps it into memory
+    fn create(path: &str) -> std::io::Result<ShmRegion> {
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .open(path)?;
+        // zero the region, so that stale requests are not served
+        file.set_len(0)?;
+        file.set_len(REGION_SIZE as u64)?;
+        let base = unsafe {
+            libc::mmap(
+                ptr::null_mut(),
+                REGION_SIZE,
+                libc::PROT_READ | libc::PROT_WRITE,
+                libc::MAP_SHARED,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if base == libc::MAP_FAILED {
+            return Err(std::io::Error::last_os_error());
+        }
+        Ok(ShmRegion {
+            base: base as *mut u8,
+            path: path.to_string(),
+        })
+    }
+
+    fn header(&self) -> &ShmHeader {
+        unsafe { &*(self.base as *const ShmHeader) }
+    }
+
+    /// Array of `len` values at `offset` (in bytes)
+    ///
+    /// # Safety
+    ///
+    /// The client must not access the array while a request is pending
+    unsafe fn array(&self, offset: usize, len: usize) -> &mut [f64] {
+        std::slice::from_raw_parts_mut(self.base.add(offset) as *mut f64, len)
+    }
+}
+
+impl Drop for ShmRegion {
+    fn drop(&mut self) {
+        self.header().magic.store(0, Ordering::Release);
+        unsafe {
+            libc::munmap(self.base as *mut libc::c_void, REGION_SIZE);
+        }
+        fs::remove_file(&self.path).unwrap_or_default();
+    }
+}
+
+/// Waits until the client submits a request with a sequence number other
+/// than `last_seq` and returns it
+///
+/// The server busy-waits for `spin_iterations` polls, then it sleeps for
+/// `idle_sleep` between polls, so that an idle server does not keep a core
+/// busy; the price is that a request which arrives after the busy-waiting
+/// phase is noticed up to `idle_sleep` (plus the timer slack of the OS) late.
+/// If `idle_sleep` is zero, the server yields the CPU between polls instead.
+fn wait_for_request(header: &ShmHeader, last_seq: u64, spin_iterations: u64, idle_sleep: Duration) -> u64 {
+    let mut polls = 0u64;
+    loop {
+        let seq = header.request_seq.load(Ordering::Acquire);
+        if seq != last_seq {
+            return seq;
+        }
+        if polls < spin_iterations {
+            polls += 1;
+            std::hint::spin_loop();
+        } else if idle_sleep.as_nanos() == 0 {
+            thread::yield_now();
+        } else {
+            thread::sleep(idle_sleep);
+        }
+    }
+}
+
+/// Writes the status of a solve into the header
+fn write_status(header: &ShmHeader, status: &AlmOptimizerStatus) {
+    let exit_status = match status.exit_status() {
+        ExitStatus::Converged => 0,
+        ExitStatus::NotConvergedIterations => 1,
+        ExitStatus::NotConvergedOutOfTime => 2,
+    };
+    ShmHeader::set(&header.exit_status, exit_status);
+    ShmHeader::set(&header.error_code, 0);
+    ShmHeader::set(&header.num_outer_iterations, status.num_outer_iterations() as u64);
+    ShmHeader::set(&header.num_inner_iterations, status.num_inner_iterations() as u64);
+    ShmHeader::set_f64(&header.last_problem_norm_fpr, status.last_problem_norm_fpr());
+    ShmHeader::set_f64(&header.delta_y_norm_over_c, status.delta_y_norm_over_c());
+    ShmHeader::set_f64(&header.f2_norm, status.f2_norm());
+    ShmHeader::set_f64(&header.penalty, status.penalty());
+    ShmHeader::set_f64(&header.cost, status.cost());
+    ShmHeader::set_f64(&header.solve_time_ms, (status.solve_time().as_nanos() as f64) / 1e6);
+}
+
+/// Runs the solver on the data of the region
+///
+/// The initial Lagrange multipliers are copied into `y0_buffer`, which is
+/// allocated once
+fn run_solver(
+    region: &ShmRegion,
+    cache: &mut SolverCache,
+    y0_buffer: &mut Option<Vec<f64>>,
+) -> Result<AlmOptimizerStatus, SolverError> {
+    let header = region.header();
+    let flags = ShmHeader::get(&header.flags);
+    let (p, u, y) = unsafe {
+        (
+            region.array(P_OFFSET, {{meta.optimizer_name|upper}}_NUM_PARAMETERS),
+            region.array(U_OFFSET, {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES),
+            region.array(Y_OFFSET, {{meta.optimizer_name|upper}}_N1),
+        )
+    };
+    let no_y0 = None;
+    let y0 = if flags & FLAG_INITIAL_Y != 0 {
+        if let Some(y0) = y0_buffer.as_mut() {
+            y0.copy_from_slice(y);
+        }
+        &*y0_buffer
+    } else {
+        &no_y0
+    };
+    let c0 = if flags & FLAG_INITIAL_PENALTY != 0 {
+        Some(f64::from_bits(ShmHeader::get(&header.initial_penalty)))
+    } else {
+        None
+    };
+    let status = if flags & FLAG_DEADLINE != 0 {
+        let deadline = Duration::from_micros(ShmHeader::get(&header.deadline_micros));
+        solve_with_deadline(p, cache, u, y0, &c0, deadline)
+    } else {
+        solve(p, cache, u, y0, &c0)
+    };
+    if let Ok(status) = &status {
+        if let Some(y_star) = status.lagrange_multipliers() {
+            y.copy_from_slice(y_star);
+        }
+    }
+    status
+}
+
+/// Serves the requests of the client until it sends the command to exit
+fn run_server(region: &ShmRegion, spin_iterations: u64, idle_sleep: Duration) {
+    let header = region.header();
+    ShmHeader::set(&header.layout_version, SHM_LAYOUT_VERSION);
+    ShmHeader::set(&header.num_parameters, {{meta.optimizer_name|upper}}_NUM_PARAMETERS as u64);
+    ShmHeader::set(&header.num_decision_variables, {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES as u64);
+    ShmHeader::set(&header.n1, {{meta.optimizer_name|upper}}_N1 as u64);
+    ShmHeader::set(&header.server_pid, std::process::id() as u64);
+    header.magic.store(SHM_MAGIC, Ordering::Release);
+
+    let mut cache = initialize_solver();
+    let mut y0_buffer = Some(vec![0.0; {{meta.optimizer_name|upper}}_N1]);
+    let mut last_seq = 0;
+    loop {
+        last_seq = wait_for_request(header, last_seq, spin_iterations, idle_sleep);
+        match ShmHeader::get(&header.command) {
+            COMMAND_SOLVE => {
+                trace!("Running solver (request {})", last_seq);
+                match run_solver(region, &mut cache, &mut y0_buffer) {
+                    Ok(status) => write_status(header, &status),
+                    Err(_) => header.set_error(2000),
+                }
+            }
+            COMMAND_KILL => {
+                warn!("Received kill signal");
+                header.response_seq.store(last_seq, Ordering::Release);
+                break;
+            }
+            command => {
+                warn!("Invalid command {}", command);
+                header.set_error(1000);
+            }
+        }
+        header.response_seq.store(last_seq, Ordering::Release);
+    }
+}
+
+fn main() {
+    let matches = App::new("OpEn Shared-Memory Server [{{meta.optimizer_name}}]")
+        .version("{{meta.version}}")
+        .author("{{meta.authors | join(', ')}}")
+        .about("Shared-memory interface of OpEn optimizer")
+        .arg(Arg::with_name("path")
+                 .long("path")
+                 .takes_value(true)
+                 .help("Path of the shared-memory file"))
+        .arg(Arg::with_name("spin-iterations")
+                 .long("spin-iterations")
+                 .takes_value(true)
+                 .help("Number of polls before the server starts sleeping between polls"))
+        .arg(Arg::with_name("idle-sleep-micros")
+                 .long("idle-sleep-micros")
+                 .takes_value(true)
+                 .help("Time between polls (in microseconds) after the busy-waiting (0: yield the CPU)"))
+        .get_matches();
+    let path = matches.value_of("path").unwrap_or(SHM_PATH_DEFAULT);
+    let spin_iterations = value_t!(matches, "spin-iterations", u64).unwrap_or(SPIN_ITERATIONS_DEFAULT);
+    let idle_sleep_micros = value_t!(matches, "idle-sleep-micros", u64).unwrap_or(IDLE_SLEEP_MICROS_DEFAULT);
+
+    pretty_env_logger::init();
+    let region = ShmRegion::create(path).expect("cannot map the shared-memory file");
+    info!("Serving requests at {} ({} bytes)", path, REGION_SIZE);
+    run_server(&region, spin_iterations, Duration::from_micros(idle_sleep_micros));
+    info!("Exiting... (adios!)");
+}
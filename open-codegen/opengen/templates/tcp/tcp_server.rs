@@ -1,15 +1,26 @@
 ///
 /// Auto-generated TCP server for optimizer: {{ meta.optimizer_name }}
 ///
-use optimization_engine::alm::*;
+use optimization_engine::{
+    alm::*,
+    core::{ExitStatus, IterationTrace, Phase, SolverStatistics},
+    SolverError,
+};
 use serde::{Deserialize, Serialize};
 
 #[macro_use]
 extern crate clap;
 
 use std::{
-    io::{prelude::Read, Write},
-    net::TcpListener,
+    collections::BTreeMap,
+    io::{self, prelude::Read, Write},
+    net::{TcpListener, TcpStream},
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        mpsc, Arc, Mutex,
+    },
+    thread,
+    time::{Duration, Instant},
 };
 
 use clap::{Arg, App};
@@ -27,10 +38,46 @@ const BIND_IP_DEFAULT: &str = "{{tcp_server_config.bind_ip}}";
 /// Can be overriden by the user
 const BIND_PORT_DEFAULT: u32 = {{tcp_server_config.bind_port}};
 
+/// Number of worker threads (each worker owns a solver instance)
+/// Can be overriden by the user
+const NUM_WORKERS_DEFAULT: usize = {{tcp_server_config.num_workers}};
+
+/// Maximum number of connections waiting for a worker
+/// Can be overriden by the user
+const MAX_QUEUE_SIZE_DEFAULT: usize = {{tcp_server_config.max_queue_size}};
+
+/// Capacity of the cache of recent solutions, which is shared by the
+/// workers (0: no cache)
+/// Can be overriden by the user
+const SOLUTION_CACHE_SIZE_DEFAULT: usize = {{tcp_server_config.solution_cache_size}};
+
 /// Size of read buffer
 /// Can be overriden by the user
 const READ_BUFFER_SIZE: usize = 1024;
 
+/// Magic bytes that a client sends right after connecting in order to use
+/// the binary protocol (instead of JSON) over a persistent connection
+const BINARY_PROTOCOL_MAGIC: &[u8; 4] = b"OPNB";
+
+/// Binary protocol: request types
+const BINARY_REQUEST_RUN: u8 = 1;
+const BINARY_REQUEST_PING: u8 = 2;
+const BINARY_REQUEST_KILL: u8 = 3;
+
+/// Binary protocol: response types
+const BINARY_RESPONSE_SOLUTION: u8 = 0;
+const BINARY_RESPONSE_ERROR: u8 = 1;
+const BINARY_RESPONSE_PONG: u8 = 2;
+
+/// Binary protocol: flags of run requests
+const BINARY_FLAG_INITIAL_GUESS: u8 = 1;
+const BINARY_FLAG_INITIAL_Y: u8 = 2;
+const BINARY_FLAG_INITIAL_PENALTY: u8 = 4;
+const BINARY_FLAG_DEADLINE: u8 = 8;
+
+/// Binary protocol: maximum size of a request frame in bytes
+const BINARY_MAX_FRAME_SIZE: usize = 64 + 8 * ({{meta.optimizer_name|upper}}_NUM_PARAMETERS + {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES + {{meta.optimizer_name|upper}}_N1);
+
 /// Configuration of TCP server (provided by the user
 /// as command-line parameters)
 #[derive(Debug)]
@@ -39,6 +86,28 @@ struct TcpServerConfiguration<'a> {
    ip: &'a str,
    /// Port
    port: u32,
+   /// Number of worker threads
+   num_workers: usize,
+   /// Maximum number of connections waiting for a worker
+   max_queue_size: usize,
+   /// Capacity of the cache of recent solutions (0: no cache)
+   solution_cache_size: usize,
+}
+
+/// Cache of recent solutions, which is shared by the workers, together with
+/// a buffer of a worker for the Lagrange multipliers of a seed
+struct SharedSolutionCache {
+    solutions: Arc<Mutex<SolutionCache>>,
+    y0: Option<Vec<f64>>,
+}
+
+impl SharedSolutionCache {
+    fn new(solutions: &Arc<Mutex<SolutionCache>>) -> Self {
+        SharedSolutionCache {
+            solutions: Arc::clone(solutions),
+            y0: if {{meta.optimizer_name|upper}}_N1 > 0 { Some(vec![0.0; {{meta.optimizer_name|upper}}_N1]) } else { None },
+        }
+    }
 }
 
 #[derive(Deserialize, Debug)]
@@ -51,6 +120,9 @@ struct ExecutionParameter {
     initial_lagrange_multipliers: Option<Vec<f64>>,
     /// Initial penalty parameter, c0
     initial_penalty: Option<f64>,
+    /// Deadline of this request in microseconds (see `solve_with_deadline`);
+    /// if it is not provided, the maximum duration of the solver is used
+    deadline_micros: Option<u64>,
 }
 
 /// Request from the client
@@ -78,29 +150,102 @@ struct OptimizerSolution<'a> {
     solution: &'a [f64],
     lagrange_multipliers: &'a [f64],
     cost: f64,
+    queue_wait_ms: f64,
+    /// Number of executions and duration of each phase of the solver
+    /// (only if the solver is built with instrumentation)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    statistics: Option<BTreeMap<&'static str, PhaseStatistics>>,
+    /// Whether the solve was warm started from the cache of recent solutions
+    /// (only if the server has a solution cache)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    cache_hit: Option<bool>,
+    /// Estimated number of inner iterations saved by the cache
+    /// (only if the server has a solution cache)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    iterations_saved: Option<usize>,
+    /// Trace of the last iterations of the solve (only if the solver
+    /// records a trace)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    trace: Option<Vec<TracePoint>>,
 }
 
-fn pong(stream: &mut std::net::TcpStream, code: i32) {
+/// Record of an iteration of the solver (see `core::trace`); values that
+/// are not available (`NaN`) are serialized as `null`
+#[derive(Serialize, Debug)]
+struct TracePoint {
+    outer_iteration: Option<usize>,
+    inner_iteration: usize,
+    gamma: f64,
+    tau: f64,
+    norm_fpr: f64,
+    cost: f64,
+    linesearch_backtracks: usize,
+    penalty: f64,
+    infeasibility: f64,
+}
+
+/// Records of the trace, oldest first
+fn trace_points(trace: &IterationTrace) -> Vec<TracePoint> {
+    trace
+        .iter()
+        .map(|record| TracePoint {
+            outer_iteration: record.outer_iteration,
+            inner_iteration: record.inner_iteration,
+            gamma: record.gamma,
+            tau: record.tau,
+            norm_fpr: record.norm_fpr,
+            cost: record.cost,
+            linesearch_backtracks: record.linesearch_backtracks,
+            penalty: record.penalty,
+            infeasibility: record.infeasibility,
+        })
+        .collect()
+}
+
+/// Number of executions and duration of a phase of the solver
+#[derive(Serialize, Debug)]
+struct PhaseStatistics {
+    count: usize,
+    time_ms: f64,
+}
+
+/// Statistics of the phases of the solver, indexed by the names of the
+/// phases; returns `None` if the solver is not built with instrumentation
+fn phase_statistics(statistics: &SolverStatistics) -> Option<BTreeMap<&'static str, PhaseStatistics>> {
+    if !SolverStatistics::is_enabled() {
+        return None;
+    }
+    Some(
+        Phase::ALL
+            .iter()
+            .map(|&phase| {
+                let phase_statistics = PhaseStatistics {
+                    count: statistics.count(phase),
+                    time_ms: (statistics.time(phase).as_nanos() as f64) / 1e6,
+                };
+                (phase.name(), phase_statistics)
+            })
+            .collect(),
+    )
+}
+
+fn pong(stream: &mut std::net::TcpStream, code: i32) -> io::Result<()> {
     let error_message = format!(
         {% raw %}"{{\n\t\"Pong\" : {}\n}}\n"{% endraw %},
         code
     );
-    stream
-        .write_all(error_message.as_bytes())
-        .expect("cannot write to stream");
+    stream.write_all(error_message.as_bytes())
 }
 
 /// Writes an error to the communication stream
-fn write_error_message(stream: &mut std::net::TcpStream, code: i32, error_msg: &str) {
+fn write_error_message(stream: &mut std::net::TcpStream, code: i32, error_msg: &str) -> io::Result<()> {
     let error_message = format!(
         {% raw %}"{{\n\t\"type\" : \"Error\", \n\t\"code\" : {}, \n\t\"message\" : \"{}\"\n}}\n"{% endraw %},
         code,
         error_msg
     );
     warn!("Invalid request {:?}", code);
-    stream
-        .write_all(error_message.as_bytes())
-        .expect("cannot write to stream");
+    stream.write_all(error_message.as_bytes())
 }
 
 /// Serializes the solution and solution status and returns it
@@ -108,8 +253,11 @@ fn write_error_message(stream: &mut std::net::TcpStream, code: i32, error_msg: &
 fn return_solution_to_client(
     status: AlmOptimizerStatus,
     solution: &[f64],
+    queue_wait: Duration,
+    cache_outcome: Option<SolutionCacheOutcome>,
+    trace: Option<&IterationTrace>,
     stream: &mut std::net::TcpStream,
-) {
+) -> io::Result<()> {
     let empty_vec : [f64; 0] = Default::default();
     let solution: OptimizerSolution = OptimizerSolution {
         exit_status: format!("{:?}", status.exit_status()),
@@ -123,22 +271,69 @@ fn return_solution_to_client(
         solve_time_ms: (status.solve_time().as_nanos() as f64) / 1e6,
         solution,
         cost: status.cost(),
+        queue_wait_ms: (queue_wait.as_nanos() as f64) / 1e6,
+        statistics: phase_statistics(status.statistics()),
+        cache_hit: cache_outcome.map(|outcome| outcome.is_hit()),
+        iterations_saved: cache_outcome.map(|outcome| outcome.iterations_saved()),
+        trace: trace.map(trace_points),
+    };
+    let solution_json = serde_json::to_vec(&solution).unwrap();
+    stream.write_all(&solution_json)
+}
 
+/// Runs the solver, with a deadline if one is provided (in microseconds)
+///
+/// If the server has a cache of recent solutions and the client has not
+/// provided a warm start (initial guess, Lagrange multipliers or penalty),
+/// the solve is seeded with the cached solution of the nearest parameter; the
+/// solution is then recorded in the cache. The cache is locked only while it
+/// is looked up and updated, not during the solve.
+fn run_solver(
+    p: &[f64],
+    cache: &mut SolverCache,
+    u: &mut [f64],
+    y0: &Option<Vec<f64>>,
+    c0: &Option<f64>,
+    initial_guess_provided: bool,
+    deadline_micros: Option<u64>,
+    solution_cache: Option<&mut SharedSolutionCache>,
+) -> (Result<AlmOptimizerStatus, SolverError>, Option<SolutionCacheOutcome>) {
+    let mut solve_once = |u: &mut [f64], y0: &Option<Vec<f64>>, c0: &Option<f64>| match deadline_micros {
+        Some(micros) => solve_with_deadline(p, cache, u, y0, c0, Duration::from_micros(micros)),
+        None => solve(p, cache, u, y0, c0),
+    };
+    let solution_cache = match solution_cache {
+        Some(solution_cache) => solution_cache,
+        None => return (solve_once(u, y0, c0), None),
+    };
+
+    let seed = if initial_guess_provided || y0.is_some() || c0.is_some() {
+        None
+    } else {
+        let y_seed = solution_cache.y0.as_deref_mut().unwrap_or(&mut []);
+        solution_cache.solutions.lock().unwrap().seed(p, u, y_seed)
+    };
+    let status = match seed {
+        Some(seed) => solve_once(u, &solution_cache.y0, &Some(seed.penalty())),
+        None => solve_once(u, y0, c0),
     };
-    let solution_json = serde_json::to_string_pretty(&solution).unwrap();
-    stream
-        .write_all(solution_json.as_bytes())
-        .expect("cannot write to stream");
+    let outcome = match &status {
+        Ok(solver_status) => solution_cache.solutions.lock().unwrap().record(p, u, solver_status, seed),
+        Err(_) => SolutionCacheOutcome::default(),
+    };
+    (status, Some(outcome))
 }
 
 /// Handles an execution request
 fn execution_handler(
-    cache: &mut AlmCache,
+    cache: &mut SolverCache,
+    solution_cache: Option<&mut SharedSolutionCache>,
     execution_parameter: &ExecutionParameter,
     u: &mut [f64],
     p: &mut [f64],
+    queue_wait: Duration,
     stream: &mut std::net::TcpStream,
-) {
+) -> io::Result<()> {
     // ----------------------------------------------------
     // Set initial value
     // ----------------------------------------------------
@@ -150,8 +345,7 @@ fn execution_handler(
         Some(u0) => {
             if u0.len() != {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES {
                 warn!("initial guess has incompatible dimensions");
-                write_error_message(stream, 1600, "Initial guess has incompatible dimensions");
-                return;
+                return write_error_message(stream, 1600, "Initial guess has incompatible dimensions");
             }
             u.copy_from_slice(u0);
         }
@@ -162,8 +356,7 @@ fn execution_handler(
     // ----------------------------------------------------
     if let Some(y0) = &execution_parameter.initial_lagrange_multipliers {
         if y0.len() != {{meta.optimizer_name|upper}}_N1 {
-            write_error_message(stream, 1700, "wrong dimension of Langrange multipliers");
-            return;
+            return write_error_message(stream, 1700, "wrong dimension of Langrange multipliers");
         }
     }
 
@@ -172,74 +365,449 @@ fn execution_handler(
     // ----------------------------------------------------
     let parameter = &execution_parameter.parameter;
     if parameter.len() != {{meta.optimizer_name|upper}}_NUM_PARAMETERS {
-        write_error_message(stream, 3003, "wrong number of parameters");
-        return;
+        return write_error_message(stream, 3003, "wrong number of parameters");
     }
     p.copy_from_slice(parameter);
-    let status = solve(p,
-                       cache,
-                       u,
-                       &execution_parameter.initial_lagrange_multipliers,
-                       &execution_parameter.initial_penalty);
+    let (status, cache_outcome) = run_solver(p,
+                                             cache,
+                                             u,
+                                             &execution_parameter.initial_lagrange_multipliers,
+                                             &execution_parameter.initial_penalty,
+                                             initial_guess.is_some(),
+                                             execution_parameter.deadline_micros,
+                                             solution_cache);
     match status {
         Ok(ok_status) => {
-            return_solution_to_client(ok_status, u, stream);
+            let trace = cache.alm_cache().trace();
+            return_solution_to_client(ok_status, u, queue_wait, cache_outcome, trace, stream)
         }
+        Err(_) => write_error_message(stream, 2000, "Problem solution failed (solver error)"),
+    }
+}
+
+/// Reads a request from a connection and serves it
+///
+/// Errors of the connection (e.g., a client that resets it or closes it
+/// before the response has been written) are logged and the connection is
+/// dropped, so that the worker goes on serving the next connection.
+///
+/// Returns `true` if the client has requested the server to quit
+fn connection_handler(
+    cache: &mut SolverCache,
+    solution_cache: &mut Option<SharedSolutionCache>,
+    u: &mut [f64],
+    p: &mut [f64],
+    queue_wait: Duration,
+    stream: &mut TcpStream,
+) -> bool {
+    match serve_connection(cache, solution_cache, u, p, queue_wait, stream) {
+        Ok(kill_requested) => kill_requested,
+        Err(error) => {
+            warn!("Dropping connection: {}", error);
+            false
+        }
+    }
+}
+
+fn serve_connection(
+    cache: &mut SolverCache,
+    solution_cache: &mut Option<SharedSolutionCache>,
+    u: &mut [f64],
+    p: &mut [f64],
+    queue_wait: Duration,
+    stream: &mut TcpStream,
+) -> io::Result<bool> {
+    // Read the first bytes to find out which protocol the client uses
+    let mut head = [0u8; 4];
+    let mut head_length = 0;
+    while head_length < head.len() {
+        let read_data_length = stream.read(&mut head[head_length..])?;
+        if read_data_length == 0 {
+            break;
+        }
+        head_length += read_data_length;
+    }
+    if &head == BINARY_PROTOCOL_MAGIC {
+        return binary_session(cache, solution_cache, u, p, queue_wait, stream);
+    }
+
+    // JSON request: the client closes its write side once it has sent the request
+    let mut buffer = Vec::with_capacity(READ_BUFFER_SIZE);
+    buffer.extend_from_slice(&head[..head_length]);
+    stream.read_to_end(&mut buffer)?;
+
+    let received_request: serde_json::Result<ClientRequest> = serde_json::from_slice(&buffer);
+    trace!("Received new request");
+    match received_request {
+        Ok(request_content) => match request_content {
+            ClientRequest::Run(execution_param) => {
+                trace!("Running solver");
+                execution_handler(cache,
+                                  solution_cache.as_mut(),
+                                  &execution_param,
+                                  u,
+                                  p,
+                                  queue_wait,
+                                  stream)?;
+            }
+            ClientRequest::Kill(kill_code) => {
+                info!("Quitting on request (kill code: {})", kill_code);
+                return Ok(true);
+            }
+            ClientRequest::Ping(ping_code) => {
+                info!("Ping received");
+                pong(stream, ping_code)?;
+            }
+        },
         Err(_) => {
-            write_error_message(stream, 2000, "Problem solution failed (solver error)");
+            write_error_message(stream, 1000, "Invalid request")?;
         }
     }
+    Ok(false)
 }
 
-fn run_server(tcp_config: &TcpServerConfiguration) {
-    info!("Initializing cache...");
-    let mut p = [0.0; {{meta.optimizer_name|upper}}_NUM_PARAMETERS];
-    let mut cache = initialize_solver();
-    info!("Done");
-    let listener = TcpListener::bind(format!("{}:{}", tcp_config.ip, tcp_config.port)).unwrap();
-    let mut u = [0.0; {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES];
-    info!("listening started, ready to accept connections at {}:{}", tcp_config.ip, tcp_config.port);
-    for stream in listener.incoming() {
-        let mut stream = stream.unwrap();
-
-        //The following is more robust compared to `read_to_string`
-        let mut bytes_buffer = vec![0u8; READ_BUFFER_SIZE];
-        let mut read_data_length = 1;
-        let mut buffer = String::new();
-        while read_data_length != 0 {
-            read_data_length = stream
-                .read(&mut bytes_buffer)
-                .expect("could not read stream");
-            let new_string = String::from_utf8(bytes_buffer[0..read_data_length].to_vec())
-                .expect("sent data is not UFT-8");
-            buffer.push_str(&new_string);
+/// Reads little-endian values from a frame of the binary protocol
+struct FrameReader<'a> {
+    data: &'a [u8],
+}
+
+impl<'a> FrameReader<'a> {
+    fn take(&mut self, len: usize) -> Option<&'a [u8]> {
+        if self.data.len() < len {
+            return None;
+        }
+        let (head, tail) = self.data.split_at(len);
+        self.data = tail;
+        Some(head)
+    }
+
+    fn read_u8(&mut self) -> Option<u8> {
+        self.take(1).map(|b| b[0])
+    }
+
+    fn read_u32(&mut self) -> Option<u32> {
+        let mut bytes = [0u8; 4];
+        bytes.copy_from_slice(self.take(4)?);
+        Some(u32::from_le_bytes(bytes))
+    }
+
+    fn read_u64(&mut self) -> Option<u64> {
+        let mut bytes = [0u8; 8];
+        bytes.copy_from_slice(self.take(8)?);
+        Some(u64::from_le_bytes(bytes))
+    }
+
+    fn read_f64(&mut self) -> Option<f64> {
+        let mut bytes = [0u8; 8];
+        bytes.copy_from_slice(self.take(8)?);
+        Some(f64::from_le_bytes(bytes))
+    }
+
+    /// Reads an array of the form `[length: u32, values: f64...]`; returns
+    /// `None` if the frame is malformed and `Some(false)` if the length of the
+    /// array is not equal to `out.len()`
+    fn read_f64_array_into(&mut self, out: &mut [f64]) -> Option<bool> {
+        let len = self.read_u32()? as usize;
+        let bytes = self.take(8 * len)?;
+        if len != out.len() {
+            return Some(false);
+        }
+        for (out_i, bytes_i) in out.iter_mut().zip(bytes.chunks_exact(8)) {
+            let mut value = [0u8; 8];
+            value.copy_from_slice(bytes_i);
+            *out_i = f64::from_le_bytes(value);
+        }
+        Some(true)
+    }
+}
+
+/// Writes a response frame of the binary protocol, `[length: u32, payload]`
+fn write_binary_frame(stream: &mut TcpStream, frame: &mut Vec<u8>) -> io::Result<()> {
+    let payload_length = (frame.len() - 4) as u32;
+    frame[..4].copy_from_slice(&payload_length.to_le_bytes());
+    stream.write_all(frame)
+}
+
+/// Starts a new response frame of the given type
+fn start_binary_frame(frame: &mut Vec<u8>, response_type: u8) {
+    frame.clear();
+    frame.extend_from_slice(&[0u8; 4]);
+    frame.push(response_type);
+}
+
+fn push_f64_array(frame: &mut Vec<u8>, values: &[f64]) {
+    frame.extend_from_slice(&(values.len() as u32).to_le_bytes());
+    for value in values {
+        frame.extend_from_slice(&value.to_le_bytes());
+    }
+}
+
+/// Writes an error to the communication stream (binary protocol)
+fn write_binary_error(stream: &mut TcpStream, frame: &mut Vec<u8>, code: i32, error_msg: &str) -> io::Result<()> {
+    warn!("Invalid request {:?}", code);
+    start_binary_frame(frame, BINARY_RESPONSE_ERROR);
+    frame.extend_from_slice(&code.to_le_bytes());
+    frame.extend_from_slice(&(error_msg.len() as u32).to_le_bytes());
+    frame.extend_from_slice(error_msg.as_bytes());
+    write_binary_frame(stream, frame)
+}
+
+/// Serves the requests of a client that uses the binary protocol
+///
+/// The connection is kept open and requests are served until the client
+/// closes it. Every request is a frame `[length: u32, payload]`, where all
+/// numbers are little-endian. The payload of a request starts with its type:
+///
+/// - run: `[1: u8, flags: u8, p, u0 (optional), y0 (optional), c0: f64 (optional),
+///   deadline_micros: u64 (optional)]`, where every array is
+///   `[length: u32, values: f64...]` and the flags indicate which of the
+///   optional fields are present
+/// - ping: `[2: u8, code: i32]`
+/// - kill: `[3: u8]`
+///
+/// If the server has a cache of recent solutions, the response to a run
+/// request ends with `[cache_hit: u8, iterations_saved: u64]`.
+///
+/// Returns `true` if the client has requested the server to quit
+fn binary_session(
+    cache: &mut SolverCache,
+    solution_cache: &mut Option<SharedSolutionCache>,
+    u: &mut [f64],
+    p: &mut [f64],
+    queue_wait: Duration,
+    stream: &mut TcpStream,
+) -> io::Result<bool> {
+    stream.set_nodelay(true)?;
+    let mut queue_wait = queue_wait;
+    let mut request = Vec::with_capacity(BINARY_MAX_FRAME_SIZE);
+    let mut response = Vec::with_capacity(READ_BUFFER_SIZE);
+    let mut y0: Option<Vec<f64>> = Some(vec![0.0; {{meta.optimizer_name|upper}}_N1]);
+    let no_y0: Option<Vec<f64>> = None;
+
+    loop {
+        let mut length_bytes = [0u8; 4];
+        if stream.read_exact(&mut length_bytes).is_err() {
+            return Ok(false); // the client has closed the connection
+        }
+        let request_length = u32::from_le_bytes(length_bytes) as usize;
+        if request_length > BINARY_MAX_FRAME_SIZE {
+            write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+            return Ok(false);
+        }
+        request.resize(request_length, 0);
+        if stream.read_exact(&mut request).is_err() {
+            return Ok(false);
         }
 
-        let received_request: serde_json::Result<ClientRequest> = serde_json::from_str(&buffer);
-        trace!("Received new request");
-        match received_request {
-            Ok(request_content) => match request_content {
-                ClientRequest::Run(execution_param) => {
-                    trace!("Running solver");
-                    execution_handler(&mut cache,
-                                      &execution_param,
-                                      &mut u,
-                                      &mut p,
-                                      &mut stream);
+        let mut reader = FrameReader { data: &request };
+        match reader.read_u8() {
+            Some(BINARY_REQUEST_RUN) => {
+                trace!("Running solver");
+                let flags = match reader.read_u8() {
+                    Some(flags) => flags,
+                    None => {
+                        write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+                        continue;
+                    }
+                };
+                match reader.read_f64_array_into(p) {
+                    Some(true) => {}
+                    Some(false) => {
+                        write_binary_error(stream, &mut response, 3003, "wrong number of parameters")?;
+                        continue;
+                    }
+                    None => {
+                        write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+                        continue;
+                    }
                 }
-                ClientRequest::Kill(kill_code) => {
-                    info!("Quitting on request (kill code: {})", kill_code);
-                    break;
+                if flags & BINARY_FLAG_INITIAL_GUESS != 0 {
+                    match reader.read_f64_array_into(u) {
+                        Some(true) => {}
+                        Some(false) => {
+                            write_binary_error(stream, &mut response, 1600, "Initial guess has incompatible dimensions")?;
+                            continue;
+                        }
+                        None => {
+                            write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+                            continue;
+                        }
+                    }
                 }
-                ClientRequest::Ping(ping_code) => {
-                    info!("Ping received");
-                    pong(&mut stream, ping_code);
+                if flags & BINARY_FLAG_INITIAL_Y != 0 {
+                    match reader.read_f64_array_into(y0.as_mut().unwrap()) {
+                        Some(true) => {}
+                        Some(false) => {
+                            write_binary_error(stream, &mut response, 1700, "wrong dimension of Langrange multipliers")?;
+                            continue;
+                        }
+                        None => {
+                            write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+                            continue;
+                        }
+                    }
                 }
-            },
-            Err(_) => {
-                write_error_message(&mut stream, 1000, "Invalid request");
+                let c0 = if flags & BINARY_FLAG_INITIAL_PENALTY != 0 {
+                    match reader.read_f64() {
+                        Some(c0) => Some(c0),
+                        None => {
+                            write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+                            continue;
+                        }
+                    }
+                } else {
+                    None
+                };
+                let deadline_micros = if flags & BINARY_FLAG_DEADLINE != 0 {
+                    match reader.read_u64() {
+                        Some(micros) => Some(micros),
+                        None => {
+                            write_binary_error(stream, &mut response, 1000, "Invalid request")?;
+                            continue;
+                        }
+                    }
+                } else {
+                    None
+                };
+                let initial_y = if flags & BINARY_FLAG_INITIAL_Y != 0 { &y0 } else { &no_y0 };
+
+                let initial_guess_provided = flags & BINARY_FLAG_INITIAL_GUESS != 0;
+                let (status, cache_outcome) = run_solver(p,
+                                                         cache,
+                                                         u,
+                                                         initial_y,
+                                                         &c0,
+                                                         initial_guess_provided,
+                                                         deadline_micros,
+                                                         solution_cache.as_mut());
+                match status {
+                    Ok(status) => {
+                        start_binary_frame(&mut response, BINARY_RESPONSE_SOLUTION);
+                        response.push(match status.exit_status() {
+                            ExitStatus::Converged => 0,
+                            ExitStatus::NotConvergedIterations => 1,
+                            ExitStatus::NotConvergedOutOfTime => 2,
+                        });
+                        response.extend_from_slice(&(status.num_outer_iterations() as u64).to_le_bytes());
+                        response.extend_from_slice(&(status.num_inner_iterations() as u64).to_le_bytes());
+                        for value in &[
+                            status.last_problem_norm_fpr(),
+                            status.delta_y_norm_over_c(),
+                            status.f2_norm(),
+                            (status.solve_time().as_nanos() as f64) / 1e6,
+                            status.penalty(),
+                            status.cost(),
+                            (queue_wait.as_nanos() as f64) / 1e6,
+                        ] {
+                            response.extend_from_slice(&value.to_le_bytes());
+                        }
+                        push_f64_array(&mut response, u);
+                        push_f64_array(&mut response, status.lagrange_multipliers().as_deref().unwrap_or(&[]));
+                        if let Some(outcome) = cache_outcome {
+                            response.push(outcome.is_hit() as u8);
+                            response.extend_from_slice(&(outcome.iterations_saved() as u64).to_le_bytes());
+                        }
+                        write_binary_frame(stream, &mut response)?;
+                    }
+                    Err(_) => {
+                        write_binary_error(stream, &mut response, 2000, "Problem solution failed (solver error)")?;
+                    }
+                }
+            }
+            Some(BINARY_REQUEST_PING) => {
+                info!("Ping received");
+                let mut code = [0u8; 4];
+                code.copy_from_slice(reader.take(4).unwrap_or(&[0u8; 4]));
+                start_binary_frame(&mut response, BINARY_RESPONSE_PONG);
+                response.extend_from_slice(&code);
+                write_binary_frame(stream, &mut response)?;
+            }
+            Some(BINARY_REQUEST_KILL) => {
+                info!("Quitting on request (binary protocol)");
+                return Ok(true);
+            }
+            _ => {
+                write_binary_error(stream, &mut response, 1000, "Invalid request")?;
             }
         }
+        // only the first request of the connection has waited in the queue
+        queue_wait = Duration::from_secs(0);
+    }
+}
+
+/// Connection that has been accepted and waits for a worker
+type QueuedConnection = (TcpStream, Instant);
+
+fn run_server(tcp_config: &TcpServerConfiguration) {
+    let listener = TcpListener::bind(format!("{}:{}", tcp_config.ip, tcp_config.port)).unwrap();
+    let mut wake_up_address = listener.local_addr().unwrap();
+    if wake_up_address.ip().is_unspecified() {
+        wake_up_address.set_ip(std::net::Ipv4Addr::LOCALHOST.into());
+    }
+
+    // Bounded queue of connections; when it is full, the listener blocks and
+    // stops accepting new connections until a worker becomes available
+    let (sender, receiver) = mpsc::sync_channel::<QueuedConnection>(tcp_config.max_queue_size);
+    let receiver = Arc::new(Mutex::new(receiver));
+    let kill_requested = Arc::new(AtomicBool::new(false));
+    let solutions = if tcp_config.solution_cache_size > 0 {
+        info!("Solution cache with room for {} solution(s)", tcp_config.solution_cache_size);
+        Some(Arc::new(Mutex::new(initialize_solution_cache(tcp_config.solution_cache_size))))
+    } else {
+        None
+    };
+
+    info!("Initializing {} worker(s)...", tcp_config.num_workers);
+    let workers: Vec<_> = (0..tcp_config.num_workers)
+        .map(|_| {
+            let receiver = Arc::clone(&receiver);
+            let kill_requested = Arc::clone(&kill_requested);
+            // Each worker owns its own solver cache and buffers
+            let mut cache = initialize_solver();
+            let mut solution_cache = solutions.as_ref().map(SharedSolutionCache::new);
+            thread::spawn(move || {
+                let mut p = [0.0; {{meta.optimizer_name|upper}}_NUM_PARAMETERS];
+                let mut u = [0.0; {{meta.optimizer_name|upper}}_NUM_DECISION_VARIABLES];
+                loop {
+                    let next_connection = receiver.lock().unwrap().recv();
+                    let (mut stream, queued_at) = match next_connection {
+                        Ok(connection) => connection,
+                        Err(_) => break, // the listener has shut down
+                    };
+                    if connection_handler(&mut cache, &mut solution_cache, &mut u, &mut p, queued_at.elapsed(), &mut stream) {
+                        kill_requested.store(true, Ordering::SeqCst);
+                        // wake up the listener, which is blocked in `accept`
+                        let _ = TcpStream::connect(wake_up_address);
+                    }
+                }
+            })
+        })
+        .collect();
+    info!("Done");
+
+    info!("listening started, ready to accept connections at {}:{}", tcp_config.ip, tcp_config.port);
+    for stream in listener.incoming() {
+        if kill_requested.load(Ordering::SeqCst) {
+            break;
+        }
+        let stream = match stream {
+            Ok(stream) => stream,
+            Err(error) => {
+                warn!("Could not accept connection: {}", error);
+                continue;
+            }
+        };
+        if sender.send((stream, Instant::now())).is_err() {
+            break;
+        }
+    }
+
+    // Let the workers serve the connections that are still in the queue
+    drop(sender);
+    for worker in workers {
+        if worker.join().is_err() {
+            error!("A worker thread has panicked");
+        }
     }
 }
 
@@ -258,10 +826,28 @@ fn main() {
                  .long("port")
                  .takes_value(true)
                  .help("TCP server port"))
+        .arg(Arg::with_name("workers")
+                 .short("w")
+                 .long("workers")
+                 .takes_value(true)
+                 .help("Number of worker threads"))
+        .arg(Arg::with_name("queue-size")
+                 .short("q")
+                 .long("queue-size")
+                 .takes_value(true)
+                 .help("Maximum number of connections waiting for a worker"))
+        .arg(Arg::with_name("solution-cache-size")
+                 .short("c")
+                 .long("solution-cache-size")
+                 .takes_value(true)
+                 .help("Capacity of the cache of recent solutions (0: no cache)"))
         .get_matches();
     let port = value_t!(matches, "port", u32).unwrap_or(BIND_PORT_DEFAULT);
     let ip = matches.value_of("ip").unwrap_or(BIND_IP_DEFAULT);
-    let server_config = TcpServerConfiguration {ip, port};
+    let num_workers = value_t!(matches, "workers", usize).unwrap_or(NUM_WORKERS_DEFAULT).max(1);
+    let max_queue_size = value_t!(matches, "queue-size", usize).unwrap_or(MAX_QUEUE_SIZE_DEFAULT).max(1);
+    let solution_cache_size = value_t!(matches, "solution-cache-size", usize).unwrap_or(SOLUTION_CACHE_SIZE_DEFAULT);
+    let server_config = TcpServerConfiguration {ip, port, num_workers, max_queue_size, solution_cache_size};
 
     pretty_env_logger::init();
     info!("{:?}", server_config);
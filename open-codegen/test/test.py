@@ -1,9 +1,13 @@
 import os
+import json
 import unittest
+import unittest.mock
 import casadi.casadi as cs
 import opengen as og
 import subprocess
 import logging
+import socket
+import struct
 
 
 class RustBuildTestCase(unittest.TestCase):
@@ -92,7 +96,9 @@ class RustBuildTestCase(unittest.TestCase):
         phi = og.functions.rosenbrock(u, p)
         bounds = og.constraints.Ball2(None, 1.5)
         tcp_config = og.config.TcpServerConfiguration(
-            bind_port=3302 if not is_preconditioned else 3309)
+            bind_port=3302 if not is_preconditioned else 3309,
+            num_workers=2,
+            solution_cache_size=0 if is_preconditioned else 8)
         meta = og.config.OptimizerMeta() \
             .with_optimizer_name("only_f2" + ("_precond" if is_preconditioned else ""))
         problem = og.builder.Problem(u, p, phi) \
@@ -111,7 +117,8 @@ class RustBuildTestCase(unittest.TestCase):
             .with_penalty_weight_update_factor(10.0) \
             .with_max_inner_iterations(1000) \
             .with_max_outer_iterations(50) \
-            .with_preconditioning(is_preconditioned)
+            .with_preconditioning(is_preconditioned) \
+            .with_preconditioning_reuse(0.05, 10)
         og.builder.OpEnOptimizerBuilder(problem,
                                         metadata=meta,
                                         build_configuration=build_config,
@@ -134,11 +141,66 @@ class RustBuildTestCase(unittest.TestCase):
             .with_build_directory(RustBuildTestCase.TEST_DIR) \
             .with_build_mode(og.config.BuildConfiguration.DEBUG_MODE) \
             .with_tcp_interface_config(tcp_interface_config=tcp_config) \
-            .with_build_c_bindings()
+            .with_shm_interface_config(og.config.ShmServerConfiguration(
+                path=os.path.join(RustBuildTestCase.TEST_DIR, 'plain.shm'))) \
+            .with_build_c_bindings() \
+            .with_instrumentation(timing=True)
         og.builder.OpEnOptimizerBuilder(problem,
                                         metadata=meta,
                                         build_configuration=build_config,
-                                        solver_configuration=cls.solverConfig()) \
+                                        solver_configuration=cls.solverConfig().with_trace(50)) \
+            .build()
+
+    @classmethod
+    def setUpSinglePrecision(cls):
+        u = cs.MX.sym("u", 5)  # decision variable (nu = 5)
+        p = cs.MX.sym("p", 2)  # parameter (np = 2)
+        phi = og.functions.rosenbrock(u, p)
+        c = 1.5 * u[0] - u[1]
+        bounds = og.constraints.Ball2(None, 1.5)
+        tcp_config = og.config.TcpServerConfiguration(bind_port=4600)
+        meta = og.config.OptimizerMeta() \
+            .with_optimizer_name("single_precision")
+        problem = og.builder.Problem(u, p, phi) \
+            .with_aug_lagrangian_constraints(c, og.constraints.Zero()) \
+            .with_constraints(bounds)
+        build_config = og.config.BuildConfiguration() \
+            .with_open_version(local_path=RustBuildTestCase.get_open_local_absolute_path()) \
+            .with_build_directory(RustBuildTestCase.TEST_DIR) \
+            .with_build_mode(og.config.BuildConfiguration.DEBUG_MODE) \
+            .with_tcp_interface_config(tcp_interface_config=tcp_config)
+        solver_config = cls.solverConfig().with_single_precision()
+        og.builder.OpEnOptimizerBuilder(problem,
+                                        metadata=meta,
+                                        build_configuration=build_config,
+                                        solver_configuration=solver_config) \
+            .build()
+
+    @classmethod
+    def setUpFusedCostAndGradient(cls):
+        u = cs.MX.sym("u", 5)  # decision variable (nu = 5)
+        p = cs.MX.sym("p", 2)  # parameter (np = 2)
+        phi = og.functions.rosenbrock(u, p)
+        c = 1.5 * u[0] - u[1]
+        bounds = og.constraints.Ball2(None, 1.5)
+        tcp_config = og.config.TcpServerConfiguration(bind_port=4601)
+        meta = og.config.OptimizerMeta() \
+            .with_optimizer_name("fused_cost_and_grad")
+        problem = og.builder.Problem(u, p, phi) \
+            .with_aug_lagrangian_constraints(c, og.constraints.Zero()) \
+            .with_constraints(bounds)
+        build_config = og.config.BuildConfiguration() \
+            .with_open_version(local_path=RustBuildTestCase.get_open_local_absolute_path()) \
+            .with_build_directory(RustBuildTestCase.TEST_DIR) \
+            .with_build_mode(og.config.BuildConfiguration.DEBUG_MODE) \
+            .with_tcp_interface_config(tcp_interface_config=tcp_config)
+        solver_config = cls.solverConfig() \
+            .with_fused_cost_and_gradient() \
+            .with_lbfgs_warm_start("solves")
+        og.builder.OpEnOptimizerBuilder(problem,
+                                        metadata=meta,
+                                        build_configuration=build_config,
+                                        solver_configuration=solver_config) \
             .build()
 
     @classmethod
@@ -158,6 +220,7 @@ class RustBuildTestCase(unittest.TestCase):
             .with_package_name("parametric_optimizer") \
             .with_node_name("open_node") \
             .with_rate(35) \
+            .with_solve_on_request() \
             .with_description("really cool ROS node")
         build_config = og.config.BuildConfiguration() \
             .with_open_version(local_path=RustBuildTestCase.get_open_local_absolute_path())  \
@@ -233,6 +296,8 @@ class RustBuildTestCase(unittest.TestCase):
         cls.setUpOnlyF2()
         cls.setUpOnlyF2(is_preconditioned=True)
         cls.setUpPlain()
+        cls.setUpSinglePrecision()
+        cls.setUpFusedCostAndGradient()
         cls.setUpOnlyParametricF2()
         cls.setUpHalfspace()
 
@@ -250,6 +315,28 @@ class RustBuildTestCase(unittest.TestCase):
         result = solver.run([1., 2.])
         self.assertIsNotNone(result.solution)
 
+    def test_python_bindings_numpy(self):
+        import sys
+        import os
+        import numpy as np
+
+        sys.path.insert(1, os.path.join(
+            RustBuildTestCase.TEST_DIR, "python_bindings"))
+        import python_bindings
+
+        solver = python_bindings.solver()
+        # numpy arrays are accepted (and returned)
+        result = solver.run(np.array([1., 2.]), initial_guess=np.zeros(5))
+        self.assertEqual("Converged", result.exit_status)
+        self.assertEqual((5,), result.solution.shape)
+
+        # batch of parameters (one per row), solved in parallel
+        params = np.array([[1., 2.], [1., 5.], [2., 10.]])
+        batch = solver.run_batch(params, num_workers=2)
+        self.assertEqual((3, 5), batch.solution.shape)
+        self.assertEqual(["Converged"] * 3, batch.exit_status)
+        self.assertTrue(np.allclose(result.solution, batch.solution[0], atol=1e-4))
+
     def test_rectangle_empty(self):
         xmin = [-1, 2]
         xmax = [-2, 4]
@@ -302,6 +389,307 @@ class RustBuildTestCase(unittest.TestCase):
         with self.assertRaises(Exception) as __context:
             og.config.SolverConfiguration().with_max_inner_iterations()
 
+    def test_solver_config_wrong_horizon_shift(self):
+        with self.assertRaises(Exception) as __context:
+            og.config.SolverConfiguration().with_horizon_shift(0, 10)
+        with self.assertRaises(Exception) as __context:
+            og.config.SolverConfiguration().with_horizon_shift(2, 1.5)
+
+    def test_solver_config_lbfgs_warm_start(self):
+        solver_config = og.config.SolverConfiguration()
+        self.assertEqual("cold", solver_config.lbfgs_warm_start)
+        solver_config.with_lbfgs_warm_start()
+        self.assertEqual("outer_iterations", solver_config.to_dict()["lbfgs_warm_start"])
+        with self.assertRaises(ValueError) as __context:
+            solver_config.with_lbfgs_warm_start("always")
+
+    def test_solver_config_anderson_acceleration(self):
+        solver_config = og.config.SolverConfiguration()
+        self.assertIsNone(solver_config.anderson_memory)
+        solver_config.with_anderson_acceleration(3)
+        self.assertEqual(3, solver_config.to_dict()["anderson_memory"])
+        with self.assertRaises(ValueError) as __context:
+            solver_config.with_anderson_acceleration(0)
+
+    def test_solver_config_preconditioning_reuse(self):
+        solver_config = og.config.SolverConfiguration()
+        self.assertIsNone(solver_config.preconditioning_reuse_threshold)
+        solver_config.with_preconditioning_reuse(0.1, 5)
+        self.assertEqual(0.1, solver_config.to_dict()["preconditioning_reuse_threshold"])
+        self.assertEqual(5, solver_config.preconditioning_reuse_max_solves)
+        with self.assertRaises(ValueError) as __context:
+            solver_config.with_preconditioning_reuse(-1.0)
+        with self.assertRaises(ValueError) as __context:
+            solver_config.with_preconditioning_reuse(0.1, 0)
+
+    def test_solver_config_trace(self):
+        solver_config = og.config.SolverConfiguration()
+        self.assertIsNone(solver_config.trace_capacity)
+        solver_config.with_trace(200)
+        self.assertEqual(200, solver_config.to_dict()["trace_capacity"])
+        solver_config.with_trace(None)
+        self.assertIsNone(solver_config.trace_capacity)
+        with self.assertRaises(ValueError) as __context:
+            solver_config.with_trace(0)
+
+    def test_build_config_instrumentation_features(self):
+        build_config = og.config.BuildConfiguration() \
+            .with_allocator(og.config.RustAllocator.JemAlloc)
+        self.assertEqual(["jem"], build_config.open_features)
+        build_config.with_instrumentation()
+        self.assertEqual(["jem", "instrumentation"], build_config.open_features)
+        build_config.with_instrumentation(timing=True)
+        self.assertTrue(build_config.instrumentation)
+        self.assertEqual(["jem", "instrumentation-timing"], build_config.open_features)
+
+    def test_build_config_static_memory(self):
+        build_config = og.config.BuildConfiguration()
+        self.assertFalse(build_config.static_memory)
+        build_config.with_static_memory(size_bytes=65536)
+        self.assertTrue(build_config.to_dict()["static_memory"])
+        self.assertEqual(65536, build_config.static_memory_bytes)
+        with self.assertRaises(ValueError) as __context:
+            build_config.with_static_memory(size_bytes=0)
+
+    def test_build_config_static_memory_with_tcp(self):
+        u = cs.SX.sym("u", 2)
+        p = cs.SX.sym("p", 1)
+        problem = og.builder.Problem(u, p, cs.dot(u, u)) \
+            .with_constraints(og.constraints.Ball2(None, 1.0))
+        build_config = og.config.BuildConfiguration() \
+            .with_build_directory(RustBuildTestCase.TEST_DIR) \
+            .with_tcp_interface_config() \
+            .with_static_memory()
+        builder = og.builder.OpEnOptimizerBuilder(problem,
+                                                  og.config.OptimizerMeta().with_optimizer_name("static_tcp"),
+                                                  build_config,
+                                                  og.config.SolverConfiguration())
+        with self.assertRaises(ValueError) as __context:
+            builder.build()
+
+    def test_rust_build_static_memory(self):
+        u = cs.SX.sym("u", 5)
+        p = cs.SX.sym("p", 2)
+        cost = cs.sumsqr(u - p[0]) + p[1] * u[0]
+        f1 = cs.vertcat(u[0] + u[1], u[2] - u[3])
+        # the sets are constructed with the cache (the Cartesian products
+        # allocate their index vectors and the affine space its factorisation)
+        bounds = og.constraints.CartesianProduct(
+            [1, 4], [og.constraints.Ball2(None, 1.5),
+                     og.constraints.AffineSpace([1., 1., 1.], [1.])])
+        set_c = og.constraints.CartesianProduct(
+            [0, 1], [og.constraints.BallInf(None, 0.5), og.constraints.Ball2(None, 0.5)])
+        problem = og.builder.Problem(u, p, cost) \
+            .with_constraints(bounds) \
+            .with_aug_lagrangian_constraints(f1, set_c)
+        build_config = og.config.BuildConfiguration() \
+            .with_open_version(local_path=RustBuildTestCase.get_open_local_absolute_path()) \
+            .with_build_directory(RustBuildTestCase.TEST_DIR) \
+            .with_build_mode(og.config.BuildConfiguration.DEBUG_MODE) \
+            .with_build_c_bindings() \
+            .with_static_memory()
+        og.builder.OpEnOptimizerBuilder(problem,
+                                        og.config.OptimizerMeta().with_optimizer_name("static_memory"),
+                                        build_config,
+                                        RustBuildTestCase.solverConfig()) \
+            .build()
+        with open(os.path.join(RustBuildTestCase.TEST_DIR, "static_memory", "src", "lib.rs")) as fh:
+            self.assertIn("STATIC_MEMORY_STATIC_MEMORY_BYTES", fh.read())
+
+        # solve many times in a row: if memory were leaked, the static buffer
+        # would be exhausted (and the program would abort)
+        optimizer_dir = os.path.join(RustBuildTestCase.TEST_DIR, "static_memory")
+        test_program = os.path.join(optimizer_dir, "test_static_memory")
+        p = subprocess.Popen(["/usr/bin/gcc",
+                              os.path.join(os.path.dirname(os.path.abspath(__file__)), "test_static_memory.c"),
+                              "-I" + optimizer_dir,
+                              "-pthread",
+                              os.path.join(optimizer_dir, "target", "debug", "libstatic_memory.a"),
+                              "-lm",
+                              "-ldl",
+                              "-std=c99",
+                              "-o",
+                              test_program])
+        p.communicate()
+        self.assertEqual(0, p.returncode)
+        p = subprocess.Popen([test_program], stdout=subprocess.DEVNULL)
+        p.communicate()
+        self.assertEqual(0, p.returncode)
+
+    def test_build_cache(self):
+        u = cs.SX.sym("u", 3)
+        p = cs.SX.sym("p", 1)
+
+        def generate(cost, tolerance):
+            problem = og.builder.Problem(u, p, cost) \
+                .with_constraints(og.constraints.Ball2(None, 1.0))
+            build_config = og.config.BuildConfiguration() \
+                .with_build_directory(RustBuildTestCase.TEST_DIR) \
+                .with_build_cache()
+            og.builder.OpEnOptimizerBuilder(problem,
+                                            og.config.OptimizerMeta().with_optimizer_name("build_cache"),
+                                            build_config,
+                                            og.config.SolverConfiguration().with_tolerance(tolerance)) \
+                .with_generate_not_build_flag(True) \
+                .build()
+
+        target_dir = os.path.join(RustBuildTestCase.TEST_DIR, "build_cache")
+        cost_c = os.path.join(target_dir, "icasadi_build_cache", "extern", "auto_casadi_cost.c")
+        lib_rs = os.path.join(target_dir, "src", "lib.rs")
+        generate(cs.dot(u, u) + p[0] * u[0], 1e-5)
+        cost_mtime, lib_mtime = os.path.getmtime(cost_c), os.path.getmtime(lib_rs)
+        with open(cost_c) as fh:
+            cost_code = fh.read()
+        # unchanged problem and configuration: no file is rewritten
+        generate(cs.dot(u, u) + p[0] * u[0], 1e-5)
+        self.assertEqual(cost_mtime, os.path.getmtime(cost_c))
+        self.assertEqual(lib_mtime, os.path.getmtime(lib_rs))
+        # new tolerance: only lib.rs changes
+        generate(cs.dot(u, u) + p[0] * u[0], 1e-6)
+        self.assertEqual(cost_mtime, os.path.getmtime(cost_c))
+        with open(lib_rs) as fh:
+            self.assertIn("1e-06", fh.read())
+        # new cost: the CasADi code is regenerated
+        generate(cs.dot(u, u) + p[0] * u[1], 1e-6)
+        with open(cost_c) as fh:
+            self.assertNotEqual(cost_code, fh.read())
+
+    def test_build_cache_artifacts(self):
+        u = cs.SX.sym("u", 3)
+        p = cs.SX.sym("p", 1)
+        problem = og.builder.Problem(u, p, cs.dot(u, u) + p[0] * u[0]) \
+            .with_constraints(og.constraints.Ball2(None, 1.0))
+        shared_target_dir = os.path.join(RustBuildTestCase.TEST_DIR, "shared_target")
+
+        def build(variant):
+            build_config = og.config.BuildConfiguration() \
+                .with_open_version(local_path=RustBuildTestCase.get_open_local_absolute_path()) \
+                .with_build_directory(os.path.join(RustBuildTestCase.TEST_DIR, variant)) \
+                .with_build_mode(og.config.BuildConfiguration.DEBUG_MODE) \
+                .with_build_cache() \
+                .with_shared_target_dir(shared_target_dir)
+            og.builder.OpEnOptimizerBuilder(problem,
+                                            og.config.OptimizerMeta().with_optimizer_name("cached"),
+                                            build_config,
+                                            og.config.SolverConfiguration()) \
+                .build()
+            with open(os.path.join(RustBuildTestCase.TEST_DIR, variant, "cached",
+                                   ".opengen_build_cache.json")) as fh:
+                return json.load(fh)["build"]
+
+        def stamp():
+            with open(os.path.join(shared_target_dir, "debug", ".opengen_build_cached")) as fh:
+                return fh.read()
+
+        library = os.path.join(shared_target_dir, "debug", "libcached.rlib")
+        fingerprint_a = build("variant_a")
+        library_mtime = os.path.getmtime(library)
+        # nothing has changed: cargo is not invoked
+        self.assertEqual(fingerprint_a, build("variant_a"))
+        self.assertEqual(library_mtime, os.path.getmtime(library))
+        # a variant with the same name overwrites the shared artifacts...
+        self.assertNotEqual(fingerprint_a, build("variant_b"))
+        self.assertNotEqual(fingerprint_a, stamp())
+        # ...so the first variant is rebuilt
+        build("variant_a")
+        self.assertEqual(fingerprint_a, stamp())
+        # removed artifacts are rebuilt
+        os.remove(library)
+        build("variant_a")
+        self.assertTrue(os.path.isfile(library))
+
+    def test_build_config_shared_target_dir(self):
+        build_config = og.config.BuildConfiguration().with_shared_target_dir("shared_target")
+        self.assertTrue(os.path.isabs(build_config.shared_target_dir))
+        self.assertEqual(build_config.shared_target_dir, build_config.to_dict()["shared_target_dir"])
+        self.assertIsNone(build_config.with_shared_target_dir(None).shared_target_dir)
+
+    def test_benchmark_config(self):
+        benchmark_config = og.config.BenchmarkConfiguration(num_runs=50) \
+            .with_parameter_ranges([0, -1], [1, 1]) \
+            .with_warm_start_modes(["warm"])
+        self.assertEqual([0.0, -1.0], benchmark_config.parameter_lower)
+        self.assertEqual(["warm"], benchmark_config.to_dict()["warm_start_modes"])
+        with self.assertRaises(ValueError) as __context:
+            og.config.BenchmarkConfiguration(num_runs=0)
+        with self.assertRaises(ValueError) as __context:
+            benchmark_config.with_parameter_ranges([0, 2], [1, 1])
+        with self.assertRaises(ValueError) as __context:
+            benchmark_config.with_warm_start_modes(["hot"])
+
+    def test_benchmark_generate(self):
+        u = cs.SX.sym("u", 3)
+        p = cs.SX.sym("p", 2)
+        problem = og.builder.Problem(u, p, cs.dot(u, u) + p[0] * u[0]) \
+            .with_constraints(og.constraints.Ball2(None, p[1] + 1.0))
+
+        def builder(benchmark_config):
+            build_config = og.config.BuildConfiguration() \
+                .with_build_directory(RustBuildTestCase.TEST_DIR) \
+                .with_benchmark(benchmark_config)
+            return og.builder.OpEnOptimizerBuilder(problem,
+                                                   og.config.OptimizerMeta().with_optimizer_name("benchmark"),
+                                                   build_config,
+                                                   og.config.SolverConfiguration()) \
+                .with_generate_not_build_flag(True)
+
+        # the parameter ranges must match the number of parameters
+        with self.assertRaises(ValueError) as __context:
+            builder(og.config.BenchmarkConfiguration().with_parameter_ranges([0], [1])).build()
+        builder(og.config.BenchmarkConfiguration(num_runs=200).with_parameter_ranges([0, 0], [1, 2])).build()
+        main_rs = os.path.join(RustBuildTestCase.TEST_DIR, "benchmark", "benchmark_benchmark", "src", "main.rs")
+        with open(main_rs) as fh:
+            benchmark_code = fh.read()
+        self.assertIn("const NUM_RUNS_DEFAULT: usize = 200;", benchmark_code)
+        self.assertIn("const PARAMETER_UPPER: &[f64] = &[1.0, 2.0];", benchmark_code)
+
+    def test_shm_config(self):
+        shm_config = og.config.ShmServerConfiguration(path="my.shm", spin_iterations=0)
+        self.assertEqual(os.path.abspath("my.shm"), shm_config.to_dict()["path"])
+        self.assertEqual(0, shm_config.spin_iterations)
+        self.assertEqual(50, shm_config.idle_sleep_micros)
+        self.assertIsNone(og.config.ShmServerConfiguration().path)
+        with self.assertRaises(ValueError) as __context:
+            og.config.ShmServerConfiguration(spin_iterations=-1)
+        with self.assertRaises(ValueError) as __context:
+            og.config.ShmServerConfiguration(idle_sleep_micros=-1)
+        build_config = og.config.BuildConfiguration().with_shm_interface_config()
+        self.assertEqual(10000, build_config.to_dict()["shm_interface_config"]["spin_iterations"])
+
+    def test_shm_manager_requires_x86_64(self):
+        with unittest.mock.patch('platform.machine', return_value='aarch64'):
+            with self.assertRaises(Exception) as __context:
+                og.shm.OptimizerShmManager(path='my.shm')
+
+    def test_solver_host_config(self):
+        builder = og.builder.SolverHostBuilder("host_config")
+        with self.assertRaises(ValueError) as __context:
+            builder.build()
+        with self.assertRaises(ValueError) as __context:
+            builder.with_solver(os.path.join(RustBuildTestCase.TEST_DIR, "no_such_optimizer"))
+        plain_path = os.path.join(RustBuildTestCase.TEST_DIR, "plain")
+        with self.assertRaises(ValueError) as __context:
+            builder.with_solver(plain_path, num_instances=0)
+        builder.with_solver(plain_path, priority=3)
+        with self.assertRaises(ValueError) as __context:
+            builder.with_solver(plain_path)
+        self.assertEqual("plain", builder.solvers[0]["name"])
+        self.assertEqual(3, builder.solvers[0]["priority"])
+        with self.assertRaises(ValueError) as __context:
+            og.builder.SolverHostBuilder("not a name")
+
+    def test_tcp_config_wrong_num_workers(self):
+        with self.assertRaises(Exception) as __context:
+            og.config.TcpServerConfiguration(num_workers=0)
+
+    def test_tcp_config_wrong_max_queue_size(self):
+        with self.assertRaises(Exception) as __context:
+            og.config.TcpServerConfiguration(max_queue_size=0)
+
+    def test_tcp_config_wrong_solution_cache_size(self):
+        with self.assertRaises(Exception) as __context:
+            og.config.TcpServerConfiguration(solution_cache_size=-1)
+
     def test_start_multiple_servers(self):
         all_managers = []
         for i in range(10):
@@ -364,6 +752,24 @@ class RustBuildTestCase(unittest.TestCase):
 
         mng.kill()
 
+    def test_rust_build_only_f2_solution_cache(self):
+        for binary_protocol in [False, True]:
+            mng = og.tcp.OptimizerTcpManager(RustBuildTestCase.TEST_DIR + '/only_f2',
+                                             binary_protocol=binary_protocol)
+            mng.start()
+            try:
+                # A client-provided warm start bypasses the cache...
+                status = mng.call(p=[0.5, 8.5], initial_guess=[1, 2, 3, 4, 0]).get()
+                self.assertEqual("Converged", status.exit_status)
+                self.assertFalse(status.cache_hit)
+                # ...but its solution is cached and seeds nearby parameters
+                status_seeded = mng.call(p=[0.5, 8.6]).get()
+                self.assertEqual("Converged", status_seeded.exit_status)
+                self.assertTrue(status_seeded.cache_hit)
+                self.assertGreaterEqual(status_seeded.iterations_saved, 0)
+            finally:
+                mng.kill()
+
     def test_rust_build_only_f2_preconditioned(self):
         mng1 = og.tcp.OptimizerTcpManager(
             RustBuildTestCase.TEST_DIR + '/only_f2')
@@ -398,6 +804,11 @@ class RustBuildTestCase(unittest.TestCase):
             for i in range(len(x1)):
                 self.assertAlmostEqual(x1[i], x2[i], delta=5e-4)
 
+            # A nearby parameter reuses the preconditioning weights
+            response2 = mng2.call(p=[0.5, 8.55], initial_guess=[1, 2, 3, 4, 0]).get()
+            self.assertEqual("Converged", response2.exit_status)
+            self.assertTrue(response2.f2_norm < slv_cfg.constraints_tolerance)
+
             response = mng1.call(p=[2.0, 10.0, 50.0])
             self.assertFalse(response.is_ok())
             status = response.get()
@@ -431,8 +842,171 @@ class RustBuildTestCase(unittest.TestCase):
         status = response.get()
         self.assertEqual("Converged", status.exit_status)
 
+        # The solver is built with instrumentation
+        statistics = status.statistics
+        self.assertEqual(1, statistics["lipschitz_estimation"]["count"])
+        self.assertTrue(statistics["half_step"]["count"] > status.num_inner_iterations)
+        self.assertTrue(statistics["cost_evaluation"]["time_ms"] >= 0.0)
+
+        # The solver records a trace of the last 50 iterations
+        trace = status.trace
+        self.assertTrue(0 < len(trace) <= 50)
+        self.assertTrue(trace[-1]["outer_iteration"] < status.num_outer_iterations)
+        self.assertTrue(trace[-1]["norm_fpr"] >= 0.0)
+
         mng.kill()
 
+    def test_rust_build_plain_client_disconnects(self):
+        mng = og.tcp.OptimizerTcpManager(RustBuildTestCase.TEST_DIR + '/plain')
+        mng.start()
+        address = (mng.details['tcp']['ip'], mng.details['tcp']['port'])
+
+        # More clients than workers reset their connection (SO_LINGER with a
+        # zero timeout), either in the middle of a request or before the
+        # server has written its response
+        reset_on_close = struct.pack('ii', 1, 0)
+        for i in range(4):
+            with socket.create_connection(address) as conn_socket:
+                conn_socket.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, reset_on_close)
+                if i % 2 == 0:
+                    conn_socket.sendall(b'{"Run" : {"parameter": [2.0,')
+                else:
+                    conn_socket.sendall(b'{"Run" : {"parameter": [2.0, 10.0]}}')
+                    conn_socket.shutdown(socket.SHUT_WR)
+
+        # The server still answers
+        pong = mng.ping()
+        self.assertEqual(1, pong["Pong"])
+        response = mng.call(p=[2.0, 10.0])
+        self.assertTrue(response.is_ok())
+        self.assertEqual("Converged", response.get().exit_status)
+
+        mng.kill()
+
+    def test_rust_build_plain_shm(self):
+        mng = og.shm.OptimizerShmManager(RustBuildTestCase.TEST_DIR + '/plain')
+        mng.start()
+        try:
+            response = mng.call(p=[2.0, 10.0])
+            self.assertTrue(response.is_ok())
+            status = response.get()
+            self.assertEqual("Converged", status.exit_status)
+            self.assertEqual(5, len(status.solution))
+
+            # the parameter and the solution are in the shared memory, and the
+            # next call is warm started from the previous solution
+            self.assertEqual([2.0, 10.0], mng.parameter.tolist())
+            self.assertEqual(status.solution, mng.solution.tolist())
+            cold_inner_iterations = status.num_inner_iterations
+            status = mng.call().get()
+            self.assertEqual("Converged", status.exit_status)
+            self.assertTrue(status.num_inner_iterations <= cold_inner_iterations)
+
+            with self.assertRaises(ValueError) as __context:
+                mng.call(p=[1.0])
+        finally:
+            mng.kill()
+
+    def test_rust_build_single_precision(self):
+        mng = og.tcp.OptimizerTcpManager(RustBuildTestCase.TEST_DIR + '/single_precision')
+        mng.start()
+
+        response = mng.call(p=[2.0, 10.0])
+        self.assertTrue(response.is_ok())
+        status = response.get()
+        self.assertEqual("Converged", status.exit_status)
+        u = status.solution
+        self.assertTrue(abs(1.5 * u[0] - u[1]) < 1e-3)
+        self.assertTrue(sum(ui ** 2 for ui in u) <= 1.5 ** 2 + 1e-4)
+
+        # Warm start with the previous Lagrange multipliers
+        response = mng.call(p=[2.0, 10.0], initial_guess=u,
+                            initial_y=status.lagrange_multipliers)
+        self.assertTrue(response.is_ok())
+        self.assertEqual("Converged", response.get().exit_status)
+
+        mng.kill()
+
+    def test_rust_build_fused_cost_and_gradient(self):
+        mng = og.tcp.OptimizerTcpManager(RustBuildTestCase.TEST_DIR + '/fused_cost_and_grad')
+        mng.start()
+
+        response = mng.call(p=[2.0, 10.0])
+        self.assertTrue(response.is_ok())
+        status = response.get()
+        self.assertEqual("Converged", status.exit_status)
+        u = status.solution
+        self.assertTrue(abs(1.5 * u[0] - u[1]) < 1e-4)
+        self.assertTrue(sum(ui ** 2 for ui in u) <= 1.5 ** 2 + 1e-6)
+
+        # The inner solver is warm started from the previous call
+        response = mng.call(p=[2.0, 10.5], initial_guess=u)
+        self.assertTrue(response.is_ok())
+        self.assertEqual("Converged", response.get().exit_status)
+
+        mng.kill()
+
+    def test_solver_config_single_precision_affine_space(self):
+        u = cs.SX.sym("u", 2)
+        p = cs.SX.sym("p", 1)
+        problem = og.builder.Problem(u, p, cs.dot(u, u)) \
+            .with_constraints(og.constraints.AffineSpace([1., 1.], [1.]))
+        build_config = og.config.BuildConfiguration() \
+            .with_build_directory(RustBuildTestCase.TEST_DIR)
+        solver_config = og.config.SolverConfiguration().with_single_precision()
+        self.assertTrue(solver_config.to_dict()["single_precision"])
+        builder = og.builder.OpEnOptimizerBuilder(problem,
+                                                  og.config.OptimizerMeta().with_optimizer_name("sp_affine"),
+                                                  build_config,
+                                                  solver_config)
+        with self.assertRaises(NotImplementedError) as __context:
+            builder.build()
+
+    def test_rust_build_plain_binary_protocol(self):
+        mng = og.tcp.OptimizerTcpManager(RustBuildTestCase.TEST_DIR + '/plain',
+                                         binary_protocol=True)
+        mng.start()
+        pong = mng.ping()  # check if the server is alive
+        self.assertEqual(1, pong["Pong"])
+
+        # Regular calls over the same connection
+        response = mng.call(p=[2.0, 10.0])
+        self.assertTrue(response.is_ok())
+        status = response.get()
+        self.assertEqual("Converged", status.exit_status)
+
+        response_warm = mng.call(p=[2.0, 10.0], initial_guess=status.solution)
+        self.assertTrue(response_warm.is_ok())
+        self.assertEqual(len(status.solution), len(response_warm["solution"]))
+
+        # Wrong number of parameters
+        response = mng.call(p=[2.0])
+        self.assertFalse(response.is_ok())
+        self.assertEqual(3003, response.get().code)
+
+        mng.kill()
+
+    def test_rust_build_plain_deadline(self):
+        for binary_protocol in [False, True]:
+            mng = og.tcp.OptimizerTcpManager(RustBuildTestCase.TEST_DIR + '/plain',
+                                             binary_protocol=binary_protocol)
+            mng.start()
+
+            # A generous deadline does not prevent convergence
+            response = mng.call(p=[2.0, 10.0], deadline_micros=1000000)
+            self.assertTrue(response.is_ok())
+            status = response.get()
+            self.assertEqual("Converged", status.exit_status)
+
+            # The solver returns its best iterate when the deadline is hit
+            response = mng.call(p=[2.0, 10.0], initial_guess=[0.0] * 5, deadline_micros=1)
+            self.assertTrue(response.is_ok())
+            status = response.get()
+            self.assertEqual("NotConvergedOutOfTime", status.exit_status)
+            self.assertEqual(5, len(status.solution))
+
+            mng.kill()
+
     def test_rust_build_parametric_f2(self):
         # introduced to tackle issue #123
         mng = og.tcp.OptimizerTcpManager(
@@ -449,6 +1023,42 @@ class RustBuildTestCase(unittest.TestCase):
         self.assertTrue(status.f2_norm < 1e-4)
         mng.kill()
 
+    def test_rust_build_solver_host(self):
+        tcp_config = og.config.TcpServerConfiguration(bind_port=3311, num_workers=2)
+        build_config = og.config.BuildConfiguration() \
+            .with_open_version(local_path=RustBuildTestCase.get_open_local_absolute_path()) \
+            .with_build_directory(RustBuildTestCase.TEST_DIR) \
+            .with_build_mode(og.config.BuildConfiguration.DEBUG_MODE) \
+            .with_tcp_interface_config(tcp_interface_config=tcp_config)
+        host_path = og.builder.SolverHostBuilder("host", build_config) \
+            .with_solver(os.path.join(RustBuildTestCase.TEST_DIR, "plain"), priority=10) \
+            .with_solver(os.path.join(RustBuildTestCase.TEST_DIR, "parametric_f2"), num_instances=2) \
+            .build()
+        mng = og.tcp.OptimizerTcpManager(host_path)
+        mng.start()
+        pong = mng.ping()  # check if the server is alive
+        self.assertEqual(1, pong["Pong"])
+
+        response = mng.call(p=[2.0, 10.0], solver="plain")
+        self.assertTrue(response.is_ok())
+        self.assertEqual("Converged", response.get().exit_status)
+
+        response = mng.call(p=[1.0, 1.0, 0.5], solver="parametric_f2")
+        self.assertTrue(response.is_ok())
+        self.assertTrue(response.get().f2_norm < 1e-4)
+
+        # Unknown solver
+        response = mng.call(p=[2.0, 10.0], solver="no_such_solver")
+        self.assertFalse(response.is_ok())
+        self.assertEqual(4000, response.get().code)
+
+        # Wrong number of parameters
+        response = mng.call(p=[2.0, 10.0], solver="parametric_f2")
+        self.assertFalse(response.is_ok())
+        self.assertEqual(3003, response.get().code)
+
+        mng.kill()
+
     def test_rust_build_parametric_halfspace(self):
         mng = og.tcp.OptimizerTcpManager(
             RustBuildTestCase.TEST_DIR + '/halfspace_optimizer')
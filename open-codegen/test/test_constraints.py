@@ -3,6 +3,7 @@ import unittest
 import casadi.casadi as cs
 import numpy as np
 import math
+import importlib.util
 
 
 class ConstraintsTestCase(unittest.TestCase):
@@ -343,6 +344,25 @@ class ConstraintsTestCase(unittest.TestCase):
         with self.assertRaises(ValueError) as __context:
             og.constraints.CartesianProduct([], sets)
 
+    def test_cartesian_static_product_tree(self):
+        no_constraints = og.constraints.NoConstraints()
+        cartesian = og.constraints.CartesianProduct([1, 4, 8], [no_constraints] * 3)
+        self.assertListEqual([(2, 1), (5, 2), (9, 3)],
+                             cartesian.static_product_tree())
+        # nested products with at most 2 sets each
+        self.assertListEqual([(5, [(2, 1), (5, 2)]), (9, [(4, 3)])],
+                             cartesian.static_product_tree(max_arity=2))
+
+    def test_cartesian_parallel_projection(self):
+        no_constraints = og.constraints.NoConstraints()
+        cartesian = og.constraints.CartesianProduct([1, 4], [no_constraints] * 2)
+        self.assertIsNone(cartesian.parallel_num_threads)
+        cartesian.with_parallel_projection(4, min_dimension=1000)
+        self.assertEqual(4, cartesian.parallel_num_threads)
+        self.assertEqual(1000, cartesian.parallel_min_dimension)
+        with self.assertRaises(ValueError) as __context:
+            cartesian.with_parallel_projection(0)
+
     # -----------------------------------------------------------------------
     # Finite Set
     # -----------------------------------------------------------------------
@@ -513,6 +533,31 @@ class ConstraintsTestCase(unittest.TestCase):
         z = fun([1, 1, 0, 0])
         self.assertAlmostEqual(0.835786437626905, z, places=12)
 
+    # -----------------------------------------------------------------------
+    # Affine space
+    # -----------------------------------------------------------------------
+
+    def test_affine_space_dense(self):
+        A = np.array([[1., 2., 0.], [0., 1., 3.]])
+        affine = og.constraints.AffineSpace(A, [1., 2.])
+        self.assertFalse(affine.is_sparse)
+        self.assertTrue(affine.is_convex())
+        self.assertFalse(affine.is_compact())
+        self.assertListEqual([1., 2., 0., 0., 1., 3.], list(affine.matrix_a))
+        self.assertIsNone(affine.csr_row_ptr)
+
+    @unittest.skipIf(importlib.util.find_spec("scipy") is None, "requires scipy")
+    def test_affine_space_sparse(self):
+        import scipy.sparse as sp
+        A = sp.csc_matrix(np.array([[1., 2., 0.], [0., 1., 3.]]))
+        affine = og.constraints.AffineSpace(A, [1., 2.])
+        self.assertTrue(affine.is_sparse)
+        self.assertEqual(3, affine.num_columns)
+        self.assertListEqual([0, 2, 4], affine.csr_row_ptr)
+        self.assertListEqual([0, 1, 1, 2], affine.csr_col_idx)
+        self.assertListEqual([1., 2., 1., 3.], affine.csr_values)
+        self.assertListEqual([1., 2., 0., 0., 1., 3.], list(affine.matrix_a))
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,27 @@
+/*
+ * Solves the problem of the optimizer `static_memory`, which allocates its
+ * memory from a static buffer, many times in a row; the program aborts if
+ * memory is leaked in some solve, as the buffer is eventually exhausted
+ */
+#include <stdio.h>
+#include <assert.h>
+
+#include "static_memory_bindings.h"
+
+#define NUM_SOLVES (20000)
+
+int main() {
+    double p[STATIC_MEMORY_NUM_PARAMETERS] = {1.0, 10.0};
+    double u[STATIC_MEMORY_NUM_DECISION_VARIABLES] = {0};
+
+    static_memoryCache *cache = static_memory_new();
+    for (int k = 0; k < NUM_SOLVES; ++k) {
+        p[0] = 1.0 + 0.001 * (k % 100);
+        static_memorySolverStatus status = static_memory_solve(cache, u, p, 0, 0);
+        assert(status.exit_status == static_memoryConverged);
+    }
+    static_memory_free(cache);
+
+    printf("%d solves: Ok\n", NUM_SOLVES);
+    return 0;
+}
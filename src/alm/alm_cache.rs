@@ -1,7 +1,32 @@
-use crate::panoc::PANOCCache;
+use crate::{
+    constraints::Constraint,
+    core::{deadline::Deadline, IterationTrace, SolverStatistics},
+    panoc::PANOCCache,
+    Scalar,
+};
 
 const DEFAULT_INITIAL_PENALTY: f64 = 10.0;
 
+/// Best iterate of a solve with a deadline (see `AlmOptimizer::with_deadline`)
+#[derive(Debug)]
+pub(crate) struct BestIterate<T: Scalar> {
+    /// Solution of the inner problem
+    pub(crate) u: Vec<T>,
+    /// Lagrange multipliers
+    pub(crate) y: Vec<T>,
+    /// Infeasibility, `max(||y_plus - y|| / c, ||F2(u)||)` (infinite if
+    /// there is no best iterate yet)
+    pub(crate) infeasibility: T,
+    /// Norm of the fixed-point residual of the inner problem
+    pub(crate) norm_fpr: f64,
+    /// Value of `||y_plus - y||`
+    pub(crate) delta_y_norm: T,
+    /// Value of `||F2(u)||`
+    pub(crate) f2_norm: T,
+    /// Penalty parameter
+    pub(crate) penalty: T,
+}
+
 /// Cache for `AlmOptimizer` (to be allocated once)
 ///
 /// This is a cache structure that contains all the data that make
@@ -11,26 +36,28 @@ const DEFAULT_INITIAL_PENALTY: f64 = 10.0;
 /// On the other hand, the problem data are provided in an instance
 /// of `AlmProblem`
 ///
+/// The decision variables are of type `T`, which is `f64` by default
+///
 #[derive(Debug)]
-pub struct AlmCache {
+pub struct AlmCache<T: Scalar = f64> {
     /// PANOC cache for inner problems
-    pub(crate) panoc_cache: PANOCCache,
+    pub(crate) panoc_cache: PANOCCache<T>,
     /// Lagrange multipliers (next)
-    pub(crate) y_plus: Option<Vec<f64>>,
+    pub(crate) y_plus: Option<Vec<T>>,
     /// Vector $\xi^\nu = (c^\nu, y^\nu)$
-    pub(crate) xi: Option<Vec<f64>>,
+    pub(crate) xi: Option<Vec<T>>,
     /// Infeasibility related to ALM-type constraints
-    pub(crate) delta_y_norm: f64,
+    pub(crate) delta_y_norm: T,
     /// Delta y at iteration `nu+1`
-    pub(crate) delta_y_norm_plus: f64,
+    pub(crate) delta_y_norm_plus: T,
     /// Value $\Vert F_2(u^\nu) \Vert$
-    pub(crate) f2_norm: f64,
+    pub(crate) f2_norm: T,
     /// Value $\Vert F_2(u^{\nu+1}) \Vert$
-    pub(crate) f2_norm_plus: f64,
+    pub(crate) f2_norm_plus: T,
     /// Auxiliary variable `w`
-    pub(crate) w_alm_aux: Option<Vec<f64>>,
+    pub(crate) w_alm_aux: Option<Vec<T>>,
     /// Infeasibility related to PM-type constraints, `w_pm = F2(u)`
-    pub(crate) w_pm: Option<Vec<f64>>,
+    pub(crate) w_pm: Option<Vec<T>>,
     /// (Outer) iteration count
     pub(crate) iteration: usize,
     /// Counter for inner iterations
@@ -43,9 +70,20 @@ pub struct AlmCache {
     /// no bounds on the maximum time). The maximum time is specified,
     /// if at all, in `AlmOptimizer`
     pub(crate) available_time: Option<std::time::Duration>,
+    /// Deadline of the current solve, if any (see `AlmOptimizer::with_deadline`)
+    pub(crate) deadline: Option<Deadline>,
+    /// Best iterate of the current solve with a deadline; its vectors are
+    /// allocated by the first solve with a deadline
+    pub(crate) best_iterate: BestIterate<T>,
+    /// Statistics of the phases of the algorithm, accumulated over all
+    /// inner problems (see `core::instrumentation`)
+    pub(crate) statistics: SolverStatistics,
+    /// Scratch workspace for the projections on the sets `C` and `Y`
+    /// (see `Constraint::project_with_workspace`)
+    pub(crate) projection_workspace: Vec<T>,
 }
 
-impl AlmCache {
+impl<T: Scalar> AlmCache<T> {
     /// Construct a new instance of `AlmCache`
     ///
     /// # Arguments
@@ -58,44 +96,124 @@ impl AlmCache {
     ///
     /// Does not panic
     ///
-    pub fn new(panoc_cache: PANOCCache, n1: usize, n2: usize) -> Self {
+    pub fn new(panoc_cache: PANOCCache<T>, n1: usize, n2: usize) -> Self {
         AlmCache {
             panoc_cache,
-            y_plus: if n1 > 0 { Some(vec![0.0; n1]) } else { None },
+            y_plus: if n1 > 0 {
+                Some(vec![T::zero(); n1])
+            } else {
+                None
+            },
             // Allocate memory for xi = (c, y) if either n1 or n2 is nonzero,
             // otherwise, xi is None
             xi: if n1 + n2 > 0 {
-                let mut xi_init = vec![DEFAULT_INITIAL_PENALTY; 1];
-                xi_init.append(&mut vec![0.0; n1]);
+                let mut xi_init = vec![T::from_f64(DEFAULT_INITIAL_PENALTY); 1];
+                xi_init.append(&mut vec![T::zero(); n1]);
                 Some(xi_init)
             } else {
                 None
             },
             // w_alm_aux should be allocated only if n1 > 0
-            w_alm_aux: if n1 > 0 { Some(vec![0.0; n1]) } else { None },
+            w_alm_aux: if n1 > 0 {
+                Some(vec![T::zero(); n1])
+            } else {
+                None
+            },
             // w_pm is needed only if n2 > 0
-            w_pm: if n2 > 0 { Some(vec![0.0; n2]) } else { None },
+            w_pm: if n2 > 0 {
+                Some(vec![T::zero(); n2])
+            } else {
+                None
+            },
             iteration: 0,
-            delta_y_norm: 0.0,
-            delta_y_norm_plus: std::f64::INFINITY,
-            f2_norm: 0.0,
-            f2_norm_plus: std::f64::INFINITY,
+            delta_y_norm: T::zero(),
+            delta_y_norm_plus: T::infinity(),
+            f2_norm: T::zero(),
+            f2_norm_plus: T::infinity(),
             inner_iteration_count: 0,
             last_inner_problem_norm_fpr: -1.0,
             available_time: None,
+            deadline: None,
+            best_iterate: BestIterate {
+                u: Vec::new(),
+                y: Vec::new(),
+                infeasibility: T::infinity(),
+                norm_fpr: f64::INFINITY,
+                delta_y_norm: T::zero(),
+                f2_norm: T::zero(),
+                penalty: T::zero(),
+            },
+            statistics: SolverStatistics::new(),
+            projection_workspace: Vec::new(),
+        }
+    }
+
+    /// Allocates the scratch workspace needed to project on the set `C`
+    /// or the set `Y` of the ALM-type constraints (which are subsets of
+    /// $\mathbb{R}^{n_1}$)
+    ///
+    /// The optimizer allocates this workspace (if needed) the first time
+    /// it is used with these sets; use this method (once for `C` and once
+    /// for `Y`) so that no memory is allocated while solving the problem.
+    /// For the constraints on the decision variables, use
+    /// `PANOCCache::with_projection_workspace`.
+    ///
+    /// ## Arguments
+    ///
+    /// - `alm_set`: set `C` or set `Y`
+    ///
+    pub fn with_projection_workspace<C: Constraint<T> + ?Sized>(mut self, alm_set: &C) -> Self {
+        let n1 = self.y_plus.as_ref().map_or(0, |y_plus| y_plus.len());
+        self.reserve_projection_workspace(alm_set.workspace_size(n1));
+        self
+    }
+
+    /// Makes sure that the projection workspace has at least `size` elements
+    pub(crate) fn reserve_projection_workspace(&mut self, size: usize) {
+        if self.projection_workspace.len() < size {
+            self.projection_workspace.resize(size, T::zero());
         }
     }
 
+    /// Records a trace of the (inner) iterations of every solve, which also
+    /// stores the outer iteration, the penalty parameter and the infeasibility
+    /// (see [`trace`](../core/trace/index.html) and `PANOCCache::with_trace`)
+    ///
+    /// ## Arguments
+    ///
+    /// - `capacity`: maximum number of records
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `capacity` is zero
+    ///
+    pub fn with_trace(mut self, capacity: usize) -> Self {
+        self.panoc_cache.trace = Some(IterationTrace::new(capacity));
+        self
+    }
+
+    /// Trace of the iterations of the last solve; returns `None` unless the
+    /// cache was constructed `with_trace`
+    pub fn trace(&self) -> Option<&IterationTrace> {
+        self.panoc_cache.trace()
+    }
+
     /// Resets the cache to its virgin state, and resets the stored instance
     /// of `PANOCCache`
     ///
     pub fn reset(&mut self) {
         self.panoc_cache.reset();
+        self.reset_outer_state();
+    }
+
+    /// Resets the state of the outer iterations, but not the PANOC cache
+    pub(crate) fn reset_outer_state(&mut self) {
         self.iteration = 0;
-        self.f2_norm = 0.0;
-        self.f2_norm_plus = 0.0;
-        self.delta_y_norm = 0.0;
-        self.delta_y_norm_plus = 0.0;
+        self.f2_norm = T::zero();
+        self.f2_norm_plus = T::zero();
+        self.delta_y_norm = T::zero();
+        self.delta_y_norm_plus = T::zero();
         self.inner_iteration_count = 0;
+        self.statistics.reset();
     }
 }
@@ -1,8 +1,14 @@
 use crate::{
     alm::*,
     constraints,
-    core::{panoc::PANOCOptimizer, ExitStatus, Optimizer, Problem, SolverStatus},
-    matrix_operations, FunctionCallResult, SolverError,
+    core::{
+        deadline::Deadline,
+        instrumentation::{instrumented, Phase},
+        multistart::{self, EarlyStop},
+        panoc::{PANOCOptimizer, WarmStartPolicy},
+        ExitStatus, Optimizer, Problem, SolverStatus,
+    },
+    matrix_operations, FunctionCallResult, Scalar, SolverError,
 };
 
 const DEFAULT_MAX_OUTER_ITERATIONS: usize = 50;
@@ -13,7 +19,6 @@ const DEFAULT_PENALTY_UPDATE_FACTOR: f64 = 5.0;
 const DEFAULT_EPSILON_UPDATE_FACTOR: f64 = 0.1;
 const DEFAULT_INFEAS_SUFFICIENT_DECREASE_FACTOR: f64 = 0.1;
 const DEFAULT_INITIAL_TOLERANCE: f64 = 0.1;
-const SMALL_EPSILON: f64 = std::f64::EPSILON;
 
 /// Internal/private structure used by method AlmOptimizer.step
 /// to return some minimal information about the inner problem
@@ -124,17 +129,21 @@ pub struct AlmOptimizer<
     ConstraintsType,
     AlmSetC,
     LagrangeSetY,
+    T = f64,
+    ParametricCostGradientType = ParametricCostAndGradientType<T>,
 > where
-    MappingAlm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    MappingPm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricGradientType: Fn(&[f64], &[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricCostType: Fn(&[f64], &[f64], &mut f64) -> FunctionCallResult,
-    ConstraintsType: constraints::Constraint,
-    AlmSetC: constraints::Constraint,
-    LagrangeSetY: constraints::Constraint,
+    T: Scalar,
+    MappingAlm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    MappingPm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    ParametricGradientType: Fn(&[T], &[T], &mut [T]) -> FunctionCallResult,
+    ParametricCostType: Fn(&[T], &[T], &mut T) -> FunctionCallResult,
+    ParametricCostGradientType: Fn(&[T], &[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintsType: constraints::Constraint<T>,
+    AlmSetC: constraints::Constraint<T>,
+    LagrangeSetY: constraints::Constraint<T>,
 {
     /// ALM cache (borrowed)
-    alm_cache: &'life mut AlmCache,
+    alm_cache: &'life mut AlmCache<T>,
     /// ALM problem definition (oracle)
     alm_problem: AlmProblem<
         MappingAlm,
@@ -144,6 +153,8 @@ pub struct AlmOptimizer<
         ConstraintsType,
         AlmSetC,
         LagrangeSetY,
+        T,
+        ParametricCostGradientType,
     >,
     /// Maximum number of outer iterations
     max_outer_iterations: usize,
@@ -151,20 +162,24 @@ pub struct AlmOptimizer<
     max_inner_iterations: usize,
     /// Maximum duration
     max_duration: Option<std::time::Duration>,
+    /// Deadline (anytime mode)
+    deadline: Option<std::time::Duration>,
     /// epsilon for inner AKKT condition
-    epsilon_tolerance: f64,
+    epsilon_tolerance: T,
     /// delta for outer AKKT condition
-    delta_tolerance: f64,
+    delta_tolerance: T,
     /// At every outer iteration, c is multiplied by this scalar
-    penalty_update_factor: f64,
+    penalty_update_factor: T,
     /// The epsilon-tolerance is multiplied by this factor until
     /// it reaches its target value
-    epsilon_update_factor: f64,
+    epsilon_update_factor: T,
     /// If current_infeasibility <= sufficient_decrease_coeff * previous_infeasibility,
     /// then the penalty parameter is kept constant
-    sufficient_decrease_coeff: f64,
+    sufficient_decrease_coeff: T,
     // Initial tolerance (for the inner problem)
-    epsilon_inner_initial: f64,
+    epsilon_inner_initial: T,
+    /// Early-stopping criterion of a multi-start solve
+    early_stop: Option<&'life EarlyStop<'life>>,
 }
 
 impl<
@@ -176,6 +191,8 @@ impl<
         ConstraintsType,
         AlmSetC,
         LagrangeSetY,
+        T,
+        ParametricCostGradientType,
     >
     AlmOptimizer<
         'life,
@@ -186,15 +203,19 @@ impl<
         ConstraintsType,
         AlmSetC,
         LagrangeSetY,
+        T,
+        ParametricCostGradientType,
     >
 where
-    MappingAlm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    MappingPm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricGradientType: Fn(&[f64], &[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricCostType: Fn(&[f64], &[f64], &mut f64) -> FunctionCallResult,
-    ConstraintsType: constraints::Constraint,
-    AlmSetC: constraints::Constraint,
-    LagrangeSetY: constraints::Constraint,
+    T: Scalar,
+    MappingAlm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    MappingPm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    ParametricGradientType: Fn(&[T], &[T], &mut [T]) -> FunctionCallResult,
+    ParametricCostType: Fn(&[T], &[T], &mut T) -> FunctionCallResult,
+    ParametricCostGradientType: Fn(&[T], &[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintsType: constraints::Constraint<T>,
+    AlmSetC: constraints::Constraint<T>,
+    LagrangeSetY: constraints::Constraint<T>,
 {
     /* ---------------------------------------------------------------------------- */
     /*          CONSTRUCTOR                                                         */
@@ -250,7 +271,7 @@ where
     ///```     
     ///
     pub fn new(
-        alm_cache: &'life mut AlmCache,
+        alm_cache: &'life mut AlmCache<T>,
         alm_problem: AlmProblem<
             MappingAlm,
             MappingPm,
@@ -259,6 +280,8 @@ where
             ConstraintsType,
             AlmSetC,
             LagrangeSetY,
+            T,
+            ParametricCostGradientType,
         >,
     ) -> Self {
         // set the initial value of the inner tolerance; this step is
@@ -266,19 +289,28 @@ where
         // in #solve (see below)
         alm_cache
             .panoc_cache
-            .set_akkt_tolerance(DEFAULT_INITIAL_TOLERANCE);
+            .set_akkt_tolerance(T::from_f64(DEFAULT_INITIAL_TOLERANCE));
+        let n1 = alm_problem.n1;
+        if let Some(alm_set_c) = &alm_problem.alm_set_c {
+            alm_cache.reserve_projection_workspace(alm_set_c.workspace_size(n1));
+        }
+        if let Some(alm_set_y) = &alm_problem.alm_set_y {
+            alm_cache.reserve_projection_workspace(alm_set_y.workspace_size(n1));
+        }
         AlmOptimizer {
             alm_cache,
             alm_problem,
             max_outer_iterations: DEFAULT_MAX_OUTER_ITERATIONS,
             max_inner_iterations: DEFAULT_MAX_INNER_ITERATIONS,
             max_duration: None,
-            epsilon_tolerance: DEFAULT_EPSILON_TOLERANCE,
-            delta_tolerance: DEFAULT_DELTA_TOLERANCE,
-            penalty_update_factor: DEFAULT_PENALTY_UPDATE_FACTOR,
-            epsilon_update_factor: DEFAULT_EPSILON_UPDATE_FACTOR,
-            sufficient_decrease_coeff: DEFAULT_INFEAS_SUFFICIENT_DECREASE_FACTOR,
-            epsilon_inner_initial: DEFAULT_INITIAL_TOLERANCE,
+            deadline: None,
+            epsilon_tolerance: T::from_f64(DEFAULT_EPSILON_TOLERANCE),
+            delta_tolerance: T::from_f64(DEFAULT_DELTA_TOLERANCE),
+            penalty_update_factor: T::from_f64(DEFAULT_PENALTY_UPDATE_FACTOR),
+            epsilon_update_factor: T::from_f64(DEFAULT_EPSILON_UPDATE_FACTOR),
+            sufficient_decrease_coeff: T::from_f64(DEFAULT_INFEAS_SUFFICIENT_DECREASE_FACTOR),
+            epsilon_inner_initial: T::from_f64(DEFAULT_INITIAL_TOLERANCE),
+            early_stop: None,
         }
     }
 
@@ -353,6 +385,33 @@ where
         self
     }
 
+    /// Sets a deadline, for hard real-time applications (anytime mode)
+    ///
+    /// Unlike `with_max_duration`, the clock is not read at every inner
+    /// iteration; instead, the solver predicts the duration of an inner
+    /// iteration (see `PANOCOptimizer::with_deadline`) and stops so as to
+    /// return before the deadline. If the deadline is hit, the solver returns
+    /// the best iterate found so far and reports `ExitStatus::NotConvergedOutOfTime`.
+    /// The best iterate is the one with the smallest infeasibility,
+    /// $\max\{\Vert y^+ - y \Vert / c, \Vert F_2(u) \Vert\}$, or, among the
+    /// iterates whose infeasibility is within the delta tolerance, the one
+    /// with the smallest fixed-point residual.
+    ///
+    /// If a deadline is set, the maximum duration is not used.
+    ///
+    /// # Arguments
+    ///
+    /// - `deadline`: available time, measured from the start of `solve`
+    ///
+    /// # Returns
+    ///
+    /// Returns the current mutable and updated instance of the provided object
+    ///
+    pub fn with_deadline(mut self, deadline: std::time::Duration) -> Self {
+        self.deadline = Some(deadline);
+        self
+    }
+
     /// Set the delta tolerance
     ///
     /// # Arguments
@@ -367,8 +426,11 @@ where
     ///
     /// The method panics if the specified tolerance is not positive
     ///
-    pub fn with_delta_tolerance(mut self, delta_tolerance: f64) -> Self {
-        assert!(delta_tolerance > 0.0, "delta_tolerance must be positive");
+    pub fn with_delta_tolerance(mut self, delta_tolerance: T) -> Self {
+        assert!(
+            delta_tolerance > T::zero(),
+            "delta_tolerance must be positive"
+        );
         self.delta_tolerance = delta_tolerance;
         self
     }
@@ -387,9 +449,9 @@ where
     ///
     /// The method panics if the specified tolerance is not positive
     ///
-    pub fn with_epsilon_tolerance(mut self, epsilon_tolerance: f64) -> Self {
+    pub fn with_epsilon_tolerance(mut self, epsilon_tolerance: T) -> Self {
         assert!(
-            epsilon_tolerance > 0.0,
+            epsilon_tolerance > T::zero(),
             "epsilon_tolerance must be positive"
         );
         self.epsilon_tolerance = epsilon_tolerance;
@@ -415,9 +477,9 @@ where
     /// The method panics if the update factor is not larger than `1.0 + f64::EPSILON`
     ///
     ///
-    pub fn with_penalty_update_factor(mut self, penalty_update_factor: f64) -> Self {
+    pub fn with_penalty_update_factor(mut self, penalty_update_factor: T) -> Self {
         assert!(
-            penalty_update_factor > 1.0 + SMALL_EPSILON,
+            penalty_update_factor > T::one() + T::epsilon(),
             "`penalty_update_factor` must be larger than 1.0 + f64::EPSILON"
         );
         self.penalty_update_factor = penalty_update_factor;
@@ -444,13 +506,10 @@ where
     /// The method panics if the specified tolerance update factor is not in the
     /// interval from `f64::EPSILON` to `1.0 - f64::EPSILON`.
     ///
-    pub fn with_inner_tolerance_update_factor(
-        mut self,
-        inner_tolerance_update_factor: f64,
-    ) -> Self {
+    pub fn with_inner_tolerance_update_factor(mut self, inner_tolerance_update_factor: T) -> Self {
         assert!(
-            inner_tolerance_update_factor > SMALL_EPSILON
-                && inner_tolerance_update_factor < 1.0 - SMALL_EPSILON,
+            inner_tolerance_update_factor > T::epsilon()
+                && inner_tolerance_update_factor < T::one() - T::epsilon(),
             "the tolerance update factor needs to be in (f64::EPSILON, 1)"
         );
         self.epsilon_update_factor = inner_tolerance_update_factor;
@@ -480,7 +539,7 @@ where
     /// `with_inner_tolerance` to do so before invoking `with_initial_inner_tolerance`.
     ///
     ///
-    pub fn with_initial_inner_tolerance(mut self, initial_inner_tolerance: f64) -> Self {
+    pub fn with_initial_inner_tolerance(mut self, initial_inner_tolerance: T) -> Self {
         assert!(
             initial_inner_tolerance >= self.epsilon_tolerance,
             "the initial tolerance should be no less than the target tolerance"
@@ -514,11 +573,11 @@ where
     ///
     pub fn with_sufficient_decrease_coefficient(
         mut self,
-        sufficient_decrease_coefficient: f64,
+        sufficient_decrease_coefficient: T,
     ) -> Self {
         assert!(
-            sufficient_decrease_coefficient < 1.0 - SMALL_EPSILON
-                && sufficient_decrease_coefficient > SMALL_EPSILON,
+            sufficient_decrease_coefficient < T::one() - T::epsilon()
+                && sufficient_decrease_coefficient > T::epsilon(),
             "sufficient_decrease_coefficient must be in (f64::EPSILON, 1.0 - f64::EPSILON)"
         );
         self.sufficient_decrease_coeff = sufficient_decrease_coefficient;
@@ -529,7 +588,7 @@ where
     ///
     /// # Arguments
     ///
-    /// - `y_init`: initial vector of Lagrange multipliers (type: `&[f64]`) of
+    /// - `y_init`: initial vector of Lagrange multipliers (type: `&[T]`) of
     ///             length equal to `n1`
     ///
     /// # Returns
@@ -540,7 +599,7 @@ where
     ///
     /// The method will panic if the length of `y_init` is not equal to `n1`
     ///
-    pub fn with_initial_lagrange_multipliers(mut self, y_init: &[f64]) -> Self {
+    pub fn with_initial_lagrange_multipliers(mut self, y_init: &[T]) -> Self {
         let cache = &mut self.alm_cache;
         assert!(
             y_init.len() == self.alm_problem.n1,
@@ -570,9 +629,9 @@ where
     /// The method panics if the specified initial penalty parameter is not
     /// larger than `f64::EPSILON`
     ///
-    pub fn with_initial_penalty(self, c0: f64) -> Self {
+    pub fn with_initial_penalty(self, c0: T) -> Self {
         assert!(
-            c0 > SMALL_EPSILON,
+            c0 > T::epsilon(),
             "the initial penalty must be larger than f64::EPSILON"
         );
         if let Some(xi_in_cache) = &mut self.alm_cache.xi {
@@ -581,6 +640,18 @@ where
         self
     }
 
+    /// Sets the early-stopping criterion of a multi-start solve (see
+    /// [`multistart`](crate::core::multistart))
+    ///
+    /// Once another start has found a feasible solution, the criterion is
+    /// checked after every outer iteration with the cost at the current
+    /// iterate; if the solver stops early, it reports
+    /// `ExitStatus::NotConvergedIterations`
+    pub fn with_early_stop(mut self, early_stop: &'life EarlyStop<'life>) -> Self {
+        self.early_stop = Some(early_stop);
+        self
+    }
+
     /* ---------------------------------------------------------------------------- */
     /*          PRIVATE METHODS                                                     */
     /* ---------------------------------------------------------------------------- */
@@ -589,22 +660,22 @@ where
         let alm_cache = &mut self.alm_cache; // ALM cache
         if let (Some(y_plus), Some(xi)) = (&alm_cache.y_plus, &alm_cache.xi) {
             // compute ||y_plus - y||
-            let norm_diff_squared = matrix_operations::norm2_squared_diff(y_plus, &xi[1..]);
+            let norm_diff_squared = matrix_operations::solver::norm2_squared_diff(y_plus, &xi[1..]);
             alm_cache.delta_y_norm_plus = norm_diff_squared.sqrt();
         }
         Ok(())
     }
 
     /// Computes PM infeasibility, that is, ||F2(u)||
-    fn compute_pm_infeasibility(&mut self, u: &[f64]) -> FunctionCallResult {
+    fn compute_pm_infeasibility(&mut self, u: &[T]) -> FunctionCallResult {
         let problem = &self.alm_problem; // ALM problem
         let cache = &mut self.alm_cache; // ALM cache
 
         // If there is an F2 mapping: cache.w_pm <-- F2
         // Then compute the norm of w_pm and store it in cache.f2_norm_plus
         if let (Some(f2), Some(w_pm_vec)) = (&problem.mapping_f2, &mut cache.w_pm.as_mut()) {
-            f2(u, w_pm_vec)?;
-            cache.f2_norm_plus = matrix_operations::norm2(w_pm_vec);
+            instrumented!(cache.statistics, Phase::F2Evaluation, f2(u, w_pm_vec))?;
+            cache.f2_norm_plus = matrix_operations::solver::norm2(w_pm_vec);
         }
         Ok(())
     }
@@ -613,7 +684,7 @@ where
     ///
     /// `y_plus <-- y + c*[F1(u_plus) - Proj_C(F1(u_plus) + y/c)]`
     ///
-    fn update_lagrange_multipliers(&mut self, u: &[f64]) -> FunctionCallResult {
+    fn update_lagrange_multipliers(&mut self, u: &[T]) -> FunctionCallResult {
         let problem = &self.alm_problem; // ALM problem
         let cache = &mut self.alm_cache; // ALM cache
 
@@ -638,7 +709,7 @@ where
             &problem.alm_set_c,
         ) {
             // Step #1: w_alm_aux := F1(u)
-            (f1)(u, w_alm_aux)?;
+            instrumented!(cache.statistics, Phase::F1Evaluation, (f1)(u, w_alm_aux))?;
 
             // Step #2: y_plus := w_alm_aux + y/c
             let y = &xi[1..];
@@ -647,17 +718,17 @@ where
                 .iter_mut()
                 .zip(y.iter())
                 .zip(w_alm_aux.iter())
-                .for_each(|((y_plus_i, y_i), w_alm_aux_i)| *y_plus_i = w_alm_aux_i + y_i / c);
+                .for_each(|((y_plus_i, &y_i), &w_alm_aux_i)| *y_plus_i = w_alm_aux_i + y_i / c);
 
             // Step #3: y_plus := Proj_C(y_plus)
-            alm_set_c.project(y_plus);
+            alm_set_c.project_with_workspace(y_plus, &mut cache.projection_workspace);
 
             // Step #4
             y_plus
                 .iter_mut()
                 .zip(y.iter())
                 .zip(w_alm_aux.iter())
-                .for_each(|((y_plus_i, y_i), w_alm_aux_i)| {
+                .for_each(|((y_plus_i, &y_i), &w_alm_aux_i)| {
                     // y_plus := y  + c * (w_alm_aux   - y_plus)
                     *y_plus_i = y_i + c * (w_alm_aux_i - *y_plus_i)
                 });
@@ -671,12 +742,13 @@ where
         let problem = &self.alm_problem;
         if let Some(y_set) = &problem.alm_set_y {
             // NOTE: as_mut() converts from &mut Option<T> to Option<&mut T>
-            // * cache.y is                Option<Vec<f64>>
-            // * cache.y.as_mut is         Option<&mut Vec<f64>>
-            // *  which can be treated as  Option<&mut [f64]>
-            // * y_vec is                  &mut [f64]
-            if let Some(xi_vec) = self.alm_cache.xi.as_mut() {
-                y_set.project(&mut xi_vec[1..]);
+            // * cache.y is                Option<Vec<T>>
+            // * cache.y.as_mut is         Option<&mut Vec<T>>
+            // *  which can be treated as  Option<&mut [T]>
+            // * y_vec is                  &mut [T]
+            let cache = &mut self.alm_cache;
+            if let Some(xi_vec) = cache.xi.as_mut() {
+                y_set.project_with_workspace(&mut xi_vec[1..], &mut cache.projection_workspace);
             }
         }
     }
@@ -696,7 +768,7 @@ where
     /// error in solving the inner problem.
     ///
     ///
-    fn solve_inner_problem(&mut self, u: &mut [f64]) -> Result<SolverStatus, SolverError> {
+    fn solve_inner_problem(&mut self, u: &mut [T]) -> Result<SolverStatus, SolverError> {
         let alm_problem = &self.alm_problem; // Problem
         let alm_cache = &mut self.alm_cache; // ALM cache
 
@@ -713,20 +785,30 @@ where
         // Construct psi and psi_grad (as functions of `u` alone); it is
         // psi(u) = psi(u; xi) and psi_grad(u) = phi_grad(u; xi)
         // psi: R^nu --> R
-        let psi = |u: &[f64], psi_val: &mut f64| -> FunctionCallResult {
+        let psi = |u: &[T], psi_val: &mut T| -> FunctionCallResult {
             (alm_problem.parametric_cost)(u, xi, psi_val)
         };
         // psi_grad: R^nu --> R^nu
-        let psi_grad = |u: &[f64], psi_grad: &mut [f64]| -> FunctionCallResult {
+        let psi_grad = |u: &[T], psi_grad: &mut [T]| -> FunctionCallResult {
             (alm_problem.parametric_gradient)(u, xi, psi_grad)
         };
+        // psi_and_grad: R^nu --> R x R^nu (if provided)
+        let psi_and_grad = alm_problem.parametric_cost_and_gradient.as_ref().map(|f| {
+            move |u: &[T], psi_val: &mut T, psi_grad: &mut [T]| -> FunctionCallResult {
+                f(u, xi, psi_val, psi_grad)
+            }
+        });
         // define the inner problem
-        let inner_problem = Problem::new(&self.alm_problem.constraints, psi_grad, psi);
+        let inner_problem = Problem::new(&self.alm_problem.constraints, psi_grad, psi)
+            .with_optional_cost_and_gradient(psi_and_grad);
         // The AKKT-tolerance decreases until it reaches the target tolerance
         // We don't need to update the tolerance here; this is done in
         // `update_inner_akkt_tolerance` which updates the AKKT-tolerance (epsilon)
         // in the PANOCCache instance held by AlmCache directly.
-        let mut inner_solver = PANOCOptimizer::new(inner_problem, &mut alm_cache.panoc_cache)
+        let deadline = alm_cache.deadline;
+        let outer_iteration = alm_cache.iteration;
+        let penalty = xi.first().map_or(f64::NAN, |c| c.as_f64());
+        let inner_solver = PANOCOptimizer::new(inner_problem, &mut alm_cache.panoc_cache)
             // Set the maximum duration of the inner solver to the available time, which is
             // stored in AlmCache, or set it to the maximum possible duration
             .with_max_duration(
@@ -735,7 +817,13 @@ where
                     .unwrap_or_else(|| std::time::Duration::from_secs(std::u64::MAX)),
             )
             // Set the maximum number of inner iterations
-            .with_max_iter(self.max_inner_iterations);
+            .with_max_iter(self.max_inner_iterations)
+            .with_outer_iteration(outer_iteration, penalty);
+        // With a deadline, the inner solver stops at the deadline of the outer solver
+        let mut inner_solver = match deadline {
+            Some(deadline) => inner_solver.with_shared_deadline(deadline),
+            None => inner_solver,
+        };
         // this method returns the result of .solve:
         inner_solver.solve(u)
     }
@@ -750,7 +838,7 @@ where
             || if let Some(xi) = &cache.xi {
                 let c = xi[0];
                 cache.iteration > 0
-                    && cache.delta_y_norm_plus <= c * self.delta_tolerance + SMALL_EPSILON
+                    && cache.delta_y_norm_plus <= c * self.delta_tolerance + T::epsilon()
             } else {
                 true
             };
@@ -758,13 +846,13 @@ where
         //              If n2 = 0, there are no PM-type constraints, so this
         //              criterion is automatically satisfied
         let criterion_2 =
-            problem.n2 == 0 || cache.f2_norm_plus <= self.delta_tolerance + SMALL_EPSILON;
+            problem.n2 == 0 || cache.f2_norm_plus <= self.delta_tolerance + T::epsilon();
         // Criterion 3: epsilon_nu <= epsilon
         //              This function will panic is there is no akkt_tolerance
         //              This should never happen because we set the AKKT tolerance
         //              in the constructor and can never become `None` again
         let criterion_3 =
-            cache.panoc_cache.akkt_tolerance.unwrap() <= self.epsilon_tolerance + SMALL_EPSILON;
+            cache.panoc_cache.akkt_tolerance.unwrap() <= self.epsilon_tolerance + T::epsilon();
         criterion_1 && criterion_2 && criterion_3
     }
 
@@ -781,9 +869,9 @@ where
         let is_alm = problem.n1 > 0;
         let is_pm = problem.n2 > 0;
         let criterion_alm = cache.delta_y_norm_plus
-            <= self.sufficient_decrease_coeff * cache.delta_y_norm + SMALL_EPSILON;
+            <= self.sufficient_decrease_coeff * cache.delta_y_norm + T::epsilon();
         let criterion_pm =
-            cache.f2_norm_plus <= self.sufficient_decrease_coeff * cache.f2_norm + SMALL_EPSILON;
+            cache.f2_norm_plus <= self.sufficient_decrease_coeff * cache.f2_norm + T::epsilon();
         if is_alm && !is_pm {
             return criterion_alm;
         } else if !is_alm && is_pm {
@@ -795,6 +883,66 @@ where
         false
     }
 
+    /// Infeasibility of the current iterate, `max(||y_plus - y|| / c, ||F2(u)||)`
+    fn infeasibility(&self) -> T {
+        let cache = &self.alm_cache;
+        let c = cache.xi.as_ref().map_or(T::one(), |xi| xi[0]);
+        let mut infeasibility = T::zero();
+        if self.alm_problem.n1 > 0 {
+            infeasibility = cache.delta_y_norm_plus / c;
+        }
+        if self.alm_problem.n2 > 0 {
+            infeasibility = T::max(infeasibility, cache.f2_norm_plus);
+        }
+        infeasibility
+    }
+
+    /// Stores the current iterate, `u`, if it is better than the best iterate
+    /// so far (see `with_deadline`)
+    fn keep_best_iterate(&mut self, u: &[T]) {
+        let infeasibility = self.infeasibility();
+        let cache = &mut self.alm_cache;
+        let c = cache.xi.as_ref().map_or(T::one(), |xi| xi[0]);
+        let best = &mut cache.best_iterate;
+        let is_better = if infeasibility <= self.delta_tolerance
+            && best.infeasibility <= self.delta_tolerance
+        {
+            cache.last_inner_problem_norm_fpr < best.norm_fpr
+        } else {
+            infeasibility < best.infeasibility
+        };
+        if is_better {
+            best.u.copy_from_slice(u);
+            if let Some(y_plus) = &cache.y_plus {
+                best.y.copy_from_slice(y_plus);
+            }
+            best.infeasibility = infeasibility;
+            best.norm_fpr = cache.last_inner_problem_norm_fpr;
+            best.delta_y_norm = cache.delta_y_norm_plus;
+            best.f2_norm = cache.f2_norm_plus;
+            best.penalty = c;
+        }
+    }
+
+    /// Replaces the current iterate, `u`, by the best iterate (if any)
+    fn restore_best_iterate(&mut self, u: &mut [T]) {
+        let cache = &mut self.alm_cache;
+        let best = &cache.best_iterate;
+        if !best.infeasibility.is_finite() {
+            return;
+        }
+        u.copy_from_slice(&best.u);
+        if let Some(y_plus) = &mut cache.y_plus {
+            y_plus.copy_from_slice(&best.y);
+        }
+        if let Some(xi) = &mut cache.xi {
+            xi[0] = best.penalty;
+        }
+        cache.last_inner_problem_norm_fpr = best.norm_fpr;
+        cache.delta_y_norm_plus = best.delta_y_norm;
+        cache.f2_norm_plus = best.f2_norm;
+    }
+
     fn update_penalty_parameter(&mut self) {
         let cache = &mut self.alm_cache;
         if let Some(xi) = &mut cache.xi {
@@ -805,7 +953,7 @@ where
     fn update_inner_akkt_tolerance(&mut self) {
         let cache = &mut self.alm_cache;
         // epsilon_{nu+1} := max(epsilon, beta*epsilon_nu)
-        cache.panoc_cache.set_akkt_tolerance(f64::max(
+        cache.panoc_cache.set_akkt_tolerance(T::max(
             cache.panoc_cache.akkt_tolerance.unwrap() * self.epsilon_update_factor,
             self.epsilon_tolerance,
         ));
@@ -819,7 +967,9 @@ where
         if let (Some(xi), Some(y_plus)) = (&mut cache.xi, &cache.y_plus) {
             xi[1..].copy_from_slice(y_plus);
         }
-        cache.panoc_cache.reset();
+        if cache.panoc_cache.warm_start == WarmStartPolicy::Cold {
+            cache.panoc_cache.reset();
+        }
     }
 
     /// Step of ALM algorithm
@@ -837,7 +987,7 @@ where
     /// - Shrinks the inner tolerance and
     /// - Updates the ALM cache
     ///
-    fn step(&mut self, u: &mut [f64]) -> Result<InnerProblemStatus, SolverError> {
+    fn step(&mut self, u: &mut [T]) -> Result<InnerProblemStatus, SolverError> {
         // store the exit status of the inner problem in this problem
         // (we'll need to return it within `InnerProblemStatus`)
         let mut inner_exit_status: ExitStatus = ExitStatus::Converged;
@@ -852,6 +1002,7 @@ where
             let inner_iters = status.iterations();
             self.alm_cache.last_inner_problem_norm_fpr = status.norm_fpr();
             self.alm_cache.inner_iteration_count += inner_iters;
+            self.alm_cache.statistics.accumulate(status.statistics());
             inner_exit_status = status.exit_status();
         })?;
 
@@ -866,6 +1017,19 @@ where
         self.compute_pm_infeasibility(u)?; // penalty method: F2(u_plus) and its norm
         self.compute_alm_infeasibility()?; // ALM: ||y_plus - y||
 
+        // Store the infeasibility in the trace
+        if self.alm_cache.panoc_cache.trace.is_some() {
+            let infeasibility = self.infeasibility().as_f64();
+            if let Some(trace) = self.alm_cache.panoc_cache.trace.as_mut() {
+                trace.set_infeasibility(infeasibility);
+            }
+        }
+
+        // With a deadline, keep the best iterate so far
+        if self.alm_cache.deadline.is_some() {
+            self.keep_best_iterate(u);
+        }
+
         // Check exit criterion
         if self.is_exit_criterion_satisfied() {
             // Do not continue the outer iteration
@@ -885,19 +1049,23 @@ where
         Ok(InnerProblemStatus::new(true, inner_exit_status)) // `true` means do continue the outer iterations
     }
 
-    fn compute_cost_at_solution(&mut self, u: &mut [f64]) -> Result<f64, SolverError> {
+    fn compute_cost_at_solution(&mut self, u: &mut [T]) -> Result<T, SolverError> {
         /* WORK IN PROGRESS */
         let alm_problem = &self.alm_problem; // Problem
         let alm_cache = &mut self.alm_cache; // ALM Cache
         let mut empty_vec = std::vec::Vec::new(); // Empty vector
-        let xi: &mut std::vec::Vec<f64> = alm_cache.xi.as_mut().unwrap_or(&mut empty_vec);
-        let mut __c: f64 = 0.0;
+        let xi: &mut std::vec::Vec<T> = alm_cache.xi.as_mut().unwrap_or(&mut empty_vec);
+        let mut __c = T::zero();
         if !xi.is_empty() {
             __c = xi[0];
-            xi[0] = 0.0;
+            xi[0] = T::zero();
         }
-        let mut cost_value: f64 = 0.0;
-        (alm_problem.parametric_cost)(u, xi, &mut cost_value)?;
+        let mut cost_value = T::zero();
+        instrumented!(
+            alm_cache.statistics,
+            Phase::CostEvaluation,
+            (alm_problem.parametric_cost)(u, xi, &mut cost_value)
+        )?;
         if !xi.is_empty() {
             xi[0] = __c;
         }
@@ -911,21 +1079,49 @@ where
     /// Solve the specified ALM problem
     ///
     ///
-    pub fn solve(&mut self, u: &mut [f64]) -> Result<AlmOptimizerStatus, SolverError> {
+    pub fn solve(&mut self, u: &mut [T]) -> Result<AlmOptimizerStatus, SolverError> {
         let mut num_outer_iterations = 0;
         // let tic = std::time::Instant::now();
         let tic = instant::Instant::now();
         let mut exit_status = ExitStatus::Converged;
-        self.alm_cache.reset(); // first, reset the cache
+        // first, reset the cache (keeping the warm start of PANOC, if so requested)
+        if self.alm_cache.panoc_cache.warm_start == WarmStartPolicy::AcrossSolves {
+            self.alm_cache.reset_outer_state();
+        } else {
+            self.alm_cache.reset();
+        }
         self.alm_cache.available_time = self.max_duration;
+        self.alm_cache.deadline = self.deadline.map(Deadline::new);
+        if let Some(trace) = self.alm_cache.panoc_cache.trace.as_mut() {
+            trace.clear();
+        }
+        if let Some(deadline) = self.alm_cache.deadline.as_mut() {
+            deadline.start(self.alm_cache.panoc_cache.iteration_time);
+            // the first solve with a deadline allocates memory for the best iterate
+            let n1 = self.alm_problem.n1;
+            let best = &mut self.alm_cache.best_iterate;
+            best.u.resize(u.len(), T::zero());
+            best.y.resize(n1, T::zero());
+            best.infeasibility = T::infinity();
+            best.norm_fpr = f64::INFINITY;
+        }
 
         self.alm_cache
             .panoc_cache
             .set_akkt_tolerance(self.epsilon_inner_initial);
 
         let mut inner = InnerProblemStatus::new(false, ExitStatus::Converged);
+        let mut dominated = false;
         for _outer_iters in 1..=self.max_outer_iterations {
-            if let Some(max_duration) = self.max_duration {
+            if let Some(deadline) = &self.alm_cache.deadline {
+                // an inner problem needs (at least) one iteration, and the
+                // solver needs about as long to finish
+                let iteration_time = self.alm_cache.panoc_cache.iteration_time;
+                if !deadline.has_time_for(2, iteration_time) {
+                    exit_status = ExitStatus::NotConvergedOutOfTime;
+                    break;
+                }
+            } else if let Some(max_duration) = self.max_duration {
                 let available_time_left = max_duration.checked_sub(tic.elapsed());
                 self.alm_cache.available_time = available_time_left;
                 if available_time_left.is_none() {
@@ -944,6 +1140,15 @@ where
             if !inner.outer_continue_iterating {
                 break;
             }
+            if let Some(early_stop) = self.early_stop {
+                // the cost is only computed once there is a solution to compare with
+                if early_stop.best_cost().is_finite()
+                    && early_stop.should_stop(self.compute_cost_at_solution(u)?.as_f64())
+                {
+                    dominated = true;
+                    break;
+                }
+            }
         }
 
         // after outer loop: if the outer loop has terminated, and it was no interrupted
@@ -961,11 +1166,21 @@ where
             exit_status = ExitStatus::NotConvergedIterations;
         }
 
+        // the start of a multi-start solve has been abandoned
+        if dominated {
+            exit_status = multistart::ABANDONED_EXIT_STATUS;
+        }
+
+        // out of time: return the best iterate so far
+        if self.alm_cache.deadline.is_some() && exit_status == ExitStatus::NotConvergedOutOfTime {
+            self.restore_best_iterate(u);
+        }
+
         // obtain the penalty parameter
         let c = if let Some(xi) = &self.alm_cache.xi {
             xi[0]
         } else {
-            0.0
+            T::zero()
         };
 
         let cost = self.compute_cost_at_solution(u)?;
@@ -974,10 +1189,11 @@ where
             .with_inner_iterations(self.alm_cache.inner_iteration_count)
             .with_outer_iterations(num_outer_iterations)
             .with_last_problem_norm_fpr(self.alm_cache.last_inner_problem_norm_fpr)
-            .with_delta_y_norm(self.alm_cache.delta_y_norm_plus)
-            .with_f2_norm(self.alm_cache.f2_norm_plus)
-            .with_penalty(c)
-            .with_cost(cost);
+            .with_delta_y_norm(self.alm_cache.delta_y_norm_plus.as_f64())
+            .with_f2_norm(self.alm_cache.f2_norm_plus.as_f64())
+            .with_penalty(c.as_f64())
+            .with_cost(cost.as_f64())
+            .with_statistics(self.alm_cache.statistics);
         if self.alm_problem.n1 > 0 {
             let status = status.with_lagrange_multipliers(
                 self.alm_cache
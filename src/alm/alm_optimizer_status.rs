@@ -1,4 +1,7 @@
-use crate::core::ExitStatus;
+use crate::{
+    core::{multistart::StartStatus, ExitStatus, SolverStatistics},
+    Scalar,
+};
 
 /// Solution statistics for `AlmOptimizer`
 ///
@@ -32,6 +35,9 @@ pub struct AlmOptimizerStatus {
     f2_norm: f64,
     /// Value of cost function at optimal solution (optimal cost)
     cost: f64,
+    /// Statistics of the phases of the algorithm (only recorded
+    /// with the feature `instrumentation`)
+    statistics: SolverStatistics,
 }
 
 impl AlmOptimizerStatus {
@@ -67,6 +73,7 @@ impl AlmOptimizerStatus {
             delta_y_norm: 0.0,
             f2_norm: 0.0,
             cost: 0.0,
+            statistics: SolverStatistics::new(),
         }
     }
 
@@ -129,10 +136,13 @@ impl AlmOptimizerStatus {
     /// Does not panic; it is the responsibility of the caller to provide a vector of
     /// Lagrange multipliers of correct length
     ///
-    pub(crate) fn with_lagrange_multipliers(mut self, lagrange_multipliers: &[f64]) -> Self {
+    pub(crate) fn with_lagrange_multipliers<T: Scalar>(
+        mut self,
+        lagrange_multipliers: &[T],
+    ) -> Self {
         self.lagrange_multipliers = Some(vec![]);
         if let Some(y) = &mut self.lagrange_multipliers {
-            y.extend_from_slice(lagrange_multipliers);
+            y.extend(lagrange_multipliers.iter().map(|&y_i| y_i.as_f64()));
         }
         self
     }
@@ -187,6 +197,11 @@ impl AlmOptimizerStatus {
         self
     }
 
+    pub(crate) fn with_statistics(mut self, statistics: SolverStatistics) -> Self {
+        self.statistics = statistics;
+        self
+    }
+
     // -------------------------------------------------
     // Update Methods
     // -------------------------------------------------
@@ -297,4 +312,21 @@ impl AlmOptimizerStatus {
     pub fn cost(&self) -> f64 {
         self.cost
     }
+
+    /// Number of executions and duration of the phases of the algorithm,
+    /// accumulated over all inner problems; all entries are zero unless
+    /// OpEn is compiled with the feature `instrumentation`
+    pub fn statistics(&self) -> &SolverStatistics {
+        &self.statistics
+    }
+}
+
+impl StartStatus for AlmOptimizerStatus {
+    fn is_converged(&self) -> bool {
+        self.exit_status == ExitStatus::Converged
+    }
+
+    fn cost_value(&self) -> f64 {
+        self.cost
+    }
 }
@@ -1,4 +1,6 @@
-use crate::{constraints::Constraint, FunctionCallResult};
+use crate::{
+    alm::ParametricCostAndGradientType, constraints::Constraint, FunctionCallResult, Scalar,
+};
 
 /// Definition of optimization problem to be solved with `AlmOptimizer`. The optimization
 /// problem has the general form
@@ -24,6 +26,15 @@ use crate::{constraints::Constraint, FunctionCallResult};
 ///   are mappings with smooth partial derivatives, and
 /// - $C\subseteq\mathbb{R}^{n_1}$ is a convex closed set on which we can easily compute projections.
 ///
+/// The decision variables are of type `T`, which is `f64` by default; note that
+/// [`NO_MAPPING`](constant.NO_MAPPING.html) is a double-precision mapping, so in
+/// single precision an unused mapping is specified as
+/// `None::<fn(&[f32], &mut [f32]) -> FunctionCallResult>`
+///
+/// Optionally, a function which computes $\psi(u, \xi)$ and $\nabla_u \psi(u, \xi)$
+/// at the same point can be provided with `with_cost_and_gradient`; the inner solver
+/// uses it where both are needed
+///
 pub struct AlmProblem<
     MappingAlm,
     MappingPm,
@@ -32,16 +43,20 @@ pub struct AlmProblem<
     ConstraintsType,
     AlmSetC,
     LagrangeSetY,
+    T = f64,
+    ParametricCostGradientType = ParametricCostAndGradientType<T>,
 > where
+    T: Scalar,
     // This is function F1: R^xn --> R^n1 (ALM)
-    MappingAlm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
+    MappingAlm: Fn(&[T], &mut [T]) -> FunctionCallResult,
     // This is function F2: R^xn --> R^n2 (PM)
-    MappingPm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricGradientType: Fn(&[f64], &[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricCostType: Fn(&[f64], &[f64], &mut f64) -> FunctionCallResult,
-    ConstraintsType: Constraint,
-    AlmSetC: Constraint,
-    LagrangeSetY: Constraint,
+    MappingPm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    ParametricGradientType: Fn(&[T], &[T], &mut [T]) -> FunctionCallResult,
+    ParametricCostType: Fn(&[T], &[T], &mut T) -> FunctionCallResult,
+    ParametricCostGradientType: Fn(&[T], &[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintsType: Constraint<T>,
+    AlmSetC: Constraint<T>,
+    LagrangeSetY: Constraint<T>,
 {
     //
     // NOTE: the reason why we need to define different set types (ConstraintsType,
@@ -59,6 +74,8 @@ pub struct AlmProblem<
     pub(crate) parametric_cost: ParametricCostType,
     /// gradient of parametric cost function, psi'(u; p)
     pub(crate) parametric_gradient: ParametricGradientType,
+    /// parametric cost function and its gradient (optional)
+    pub(crate) parametric_cost_and_gradient: Option<ParametricCostGradientType>,
     /// Mapping F1(u; p)
     pub(crate) mapping_f1: Option<MappingAlm>,
     /// Mapping F2(u; p)
@@ -67,6 +84,7 @@ pub struct AlmProblem<
     pub(crate) n1: usize,
     /// number of PM-type parameters (range dim of F2)
     pub(crate) n2: usize,
+    scalar: std::marker::PhantomData<T>,
 }
 
 impl<
@@ -77,6 +95,7 @@ impl<
         ConstraintsType,
         AlmSetC,
         LagrangeSetY,
+        T,
     >
     AlmProblem<
         MappingAlm,
@@ -86,15 +105,17 @@ impl<
         ConstraintsType,
         AlmSetC,
         LagrangeSetY,
+        T,
     >
 where
-    MappingAlm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    MappingPm: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricGradientType: Fn(&[f64], &[f64], &mut [f64]) -> FunctionCallResult,
-    ParametricCostType: Fn(&[f64], &[f64], &mut f64) -> FunctionCallResult,
-    ConstraintsType: Constraint,
-    AlmSetC: Constraint,
-    LagrangeSetY: Constraint,
+    T: Scalar,
+    MappingAlm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    MappingPm: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    ParametricGradientType: Fn(&[T], &[T], &mut [T]) -> FunctionCallResult,
+    ParametricCostType: Fn(&[T], &[T], &mut T) -> FunctionCallResult,
+    ConstraintsType: Constraint<T>,
+    AlmSetC: Constraint<T>,
+    LagrangeSetY: Constraint<T>,
 {
     ///Constructs new instance of `AlmProblem`
     ///
@@ -163,6 +184,78 @@ where
             mapping_f2,
             n1,
             n2,
+            parametric_cost_and_gradient: None,
+            scalar: std::marker::PhantomData,
+        }
+    }
+
+    /// Specifies a function which computes the parametric cost and its gradient
+    /// at the same point
+    ///
+    /// # Arguments
+    ///
+    /// - `parametric_cost_and_gradient`: function of the form `f(u, xi, cost, grad)`
+    ///    which computes $\psi(u, \xi)$ and $\nabla_u \psi(u, \xi)$
+    ///
+    /// # Returns
+    ///
+    /// The problem with the given function; `parametric_cost` and `parametric_gradient`
+    /// are still used where only one of the two is needed
+    ///
+    /// # Example
+    ///
+    /// ```rust
+    /// use optimization_engine::{FunctionCallResult, alm::*, constraints::Ball2};
+    ///
+    /// let psi = |u: &[f64], _xi: &[f64], cost: &mut f64| -> FunctionCallResult {
+    ///     *cost = u[0] * u[0];
+    ///     Ok(())
+    /// };
+    /// let dpsi = |u: &[f64], _xi: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+    ///     grad[0] = 2.0 * u[0];
+    ///     Ok(())
+    /// };
+    /// let psi_and_grad = |u: &[f64], _xi: &[f64], cost: &mut f64, grad: &mut [f64]| {
+    ///     *cost = u[0] * u[0];
+    ///     grad[0] = 2.0 * u[0];
+    ///     Ok(())
+    /// };
+    /// let bounds = Ball2::new(None, 10.0);
+    /// let _alm_problem = AlmProblem::new(
+    ///     bounds, NO_SET, NO_SET, psi, dpsi, NO_MAPPING, NO_MAPPING, 0, 0,
+    /// )
+    /// .with_cost_and_gradient(psi_and_grad);
+    /// ```
+    ///
+    pub fn with_cost_and_gradient<ParametricCostGradientType>(
+        self,
+        parametric_cost_and_gradient: ParametricCostGradientType,
+    ) -> AlmProblem<
+        MappingAlm,
+        MappingPm,
+        ParametricGradientType,
+        ParametricCostType,
+        ConstraintsType,
+        AlmSetC,
+        LagrangeSetY,
+        T,
+        ParametricCostGradientType,
+    >
+    where
+        ParametricCostGradientType: Fn(&[T], &[T], &mut T, &mut [T]) -> FunctionCallResult,
+    {
+        AlmProblem {
+            constraints: self.constraints,
+            alm_set_c: self.alm_set_c,
+            alm_set_y: self.alm_set_y,
+            parametric_cost: self.parametric_cost,
+            parametric_gradient: self.parametric_gradient,
+            parametric_cost_and_gradient: Some(parametric_cost_and_gradient),
+            mapping_f1: self.mapping_f1,
+            mapping_f2: self.mapping_f2,
+            n1: self.n1,
+            n2: self.n2,
+            scalar: std::marker::PhantomData,
         }
     }
 }
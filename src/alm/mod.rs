@@ -22,23 +22,32 @@
 //! Should the user need to use Optimization Engine in Rust, she can construct
 //! function `psi` using [`AlmFactory`]
 //!
+//! In server deployments, where requests with unrelated parameters are
+//! interleaved, a [`SolutionCache`] can be used to warm start each solve from
+//! the solution of the nearest recently solved parameter
+//!
 //! [`AlmProblem`]: struct.AlmProblem.html
 //! [`AlmOptimizer`]: struct.AlmOptimizer.html
 //! [`AlmCache`]: struct.AlmCache.html
 //! [`AlmOptimizerStatus`]: struct.AlmOptimizerStatus.html
 //! [`AlmFactory`]: struct.AlmFactory.html
+//! [`SolutionCache`]: struct.SolutionCache.html
 //!
 mod alm_cache;
 mod alm_factory;
 mod alm_optimizer;
 mod alm_optimizer_status;
 mod alm_problem;
+mod solution_cache;
+mod solver_host;
 
 pub use alm_cache::AlmCache;
 pub use alm_factory::AlmFactory;
 pub use alm_optimizer::AlmOptimizer;
 pub use alm_optimizer_status::AlmOptimizerStatus;
 pub use alm_problem::AlmProblem;
+pub use solution_cache::{SolutionCache, SolutionCacheOutcome, SolutionCacheSeed};
+pub use solver_host::{HostError, HostRequest, HostResponse, HostTicket, HostedSolver, SolverHost};
 
 /// Type of mappings $F_1(u)$ and $F_2(u)$
 ///
@@ -55,6 +64,17 @@ pub type MappingType = fn(&[f64], &mut [f64]) -> Result<(), crate::SolverError>;
 /// and $d\in\mathbb{R}^{n_1}$ (similarly for $F_2$)
 pub type JacobianMappingType = fn(&[f64], &[f64], &mut [f64]) -> Result<(), crate::SolverError>;
 
+/// Type of functions which compute the parametric cost $\psi(u, \xi)$ and its
+/// gradient $\nabla_u \psi(u, \xi)$ at the same point
+///
+/// These functions have the signature
+///
+/// ```ignore
+/// fn psi_and_grad(u: &[T], xi: &[T], cost: &mut T, grad: &mut [T]) -> FunctionCallResult
+/// ```
+pub type ParametricCostAndGradientType<T = f64> =
+    fn(&[T], &[T], &mut T, &mut [T]) -> Result<(), crate::SolverError>;
+
 /// No mapping $F_1(u)$ or $F_2(u)$ is specified
 pub const NO_MAPPING: Option<MappingType> = None::<MappingType>;
 
@@ -0,0 +1,431 @@
+//! Cache of recent solutions, which are used to warm start new solves
+//!
+//! When a solver serves requests with unrelated parameters (e.g., several
+//! clients of the same TCP server), the previous solution is usually a poor
+//! initial guess. [`SolutionCache`] keeps the converged solutions of the most
+//! recently used parameters, namely the decision variables, $u$, the Lagrange
+//! multipliers, $y$, and the final penalty parameter, $c$, and seeds a new
+//! solve with the solution whose parameter is nearest (in the Euclidean norm)
+//! to the new one. When the cache is full, the least recently used solution
+//! is evicted.
+//!
+//! The memory for all entries is allocated when the cache is constructed; the
+//! lookup is a linear scan, which is fast for the intended (small) capacities.
+//!
+use crate::{alm::AlmOptimizerStatus, core::ExitStatus, SolverError};
+
+/// A solution which is stored in the cache
+#[derive(Debug, Clone)]
+struct Entry {
+    /// Parameter
+    p: Vec<f64>,
+    /// Solution
+    u: Vec<f64>,
+    /// Lagrange multipliers
+    y: Vec<f64>,
+    /// Final penalty parameter
+    penalty: f64,
+    /// Number of inner iterations of the solve that produced this
+    /// solution without a seed (used to estimate the iterations saved)
+    reference_iterations: usize,
+    /// Time of last use (value of the use counter)
+    last_used: u64,
+}
+
+/// Solution of the cache which seeds a solve (see [`SolutionCache::seed`])
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct SolutionCacheSeed {
+    penalty: f64,
+    distance: f64,
+    reference_iterations: usize,
+}
+
+impl SolutionCacheSeed {
+    /// Final penalty parameter of the cached solution, which should be used
+    /// as initial penalty parameter
+    pub fn penalty(&self) -> f64 {
+        self.penalty
+    }
+
+    /// Distance between the parameter of the cached solution and the
+    /// parameter of the new solve
+    pub fn distance(&self) -> f64 {
+        self.distance
+    }
+}
+
+/// Outcome of a solve with a solution cache
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct SolutionCacheOutcome {
+    hit: bool,
+    iterations_saved: usize,
+}
+
+impl SolutionCacheOutcome {
+    /// Whether the solve was seeded with a cached solution
+    pub fn is_hit(&self) -> bool {
+        self.hit
+    }
+
+    /// Estimated number of inner iterations that the seed saved, that is,
+    /// the number of inner iterations of the solve without a seed that
+    /// produced the cached solution minus the number of inner iterations of
+    /// this solve (zero if this solve took more iterations or there was no seed)
+    pub fn iterations_saved(&self) -> usize {
+        self.iterations_saved
+    }
+}
+
+/// Bounded cache of converged solutions with least-recently-used eviction
+/// (see the [module documentation](index.html))
+///
+/// # Example
+///
+/// ```
+/// use optimization_engine::alm::SolutionCache;
+///
+/// // up to 32 solutions of a problem with 2 parameters, 5 decision variables
+/// // and 3 ALM-type constraints
+/// let mut solution_cache = SolutionCache::new(32, 2, 5, 3).with_max_distance(1.0);
+/// assert!(solution_cache.is_empty());
+/// ```
+#[derive(Debug, Clone)]
+pub struct SolutionCache {
+    /// Entries; only the first `len` entries are in use
+    entries: Vec<Entry>,
+    /// Number of entries in use
+    len: usize,
+    /// Use counter, which orders the entries by time of last use
+    clock: u64,
+    /// Maximum distance between the parameters of a seed and a new solve
+    max_distance: f64,
+    /// Buffer for the Lagrange multipliers of a seed (`None` if there are
+    /// no ALM-type constraints)
+    y0: Option<Vec<f64>>,
+}
+
+impl SolutionCache {
+    /// Constructs a new (empty) cache
+    ///
+    /// # Arguments
+    ///
+    /// - `capacity`: maximum number of solutions
+    /// - `num_parameters`: dimension of the parameter vector
+    /// - `num_decision_variables`: dimension of the decision variables
+    /// - `n1`: number of ALM-type constraints (dimension of the Lagrange multipliers)
+    ///
+    /// # Panics
+    ///
+    /// The method panics if `capacity` is zero
+    ///
+    pub fn new(
+        capacity: usize,
+        num_parameters: usize,
+        num_decision_variables: usize,
+        n1: usize,
+    ) -> Self {
+        assert!(capacity > 0, "capacity must be positive");
+        let entry = Entry {
+            p: vec![0.0; num_parameters],
+            u: vec![0.0; num_decision_variables],
+            y: vec![0.0; n1],
+            penalty: 0.0,
+            reference_iterations: 0,
+            last_used: 0,
+        };
+        SolutionCache {
+            entries: vec![entry; capacity],
+            len: 0,
+            clock: 0,
+            max_distance: f64::INFINITY,
+            y0: if n1 > 0 { Some(vec![0.0; n1]) } else { None },
+        }
+    }
+
+    /// Sets the maximum distance between the parameter of a cached solution
+    /// and the parameter of a new solve for the solution to be used as a seed
+    /// (the default is infinity, that is, the nearest solution is always used)
+    ///
+    /// # Panics
+    ///
+    /// The method panics if `max_distance` is negative
+    ///
+    pub fn with_max_distance(mut self, max_distance: f64) -> Self {
+        assert!(max_distance >= 0.0, "max_distance must be nonnegative");
+        self.max_distance = max_distance;
+        self
+    }
+
+    /// Maximum number of solutions
+    pub fn capacity(&self) -> usize {
+        self.entries.len()
+    }
+
+    /// Number of cached solutions
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Whether the cache is empty
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Removes all solutions
+    pub fn clear(&mut self) {
+        self.len = 0;
+    }
+
+    /// Index and (squared) distance of the cached solution whose parameter is
+    /// nearest to `p`
+    fn nearest(&self, p: &[f64]) -> Option<(usize, f64)> {
+        self.entries[..self.len]
+            .iter()
+            .map(|entry| {
+                entry
+                    .p
+                    .iter()
+                    .zip(p.iter())
+                    .map(|(a, b)| (a - b) * (a - b))
+                    .sum::<f64>()
+            })
+            .enumerate()
+            .fold(
+                None,
+                |nearest: Option<(usize, f64)>, (i, d)| match nearest {
+                    Some((_, d_min)) if d_min <= d => nearest,
+                    _ => Some((i, d)),
+                },
+            )
+    }
+
+    /// Looks up the solution whose parameter is nearest to `p`
+    ///
+    /// If there is a solution within the maximum distance, it is copied into
+    /// `u` and its Lagrange multipliers are copied into `y` (which must have
+    /// length `n1`), and the seed is returned; otherwise, `u` and `y` are not
+    /// modified and `None` is returned.
+    ///
+    /// # Panics
+    ///
+    /// The method panics if the dimensions of `p`, `u` or `y` are wrong
+    ///
+    pub fn seed(&mut self, p: &[f64], u: &mut [f64], y: &mut [f64]) -> Option<SolutionCacheSeed> {
+        let (i, distance_squared) = self.nearest(p)?;
+        let distance = distance_squared.sqrt();
+        if distance > self.max_distance {
+            return None;
+        }
+        self.clock += 1;
+        let entry = &mut self.entries[i];
+        entry.last_used = self.clock;
+        u.copy_from_slice(&entry.u);
+        y.copy_from_slice(&entry.y);
+        Some(SolutionCacheSeed {
+            penalty: entry.penalty,
+            distance,
+            reference_iterations: entry.reference_iterations,
+        })
+    }
+
+    /// Records the result of a solve with parameter `p`, solution `u` and
+    /// solver status `status`, which was seeded with `seed` (if any)
+    ///
+    /// The solution is stored only if the solver has converged; if the cache
+    /// is full, the least recently used solution is evicted, unless there is
+    /// a solution with the same parameter, which is then replaced.
+    ///
+    /// # Panics
+    ///
+    /// The method panics if the dimensions of `p` or `u` are wrong
+    ///
+    pub fn record(
+        &mut self,
+        p: &[f64],
+        u: &[f64],
+        status: &AlmOptimizerStatus,
+        seed: Option<SolutionCacheSeed>,
+    ) -> SolutionCacheOutcome {
+        let iterations = status.num_inner_iterations();
+        let reference_iterations = seed.map_or(iterations, |s| s.reference_iterations);
+        let outcome = SolutionCacheOutcome {
+            hit: seed.is_some(),
+            iterations_saved: reference_iterations.saturating_sub(iterations),
+        };
+        if status.exit_status() != ExitStatus::Converged {
+            return outcome;
+        }
+
+        let i = match self.nearest(p) {
+            Some((i, distance_squared)) if distance_squared == 0.0 => i,
+            _ if self.len < self.capacity() => {
+                self.len += 1;
+                self.len - 1
+            }
+            _ => {
+                // evict the least recently used solution
+                (0..self.len)
+                    .min_by_key(|&i| self.entries[i].last_used)
+                    .unwrap_or(0)
+            }
+        };
+        self.clock += 1;
+        let entry = &mut self.entries[i];
+        entry.p.copy_from_slice(p);
+        entry.u.copy_from_slice(u);
+        if let Some(y) = status.lagrange_multipliers() {
+            entry.y.copy_from_slice(y);
+        }
+        entry.penalty = status.penalty();
+        entry.reference_iterations = reference_iterations;
+        entry.last_used = self.clock;
+        outcome
+    }
+
+    /// Solves a problem with parameter `p`, seeded by the cache
+    ///
+    /// If the cache has a solution for a nearby parameter, it is used as the
+    /// initial guess, `u`, together with its Lagrange multipliers and final
+    /// penalty parameter; otherwise, the provided `u` is used. The solution
+    /// is then recorded (see `record`).
+    ///
+    /// # Arguments
+    ///
+    /// - `p`: parameter
+    /// - `u`: on entry, initial guess (used if there is no seed), on exit, solution
+    /// - `solver`: closure that solves the problem given the initial guess,
+    ///   the initial Lagrange multipliers and the initial penalty (as the
+    ///   function `solve` of a generated solver)
+    ///
+    /// # Returns
+    ///
+    /// The result of the solver and the outcome of the cache lookup
+    ///
+    pub fn solve<F>(
+        &mut self,
+        p: &[f64],
+        u: &mut [f64],
+        solver: F,
+    ) -> (
+        Result<AlmOptimizerStatus, SolverError>,
+        SolutionCacheOutcome,
+    )
+    where
+        F: FnOnce(
+            &mut [f64],
+            &Option<Vec<f64>>,
+            &Option<f64>,
+        ) -> Result<AlmOptimizerStatus, SolverError>,
+    {
+        let mut y0 = self.y0.take();
+        let seed = self.seed(p, u, y0.as_deref_mut().unwrap_or(&mut []));
+        let c0 = seed.map(|s| s.penalty);
+        let y0 = if seed.is_some() {
+            y0
+        } else {
+            self.y0 = y0;
+            None
+        };
+        let result = solver(u, &y0, &c0);
+        if y0.is_some() {
+            self.y0 = y0;
+        }
+        match result {
+            Ok(status) => {
+                let outcome = self.record(p, u, &status, seed);
+                (Ok(status), outcome)
+            }
+            Err(e) => (
+                Err(e),
+                SolutionCacheOutcome {
+                    hit: seed.is_some(),
+                    iterations_saved: 0,
+                },
+            ),
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+
+    use super::*;
+
+    fn converged(iterations: usize, y: &[f64], penalty: f64) -> AlmOptimizerStatus {
+        AlmOptimizerStatus::new(ExitStatus::Converged)
+            .with_inner_iterations(iterations)
+            .with_lagrange_multipliers(y)
+            .with_penalty(penalty)
+    }
+
+    #[test]
+    fn t_solution_cache_nearest_neighbour() {
+        let mut solution_cache = SolutionCache::new(4, 1, 2, 1);
+        let (mut u, mut y) = ([0.0; 2], [0.0; 1]);
+        assert!(solution_cache.seed(&[0.0], &mut u, &mut y).is_none());
+        solution_cache.record(&[0.0], &[1.0, 1.0], &converged(50, &[0.5], 10.0), None);
+        solution_cache.record(&[1.0], &[2.0, 2.0], &converged(60, &[1.5], 20.0), None);
+        assert_eq!(2, solution_cache.len());
+
+        let seed = solution_cache.seed(&[0.8], &mut u, &mut y).unwrap();
+        assert_eq!([2.0, 2.0], u);
+        assert_eq!([1.5], y);
+        assert_eq!(20.0, seed.penalty());
+        assert!((seed.distance() - 0.2).abs() < 1e-12);
+
+        // a seeded solve which takes 15 iterations saves 45 iterations
+        let outcome = solution_cache.record(&[0.8], &u, &converged(15, &y, 20.0), Some(seed));
+        assert!(outcome.is_hit());
+        assert_eq!(45, outcome.iterations_saved());
+
+        // solutions which did not converge are not recorded
+        let not_converged = AlmOptimizerStatus::new(ExitStatus::NotConvergedIterations);
+        solution_cache.record(&[5.0], &u, &not_converged, None);
+        assert_eq!(3, solution_cache.len());
+
+        // beyond the maximum distance, there is no seed
+        let mut solution_cache = solution_cache.with_max_distance(0.1);
+        assert!(solution_cache.seed(&[0.5], &mut u, &mut y).is_none());
+    }
+
+    #[test]
+    fn t_solution_cache_lru_eviction() {
+        let mut solution_cache = SolutionCache::new(2, 1, 1, 0);
+        let mut u = [0.0];
+        solution_cache.record(&[0.0], &[0.0], &converged(10, &[], 1.0), None);
+        solution_cache.record(&[1.0], &[1.0], &converged(10, &[], 1.0), None);
+        // use the solution for p = 0, so that the one for p = 1 is evicted
+        solution_cache.seed(&[0.1], &mut u, &mut []).unwrap();
+        solution_cache.record(&[2.0], &[2.0], &converged(10, &[], 1.0), None);
+        assert_eq!(2, solution_cache.len());
+        solution_cache.seed(&[1.1], &mut u, &mut []).unwrap();
+        assert_eq!([2.0], u);
+        // a solution with the same parameter is replaced
+        solution_cache.record(&[2.0], &[3.0], &converged(10, &[], 1.0), None);
+        solution_cache.seed(&[2.0], &mut u, &mut []).unwrap();
+        assert_eq!([3.0], u);
+        assert_eq!(2, solution_cache.len());
+    }
+
+    #[test]
+    fn t_solution_cache_solve() {
+        let mut solution_cache = SolutionCache::new(8, 1, 1, 1);
+        let solver = |u: &mut [f64], y0: &Option<Vec<f64>>, c0: &Option<f64>| {
+            // the solver takes fewer iterations if it is warm started
+            let iterations = if y0.is_some() && c0.is_some() { 5 } else { 40 };
+            u[0] = 3.0;
+            Ok(converged(iterations, &[0.25], 100.0))
+        };
+        let mut u = [0.0];
+        let (status, outcome) = solution_cache.solve(&[1.0], &mut u, solver);
+        assert!(status.is_ok());
+        assert!(!outcome.is_hit());
+        let mut u = [0.0];
+        let (_, outcome) = solution_cache.solve(&[1.1], &mut u, solver);
+        assert!(outcome.is_hit());
+        assert_eq!(35, outcome.iterations_saved());
+    }
+}
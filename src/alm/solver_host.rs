@@ -0,0 +1,770 @@
+//! Host of several solvers which share a pool of worker threads
+//!
+//! An application that solves several different problems (e.g., a planner, a
+//! tracker and an estimator) can register all of them with one [`SolverHost`],
+//! by name, instead of running one server (and one pool of threads) per
+//! problem. Every solver is registered with a priority and a number of
+//! instances ([`HostedSolver`]s, e.g., solver caches); the instances bound the
+//! number of concurrent solves of that solver, so that background solves
+//! cannot occupy all workers.
+//!
+//! Requests are submitted with [`SolverHost::submit`] (or
+//! [`SolverHost::solve`], which waits for the response) and are queued; an
+//! idle worker runs the most urgent queued request for which an instance is
+//! available, that is, the request of the solver with the highest priority,
+//! then the one with the earliest deadline, then the oldest one. Solves are
+//! not preempted; a request with a deadline is solved with the time that
+//! remains after it has waited in the queue.
+//!
+//! Unless a request provides an initial guess, every instance is warm started
+//! with its previous solution. If a solver panics, the request fails with
+//! [`HostError::SolverPanicked`] and the instance is used again, starting from
+//! zero.
+//!
+use crate::{alm::AlmOptimizerStatus, SolverError};
+use std::{
+    cmp::Ordering,
+    panic::{self, AssertUnwindSafe},
+    sync::{mpsc, Arc, Condvar, Mutex, MutexGuard},
+    thread,
+    time::{Duration, Instant},
+};
+
+/// A solver instance which can be registered with a [`SolverHost`]
+///
+/// This is implemented by the generated optimizers (see `hosted_solver` in
+/// the generated crate)
+pub trait HostedSolver: Send {
+    /// Number of parameters
+    fn num_parameters(&self) -> usize;
+
+    /// Number of decision variables
+    fn num_decision_variables(&self) -> usize;
+
+    /// Number of Lagrange multipliers (dimension of the ALM-type constraints)
+    fn num_lagrange_multipliers(&self) -> usize;
+
+    /// Solves the problem for the parameter `p`, starting from `u`, which is
+    /// overwritten with the solution; the solver should return before the
+    /// `deadline`, if one is provided
+    fn solve(
+        &mut self,
+        p: &[f64],
+        u: &mut [f64],
+        y0: &Option<Vec<f64>>,
+        c0: &Option<f64>,
+        deadline: Option<Duration>,
+    ) -> Result<AlmOptimizerStatus, SolverError>;
+}
+
+/// Errors of a [`SolverHost`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum HostError {
+    /// There is no solver with the given name
+    UnknownSolver,
+    /// A solver with the given name is already registered
+    DuplicateSolver,
+    /// A solver is registered without instances, or with instances of
+    /// different dimensions
+    InvalidInstances,
+    /// The parameter has the wrong length
+    WrongNumberOfParameters,
+    /// The initial guess has the wrong length
+    WrongInitialGuess,
+    /// The initial Lagrange multipliers have the wrong length
+    WrongLagrangeMultipliers,
+    /// The host has shut down before the request was solved
+    ShutDown,
+    /// The solver panicked while solving the request
+    SolverPanicked,
+}
+
+/// Request to a solver of a [`SolverHost`]
+#[derive(Debug, Clone, Default)]
+pub struct HostRequest {
+    parameter: Vec<f64>,
+    initial_guess: Option<Vec<f64>>,
+    initial_lagrange_multipliers: Option<Vec<f64>>,
+    initial_penalty: Option<f64>,
+    deadline: Option<Duration>,
+}
+
+impl HostRequest {
+    /// Constructs a new request for the given parameter
+    pub fn new(parameter: Vec<f64>) -> Self {
+        HostRequest {
+            parameter,
+            ..Default::default()
+        }
+    }
+
+    /// Initial guess (by default, the solver is warm started with the previous
+    /// solution of its instance)
+    pub fn with_initial_guess(mut self, initial_guess: Vec<f64>) -> Self {
+        self.initial_guess = Some(initial_guess);
+        self
+    }
+
+    /// Initial vector of Lagrange multipliers
+    pub fn with_initial_lagrange_multipliers(mut self, y0: Vec<f64>) -> Self {
+        self.initial_lagrange_multipliers = Some(y0);
+        self
+    }
+
+    /// Initial penalty parameter
+    pub fn with_initial_penalty(mut self, c0: f64) -> Self {
+        self.initial_penalty = Some(c0);
+        self
+    }
+
+    /// Deadline, relative to the submission of the request; among requests of
+    /// the same priority, the one with the earliest deadline is solved first
+    pub fn with_deadline(mut self, deadline: Duration) -> Self {
+        self.deadline = Some(deadline);
+        self
+    }
+}
+
+/// Response of a solver of a [`SolverHost`]
+#[derive(Debug)]
+pub struct HostResponse {
+    status: Result<AlmOptimizerStatus, SolverError>,
+    solution: Vec<f64>,
+    queue_wait: Duration,
+}
+
+impl HostResponse {
+    /// Status of the solve
+    pub fn status(&self) -> &Result<AlmOptimizerStatus, SolverError> {
+        &self.status
+    }
+
+    /// Solution
+    pub fn solution(&self) -> &[f64] {
+        &self.solution
+    }
+
+    /// Time that the request waited in the queue
+    pub fn queue_wait(&self) -> Duration {
+        self.queue_wait
+    }
+}
+
+/// Handle of a request that has been submitted to a [`SolverHost`]
+#[derive(Debug)]
+pub struct HostTicket {
+    receiver: mpsc::Receiver<Result<HostResponse, HostError>>,
+}
+
+impl HostTicket {
+    /// Waits for the response
+    ///
+    /// ## Errors
+    ///
+    /// - [`HostError::ShutDown`] if the host shuts down before the request is
+    ///   solved
+    /// - [`HostError::SolverPanicked`] if the solver panics
+    ///
+    pub fn wait(self) -> Result<HostResponse, HostError> {
+        self.receiver.recv().map_err(|_| HostError::ShutDown)?
+    }
+}
+
+/// Solver instance and its last solution
+struct Instance {
+    solver: Box<dyn HostedSolver>,
+    u: Vec<f64>,
+}
+
+/// Registered solver
+struct RegisteredSolver {
+    name: String,
+    priority: u32,
+    num_parameters: usize,
+    num_decision_variables: usize,
+    num_lagrange_multipliers: usize,
+    idle_instances: Vec<Instance>,
+}
+
+/// Queued request
+struct Job {
+    solver: usize,
+    priority: u32,
+    deadline: Option<Instant>,
+    seq: u64,
+    submitted: Instant,
+    request: HostRequest,
+    reply: mpsc::Sender<Result<HostResponse, HostError>>,
+}
+
+impl Job {
+    /// Compares the urgency of two jobs (`Greater`: `self` is more urgent)
+    fn cmp_urgency(&self, other: &Job) -> Ordering {
+        self.priority
+            .cmp(&other.priority)
+            .then_with(|| match (self.deadline, other.deadline) {
+                (Some(a), Some(b)) => b.cmp(&a),
+                (Some(_), None) => Ordering::Greater,
+                (None, Some(_)) => Ordering::Less,
+                (None, None) => Ordering::Equal,
+            })
+            .then_with(|| other.seq.cmp(&self.seq))
+    }
+}
+
+/// State of the host, which is shared by the workers
+struct State {
+    solvers: Vec<RegisteredSolver>,
+    queue: Vec<Job>,
+    next_seq: u64,
+    shut_down: bool,
+}
+
+impl State {
+    /// Removes the most urgent job for which an instance is available from
+    /// the queue, together with the instance
+    fn next_job(&mut self) -> Option<(Job, Instance)> {
+        let solvers = &self.solvers;
+        let (index, _) = self
+            .queue
+            .iter()
+            .enumerate()
+            .filter(|(_, job)| !solvers[job.solver].idle_instances.is_empty())
+            .max_by(|(_, a), (_, b)| a.cmp_urgency(b))?;
+        let job = self.queue.swap_remove(index);
+        let instance = self.solvers[job.solver].idle_instances.pop()?;
+        Some((job, instance))
+    }
+}
+
+struct Shared {
+    state: Mutex<State>,
+    work_available: Condvar,
+}
+
+impl Shared {
+    fn lock(&self) -> MutexGuard<'_, State> {
+        self.state.lock().unwrap()
+    }
+}
+
+/// Host of several named solvers which share a pool of worker threads
+/// (see the [module documentation](index.html))
+pub struct SolverHost {
+    shared: Arc<Shared>,
+    workers: Vec<thread::JoinHandle<()>>,
+}
+
+impl SolverHost {
+    /// Constructs a new host with `num_workers` worker threads
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `num_workers` is zero
+    ///
+    pub fn new(num_workers: usize) -> SolverHost {
+        assert!(num_workers > 0, "the number of workers must be positive");
+        let shared = Arc::new(Shared {
+            state: Mutex::new(State {
+                solvers: Vec::new(),
+                queue: Vec::new(),
+                next_seq: 0,
+                shut_down: false,
+            }),
+            work_available: Condvar::new(),
+        });
+        let workers = (0..num_workers)
+            .map(|_| {
+                let shared = Arc::clone(&shared);
+                thread::spawn(move || SolverHost::run_worker(&shared))
+            })
+            .collect();
+        SolverHost { shared, workers }
+    }
+
+    /// Number of worker threads
+    pub fn num_workers(&self) -> usize {
+        self.workers.len()
+    }
+
+    /// Registers a solver
+    ///
+    /// ## Arguments
+    ///
+    /// - `name`: name of the solver, which is used in requests
+    /// - `priority`: priority of the requests of this solver (the higher, the
+    ///   more urgent)
+    /// - `instances`: instances of the solver (all of the same problem); at
+    ///   most this many requests of this solver are solved concurrently
+    ///
+    /// ## Errors
+    ///
+    /// - [`HostError::DuplicateSolver`] if a solver with this name exists
+    /// - [`HostError::InvalidInstances`] if there are no instances, or their
+    ///   dimensions differ
+    ///
+    pub fn register(
+        &self,
+        name: &str,
+        priority: u32,
+        instances: Vec<Box<dyn HostedSolver>>,
+    ) -> Result<(), HostError> {
+        let first = instances.first().ok_or(HostError::InvalidInstances)?;
+        let dimensions = |s: &Box<dyn HostedSolver>| {
+            (
+                s.num_parameters(),
+                s.num_decision_variables(),
+                s.num_lagrange_multipliers(),
+            )
+        };
+        let (num_parameters, num_decision_variables, num_lagrange_multipliers) = dimensions(first);
+        if instances.iter().any(|s| {
+            dimensions(s)
+                != (
+                    num_parameters,
+                    num_decision_variables,
+                    num_lagrange_multipliers,
+                )
+        }) {
+            return Err(HostError::InvalidInstances);
+        }
+        let mut state = self.shared.lock();
+        if state.solvers.iter().any(|s| s.name == name) {
+            return Err(HostError::DuplicateSolver);
+        }
+        state.solvers.push(RegisteredSolver {
+            name: name.to_string(),
+            priority,
+            num_parameters,
+            num_decision_variables,
+            num_lagrange_multipliers,
+            idle_instances: instances
+                .into_iter()
+                .map(|solver| Instance {
+                    solver,
+                    u: vec![0.0; num_decision_variables],
+                })
+                .collect(),
+        });
+        Ok(())
+    }
+
+    /// Names of the registered solvers
+    pub fn solver_names(&self) -> Vec<String> {
+        self.shared
+            .lock()
+            .solvers
+            .iter()
+            .map(|s| s.name.clone())
+            .collect()
+    }
+
+    /// Submits a request to the solver `name` and returns immediately
+    ///
+    /// ## Errors
+    ///
+    /// Returns an error if there is no solver with this name or the
+    /// dimensions of the request are wrong
+    ///
+    pub fn submit(&self, name: &str, request: HostRequest) -> Result<HostTicket, HostError> {
+        let submitted = Instant::now();
+        let (reply, receiver) = mpsc::channel();
+        let mut state = self.shared.lock();
+        let solver = state
+            .solvers
+            .iter()
+            .position(|s| s.name == name)
+            .ok_or(HostError::UnknownSolver)?;
+        let registered = &state.solvers[solver];
+        if request.parameter.len() != registered.num_parameters {
+            return Err(HostError::WrongNumberOfParameters);
+        }
+        if let Some(u0) = &request.initial_guess {
+            if u0.len() != registered.num_decision_variables {
+                return Err(HostError::WrongInitialGuess);
+            }
+        }
+        if let Some(y0) = &request.initial_lagrange_multipliers {
+            if y0.len() != registered.num_lagrange_multipliers {
+                return Err(HostError::WrongLagrangeMultipliers);
+            }
+        }
+        let job = Job {
+            solver,
+            priority: registered.priority,
+            deadline: request.deadline.map(|d| submitted + d),
+            seq: state.next_seq,
+            submitted,
+            request,
+            reply,
+        };
+        state.next_seq += 1;
+        state.queue.push(job);
+        drop(state);
+        self.shared.work_available.notify_all();
+        Ok(HostTicket { receiver })
+    }
+
+    /// Submits a request to the solver `name` and waits for the response
+    /// (see [`SolverHost::submit`])
+    pub fn solve(&self, name: &str, request: HostRequest) -> Result<HostResponse, HostError> {
+        self.submit(name, request)?.wait()
+    }
+
+    fn run_worker(shared: &Shared) {
+        loop {
+            let (job, mut instance) = {
+                let mut state = shared.lock();
+                loop {
+                    if state.shut_down {
+                        return;
+                    }
+                    if let Some(next) = state.next_job() {
+                        break next;
+                    }
+                    state = shared.work_available.wait(state).unwrap();
+                }
+            };
+
+            let queue_wait = job.submitted.elapsed();
+            let request = &job.request;
+            if let Some(u0) = &request.initial_guess {
+                instance.u.copy_from_slice(u0);
+            }
+            let deadline = request
+                .deadline
+                .map(|d| d.checked_sub(queue_wait).unwrap_or_default());
+            // a panicking solver must not take the worker and the instance
+            // with it; its previous solution is not a meaningful warm start
+            let solver = &mut instance.solver;
+            let u = &mut instance.u;
+            let response = panic::catch_unwind(AssertUnwindSafe(|| {
+                solver.solve(
+                    &request.parameter,
+                    u,
+                    &request.initial_lagrange_multipliers,
+                    &request.initial_penalty,
+                    deadline,
+                )
+            }))
+            .map(|status| HostResponse {
+                status,
+                solution: instance.u.clone(),
+                queue_wait,
+            })
+            .map_err(|_| {
+                instance.u.iter_mut().for_each(|ui| *ui = 0.0);
+                HostError::SolverPanicked
+            });
+
+            // the instance is available again (possibly, to another worker)
+            shared.lock().solvers[job.solver]
+                .idle_instances
+                .push(instance);
+            shared.work_available.notify_all();
+            // the client may have dropped the ticket
+            job.reply.send(response).unwrap_or_default();
+        }
+    }
+}
+
+impl Drop for SolverHost {
+    /// Stops the workers once they have finished their current solves; the
+    /// queued requests are discarded
+    fn drop(&mut self) {
+        self.shared.lock().shut_down = true;
+        self.shared.work_available.notify_all();
+        for worker in self.workers.drain(..) {
+            worker.join().unwrap_or_default();
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          TESTS                                                               */
+/* ---------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        alm::AlmCache, alm::AlmOptimizer, alm::AlmProblem, constraints, panoc::PANOCCache,
+    };
+    use std::sync::{
+        atomic::{AtomicUsize, Ordering as AtomicOrdering},
+        Barrier,
+    };
+
+    /// Solver of min 0.5|u - p|^2 s.t. |u|_inf <= 1, which records the order
+    /// in which the requests are solved
+    struct BoxProjection {
+        cache: AlmCache,
+        log: Arc<Mutex<Vec<f64>>>,
+        sleep: Duration,
+        gate: Option<Arc<Barrier>>,
+    }
+
+    impl BoxProjection {
+        fn new(log: &Arc<Mutex<Vec<f64>>>, sleep: Duration) -> Box<dyn HostedSolver> {
+            Box::new(BoxProjection {
+                cache: AlmCache::new(PANOCCache::new(2, 1e-8, 3), 0, 0),
+                log: Arc::clone(log),
+                sleep,
+                gate: None,
+            })
+        }
+
+        /// The first solve meets the test at `gate` once it has started and
+        /// waits there again until the test releases it
+        fn gated(log: &Arc<Mutex<Vec<f64>>>, gate: &Arc<Barrier>) -> Box<dyn HostedSolver> {
+            Box::new(BoxProjection {
+                cache: AlmCache::new(PANOCCache::new(2, 1e-8, 3), 0, 0),
+                log: Arc::clone(log),
+                sleep: Duration::from_millis(0),
+                gate: Some(Arc::clone(gate)),
+            })
+        }
+    }
+
+    impl HostedSolver for BoxProjection {
+        fn num_parameters(&self) -> usize {
+            2
+        }
+
+        fn num_decision_variables(&self) -> usize {
+            2
+        }
+
+        fn num_lagrange_multipliers(&self) -> usize {
+            0
+        }
+
+        fn solve(
+            &mut self,
+            p: &[f64],
+            u: &mut [f64],
+            _y0: &Option<Vec<f64>>,
+            _c0: &Option<f64>,
+            _deadline: Option<Duration>,
+        ) -> Result<AlmOptimizerStatus, SolverError> {
+            if let Some(gate) = self.gate.take() {
+                gate.wait();
+                gate.wait();
+            }
+            thread::sleep(self.sleep);
+            self.log.lock().unwrap().push(p[0]);
+            let f = |u: &[f64], _xi: &[f64], c: &mut f64| {
+                *c = 0.5 * ((u[0] - p[0]).powi(2) + (u[1] - p[1]).powi(2));
+                Ok(())
+            };
+            let df = |u: &[f64], _xi: &[f64], g: &mut [f64]| {
+                g[0] = u[0] - p[0];
+                g[1] = u[1] - p[1];
+                Ok(())
+            };
+            let bounds = constraints::BallInf::new(None, 1.0);
+            let problem = AlmProblem::new(
+                bounds,
+                crate::alm::NO_SET,
+                crate::alm::NO_SET,
+                f,
+                df,
+                crate::alm::NO_MAPPING,
+                crate::alm::NO_MAPPING,
+                0,
+                0,
+            );
+            AlmOptimizer::new(&mut self.cache, problem).solve(u)
+        }
+    }
+
+    #[test]
+    fn t_solver_host_solve() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let host = SolverHost::new(2);
+        host.register(
+            "box",
+            0,
+            vec![BoxProjection::new(&log, Duration::from_millis(0))],
+        )
+        .unwrap();
+        assert_eq!(
+            Err(HostError::DuplicateSolver),
+            host.register(
+                "box",
+                0,
+                vec![BoxProjection::new(&log, Duration::from_millis(0))]
+            )
+        );
+        assert_eq!(vec!["box".to_string()], host.solver_names());
+
+        let response = host.solve("box", HostRequest::new(vec![3.0, 0.5])).unwrap();
+        assert!(response.status().is_ok());
+        unit_test_utils::assert_nearly_equal_array(
+            &[1.0, 0.5],
+            response.solution(),
+            1e-6,
+            1e-6,
+            "u",
+        );
+
+        assert_eq!(
+            Some(HostError::UnknownSolver),
+            host.submit("nope", HostRequest::new(vec![0.0, 0.0])).err()
+        );
+        assert_eq!(
+            Some(HostError::WrongNumberOfParameters),
+            host.submit("box", HostRequest::new(vec![0.0])).err()
+        );
+        assert_eq!(
+            Some(HostError::WrongInitialGuess),
+            host.submit(
+                "box",
+                HostRequest::new(vec![0.0, 0.0]).with_initial_guess(vec![0.0])
+            )
+            .err()
+        );
+    }
+
+    #[test]
+    fn t_solver_host_priorities() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let gate = Arc::new(Barrier::new(2));
+        let host = SolverHost::new(1);
+        host.register("background", 1, vec![BoxProjection::gated(&log, &gate)])
+            .unwrap();
+        let sleep = Duration::from_millis(0);
+        host.register("urgent", 10, vec![BoxProjection::new(&log, sleep)])
+            .unwrap();
+
+        // the single worker is held in the first request, while the other
+        // ones are queued; the urgent requests are solved first, in the order
+        // of their deadlines
+        let first = host.submit("background", HostRequest::new(vec![0.0, 0.0]));
+        gate.wait();
+        let tickets = vec![
+            first,
+            host.submit("background", HostRequest::new(vec![1.0, 0.0])),
+            host.submit("urgent", HostRequest::new(vec![2.0, 0.0])),
+            host.submit(
+                "urgent",
+                HostRequest::new(vec![3.0, 0.0]).with_deadline(Duration::from_secs(10)),
+            ),
+            host.submit(
+                "urgent",
+                HostRequest::new(vec![4.0, 0.0]).with_deadline(Duration::from_secs(1)),
+            ),
+        ];
+        gate.wait();
+        for ticket in tickets {
+            assert!(ticket.unwrap().wait().unwrap().status().is_ok());
+        }
+        assert_eq!(vec![0.0, 4.0, 3.0, 2.0, 1.0], *log.lock().unwrap());
+    }
+
+    #[test]
+    fn t_solver_host_instances_bound_concurrency() {
+        static RUNNING: AtomicUsize = AtomicUsize::new(0);
+        static MAX_RUNNING: AtomicUsize = AtomicUsize::new(0);
+
+        struct Counting(Box<dyn HostedSolver>);
+        impl HostedSolver for Counting {
+            fn num_parameters(&self) -> usize {
+                self.0.num_parameters()
+            }
+            fn num_decision_variables(&self) -> usize {
+                self.0.num_decision_variables()
+            }
+            fn num_lagrange_multipliers(&self) -> usize {
+                self.0.num_lagrange_multipliers()
+            }
+            fn solve(
+                &mut self,
+                p: &[f64],
+                u: &mut [f64],
+                y0: &Option<Vec<f64>>,
+                c0: &Option<f64>,
+                deadline: Option<Duration>,
+            ) -> Result<AlmOptimizerStatus, SolverError> {
+                let running = RUNNING.fetch_add(1, AtomicOrdering::SeqCst) + 1;
+                MAX_RUNNING.fetch_max(running, AtomicOrdering::SeqCst);
+                let status = self.0.solve(p, u, y0, c0, deadline);
+                RUNNING.fetch_sub(1, AtomicOrdering::SeqCst);
+                status
+            }
+        }
+
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let host = SolverHost::new(4);
+        let instances = (0..2)
+            .map(|_| {
+                Box::new(Counting(BoxProjection::new(
+                    &log,
+                    Duration::from_millis(10),
+                ))) as Box<dyn HostedSolver>
+            })
+            .collect();
+        host.register("box", 0, instances).unwrap();
+        let tickets: Vec<HostTicket> = (0..8)
+            .map(|i| {
+                host.submit("box", HostRequest::new(vec![i as f64, 0.0]))
+                    .unwrap()
+            })
+            .collect();
+        for ticket in tickets {
+            ticket.wait().unwrap();
+        }
+        assert_eq!(8, log.lock().unwrap().len());
+        assert!(MAX_RUNNING.load(AtomicOrdering::SeqCst) <= 2);
+    }
+
+    #[test]
+    fn t_solver_host_solver_panics() {
+        /// Panics when the first parameter is negative
+        struct Panicking(Box<dyn HostedSolver>);
+        impl HostedSolver for Panicking {
+            fn num_parameters(&self) -> usize {
+                self.0.num_parameters()
+            }
+            fn num_decision_variables(&self) -> usize {
+                self.0.num_decision_variables()
+            }
+            fn num_lagrange_multipliers(&self) -> usize {
+                self.0.num_lagrange_multipliers()
+            }
+            fn solve(
+                &mut self,
+                p: &[f64],
+                u: &mut [f64],
+                y0: &Option<Vec<f64>>,
+                c0: &Option<f64>,
+                deadline: Option<Duration>,
+            ) -> Result<AlmOptimizerStatus, SolverError> {
+                if p[0] < 0.0 {
+                    u[0] = f64::NAN;
+                    panic!("negative parameter");
+                }
+                self.0.solve(p, u, y0, c0, deadline)
+            }
+        }
+
+        // a single worker and a single instance, which must both survive
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let host = SolverHost::new(1);
+        let instance = Panicking(BoxProjection::new(&log, Duration::from_millis(0)));
+        host.register("box", 0, vec![Box::new(instance)]).unwrap();
+
+        assert_eq!(
+            Some(HostError::SolverPanicked),
+            host.solve("box", HostRequest::new(vec![-1.0, 0.0])).err()
+        );
+        let response = host.solve("box", HostRequest::new(vec![0.5, 3.0])).unwrap();
+        assert!(response.status().is_ok());
+        unit_test_utils::assert_nearly_equal_array(
+            &[0.5, 1.0],
+            response.solution(),
+            1e-6,
+            1e-6,
+            "u",
+        );
+    }
+}
@@ -1,6 +1,6 @@
 use crate::{
     alm::*,
-    core::{constraints::*, panoc::*, ExitStatus},
+    core::{constraints::*, multistart::MultiStart, panoc::*, ExitStatus, Phase, SolverStatistics},
     matrix_operations, mocks, FunctionCallResult, SolverError,
 };
 
@@ -296,6 +296,14 @@ fn t_alm_numeric_test_1() {
     assert!(r.num_outer_iterations() > 0 && r.num_outer_iterations() <= 30);
     assert!(r.last_problem_norm_fpr() < tolerance);
 
+    // --- Test statistics (F1 is evaluated once per outer iteration)
+    if SolverStatistics::is_enabled() {
+        let stats = r.statistics();
+        assert_eq!(r.num_outer_iterations(), stats.count(Phase::F1Evaluation));
+        assert_eq!(0, stats.count(Phase::F2Evaluation));
+        assert!(stats.count(Phase::HalfStep) > r.num_inner_iterations());
+    }
+
     let mut f1res = vec![0.0; 2];
     assert!(mocks::mapping_f1_affine(&u, &mut f1res).is_ok());
 
@@ -327,6 +335,75 @@ fn jac_mapping_f2_tr(_u: &[f64], d: &[f64], res: &mut [f64]) -> FunctionCallResu
     Ok(())
 }
 
+#[test]
+fn t_alm_numeric_test_trace() {
+    let nx = 3;
+    let n1 = 2;
+    let n2 = 0;
+    let panoc_cache = PANOCCache::new(nx, 1e-8, 3);
+    let mut alm_cache = AlmCache::new(panoc_cache, n1, n2).with_trace(1000);
+
+    let factory = AlmFactory::new(
+        mocks::f0,
+        mocks::d_f0,
+        Some(mocks::mapping_f1_affine),
+        Some(mocks::mapping_f1_affine_jacobian_product),
+        NO_MAPPING,
+        NO_JACOBIAN_MAPPING,
+        Some(Ball2::new(None, 1.0)),
+        n2,
+    );
+    let alm_problem = AlmProblem::new(
+        Ball2::new(None, 10.0),
+        Some(Ball2::new(None, 1.0)),
+        Some(Ball2::new(None, 10000.0)),
+        |u: &[f64], xi: &[f64], cost: &mut f64| -> FunctionCallResult { factory.psi(u, xi, cost) },
+        |u: &[f64], xi: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+            factory.d_psi(u, xi, grad)
+        },
+        Some(mocks::mapping_f1_affine),
+        NO_MAPPING,
+        n1,
+        n2,
+    );
+
+    let mut alm_optimizer = AlmOptimizer::new(&mut alm_cache, alm_problem)
+        .with_delta_tolerance(1e-4)
+        .with_max_outer_iterations(30)
+        .with_epsilon_tolerance(1e-5)
+        .with_initial_inner_tolerance(1e-2)
+        .with_initial_penalty(1.0)
+        .with_penalty_update_factor(1.2)
+        .with_initial_lagrange_multipliers(&vec![5.0; n1]);
+
+    let mut u = vec![0.0; nx];
+    let r = alm_optimizer.solve(&mut u).unwrap();
+    assert_eq!(ExitStatus::Converged, r.exit_status());
+
+    let trace = alm_cache.trace().unwrap();
+    assert_eq!(r.num_inner_iterations(), trace.len());
+    let first = trace.iter().next().unwrap();
+    let last = trace.last().unwrap();
+    assert_eq!(
+        (Some(0), 0, 1.0),
+        (first.outer_iteration, first.inner_iteration, first.penalty)
+    );
+    assert_eq!(Some(r.num_outer_iterations() - 1), last.outer_iteration);
+    unit_test_utils::assert_nearly_equal(r.penalty(), last.penalty, 1e-12, 1e-12, "penalty");
+    unit_test_utils::assert_nearly_equal(
+        r.delta_y_norm_over_c(),
+        last.infeasibility,
+        1e-12,
+        1e-12,
+        "infeasibility",
+    );
+    // the penalty parameter does not decrease across outer iterations
+    assert!(trace
+        .iter()
+        .zip(trace.iter().skip(1))
+        .all(|(a, b)| b.penalty >= a.penalty && b.outer_iteration >= a.outer_iteration));
+}
+
 #[test]
 fn t_alm_numeric_test_2() {
     let tolerance = 1e-8;
@@ -628,6 +705,67 @@ fn t_alm_numeric_test_out_of_time() {
     );
 }
 
+#[test]
+fn t_alm_numeric_test_deadline() {
+    let tolerance = 1e-8;
+    let nx = 3;
+    let n1 = 2;
+    let n2 = 4;
+    let lbfgs_mem = 3;
+    let panoc_cache = PANOCCache::new(nx, tolerance, lbfgs_mem);
+    let mut alm_cache = AlmCache::new(panoc_cache, n1, n2);
+
+    let set_c = Ball2::new(None, 1.0);
+    let bounds = Ball2::new(None, 10.0);
+    let set_y = Ball2::new(None, 10000.0);
+
+    let factory = AlmFactory::new(
+        mocks::f0,
+        mocks::d_f0,
+        Some(mocks::mapping_f1_affine),
+        Some(mocks::mapping_f1_affine_jacobian_product),
+        Some(mapping_f2),
+        Some(jac_mapping_f2_tr),
+        Some(set_c),
+        n2,
+    );
+
+    // slow gradient, so that the deadline is hit
+    let set_c_b = Ball2::new(None, 1.0);
+    let alm_problem = AlmProblem::new(
+        bounds,
+        Some(set_c_b),
+        Some(set_y),
+        |u: &[f64], xi: &[f64], cost: &mut f64| -> FunctionCallResult { factory.psi(u, xi, cost) },
+        |u: &[f64], xi: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+            std::thread::sleep(std::time::Duration::from_micros(200));
+            factory.d_psi(u, xi, grad)
+        },
+        Some(mocks::mapping_f1_affine),
+        Some(mapping_f2),
+        n1,
+        n2,
+    );
+
+    let deadline = std::time::Duration::from_millis(5);
+    let mut alm_optimizer = AlmOptimizer::new(&mut alm_cache, alm_problem)
+        .with_delta_tolerance(1e-10)
+        .with_epsilon_tolerance(1e-10)
+        .with_max_inner_iterations(10_000)
+        .with_deadline(deadline);
+
+    let mut u = vec![0.0; nx];
+    let status = alm_optimizer.solve(&mut u).unwrap();
+    assert_eq!(ExitStatus::NotConvergedOutOfTime, status.exit_status());
+    assert!(status.solve_time() < deadline + std::time::Duration::from_millis(2));
+    // the best iterate is returned, together with its multipliers and infeasibility
+    assert!(status.num_inner_iterations() > 0);
+    assert!(status.last_problem_norm_fpr().is_finite());
+    assert!(status.f2_norm().is_finite());
+    assert_eq!(n1, status.lagrange_multipliers().as_ref().unwrap().len());
+    assert!(crate::matrix_operations::norm2(&u) <= 10.0 + 1e-12);
+}
+
 #[test]
 fn t_alm_numeric_test_no_mappings() {
     let tolerance = 1e-8;
@@ -678,3 +816,243 @@ fn t_alm_numeric_test_no_mappings() {
     assert_eq!(1, res.num_outer_iterations());
     assert!(res.last_problem_norm_fpr() <= 1e-5);
 }
+
+#[test]
+fn t_alm_numeric_test_single_precision() {
+    // minimise (u0 - 1)^2 + (u1 - 2)^2 subject to F2(u) = u0 + u1 - 1 = 0,
+    // whose solution is u = (0, 1), using the penalty method in single precision
+    let (nx, n1, n2) = (2, 0, 1);
+    let tolerance = 1e-4_f32;
+    let panoc_cache = PANOCCache::new(nx, tolerance, 5);
+    let mut alm_cache = AlmCache::new(panoc_cache, n1, n2);
+
+    let f2 = |u: &[f32], f2u: &mut [f32]| -> FunctionCallResult {
+        f2u[0] = u[0] + u[1] - 1.0;
+        Ok(())
+    };
+    let psi = |u: &[f32], xi: &[f32], cost: &mut f32| -> FunctionCallResult {
+        let f2u = u[0] + u[1] - 1.0;
+        *cost = (u[0] - 1.0).powi(2) + (u[1] - 2.0).powi(2) + 0.5 * xi[0] * f2u * f2u;
+        Ok(())
+    };
+    let d_psi = |u: &[f32], xi: &[f32], grad: &mut [f32]| -> FunctionCallResult {
+        let f2u = u[0] + u[1] - 1.0;
+        grad[0] = 2.0 * (u[0] - 1.0) + xi[0] * f2u;
+        grad[1] = 2.0 * (u[1] - 2.0) + xi[0] * f2u;
+        Ok(())
+    };
+    let bounds = Ball2::new(None, 10.0_f32);
+    let alm_problem = AlmProblem::new(
+        bounds,
+        NO_SET,
+        NO_SET,
+        psi,
+        d_psi,
+        None::<fn(&[f32], &mut [f32]) -> FunctionCallResult>,
+        Some(f2),
+        n1,
+        n2,
+    );
+
+    let mut alm_optimizer = AlmOptimizer::new(&mut alm_cache, alm_problem)
+        .with_delta_tolerance(1e-3)
+        .with_epsilon_tolerance(tolerance)
+        .with_max_outer_iterations(30);
+
+    let mut u = [0.0_f32; 2];
+    let status = alm_optimizer.solve(&mut u).unwrap();
+    assert_eq!(ExitStatus::Converged, status.exit_status());
+    assert!(status.f2_norm() <= 1e-3);
+    assert!(u[0].abs() < 1e-2 && (u[1] - 1.0).abs() < 1e-2);
+}
+
+#[test]
+fn t_alm_numeric_test_cost_and_gradient() {
+    // same problem as in `t_alm_numeric_test_single_precision`, in double precision,
+    // with a function that computes psi and its gradient together
+    let (nx, n1, n2) = (2, 0, 1);
+    let tolerance = 1e-6;
+    let num_cost_and_gradient_calls = std::cell::Cell::new(0);
+
+    let f2 = |u: &[f64], f2u: &mut [f64]| -> FunctionCallResult {
+        f2u[0] = u[0] + u[1] - 1.0;
+        Ok(())
+    };
+    let psi = |u: &[f64], xi: &[f64], cost: &mut f64| -> FunctionCallResult {
+        let f2u = u[0] + u[1] - 1.0;
+        *cost = (u[0] - 1.0).powi(2) + (u[1] - 2.0).powi(2) + 0.5 * xi[0] * f2u * f2u;
+        Ok(())
+    };
+    let d_psi = |u: &[f64], xi: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        let f2u = u[0] + u[1] - 1.0;
+        grad[0] = 2.0 * (u[0] - 1.0) + xi[0] * f2u;
+        grad[1] = 2.0 * (u[1] - 2.0) + xi[0] * f2u;
+        Ok(())
+    };
+    let psi_and_grad =
+        |u: &[f64], xi: &[f64], cost: &mut f64, grad: &mut [f64]| -> FunctionCallResult {
+            num_cost_and_gradient_calls.set(num_cost_and_gradient_calls.get() + 1);
+            psi(u, xi, cost)?;
+            d_psi(u, xi, grad)
+        };
+    let solve = |with_psi_and_grad: bool| {
+        let panoc_cache = PANOCCache::new(nx, tolerance, 5);
+        let mut alm_cache = AlmCache::new(panoc_cache, n1, n2);
+        let alm_problem = AlmProblem::new(
+            Ball2::new(None, 10.0),
+            NO_SET,
+            NO_SET,
+            psi,
+            d_psi,
+            NO_MAPPING,
+            Some(f2),
+            n1,
+            n2,
+        );
+        let mut u = [0.0; 2];
+        let status = if with_psi_and_grad {
+            AlmOptimizer::new(
+                &mut alm_cache,
+                alm_problem.with_cost_and_gradient(psi_and_grad),
+            )
+            .with_epsilon_tolerance(tolerance)
+            .solve(&mut u)
+        } else {
+            AlmOptimizer::new(&mut alm_cache, alm_problem)
+                .with_epsilon_tolerance(tolerance)
+                .solve(&mut u)
+        };
+        (u, status.unwrap())
+    };
+
+    let (u, status) = solve(true);
+    assert_eq!(ExitStatus::Converged, status.exit_status());
+    assert!(num_cost_and_gradient_calls.get() > 0);
+    assert!((u[0]).abs() < 1e-3 && (u[1] - 1.0).abs() < 1e-3);
+
+    let (u_separate, status_separate) = solve(false);
+    assert_eq!(u, u_separate);
+    assert_eq!(
+        status.num_inner_iterations(),
+        status_separate.num_inner_iterations()
+    );
+}
+
+#[test]
+fn t_alm_numeric_test_warm_start() {
+    // same problem as in `t_alm_numeric_test_cost_and_gradient`; the inner problems
+    // are warm started from one outer iteration to the next
+    let (nx, n1, n2) = (2, 0, 1);
+    let tolerance = 1e-6;
+    let num_gradient_calls = std::cell::Cell::new(0);
+
+    let f2 = |u: &[f64], f2u: &mut [f64]| -> FunctionCallResult {
+        f2u[0] = u[0] + u[1] - 1.0;
+        Ok(())
+    };
+    let psi = |u: &[f64], xi: &[f64], cost: &mut f64| -> FunctionCallResult {
+        let f2u = u[0] + u[1] - 1.0;
+        *cost = (u[0] - 1.0).powi(2) + (u[1] - 2.0).powi(2) + 0.5 * xi[0] * f2u * f2u;
+        Ok(())
+    };
+    let d_psi = |u: &[f64], xi: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        num_gradient_calls.set(num_gradient_calls.get() + 1);
+        let f2u = u[0] + u[1] - 1.0;
+        grad[0] = 2.0 * (u[0] - 1.0) + xi[0] * f2u;
+        grad[1] = 2.0 * (u[1] - 2.0) + xi[0] * f2u;
+        Ok(())
+    };
+    let solve = |warm_start: WarmStartPolicy| {
+        num_gradient_calls.set(0);
+        let panoc_cache = PANOCCache::new(nx, tolerance, 5).with_warm_start(warm_start);
+        let mut alm_cache = AlmCache::new(panoc_cache, n1, n2);
+        let alm_problem = AlmProblem::new(
+            Ball2::new(None, 10.0),
+            NO_SET,
+            NO_SET,
+            psi,
+            d_psi,
+            NO_MAPPING,
+            Some(f2),
+            n1,
+            n2,
+        );
+        let mut u = [0.0; 2];
+        let status = AlmOptimizer::new(&mut alm_cache, alm_problem)
+            .with_epsilon_tolerance(tolerance)
+            .solve(&mut u)
+            .unwrap();
+        assert_eq!(ExitStatus::Converged, status.exit_status());
+        (u, num_gradient_calls.get())
+    };
+
+    let (u_cold, num_gradient_calls_cold) = solve(WarmStartPolicy::Cold);
+    let (u_warm, num_gradient_calls_warm) = solve(WarmStartPolicy::AcrossOuterIterations);
+    unit_test_utils::assert_nearly_equal_array(&u_cold, &u_warm, 1e-3, 1e-4, "u");
+    assert!(num_gradient_calls_warm < num_gradient_calls_cold);
+}
+
+#[test]
+fn t_alm_multistart() {
+    // min u0^4 - u0^2 - 0.2 u0 + (u1 - 1)^2 subject to u1 = 0.5 (penalty method);
+    // u0 has a local minimiser at about -0.65 and the global one at about 0.75
+    let (nx, n1, n2) = (2, 0, 1);
+    let f2 = |u: &[f64], f2u: &mut [f64]| -> FunctionCallResult {
+        f2u[0] = u[1] - 0.5;
+        Ok(())
+    };
+    let psi = |u: &[f64], xi: &[f64], cost: &mut f64| -> FunctionCallResult {
+        *cost = u[0].powi(4) - u[0].powi(2) - 0.2 * u[0]
+            + (u[1] - 1.0).powi(2)
+            + 0.5 * xi[0] * (u[1] - 0.5).powi(2);
+        Ok(())
+    };
+    let d_psi = |u: &[f64], xi: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        grad[0] = 4.0 * u[0].powi(3) - 2.0 * u[0] - 0.2;
+        grad[1] = 2.0 * (u[1] - 1.0) + xi[0] * (u[1] - 0.5);
+        Ok(())
+    };
+    let mut caches: Vec<AlmCache> = (0..1)
+        .map(|_| AlmCache::new(PANOCCache::new(nx, 1e-6, 5), n1, n2))
+        .collect();
+    let mut initial_guesses = [1.0, 0.0, -1.0, 0.0];
+    let status = MultiStart::new().solve(
+        &mut caches,
+        &mut initial_guesses,
+        nx,
+        |cache, u, early_stop| {
+            let alm_problem = AlmProblem::new(
+                Ball2::new(None, 10.0),
+                NO_SET,
+                NO_SET,
+                psi,
+                d_psi,
+                NO_MAPPING,
+                Some(f2),
+                n1,
+                n2,
+            );
+            AlmOptimizer::new(cache, alm_problem)
+                .with_delta_tolerance(1e-5)
+                .with_early_stop(early_stop)
+                .solve(u)
+        },
+    );
+
+    // the first start converges to the global minimiser and the second one,
+    // which heads to the local minimiser, is abandoned
+    assert_eq!(Some(0), status.best_index());
+    let best = status.best().unwrap();
+    assert_eq!(ExitStatus::Converged, best.exit_status());
+    assert!((initial_guesses[0] - 0.7526).abs() < 1e-3);
+    assert!((initial_guesses[1] - 0.5).abs() < 1e-3);
+    assert!(status.outcomes()[1].is_abandoned());
+    assert_eq!(
+        ExitStatus::NotConvergedIterations,
+        status.outcomes()[1]
+            .status()
+            .as_ref()
+            .unwrap()
+            .exit_status()
+    );
+}
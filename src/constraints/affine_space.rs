@@ -100,31 +100,56 @@ impl Constraint for AffineSpace {
     ///
     /// The result is stored in `x` and it can be verified that $Ax = b$.
     fn project(&self, x: &mut [f64]) {
+        let mut work = vec![0.0; self.workspace_size(x.len())];
+        self.project_with_workspace(x, &mut work);
+    }
+
+    /// The projection needs a workspace of $2m$ floats, where $m$ is the
+    /// number of rows of $A$
+    fn workspace_size(&self, _n: usize) -> usize {
+        2 * self.n_rows
+    }
+
+    /// Projection onto the affine space (see `project`); the vectors
+    /// $Ax-b$, $y$ and $z$ are stored in `work`
+    fn project_with_workspace(&self, x: &mut [f64], work: &mut [f64]) {
         let m = self.n_rows;
         let n = self.n_cols;
         let chol = &self.l;
         let perm = &self.p;
+        // A is stored row-wise (see `new`), so its rows are contiguous
+        let a_rows = self
+            .a_mat
+            .as_slice()
+            .expect("A is stored row-wise")
+            .chunks_exact(n);
 
         assert!(x.len() == n, "x has wrong dimension");
-        let x_vec = x.to_vec();
-        let x_arr = Array1::from_shape_vec((n,), x_vec).unwrap();
-        let ax = self.a_mat.dot(&x_arr);
-        let err = ax - &self.b_vec;
+        assert!(work.len() >= 2 * m, "workspace is too small");
+        let (err_z, y) = work.split_at_mut(m);
+
+        // Step 0: err = Ax - b (stored in `err_z`)
+        err_z
+            .iter_mut()
+            .zip(a_rows.clone().zip(self.b_vec.iter()))
+            .for_each(|(err_i, (a_i, b_i))| {
+                *err_i = a_i
+                    .iter()
+                    .zip(x.iter())
+                    .fold(-b_i, |sum, (a_ij, x_j)| sum + a_ij * x_j);
+            });
 
         // Step 1: Solve Ly = b(P)
-        // TODO: Make `y` into an attribute; however, to do this, we need to change
-        // &self to &mut self, which will require a mild refactoring
-        let mut y = vec![0.; m];
         for i in 0..m {
-            y[i] = err[perm[i]];
+            y[i] = err_z[perm[i]];
             for j in 0..i {
                 y[i] -= chol[(i, j)] * y[j];
             }
             y[i] /= chol[(i, i)];
         }
 
-        // Step 2: Solve L'z(P) = y
-        let mut z = vec![0.; m];
+        // Step 2: Solve L'z(P) = y (`err` is overwritten by `z`)
+        let z = err_z;
         for i in 1..=m {
             z[perm[m - i]] = y[m - i];
             for j in 1..i {
@@ -133,12 +158,13 @@ impl Constraint for AffineSpace {
             z[perm[m - i]] /= chol[(m - i, m - i)];
         }
 
-        // Step 3: Determine A' * z
-        let z_arr = Array1::from_shape_vec((self.n_rows,), z).unwrap();
-        let w = self.a_mat.t().dot(&z_arr);
-
-        // Step 4: x <-- x - A'(AA')\(Ax-b)
-        x.iter_mut().zip(w.iter()).for_each(|(xi, wi)| *xi -= wi);
+        // Step 3: x <-- x - A'(AA')\(Ax-b) = x - A' * z, that is, x minus the
+        // sum of the rows of A weighted by z
+        a_rows.zip(z.iter()).for_each(|(a_i, z_i)| {
+            x.iter_mut()
+                .zip(a_i.iter())
+                .for_each(|(x_j, a_ij)| *x_j -= a_ij * z_i);
+        });
     }
 
     /// Affine sets are convex.
@@ -1,20 +1,21 @@
 use super::Constraint;
 use super::Simplex;
+use crate::Scalar;
 
 #[derive(Copy, Clone)]
 /// A norm-1 ball, that is, a set given by $B_1^r = \\{x \in \mathbb{R}^n {}:{} \Vert{}x{}\Vert_1 \leq r\\}$
 /// or a ball-1 centered at a point $x_c$, that is, $B_1^{x_c, r} = \\{x \in \mathbb{R}^n {}:{} \Vert{}x-x_c{}\Vert_1 \leq r\\}$
-pub struct Ball1<'a> {
-    center: Option<&'a [f64]>,
-    radius: f64,
-    simplex: Simplex,
+pub struct Ball1<'a, T = f64> {
+    center: Option<&'a [T]>,
+    radius: T,
+    simplex: Simplex<T>,
 }
 
-impl<'a> Ball1<'a> {
+impl<'a, T: Scalar> Ball1<'a, T> {
     /// Construct a new ball-1 with given center and radius.
     /// If no `center` is given, then it is assumed to be in the origin
-    pub fn new(center: Option<&'a [f64]>, radius: f64) -> Self {
-        assert!(radius > 0.0);
+    pub fn new(center: Option<&'a [T]>, radius: T) -> Self {
+        assert!(radius > T::zero());
         let simplex = Simplex::new(radius);
         Ball1 {
             center,
@@ -23,38 +24,68 @@ impl<'a> Ball1<'a> {
         }
     }
 
-    fn project_on_ball1_centered_at_origin(&self, x: &mut [f64]) {
+    /// Projects on the ball-1 centered at the origin; the workspace `work`
+    /// (of size `workspace_size(x.len())`) is allocated here if it is not
+    /// provided and it is needed
+    fn project_on_ball1_centered_at_origin(&self, x: &mut [T], work: Option<&mut [T]>) {
         if crate::matrix_operations::norm1(x) > self.radius {
+            let n = x.len();
+            let mut allocated_work;
+            let work = match work {
+                Some(work) => work,
+                None => {
+                    allocated_work = vec![T::zero(); self.workspace_size(n)];
+                    &mut allocated_work[..]
+                }
+            };
+            assert!(
+                work.len() >= self.workspace_size(n),
+                "workspace is too small"
+            );
+            let (u, simplex_work) = work.split_at_mut(n);
             // u = |x| (copied)
-            let mut u = vec![0.0; x.len()];
             u.iter_mut()
                 .zip(x.iter())
-                .for_each(|(ui, &xi)| *ui = f64::abs(xi));
+                .for_each(|(ui, &xi)| *ui = xi.abs());
             // u = P_simplex(u)
-            self.simplex.project(&mut u);
+            self.simplex.project_with_workspace(u, simplex_work);
             x.iter_mut()
                 .zip(u.iter())
-                .for_each(|(xi, &ui)| *xi = f64::signum(*xi) * ui);
+                .for_each(|(xi, &ui)| *xi = xi.signum() * ui);
         }
     }
-}
 
-impl<'a> Constraint for Ball1<'a> {
-    fn project(&self, x: &mut [f64]) {
+    fn project_with_optional_workspace(&self, x: &mut [T], work: Option<&mut [T]>) {
         if let Some(center) = &self.center {
             x.iter_mut()
                 .zip(center.iter())
                 .for_each(|(xi, &ci)| *xi -= ci);
-            self.project_on_ball1_centered_at_origin(x);
+            self.project_on_ball1_centered_at_origin(x, work);
             x.iter_mut()
                 .zip(center.iter())
                 .for_each(|(xi, &ci)| *xi += ci);
         } else {
-            self.project_on_ball1_centered_at_origin(x);
+            self.project_on_ball1_centered_at_origin(x, work);
         }
     }
+}
+
+impl<'a, T: Scalar> Constraint<T> for Ball1<'a, T> {
+    fn project(&self, x: &mut [T]) {
+        self.project_with_optional_workspace(x, None);
+    }
 
     fn is_convex(&self) -> bool {
         true
     }
+
+    /// The projection needs a workspace of `3n` floats (`n` for the absolute
+    /// values of `x` and `2n` for the projection on the simplex)
+    fn workspace_size(&self, n: usize) -> usize {
+        n + self.simplex.workspace_size(n)
+    }
+
+    fn project_with_workspace(&self, x: &mut [T], work: &mut [T]) {
+        self.project_with_optional_workspace(x, Some(work));
+    }
 }
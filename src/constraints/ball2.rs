@@ -1,27 +1,28 @@
-use super::Constraint;
+use super::{kernels, BlockProjection, Constraint};
+use crate::Scalar;
 
 #[derive(Copy, Clone)]
 /// A Euclidean ball, that is, a set given by $B_2^r = \\{x \in \mathbb{R}^n {}:{} \Vert{}x{}\Vert \leq r\\}$
 /// or a Euclidean ball centered at a point $x_c$, that is, $B_2^{x_c, r} = \\{x \in \mathbb{R}^n {}:{} \Vert{}x-x_c{}\Vert \leq r\\}$
-pub struct Ball2<'a> {
-    center: Option<&'a [f64]>,
-    radius: f64,
+pub struct Ball2<'a, T = f64> {
+    center: Option<&'a [T]>,
+    radius: T,
 }
 
-impl<'a> Ball2<'a> {
+impl<'a, T: Scalar> Ball2<'a, T> {
     /// Construct a new Euclidean ball with given center and radius
     /// If no `center` is given, then it is assumed to be in the origin
-    pub fn new(center: Option<&'a [f64]>, radius: f64) -> Self {
-        assert!(radius > 0.0);
+    pub fn new(center: Option<&'a [T]>, radius: T) -> Self {
+        assert!(radius > T::zero());
 
         Ball2 { center, radius }
     }
 }
 
-impl<'a> Constraint for Ball2<'a> {
-    fn project(&self, x: &mut [f64]) {
+impl<'a, T: Scalar> Constraint<T> for Ball2<'a, T> {
+    fn project(&self, x: &mut [T]) {
         if let Some(center) = &self.center {
-            let mut norm_difference = 0.0;
+            let mut norm_difference = T::zero();
             x.iter().zip(center.iter()).for_each(|(a, b)| {
                 let diff_ = *a - *b;
                 norm_difference += diff_ * diff_
@@ -30,15 +31,15 @@ impl<'a> Constraint for Ball2<'a> {
             norm_difference = norm_difference.sqrt();
 
             if norm_difference > self.radius {
+                let scaling = self.radius / norm_difference;
                 x.iter_mut().zip(center.iter()).for_each(|(x, c)| {
-                    *x = *c + self.radius * (*x - *c) / norm_difference;
+                    *x = *c + scaling * (*x - *c);
                 });
             }
         } else {
-            let norm_x = crate::matrix_operations::norm2(x);
+            let norm_x = kernels::norm2_squared(x).sqrt();
             if norm_x > self.radius {
-                let norm_over_radius = norm_x / self.radius;
-                x.iter_mut().for_each(|x_| *x_ /= norm_over_radius);
+                kernels::scale(x, self.radius / norm_x);
             }
         }
     }
@@ -47,3 +48,34 @@ impl<'a> Constraint for Ball2<'a> {
         true
     }
 }
+
+impl<'a, T: Scalar> BlockProjection<T> for Ball2<'a, T> {
+    /// Projects blocks, which are stored as structure of arrays, on the ball
+    /// (see `BlockProjection::project_blocks`)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if the dimension of the blocks differs from that of
+    /// the center of the ball (if provided)
+    fn project_blocks(&self, x: &mut [T], num_blocks: usize) {
+        let mut blocks = kernels::Blocks::new(x, num_blocks);
+        let n = blocks.dimension();
+        let center = self.center;
+        if let Some(center) = center {
+            assert_eq!(n, center.len(), "wrong dimension of the blocks");
+        }
+        let radius = self.radius;
+        blocks.for_each_group(|blocks, first, lanes| {
+            let mut scaling = blocks.norm2_squared(n, center, first, lanes);
+            scaling.iter_mut().for_each(|s| {
+                let norm = s.sqrt();
+                *s = if norm > radius {
+                    radius / norm
+                } else {
+                    T::one()
+                };
+            });
+            blocks.scale(n, center, first, lanes, &scaling);
+        });
+    }
+}
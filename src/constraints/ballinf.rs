@@ -1,26 +1,27 @@
 use super::Constraint;
+use crate::Scalar;
 
 #[derive(Copy, Clone)]
 /// An infinity ball defined as $B_\infty^r = \\{x\in\mathbb{R}^n {}:{} \Vert{}x{}\Vert_{\infty} \leq r\\}$,
 /// where $\Vert{}\cdot{}\Vert_{\infty}$ is the infinity norm. The infinity ball centered at a point
 /// $x_c$ is defined as $B_\infty^{x_c,r} = \\{x\in\mathbb{R}^n {}:{} \Vert{}x-x_c{}\Vert_{\infty} \leq r\\}$.
 ///
-pub struct BallInf<'a> {
-    center: Option<&'a [f64]>,
-    radius: f64,
+pub struct BallInf<'a, T = f64> {
+    center: Option<&'a [T]>,
+    radius: T,
 }
 
-impl<'a> BallInf<'a> {
+impl<'a, T: Scalar> BallInf<'a, T> {
     /// Construct a new infinity-norm ball with given center and radius
     /// If no `center` is given, then it is assumed to be in the origin
     ///   
-    pub fn new(center: Option<&'a [f64]>, radius: f64) -> Self {
-        assert!(radius > 0.0);
+    pub fn new(center: Option<&'a [T]>, radius: T) -> Self {
+        assert!(radius > T::zero());
         BallInf { center, radius }
     }
 }
 
-impl<'a> Constraint for BallInf<'a> {
+impl<'a, T: Scalar> Constraint<T> for BallInf<'a, T> {
     /// Computes the projection of a given vector `x` on the current infinity ball.
     ///
     ///
@@ -42,12 +43,12 @@ impl<'a> Constraint for BallInf<'a> {
     ///
     /// for all $i=1,\ldots, n$.
     ///
-    fn project(&self, x: &mut [f64]) {
+    fn project(&self, x: &mut [T]) {
         if let Some(center) = &self.center {
             x.iter_mut()
                 .zip(center.iter())
                 .filter(|(&mut xi, &ci)| (xi - ci).abs() > self.radius)
-                .for_each(|(xi, ci)| *xi = ci + (*xi - ci).signum() * self.radius);
+                .for_each(|(xi, &ci)| *xi = ci + (*xi - ci).signum() * self.radius);
         } else {
             x.iter_mut()
                 .filter(|xi| xi.abs() > self.radius)
@@ -55,6 +56,40 @@ impl<'a> Constraint for BallInf<'a> {
         }
     }
 
+    /// Projects `source` on the infinity ball in a single pass (see
+    /// `Constraint::project_from`)
+    fn project_from(&self, source: &[T], x: &mut [T], _work: &mut [T]) {
+        assert!(
+            source.len() == x.len(),
+            "source and x have different lengths"
+        );
+        if let Some(center) = &self.center {
+            x.iter_mut()
+                .zip(source.iter())
+                .zip(center.iter())
+                .for_each(|((xi, &si), &ci)| {
+                    *xi = if (si - ci).abs() > self.radius {
+                        ci + (si - ci).signum() * self.radius
+                    } else {
+                        si
+                    };
+                });
+            // as in `project`, the elements beyond the length of the center
+            // are not constrained
+            if center.len() < x.len() {
+                x[center.len()..].copy_from_slice(&source[center.len()..]);
+            }
+        } else {
+            x.iter_mut().zip(source.iter()).for_each(|(xi, &si)| {
+                *xi = if si.abs() > self.radius {
+                    si.signum() * self.radius
+                } else {
+                    si
+                };
+            });
+        }
+    }
+
     fn is_convex(&self) -> bool {
         true
     }
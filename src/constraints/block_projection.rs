@@ -0,0 +1,92 @@
+use super::Constraint;
+use crate::Scalar;
+
+/// A set on which many blocks can be projected at once, when they are
+/// stored as structure of arrays
+///
+/// This is implemented by `Ball2`, `SecondOrderCone` and
+/// `EpigraphSquaredNorm`, which often appear as hundreds of small blocks of a
+/// Cartesian product (e.g., friction cones, or bounds on the thrust at every
+/// stage of a horizon). Storing such blocks as structure of arrays, that is,
+/// first the first component of all blocks, then their second component, and
+/// so on, allows the projection to be vectorised across blocks; see also
+/// [`HomogeneousCartesianProduct`](struct.HomogeneousCartesianProduct.html).
+pub trait BlockProjection<T: Scalar = f64> {
+    /// Projects each of the `num_blocks` blocks of `x` on the set, where the
+    /// blocks are stored as structure of arrays, that is, component `j` of
+    /// block `k` is `x[j * num_blocks + k]`
+    ///
+    /// The result is the same as that of projecting every block with
+    /// `Constraint::project` (up to rounding errors)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `num_blocks` is zero, if the length of `x` is not
+    /// a multiple of `num_blocks`, or if the dimension of the blocks is not
+    /// admissible for the set
+    fn project_blocks(&self, x: &mut [T], num_blocks: usize);
+}
+
+/// Cartesian product of `num_blocks` copies of a set, whose elements are
+/// stored as structure of arrays
+///
+/// This is the set $C^m = C \times \cdots \times C$, where the vectors
+/// $x = (x^{(1)}, \ldots, x^{(m)})$ are stored so that component $j$ of
+/// block $k$ is `x[j * m + k]`; the projection is computed with
+/// [`BlockProjection::project_blocks`](trait.BlockProjection.html#tymethod.project_blocks),
+/// which is vectorised across blocks.
+///
+/// ## Example
+///
+/// ```
+/// use optimization_engine::constraints::*;
+///
+/// // three friction cones in R^3, stored as structure of arrays
+/// let cones = HomogeneousCartesianProduct::new(SecondOrderCone::new(0.5), 3);
+/// let mut x = [
+///     1.0, 0.0, 2.0, // first component of the three blocks
+///     0.0, 1.0, 0.0, // second component
+///     1.0, 1.0, 1.0, // third component (t)
+/// ];
+/// cones.project(&mut x);
+/// ```
+#[derive(Clone, Copy)]
+pub struct HomogeneousCartesianProduct<C> {
+    set: C,
+    num_blocks: usize,
+}
+
+impl<C> HomogeneousCartesianProduct<C> {
+    /// Constructs the Cartesian product of `num_blocks` copies of `set`
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `num_blocks` is zero
+    pub fn new(set: C, num_blocks: usize) -> Self {
+        assert!(num_blocks > 0, "the number of blocks must be positive");
+        HomogeneousCartesianProduct { set, num_blocks }
+    }
+
+    /// Number of blocks
+    pub fn num_blocks(&self) -> usize {
+        self.num_blocks
+    }
+}
+
+impl<T: Scalar, C: Constraint<T> + BlockProjection<T>> Constraint<T>
+    for HomogeneousCartesianProduct<C>
+{
+    /// Projects `x` (stored as structure of arrays) on the product
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if the length of `x` is not a multiple of the
+    /// number of blocks
+    fn project(&self, x: &mut [T]) {
+        self.set.project_blocks(x, self.num_blocks);
+    }
+
+    fn is_convex(&self) -> bool {
+        self.set.is_convex()
+    }
+}
@@ -1,4 +1,5 @@
 use super::Constraint;
+use crate::Scalar;
 
 /// Cartesian product of constraints
 ///
@@ -22,12 +23,12 @@ use super::Constraint;
 /// for all $i=0,\ldots, n-1$.
 ///
 #[derive(Default)]
-pub struct CartesianProduct<'a> {
+pub struct CartesianProduct<'a, T = f64> {
     idx: Vec<usize>,
-    constraints: Vec<Box<dyn Constraint + 'a>>,
+    constraints: Vec<Box<dyn Constraint<T> + 'a>>,
 }
 
-impl<'a> CartesianProduct<'a> {
+impl<'a, T: Scalar> CartesianProduct<'a, T> {
     /// Construct new instance of Cartesian product of constraints
     ///
     /// # Note
@@ -116,7 +117,7 @@ impl<'a> CartesianProduct<'a> {
     /// ```
     /// The method will panic if any of the associated projections panics.
     ///
-    pub fn add_constraint(mut self, ni: usize, constraint: impl Constraint + 'a) -> Self {
+    pub fn add_constraint(mut self, ni: usize, constraint: impl Constraint<T> + 'a) -> Self {
         assert!(
             self.dimension() < ni,
             "provided index is smaller than or equal to previous index, or zero"
@@ -127,7 +128,7 @@ impl<'a> CartesianProduct<'a> {
     }
 }
 
-impl<'a> Constraint for CartesianProduct<'a> {
+impl<'a, T: Scalar> Constraint<T> for CartesianProduct<'a, T> {
     /// Project onto Cartesian product of constraints
     ///
     /// The given vector `x` is updated with the projection on the set
@@ -136,22 +137,66 @@ impl<'a> Constraint for CartesianProduct<'a> {
     ///
     /// The method will panic if the dimension of `x` is not equal to the
     /// dimension of the Cartesian product (see `dimension()`)
-    fn project(&self, x: &mut [f64]) {
+    fn project(&self, x: &mut [T]) {
+        let workspace_size = self.workspace_size(x.len());
+        if workspace_size > 0 {
+            let mut work = vec![T::zero(); workspace_size];
+            self.project_with_workspace(x, &mut work);
+        } else {
+            self.project_with_workspace(x, &mut []);
+        }
+    }
+
+    fn is_convex(&self) -> bool {
+        self.constraints.iter().fold(true, |mut flag, cnstr| {
+            flag &= cnstr.is_convex();
+            flag
+        })
+    }
+
+    /// The sets of the Cartesian product share the workspace, so the
+    /// workspace size is the largest workspace size of the sets
+    fn workspace_size(&self, _n: usize) -> usize {
+        let mut j = 0;
+        self.idx
+            .iter()
+            .zip(self.constraints.iter())
+            .fold(0, |size, (&i, c)| {
+                let size_i = c.workspace_size(i - j);
+                j = i;
+                usize::max(size, size_i)
+            })
+    }
+
+    /// Project onto Cartesian product of constraints using the scratch
+    /// workspace `work` (see `project`)
+    fn project_with_workspace(&self, x: &mut [T], work: &mut [T]) {
         assert!(x.len() == self.dimension(), "x has wrong size");
         let mut j = 0;
         self.idx
             .iter()
             .zip(self.constraints.iter())
             .for_each(|(&i, c)| {
-                c.project(&mut x[j..i]);
+                c.project_with_workspace(&mut x[j..i], work);
                 j = i;
             });
     }
 
-    fn is_convex(&self) -> bool {
-        self.constraints.iter().fold(true, |mut flag, cnstr| {
-            flag &= cnstr.is_convex();
-            flag
-        })
+    /// Projects `source` onto the Cartesian product, block by block (see
+    /// `Constraint::project_from`)
+    fn project_from(&self, source: &[T], x: &mut [T], work: &mut [T]) {
+        assert!(x.len() == self.dimension(), "x has wrong size");
+        assert!(
+            source.len() == x.len(),
+            "source and x have different lengths"
+        );
+        let mut j = 0;
+        self.idx
+            .iter()
+            .zip(self.constraints.iter())
+            .for_each(|(&i, c)| {
+                c.project_from(&source[j..i], &mut x[j..i], work);
+                j = i;
+            });
     }
 }
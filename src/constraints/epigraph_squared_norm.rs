@@ -1,6 +1,4 @@
-use crate::matrix_operations;
-
-use super::Constraint;
+use super::{kernels, BlockProjection, Constraint};
 
 #[derive(Copy, Clone, Default)]
 /// The epigraph of the squared Eucliden norm is a set of the form
@@ -16,11 +14,77 @@ impl EpigraphSquaredNorm {
     }
 }
 
+/// Maximum number of Newton iterations which refine the root of the cubic
+/// equation of the projection
+const NEWTON_MAX_ITERS: usize = 4;
+
+/// Relative tolerance of the Newton iterations
+const NEWTON_REL_TOL: f64 = 1e-15;
+
+/// Scaling, $s$, of the projection of $x = (z, t)$ with $\\|z\\|^2 > t$ on
+/// the epigraph, where `norm_z_sq` is $\\|z\\|^2$; the projection is
+/// $(z / s, \\|z\\|^2 / s^2)$
+///
+/// The scaling is the unique root, with $s > \max(\theta, 0)$, of the cubic
+/// equation $s^2 (s - \theta) = 2\\|z\\|^2$, where $\theta = 1 - 2t$. This
+/// is computed in closed form and refined with Newton's method; the cubic is
+/// increasing and convex for $s > \max(\theta, 0)$.
+#[inline]
+fn scaling_of_projection(norm_z_sq: f64, t: f64) -> f64 {
+    let theta = 1. - 2. * t;
+    let c = 2. * norm_z_sq;
+
+    let s_closed_form = if theta < 0. && 27. * c < -4. * theta * theta * theta {
+        // Three real roots; Cardano's formula would compute s = y + theta / 3
+        // with y > 0 > theta, which loses all accuracy if s << |theta| (large
+        // t and ||z||^2 slightly larger than t). Instead, with a = |theta|,
+        // 1 / s is the largest root of c w^3 - a w - 1 = 0, whose
+        // trigonometric solution gives s without cancellation
+        let a = -theta;
+        let cos_phi = (27. * c / (4. * a * a * a)).sqrt().min(1.);
+        (3. * c / a).sqrt() / (2. * (cos_phi.acos() / 3.).cos())
+    } else {
+        // With s = y + theta / 3, the cubic becomes y^3 + p y + q = 0 with a
+        // nonnegative discriminant; Cardano's formula, y = u - (p / 3) / u,
+        // adds positive terms (u > 0, p <= 0). If theta < 0, then here
+        // s >= |theta| / 3, so adding theta / 3 costs at most one bit
+        let theta_over_3 = theta / 3.;
+        let p_over_3 = -theta_over_3 * theta_over_3;
+        let half_q = -theta_over_3 * theta_over_3 * theta_over_3 - 0.5 * c;
+        let discriminant = (half_q * half_q + p_over_3 * p_over_3 * p_over_3).max(0.);
+        let u = (-half_q + discriminant.sqrt()).cbrt();
+        u - p_over_3 / u + theta_over_3
+    };
+
+    // Newton refinement of the root of g(s) = s^2 (s - theta) - c; if the
+    // closed-form root is inaccurate (e.g., if it is not in the admissible
+    // range because of rounding errors), start from max(theta, 0) + c^(1/3),
+    // which is an upper bound of the root
+    let lower_bound = theta.max(0.);
+    let mut s = if s_closed_form > lower_bound {
+        s_closed_form
+    } else {
+        lower_bound + c.cbrt()
+    };
+    for _ in 0..NEWTON_MAX_ITERS {
+        let g = s * s * (s - theta) - c;
+        let dg = s * (3. * s - 2. * theta);
+        let step = g / dg;
+        s -= step;
+        if step.abs() <= NEWTON_REL_TOL * s {
+            break;
+        }
+    }
+    s
+}
+
 impl Constraint for EpigraphSquaredNorm {
     ///Project on the epigraph of the squared Euclidean norm.
     ///
     /// The projection is computed as detailed
-    /// [here](https://mathematix.wordpress.com/2017/05/02/projection-on-the-epigraph-of-the-squared-euclidean-norm/).
+    /// [here](https://mathematix.wordpress.com/2017/05/02/projection-on-the-epigraph-of-the-squared-euclidean-norm/),
+    /// using the closed-form solution of the cubic equation of the
+    /// projection, which is refined with Newton's method.
     ///
     /// ## Arguments
     /// - `x`: The given vector $x$ is updated with the projection on the set
@@ -37,56 +101,13 @@ impl Constraint for EpigraphSquaredNorm {
     fn project(&self, x: &mut [f64]) {
         let nx = x.len() - 1;
         assert!(nx > 0, "x must have a length of at least 2");
-        let z: &[f64] = &x[..nx];
-        let t: f64 = x[nx];
-        let norm_z_sq = matrix_operations::norm2_squared(z);
-        if norm_z_sq <= t {
-            return;
+        let (z, t) = x.split_at_mut(nx);
+        let norm_z_sq = kernels::norm2_squared(z);
+        if norm_z_sq > t[0] {
+            let scaling = scaling_of_projection(norm_z_sq, t[0]);
+            kernels::scale(z, 1. / scaling);
+            t[0] = norm_z_sq / (scaling * scaling);
         }
-
-        let theta = 1. - 2. * t;
-        let a3 = 4.;
-        let a2 = 4. * theta;
-        let a1 = theta * theta;
-        let a0 = -norm_z_sq;
-
-        let cubic_poly_roots = roots::find_roots_cubic(a3, a2, a1, a0);
-        let mut right_root = f64::NAN;
-        let mut scaling = f64::NAN;
-
-        // Find right root
-        cubic_poly_roots.as_ref().iter().for_each(|ri| {
-            if *ri > 0. {
-                let denom = 1. + 2. * (*ri - t);
-                if ((norm_z_sq / (denom * denom)) - *ri).abs() < 1e-6 {
-                    right_root = *ri;
-                    scaling = denom;
-                }
-            }
-        });
-
-        // Refinement of root with Newton-Raphson
-        let mut refinement_error = 1.;
-        let newton_max_iters: usize = 5;
-        let newton_eps = 1e-14;
-        let mut zsol = right_root;
-        let mut iter = 0;
-        while refinement_error > newton_eps && iter < newton_max_iters {
-            let zsol_sq = zsol * zsol;
-            let zsol_cb = zsol_sq * zsol;
-            let p_z = a3 * zsol_cb + a2 * zsol_sq + a1 * zsol + a0;
-            let dp_z = 3. * a3 * zsol_sq + 2. * a2 * zsol + a1;
-            zsol -= p_z / dp_z;
-            refinement_error = p_z.abs();
-            iter += 1;
-        }
-        right_root = zsol;
-
-        // Projection
-        for xi in x.iter_mut().take(nx) {
-            *xi /= scaling;
-        }
-        x[nx] = right_root;
     }
 
     /// This is a convex set, so this function returns `True`
@@ -94,3 +115,32 @@ impl Constraint for EpigraphSquaredNorm {
         true
     }
 }
+
+impl BlockProjection for EpigraphSquaredNorm {
+    /// Projects blocks, which are stored as structure of arrays, on the
+    /// epigraph (see `BlockProjection::project_blocks`)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if the dimension of the blocks is less than 2
+    fn project_blocks(&self, x: &mut [f64], num_blocks: usize) {
+        let mut blocks = kernels::Blocks::new(x, num_blocks);
+        let n = blocks.dimension();
+        assert!(n >= 2, "the blocks must be of dimension at least 2");
+        blocks.for_each_group(|blocks, first, lanes| {
+            let mut scaling = blocks.norm2_squared(n - 1, None, first, lanes);
+            let t = blocks.component(n - 1, first, lanes);
+            scaling.iter_mut().zip(t.iter_mut()).for_each(|(s, t)| {
+                let norm_z_sq = *s;
+                if norm_z_sq > *t {
+                    let scaling = scaling_of_projection(norm_z_sq, *t);
+                    *s = 1. / scaling;
+                    *t = norm_z_sq * (*s * *s);
+                } else {
+                    *s = 1.;
+                }
+            });
+            blocks.scale(n - 1, None, first, lanes, &scaling);
+        });
+    }
+}
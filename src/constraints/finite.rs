@@ -1,17 +1,18 @@
 use super::Constraint;
+use crate::Scalar;
 
 ///
 /// A finite set, $X = \\{x_1, x_2, \ldots, x_n\\}\subseteq\mathbb{R}^n$, given vectors
 /// $x_i\in\mathbb{R}^n$
 ///
 #[derive(Clone, Copy)]
-pub struct FiniteSet<'a> {
+pub struct FiniteSet<'a, T = f64> {
     /// The data is stored in a Vec-of-Vec datatype, that is, a vector
     /// of vectors
-    data: &'a [&'a [f64]],
+    data: &'a [&'a [T]],
 }
 
-impl<'a> FiniteSet<'a> {
+impl<'a, T: Scalar> FiniteSet<'a, T> {
     /// Construct a finite set, $X = \\{x_1, x_2, \ldots, x_n\\}$, given vectors
     /// $x_i\in\mathbb{R}^n$
     ///
@@ -41,7 +42,7 @@ impl<'a> FiniteSet<'a> {
     /// This method will panic if (i) the given vector of data is empty
     /// and (ii) if the given vectors have unequal dimensions.
     ///
-    pub fn new(data: &'a [&'a [f64]]) -> Self {
+    pub fn new(data: &'a [&'a [T]]) -> Self {
         // Do a sanity check...
         assert!(!data.is_empty(), "empty data not allowed");
         let n = data[0].len();
@@ -52,7 +53,7 @@ impl<'a> FiniteSet<'a> {
     }
 }
 
-impl<'a> Constraint for FiniteSet<'a> {
+impl<'a, T: Scalar> Constraint<T> for FiniteSet<'a, T> {
     ///
     /// Projection on the current finite set
     ///
@@ -84,9 +85,9 @@ impl<'a> Constraint for FiniteSet<'a> {
     ///
     /// Does not panic
     ///
-    fn project(&self, x: &mut [f64]) {
+    fn project(&self, x: &mut [T]) {
         let mut idx: usize = 0;
-        let mut best_distance: f64 = num::Float::infinity();
+        let mut best_distance: T = num::Float::infinity();
         for (i, v) in self.data.iter().enumerate() {
             let dist = crate::matrix_operations::norm2_squared_diff(v, x);
             if dist < best_distance {
@@ -1,18 +1,19 @@
 use super::Constraint;
 use crate::matrix_operations;
+use crate::Scalar;
 
 #[derive(Clone)]
 /// A hyperplane is a set given by $H = \\{x \in \mathbb{R}^n {}:{} \langle c, x\rangle = b\\}$.
-pub struct Hyperplane<'a> {
+pub struct Hyperplane<'a, T = f64> {
     /// normal vector
-    normal_vector: &'a [f64],
+    normal_vector: &'a [T],
     /// offset
-    offset: f64,
+    offset: T,
     /// squared Euclidean norm of the normal vector (computed once upon construction)
-    normal_vector_squared_norm: f64,
+    normal_vector_squared_norm: T,
 }
 
-impl<'a> Hyperplane<'a> {
+impl<'a, T: Scalar> Hyperplane<'a, T> {
     /// A hyperplane is a set given by $H = \\{x \in \mathbb{R}^n {}:{} \langle c, x\rangle = b\\}$,
     /// where $c$ is the normal vector of the hyperplane and $b$ is an offset.
     ///
@@ -45,7 +46,7 @@ impl<'a> Hyperplane<'a> {
     /// hyperplane.project(&mut x);
     /// ```
     ///
-    pub fn new(normal_vector: &'a [f64], offset: f64) -> Self {
+    pub fn new(normal_vector: &'a [T], offset: T) -> Self {
         let normal_vector_squared_norm = matrix_operations::norm2_squared(normal_vector);
         Hyperplane {
             normal_vector,
@@ -55,7 +56,7 @@ impl<'a> Hyperplane<'a> {
     }
 }
 
-impl<'a> Constraint for Hyperplane<'a> {
+impl<'a, T: Scalar> Constraint<T> for Hyperplane<'a, T> {
     /// Projects on the hyperplane using the formula:
     ///
     /// $$\begin{aligned}
@@ -76,12 +77,12 @@ impl<'a> Constraint for Hyperplane<'a> {
     /// This method panics if the length of `x` is not equal to the dimension
     /// of the hyperplane.
     ///
-    fn project(&self, x: &mut [f64]) {
+    fn project(&self, x: &mut [T]) {
         let inner_product = matrix_operations::inner_product(x, self.normal_vector);
         let factor = (inner_product - self.offset) / self.normal_vector_squared_norm;
         x.iter_mut()
             .zip(self.normal_vector.iter())
-            .for_each(|(x, nrm_vct)| *x -= factor * nrm_vct);
+            .for_each(|(x, &nrm_vct)| *x -= factor * nrm_vct);
     }
 
     /// Hyperplanes are convex sets
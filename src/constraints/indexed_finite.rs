@@ -0,0 +1,184 @@
+use super::Constraint;
+use std::cmp::Ordering;
+
+/// Maximum number of points in a leaf of the k-d tree
+const LEAF_SIZE: usize = 8;
+
+///
+/// A finite set, $X = \\{x_1, x_2, \ldots, x_n\\}\subseteq\mathbb{R}^n$, given vectors
+/// $x_i\in\mathbb{R}^n$, with a spatial index for fast projections
+///
+/// This is the same set as [`FiniteSet`](struct.FiniteSet.html), but a k-d tree
+/// of the given points is built once, at construction. A projection then
+/// visits, typically, $O(\log N)$ of the $N$ points of the set, instead of all
+/// of them, which pays off for sets with many (more than a few hundred) points
+/// in low dimensions.
+///
+/// The result of a projection is exactly the same as that of `FiniteSet`, that is,
+/// the nearest point of the set; if several points are at the same distance, the
+/// one that comes first in the given data is chosen.
+///
+#[derive(Clone)]
+pub struct IndexedFiniteSet<'a> {
+    /// The data is stored in a Vec-of-Vec datatype, that is, a vector
+    /// of vectors
+    data: &'a [&'a [f64]],
+    /// Indices of the points of `data`, ordered as in the k-d tree: every
+    /// range `lo..hi` of `index` with more than `LEAF_SIZE` elements is split
+    /// at `mid = (lo + hi) / 2`; the points of `lo..mid` (resp. `mid+1..hi`)
+    /// have a coordinate `split_dims[mid]` that is not larger (resp. not
+    /// smaller) than the one of point `index[mid]`
+    index: Vec<usize>,
+    /// Coordinates along which the ranges of `index` are split
+    split_dims: Vec<usize>,
+}
+
+impl<'a> IndexedFiniteSet<'a> {
+    /// Construct a finite set, $X = \\{x_1, x_2, \ldots, x_n\\}$, given vectors
+    /// $x_i\in\mathbb{R}^n$, and its spatial index
+    ///
+    ///
+    /// # Arguments
+    ///
+    /// - data: vector of vectors (see example below)
+    ///
+    ///
+    /// # Example
+    ///
+    /// ```
+    /// use optimization_engine::constraints::{Constraint, IndexedFiniteSet};
+    ///
+    /// let data: &[&[f64]] = &[
+    ///    &[1.0, 1.0],
+    ///    &[0.0, 1.0],
+    ///    &[1.0, 0.0],
+    ///    &[0.0, 0.0],
+    /// ];
+    /// let finite_set = IndexedFiniteSet::new(data);
+    /// let mut x = [0.7, 0.2];
+    /// finite_set.project(&mut x);
+    /// assert_eq!([1.0, 0.0], x);
+    /// ```
+    ///
+    ///
+    /// # Panics
+    ///
+    /// This method will panic if (i) the given vector of data is empty,
+    /// (ii) if the given vectors have unequal dimensions and (iii) if
+    /// the given vectors are empty.
+    ///
+    pub fn new(data: &'a [&'a [f64]]) -> Self {
+        // Do a sanity check...
+        assert!(!data.is_empty(), "empty data not allowed");
+        let n = data[0].len();
+        assert!(n > 0, "the points must have positive dimension");
+        for v in data.iter() {
+            assert!(n == v.len(), "inconsistent dimensions");
+        }
+        let mut index: Vec<usize> = (0..data.len()).collect();
+        let mut split_dims = vec![0; data.len()];
+        IndexedFiniteSet::build(data, &mut index, &mut split_dims);
+        IndexedFiniteSet {
+            data,
+            index,
+            split_dims,
+        }
+    }
+
+    /// Builds the k-d tree on `index` by splitting it at its median along the
+    /// coordinate with the largest spread
+    fn build(data: &[&[f64]], index: &mut [usize], split_dims: &mut [usize]) {
+        let len = index.len();
+        if len <= LEAF_SIZE {
+            return;
+        }
+        let mut split_dim = 0;
+        let mut largest_spread = -1.0;
+        for d in 0..data[0].len() {
+            let (min, max) = index.iter().fold(
+                (std::f64::INFINITY, std::f64::NEG_INFINITY),
+                |(min, max), &i| (min.min(data[i][d]), max.max(data[i][d])),
+            );
+            if max - min > largest_spread {
+                split_dim = d;
+                largest_spread = max - min;
+            }
+        }
+        let mid = len / 2;
+        index.select_nth_unstable_by(mid, |&i, &j| {
+            data[i][split_dim]
+                .partial_cmp(&data[j][split_dim])
+                .unwrap_or(Ordering::Equal)
+        });
+        split_dims[mid] = split_dim;
+        let (index_left, index_right) = index.split_at_mut(mid);
+        let (split_dims_left, split_dims_right) = split_dims.split_at_mut(mid);
+        IndexedFiniteSet::build(data, index_left, split_dims_left);
+        IndexedFiniteSet::build(data, &mut index_right[1..], &mut split_dims_right[1..]);
+    }
+
+    /// Updates `best = (idx, distance)` if point `i` is closer to `x`, or at
+    /// the same distance but with a smaller index
+    #[inline]
+    fn visit(&self, i: usize, x: &[f64], best: &mut (usize, f64)) {
+        let dist = crate::matrix_operations::norm2_squared_diff(self.data[i], x);
+        if dist < best.1 || (dist == best.1 && i < best.0) {
+            *best = (i, dist);
+        }
+    }
+
+    /// Searches the nearest point to `x` in the range `lo..hi` of the k-d tree
+    fn nearest(&self, lo: usize, hi: usize, x: &[f64], best: &mut (usize, f64)) {
+        if hi - lo <= LEAF_SIZE {
+            self.index[lo..hi]
+                .iter()
+                .for_each(|&i| self.visit(i, x, best));
+            return;
+        }
+        let mid = (lo + hi) / 2;
+        let median = self.index[mid];
+        let split_dim = self.split_dims[mid];
+        let delta = x[split_dim] - self.data[median][split_dim];
+        self.visit(median, x, best);
+        // visit the half-space that contains x first; then, visit the other
+        // one only if it may contain a point which is not farther than the
+        // best one so far (points at the same distance may have smaller index)
+        let (near, far) = if delta < 0.0 {
+            ((lo, mid), (mid + 1, hi))
+        } else {
+            ((mid + 1, hi), (lo, mid))
+        };
+        self.nearest(near.0, near.1, x, best);
+        if delta * delta <= best.1 {
+            self.nearest(far.0, far.1, x, best);
+        }
+    }
+}
+
+impl<'a> Constraint for IndexedFiniteSet<'a> {
+    ///
+    /// Projection on the current finite set
+    ///
+    /// Searches the k-d tree for the element of the set which is closest
+    /// to `x` (in the norm-2 sense) and updates `x` with it
+    ///
+    ///
+    /// # Parameters
+    ///
+    /// - `x`: (input) given vector, (output) projection on finite set
+    ///
+    ///
+    /// # Panics
+    ///
+    /// Does not panic
+    ///
+    fn project(&self, x: &mut [f64]) {
+        let mut best = (0, std::f64::INFINITY);
+        self.nearest(0, self.index.len(), x, &mut best);
+        x.copy_from_slice(self.data[best.0]);
+    }
+
+    fn is_convex(&self) -> bool {
+        self.data.len() == 1 && !self.data[0].is_empty()
+    }
+}
@@ -0,0 +1,145 @@
+//! Kernels of the projections on small blocks
+//!
+//! Sets such as balls and cones often appear as many small blocks (of
+//! dimension 2 to 4) of a Cartesian product, where the overhead of the
+//! general loops dominates the arithmetic; the kernels of this module are
+//! unrolled for these dimensions. They also provide the building blocks of
+//! the projections on blocks which are stored as structure of arrays (see
+//! [`BlockProjection`](../trait.BlockProjection.html)), which process
+//! [`LANES`] blocks at a time, so that the compiler can vectorise them
+//! across blocks.
+
+use crate::{matrix_operations, Scalar};
+
+/// Number of blocks which are processed together by the projections on
+/// blocks stored as structure of arrays
+pub(crate) const LANES: usize = 8;
+
+/// Squared Euclidean norm of `x` (unrolled for dimensions up to 4)
+#[inline(always)]
+pub(crate) fn norm2_squared<T: Scalar>(x: &[T]) -> T {
+    match *x {
+        [a] => a * a,
+        [a, b] => a * a + b * b,
+        [a, b, c] => a * a + b * b + c * c,
+        [a, b, c, d] => a * a + b * b + c * c + d * d,
+        _ => matrix_operations::norm2_squared(x),
+    }
+}
+
+/// Multiplies `x` by `alpha` (unrolled for dimensions up to 4)
+#[inline(always)]
+pub(crate) fn scale<T: Scalar>(x: &mut [T], alpha: T) {
+    match x {
+        [a] => *a *= alpha,
+        [a, b] => {
+            *a *= alpha;
+            *b *= alpha;
+        }
+        [a, b, c] => {
+            *a *= alpha;
+            *b *= alpha;
+            *c *= alpha;
+        }
+        [a, b, c, d] => {
+            *a *= alpha;
+            *b *= alpha;
+            *c *= alpha;
+            *d *= alpha;
+        }
+        _ => x.iter_mut().for_each(|xi| *xi *= alpha),
+    }
+}
+
+/// Blocks `x` of dimension `x.len() / num_blocks` which are stored as
+/// structure of arrays, that is, component `j` of block `k` is
+/// `x[j * num_blocks + k]`
+pub(crate) struct Blocks<'a, T> {
+    x: &'a mut [T],
+    num_blocks: usize,
+}
+
+impl<'a, T: Scalar> Blocks<'a, T> {
+    /// Splits `x` into `num_blocks` blocks
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `num_blocks` is zero, or if the length of `x` is
+    /// not a multiple of `num_blocks`
+    pub(crate) fn new(x: &'a mut [T], num_blocks: usize) -> Self {
+        assert!(num_blocks > 0, "the number of blocks must be positive");
+        assert!(
+            x.len() % num_blocks == 0,
+            "the length of x must be a multiple of the number of blocks"
+        );
+        Blocks { x, num_blocks }
+    }
+
+    /// Dimension of the blocks
+    pub(crate) fn dimension(&self) -> usize {
+        self.x.len() / self.num_blocks
+    }
+
+    /// Calls `f(first, lanes)` for consecutive groups of (at most) `LANES`
+    /// blocks, where `first` is the first block of the group and `lanes`
+    /// is the number of blocks in the group
+    pub(crate) fn for_each_group(&mut self, mut f: impl FnMut(&mut Self, usize, usize)) {
+        let mut first = 0;
+        while first < self.num_blocks {
+            let lanes = usize::min(LANES, self.num_blocks - first);
+            f(self, first, lanes);
+            first += lanes;
+        }
+    }
+
+    /// Component `j` of the blocks `first..first + lanes`
+    #[inline(always)]
+    pub(crate) fn component(&mut self, j: usize, first: usize, lanes: usize) -> &mut [T] {
+        let start = j * self.num_blocks + first;
+        &mut self.x[start..start + lanes]
+    }
+
+    /// Squared Euclidean norms of the components `0..num_components` of the
+    /// blocks `first..first + lanes`, where the components are shifted by
+    /// `center` (if provided)
+    #[inline(always)]
+    pub(crate) fn norm2_squared(
+        &mut self,
+        num_components: usize,
+        center: Option<&[T]>,
+        first: usize,
+        lanes: usize,
+    ) -> [T; LANES] {
+        let mut norm2_squared = [T::zero(); LANES];
+        for j in 0..num_components {
+            let c = center.map_or(T::zero(), |c| c[j]);
+            let xj = self.component(j, first, lanes);
+            norm2_squared
+                .iter_mut()
+                .zip(xj.iter())
+                .for_each(|(s, &xi)| *s += (xi - c) * (xi - c));
+        }
+        norm2_squared
+    }
+
+    /// Multiplies the components `0..num_components` of the blocks
+    /// `first..first + lanes` by `alpha` (one factor per block), where the
+    /// components are shifted by `center` (if provided)
+    #[inline(always)]
+    pub(crate) fn scale(
+        &mut self,
+        num_components: usize,
+        center: Option<&[T]>,
+        first: usize,
+        lanes: usize,
+        alpha: &[T; LANES],
+    ) {
+        for j in 0..num_components {
+            let c = center.map_or(T::zero(), |c| c[j]);
+            let xj = self.component(j, first, lanes);
+            xj.iter_mut()
+                .zip(alpha.iter())
+                .for_each(|(xi, &a)| *xi = c + a * (*xi - c));
+        }
+    }
+}
@@ -8,43 +8,54 @@
 //!
 //! [`Constraint`]: trait.Constraint.html
 
+use crate::Scalar;
+
 mod affine_space;
 mod ball1;
 mod ball2;
 mod ballinf;
+mod block_projection;
 mod cartesian_product;
 mod epigraph_squared_norm;
 mod finite;
 mod halfspace;
 mod hyperplane;
+mod indexed_finite;
+mod kernels;
 mod no_constraints;
 mod rectangle;
 mod simplex;
 mod soc;
+mod sparse_affine_space;
 mod sphere2;
+mod static_cartesian_product;
 mod zero;
 
 pub use affine_space::AffineSpace;
 pub use ball1::Ball1;
 pub use ball2::Ball2;
 pub use ballinf::BallInf;
+pub use block_projection::{BlockProjection, HomogeneousCartesianProduct};
 pub use cartesian_product::CartesianProduct;
 pub use epigraph_squared_norm::EpigraphSquaredNorm;
 pub use finite::FiniteSet;
 pub use halfspace::Halfspace;
 pub use hyperplane::Hyperplane;
+pub use indexed_finite::IndexedFiniteSet;
 pub use no_constraints::NoConstraints;
 pub use rectangle::Rectangle;
 pub use simplex::Simplex;
 pub use soc::SecondOrderCone;
+pub use sparse_affine_space::SparseAffineSpace;
 pub use sphere2::Sphere2;
+pub use static_cartesian_product::{ConstraintTuple, StaticCartesianProduct};
 pub use zero::Zero;
 
 /// A set which can be used as a constraint
 ///
 /// This trait defines an abstract function that allows to compute projections
 /// on sets; this is implemented by a series of structures (see below for details)
-pub trait Constraint {
+pub trait Constraint<T: Scalar = f64> {
     /// Projection onto the set, that is,
     ///
     /// $$
@@ -55,10 +66,92 @@ pub trait Constraint {
     ///
     /// - `x`: The given vector $x$ is updated with the projection on the set
     ///
-    fn project(&self, x: &mut [f64]);
+    fn project(&self, x: &mut [T]);
 
     /// Returns true if and only if the set is convex
     fn is_convex(&self) -> bool;
+
+    /// Number of elements of the scratch workspace (see `project_with_workspace`)
+    /// which is needed to project vectors of dimension `n` on the set
+    ///
+    /// The default implementation returns `0`
+    fn workspace_size(&self, n: usize) -> usize {
+        let _ = n;
+        0
+    }
+
+    /// Projection onto the set using the scratch workspace `work`, which
+    /// must have (at least) `workspace_size(x.len())` elements
+    ///
+    /// Implementations of this method do not allocate memory, so this method
+    /// should be preferred over `project` when the same projection is computed
+    /// repeatedly (e.g., at every iteration of an algorithm). On exit, the
+    /// contents of `work` are unspecified.
+    ///
+    /// The default implementation ignores `work` and calls `project`
+    ///
+    /// ## Arguments
+    ///
+    /// - `x`: The given vector $x$ is updated with the projection on the set
+    /// - `work`: scratch workspace
+    ///
+    /// ## Panics
+    ///
+    /// Implementations which need a workspace panic if `work` is too small
+    ///
+    fn project_with_workspace(&self, x: &mut [T], work: &mut [T]) {
+        let _ = work;
+        self.project(x);
+    }
+
+    /// Projection of `source` onto the set, which is stored in `x`, using
+    /// the scratch workspace `work` (see `project_with_workspace`)
+    ///
+    /// This is equivalent to copying `source` into `x` and then projecting `x`;
+    /// sets whose projection is computed elementwise (e.g., rectangles)
+    /// compute it in a single pass over `source` and `x`.
+    ///
+    /// The default implementation copies `source` into `x` and calls
+    /// `project_with_workspace`
+    ///
+    /// ## Arguments
+    ///
+    /// - `source`: the vector to be projected
+    /// - `x`: on exit, the projection of `source` on the set
+    /// - `work`: scratch workspace
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `source` and `x` have different lengths
+    ///
+    fn project_from(&self, source: &[T], x: &mut [T], work: &mut [T]) {
+        x.copy_from_slice(source);
+        self.project_with_workspace(x, work);
+    }
+}
+
+/// A reference to a set is a set, so a set which is constructed once (and
+/// stored, e.g., as a trait object) can be used in many problems
+impl<T: Scalar, C: Constraint<T> + ?Sized> Constraint<T> for &C {
+    fn project(&self, x: &mut [T]) {
+        (**self).project(x)
+    }
+
+    fn is_convex(&self) -> bool {
+        (**self).is_convex()
+    }
+
+    fn workspace_size(&self, n: usize) -> usize {
+        (**self).workspace_size(n)
+    }
+
+    fn project_with_workspace(&self, x: &mut [T], work: &mut [T]) {
+        (**self).project_with_workspace(x, work)
+    }
+
+    fn project_from(&self, source: &[T], x: &mut [T], work: &mut [T]) {
+        (**self).project_from(source, x, work)
+    }
 }
 
 /* ---------------------------------------------------------------------------- */
@@ -1,4 +1,5 @@
 use super::Constraint;
+use crate::Scalar;
 
 /// The whole space, no constraints
 #[derive(Default, Clone, Copy)]
@@ -12,8 +13,12 @@ impl NoConstraints {
     }
 }
 
-impl Constraint for NoConstraints {
-    fn project(&self, _x: &mut [f64]) {}
+impl<T: Scalar> Constraint<T> for NoConstraints {
+    fn project(&self, _x: &mut [T]) {}
+
+    fn project_from(&self, source: &[T], x: &mut [T], _work: &mut [T]) {
+        x.copy_from_slice(source);
+    }
 
     fn is_convex(&self) -> bool {
         true
@@ -1,4 +1,5 @@
 use super::Constraint;
+use crate::Scalar;
 
 #[derive(Clone, Copy)]
 ///
@@ -7,12 +8,12 @@ use super::Constraint;
 /// A set of the form $\\{x \in \mathbb{R}^n {}:{} x_{\min} {}\leq{} x {}\leq{} x_{\max}\\}$,
 /// where $\leq$ is meant in the element-wise sense and either of $x_{\min}$ and $x_{\max}$ can
 /// be equal to infinity.
-pub struct Rectangle<'a> {
-    xmin: Option<&'a [f64]>,
-    xmax: Option<&'a [f64]>,
+pub struct Rectangle<'a, T = f64> {
+    xmin: Option<&'a [T]>,
+    xmax: Option<&'a [T]>,
 }
 
-impl<'a> Rectangle<'a> {
+impl<'a, T: Scalar> Rectangle<'a, T> {
     /// Construct a new rectangle with given $x_{\min}$ and $x_{\max}$
     ///
     /// # Arguments
@@ -34,7 +35,7 @@ impl<'a> Rectangle<'a> {
     /// - Both `xmin` and `xmax` have been provided, but they have incompatible
     ///   dimensions
     ///
-    pub fn new(xmin: Option<&'a [f64]>, xmax: Option<&'a [f64]>) -> Self {
+    pub fn new(xmin: Option<&'a [T]>, xmax: Option<&'a [T]>) -> Self {
         assert!(xmin.is_some() || xmax.is_some()); // xmin or xmax must be Some
         assert!(
             xmin.is_none() || xmax.is_none() || xmin.unwrap().len() == xmax.unwrap().len(),
@@ -44,8 +45,8 @@ impl<'a> Rectangle<'a> {
     }
 }
 
-impl<'a> Constraint for Rectangle<'a> {
-    fn project(&self, x: &mut [f64]) {
+impl<'a, T: Scalar> Constraint<T> for Rectangle<'a, T> {
+    fn project(&self, x: &mut [T]) {
         if let Some(xmin) = &self.xmin {
             x.iter_mut().zip(xmin.iter()).for_each(|(x_, xmin_)| {
                 if *x_ < *xmin_ {
@@ -63,6 +64,47 @@ impl<'a> Constraint for Rectangle<'a> {
         }
     }
 
+    /// Projects `source` on the rectangle in a single pass (see
+    /// `Constraint::project_from`)
+    fn project_from(&self, source: &[T], x: &mut [T], _work: &mut [T]) {
+        assert!(
+            source.len() == x.len(),
+            "source and x have different lengths"
+        );
+        // as in `project`, the elements of `x` beyond the length of the
+        // bounds are not constrained
+        let num_bounded = match (&self.xmin, &self.xmax) {
+            (Some(xmin), Some(xmax)) => {
+                x.iter_mut()
+                    .zip(source.iter())
+                    .zip(xmin.iter().zip(xmax.iter()))
+                    .for_each(|((x_, &s), (&xmin_, &xmax_))| {
+                        let xi = if s < xmin_ { xmin_ } else { s };
+                        *x_ = if xi > xmax_ { xmax_ } else { xi };
+                    });
+                xmin.len()
+            }
+            (Some(xmin), None) => {
+                x.iter_mut()
+                    .zip(source.iter())
+                    .zip(xmin.iter())
+                    .for_each(|((x_, &s), &xmin_)| *x_ = if s < xmin_ { xmin_ } else { s });
+                xmin.len()
+            }
+            (None, Some(xmax)) => {
+                x.iter_mut()
+                    .zip(source.iter())
+                    .zip(xmax.iter())
+                    .for_each(|((x_, &s), &xmax_)| *x_ = if s > xmax_ { xmax_ } else { s });
+                xmax.len()
+            }
+            (None, None) => 0,
+        };
+        if num_bounded < x.len() {
+            x[num_bounded..].copy_from_slice(&source[num_bounded..]);
+        }
+    }
+
     fn is_convex(&self) -> bool {
         true
     }
@@ -1,89 +1,113 @@
 use super::Constraint;
+use crate::Scalar;
 
 #[derive(Copy, Clone)]
 /// A simplex with level $\alpha$ is a set of the form
 /// $\Delta_\alpha^n = \\{x \in \mathbb{R}^n {}:{} x \geq 0, \sum_i x_i = \alpha\\}$,
 /// where $\alpha$ is a positive constant.
-pub struct Simplex {
+pub struct Simplex<T = f64> {
     /// Simplex level
-    alpha: f64,
+    alpha: T,
 }
 
-impl Simplex {
+impl<T: Scalar> Simplex<T> {
     /// Construct a new simplex with given (positive) $\alpha$. The user does not need
     /// to specify the dimension of the simplex.
-    pub fn new(alpha: f64) -> Self {
-        assert!(alpha > 0.0, "alpha is nonpositive");
+    pub fn new(alpha: T) -> Self {
+        assert!(alpha > T::zero(), "alpha is nonpositive");
         Simplex { alpha }
     }
 }
 
-impl Constraint for Simplex {
+impl<T: Scalar> Constraint<T> for Simplex<T> {
     /// Project onto $\Delta_\alpha^n$ using Condat's fast projection algorithm.
     ///
     /// See: Laurent Condat. Fast Projection onto the Simplex and the $\ell_1$ Ball.
     /// <em>Mathematical Programming, Series A,</em> Springer, 2016, 158 (1), pp.575-585.
     /// ⟨<a href="https://dx.doi.org/10.1007/s10107-015-0946-6">10.1007/s10107-015-0946-6</a>⟩.
-    fn project(&self, x: &mut [f64]) {
-        let a = &self.alpha;
+    ///
+    /// This method allocates a workspace of `2*x.len()` floats; use
+    /// `project_with_workspace` to avoid allocations.
+    fn project(&self, x: &mut [T]) {
+        let mut work = vec![T::zero(); self.workspace_size(x.len())];
+        self.project_with_workspace(x, &mut work);
+    }
+
+    fn is_convex(&self) -> bool {
+        true
+    }
+
+    /// The projection needs a workspace of `2n` floats
+    fn workspace_size(&self, n: usize) -> usize {
+        2 * n
+    }
+
+    /// Project onto $\Delta_\alpha^n$ using Condat's fast projection algorithm
+    /// (see `project`); the vectors $v$ and $\tilde{v}$ of the algorithm are
+    /// stored in `work`
+    fn project_with_workspace(&self, x: &mut [T], work: &mut [T]) {
+        let n = x.len();
+        assert!(work.len() >= 2 * n, "workspace is too small");
+        let a = self.alpha;
+        let (v, v_tilde) = work.split_at_mut(n);
 
         // ---- step 1
-        let mut v = Vec::<f64>::with_capacity(x.len()); // vector containing x[0]
-        v.push(x[0]);
+        v[0] = x[0]; // v contains x[0]
+        let mut v_len: usize = 1;
         let mut v_size_old: i64 = -1; // 64 bit signed int
-        let mut v_tilde: Vec<f64> = Vec::new(); // empty vector of f64
-        let mut rho: f64 = x[0] - a; // 64 bit float
+        let mut v_tilde_len: usize = 0; // v_tilde is empty
+        let mut rho: T = x[0] - a;
 
         // ---- step 2
         x.iter().skip(1).for_each(|x_n| {
             if *x_n > rho {
-                rho += (*x_n - rho) / ((v.len() + 1) as f64);
+                rho += (*x_n - rho) / T::from_f64((v_len + 1) as f64);
                 if rho > *x_n - a {
-                    v.push(*x_n);
+                    v[v_len] = *x_n;
+                    v_len += 1;
                 } else {
-                    v_tilde.extend(&v);
-                    v = vec![*x_n];
+                    v_tilde[v_tilde_len..v_tilde_len + v_len].copy_from_slice(&v[..v_len]);
+                    v_tilde_len += v_len;
+                    v[0] = *x_n;
+                    v_len = 1;
                     rho = *x_n - a;
                 }
             }
         });
 
         // ---- step 3
-        if !v_tilde.is_empty() {
-            v_tilde.iter().for_each(|v_t_n| {
-                if *v_t_n > rho {
-                    v.push(*v_t_n);
-                    rho += (*v_t_n - rho) / (v.len() as f64);
-                }
-            });
-        }
+        v_tilde[..v_tilde_len].iter().for_each(|v_t_n| {
+            if *v_t_n > rho {
+                v[v_len] = *v_t_n;
+                v_len += 1;
+                rho += (*v_t_n - rho) / T::from_f64(v_len as f64);
+            }
+        });
 
         // ---- step 4
         let mut keep_running = true;
         while keep_running {
-            let mut hit_list: Vec<usize> = Vec::with_capacity(x.len());
-            let mut current_len_v = v.len() as i64;
-            v.iter().enumerate().for_each(|(n, v_n)| {
-                if *v_n <= rho {
-                    hit_list.push(n);
+            // remove the elements of v which are not larger than rho by
+            // compacting v in place (this keeps the order of the elements)
+            let mut current_len_v = v_len as i64;
+            let mut n_kept = 0;
+            for k in 0..v_len {
+                let v_n = v[k];
+                if v_n <= rho {
                     current_len_v -= 1;
-                    rho += (rho - *v_n) / (current_len_v as f64);
+                    rho += (rho - v_n) / T::from_f64(current_len_v as f64);
+                } else {
+                    v[n_kept] = v_n;
+                    n_kept += 1;
                 }
-            });
-            hit_list.iter().rev().for_each(|target| {
-                // remove in reverse to keep indexing correct
-                v.remove(*target);
-            });
+            }
+            v_len = n_kept;
             keep_running = current_len_v != v_size_old;
             v_size_old = current_len_v;
         }
 
         // ---- step 6
-        let zero: f64 = 0.0;
+        let zero = T::zero();
         x.iter_mut().for_each(|x_n| *x_n = zero.max(*x_n - rho));
     }
-
-    fn is_convex(&self) -> bool {
-        true
-    }
 }
@@ -1,5 +1,5 @@
-use super::Constraint;
-use crate::matrix_operations;
+use super::{kernels, BlockProjection, Constraint};
+use crate::Scalar;
 
 #[derive(Clone, Copy)]
 ///
@@ -17,11 +17,11 @@ use crate::matrix_operations;
 /// 1996 doctoral dissertation: Projection Algorithms and Monotone Operators
 /// (p. 40, Theorem 3.3.6).
 ///
-pub struct SecondOrderCone {
-    alpha: f64,
+pub struct SecondOrderCone<T = f64> {
+    alpha: T,
 }
 
-impl SecondOrderCone {
+impl<T: Scalar> SecondOrderCone<T> {
     /// Construct a new instance of SecondOrderCone with parameter `alpha`
     ///
     /// A second-order cone with parameter alpha is the set
@@ -39,13 +39,13 @@ impl SecondOrderCone {
     /// # Panics
     ///
     /// The method panics if the given parameter `alpha` is nonpositive.
-    pub fn new(alpha: f64) -> SecondOrderCone {
-        assert!(alpha > 0.0); // alpha must be positive
+    pub fn new(alpha: T) -> SecondOrderCone<T> {
+        assert!(alpha > T::zero()); // alpha must be positive
         SecondOrderCone { alpha }
     }
 }
 
-impl Constraint for SecondOrderCone {
+impl<T: Scalar> Constraint<T> for SecondOrderCone<T> {
     /// Project on the second-order cone (updates the given vector/slice)
     ///
     /// # Arguments
@@ -57,20 +57,18 @@ impl Constraint for SecondOrderCone {
     ///
     /// The methods panics is the length of `x` is less than 2.
     ///
-    fn project(&self, x: &mut [f64]) {
+    fn project(&self, x: &mut [T]) {
         // x = (z, r)
         let n = x.len();
         assert!(n >= 2, "x must be of dimension at least 2");
         let z = &x[..n - 1];
         let r = x[n - 1];
-        let norm_z = matrix_operations::norm2(z);
+        let norm_z = kernels::norm2_squared(z).sqrt();
         if self.alpha * norm_z <= -r {
-            x.iter_mut().for_each(|v| *v = 0.0);
+            x.iter_mut().for_each(|v| *v = T::zero());
         } else if norm_z > self.alpha * r {
-            let beta = (self.alpha * norm_z + r) / (self.alpha.powi(2) + 1.0);
-            x[..n - 1]
-                .iter_mut()
-                .for_each(|v| *v *= self.alpha * beta / norm_z);
+            let beta = (self.alpha * norm_z + r) / (self.alpha.powi(2) + T::one());
+            kernels::scale(&mut x[..n - 1], self.alpha * beta / norm_z);
             x[n - 1] = beta;
         }
     }
@@ -79,3 +77,37 @@ impl Constraint for SecondOrderCone {
         true
     }
 }
+
+impl<T: Scalar> BlockProjection<T> for SecondOrderCone<T> {
+    /// Projects blocks, which are stored as structure of arrays, on the
+    /// second-order cone (see `BlockProjection::project_blocks`)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if the dimension of the blocks is less than 2
+    fn project_blocks(&self, x: &mut [T], num_blocks: usize) {
+        let mut blocks = kernels::Blocks::new(x, num_blocks);
+        let n = blocks.dimension();
+        assert!(n >= 2, "the blocks must be of dimension at least 2");
+        let alpha = self.alpha;
+        let one_plus_alpha_sq = alpha.powi(2) + T::one();
+        blocks.for_each_group(|blocks, first, lanes| {
+            let mut scaling = blocks.norm2_squared(n - 1, None, first, lanes);
+            let r = blocks.component(n - 1, first, lanes);
+            scaling.iter_mut().zip(r.iter_mut()).for_each(|(s, r)| {
+                let norm_z = s.sqrt();
+                if alpha * norm_z <= -*r {
+                    *s = T::zero();
+                    *r = T::zero();
+                } else if norm_z > alpha * *r {
+                    let beta = (alpha * norm_z + *r) / one_plus_alpha_sq;
+                    *s = alpha * beta / norm_z;
+                    *r = beta;
+                } else {
+                    *s = T::one();
+                }
+            });
+            blocks.scale(n - 1, None, first, lanes, &scaling);
+        });
+    }
+}
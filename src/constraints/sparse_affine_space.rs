@@ -0,0 +1,466 @@
+use super::Constraint;
+use std::cmp::Reverse;
+use std::collections::{BTreeSet, BinaryHeap};
+
+/// Marker of the root of the elimination tree
+const NONE: usize = std::usize::MAX;
+
+/// Relative tolerance on the pivots of the Cholesky factorisation of $AA^\intercal$,
+/// below which $A$ is considered to be rank deficient
+const RANK_TOLERANCE: f64 = 1e-12;
+
+#[derive(Clone)]
+/// An affine space, $E=\\{x\in\mathbb{R}^n: Ax = b\\}$, where $A$ is a sparse
+/// matrix with full row rank
+///
+/// This is the sparse counterpart of [`AffineSpace`](struct.AffineSpace.html):
+/// matrix $A$ is stored in compressed sparse row (CSR) format and the
+/// Cholesky factorisation of $AA^\intercal$ is sparse. A fill-reducing
+/// (minimum degree) ordering of $AA^\intercal$ is computed at construction,
+/// so that for banded or block-banded matrices (e.g., the discretised
+/// dynamics of an MPC problem) the cost of a projection is proportional to
+/// the number of nonzeros of $A$ and of the Cholesky factor, rather than
+/// $O(mn + m^2)$.
+pub struct SparseAffineSpace {
+    /// Number of rows of $A$
+    n_rows: usize,
+    /// Number of columns of $A$
+    n_cols: usize,
+    /// Row pointers of $A$ (CSR)
+    a_row_ptr: Vec<usize>,
+    /// Column indices of $A$ (CSR)
+    a_col_idx: Vec<usize>,
+    /// Nonzero values of $A$ (CSR)
+    a_values: Vec<f64>,
+    /// Vector $b$
+    b_vec: Vec<f64>,
+    /// Fill-reducing permutation; the `k`-th row of $PAA^\intercal P^\intercal$
+    /// is row `perm[k]` of $AA^\intercal$
+    perm: Vec<usize>,
+    /// Column pointers of the Cholesky factor, $L$, of $PAA^\intercal P^\intercal$ (CSC)
+    l_col_ptr: Vec<usize>,
+    /// Row indices of $L$ (CSC); the first element of each column is the diagonal one
+    l_row_idx: Vec<usize>,
+    /// Nonzero values of $L$ (CSC)
+    l_values: Vec<f64>,
+}
+
+impl SparseAffineSpace {
+    /// Construct a new affine space given a matrix $A\in\mathbb{R}^{m\times n}$ in
+    /// compressed sparse row (CSR) format and the vector $b\in\mathbb{R}^m$
+    ///
+    /// ## Arguments
+    ///
+    /// - `n_cols`: number of columns of $A$
+    /// - `row_ptr`: row pointers (of length $m+1$); the nonzeros of the `i`-th
+    ///   row are stored in positions `row_ptr[i]..row_ptr[i+1]` of `col_idx` and
+    ///   `values`
+    /// - `col_idx`: column indices of the nonzeros
+    /// - `values`: values of the nonzeros
+    /// - `b`: vector $b$
+    ///
+    /// ## Returns
+    ///
+    /// New sparse affine space; the sparse Cholesky factorisation of $AA^\intercal$
+    /// is computed once here
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if the dimensions of the given data are incompatible,
+    /// if a column index is out of range, or if $A$ does not have full row rank
+    ///
+    /// ## Example
+    ///
+    /// ```rust
+    /// use optimization_engine::constraints::*;
+    ///
+    /// // A = [1 1 0; 0 1 1]
+    /// let row_ptr = vec![0, 2, 4];
+    /// let col_idx = vec![0, 1, 1, 2];
+    /// let values = vec![1., 1., 1., 1.];
+    /// let b = vec![1., 2.];
+    /// let affine_set = SparseAffineSpace::from_csr(3, row_ptr, col_idx, values, b);
+    /// let mut x = [1., -2., 0.5];
+    /// affine_set.project(&mut x);
+    /// ```
+    pub fn from_csr(
+        n_cols: usize,
+        row_ptr: Vec<usize>,
+        col_idx: Vec<usize>,
+        values: Vec<f64>,
+        b: Vec<f64>,
+    ) -> Self {
+        let n_rows = b.len();
+        assert!(n_rows > 0, "b must not be empty");
+        assert!(
+            row_ptr.len() == n_rows + 1,
+            "row_ptr and b have incompatible dimensions"
+        );
+        assert!(row_ptr[0] == 0, "row_ptr[0] must be 0");
+        assert!(
+            row_ptr.windows(2).all(|w| w[0] <= w[1]),
+            "row_ptr must be nondecreasing"
+        );
+        let nnz = row_ptr[n_rows];
+        assert!(
+            col_idx.len() == nnz && values.len() == nnz,
+            "col_idx and values must have row_ptr[m] elements"
+        );
+        assert!(
+            col_idx.iter().all(|&j| j < n_cols),
+            "column index out of range"
+        );
+
+        let mut affine_space = SparseAffineSpace {
+            n_rows,
+            n_cols,
+            a_row_ptr: row_ptr,
+            a_col_idx: col_idx,
+            a_values: values,
+            b_vec: b,
+            perm: Vec::new(),
+            l_col_ptr: Vec::new(),
+            l_row_idx: Vec::new(),
+            l_values: Vec::new(),
+        };
+        affine_space.factorise();
+        affine_space
+    }
+
+    /// Construct a new affine space given a matrix $A\in\mathbb{R}^{m\times n}$ in
+    /// compressed sparse column (CSC) format and the vector $b\in\mathbb{R}^m$
+    ///
+    /// ## Arguments
+    ///
+    /// - `col_ptr`: column pointers (of length $n+1$); the nonzeros of the `j`-th
+    ///   column are stored in positions `col_ptr[j]..col_ptr[j+1]` of `row_idx` and
+    ///   `values`
+    /// - `row_idx`: row indices of the nonzeros
+    /// - `values`: values of the nonzeros
+    /// - `b`: vector $b$
+    ///
+    /// ## Returns
+    ///
+    /// New sparse affine space (see `from_csr`)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if the dimensions of the given data are incompatible,
+    /// if a row index is out of range, or if $A$ does not have full row rank
+    ///
+    pub fn from_csc(
+        col_ptr: Vec<usize>,
+        row_idx: Vec<usize>,
+        values: Vec<f64>,
+        b: Vec<f64>,
+    ) -> Self {
+        assert!(!col_ptr.is_empty(), "col_ptr must not be empty");
+        let n_rows = b.len();
+        let n_cols = col_ptr.len() - 1;
+        let nnz = col_ptr[n_cols];
+        assert!(
+            row_idx.len() == nnz && values.len() == nnz,
+            "row_idx and values must have col_ptr[n] elements"
+        );
+        assert!(
+            row_idx.iter().all(|&i| i < n_rows),
+            "row index out of range"
+        );
+
+        // transpose the CSC data (of A) into CSR data (of A)
+        let mut row_ptr = vec![0; n_rows + 1];
+        row_idx.iter().for_each(|&i| row_ptr[i + 1] += 1);
+        for i in 0..n_rows {
+            row_ptr[i + 1] += row_ptr[i];
+        }
+        let mut next = row_ptr.clone();
+        let mut col_idx = vec![0; nnz];
+        let mut csr_values = vec![0.0; nnz];
+        for j in 0..n_cols {
+            for p in col_ptr[j]..col_ptr[j + 1] {
+                let q = next[row_idx[p]];
+                col_idx[q] = j;
+                csr_values[q] = values[p];
+                next[row_idx[p]] += 1;
+            }
+        }
+        SparseAffineSpace::from_csr(n_cols, row_ptr, col_idx, csr_values, b)
+    }
+
+    /// Number of nonzeros of the Cholesky factor of $PAA^\intercal P^\intercal$
+    pub fn cholesky_nnz(&self) -> usize {
+        self.l_values.len()
+    }
+
+    /// Computes $S = AA^\intercal$; returns, for every row of $S$, the column
+    /// indices and values of its nonzeros
+    fn a_times_a_t(&self) -> Vec<Vec<(usize, f64)>> {
+        let m = self.n_rows;
+        // columns of A (row indices and values of their nonzeros)
+        let mut a_columns: Vec<Vec<(usize, f64)>> = vec![Vec::new(); self.n_cols];
+        for i in 0..m {
+            for p in self.a_row_ptr[i]..self.a_row_ptr[i + 1] {
+                a_columns[self.a_col_idx[p]].push((i, self.a_values[p]));
+            }
+        }
+        // dense accumulator and nonzero pattern of the current row of S
+        let mut accumulator = vec![0.0; m];
+        let mut marker = vec![NONE; m];
+        let mut pattern = Vec::with_capacity(m);
+        let mut s_rows = Vec::with_capacity(m);
+        for i in 0..m {
+            pattern.clear();
+            for p in self.a_row_ptr[i]..self.a_row_ptr[i + 1] {
+                let a_ij = self.a_values[p];
+                for &(k, a_kj) in a_columns[self.a_col_idx[p]].iter() {
+                    if marker[k] != i {
+                        marker[k] = i;
+                        accumulator[k] = 0.0;
+                        pattern.push(k);
+                    }
+                    accumulator[k] += a_ij * a_kj;
+                }
+            }
+            s_rows.push(pattern.iter().map(|&k| (k, accumulator[k])).collect());
+        }
+        s_rows
+    }
+
+    /// Computes a minimum degree ordering of the symmetric matrix with the
+    /// given nonzero pattern
+    fn minimum_degree_ordering(s_rows: &[Vec<(usize, f64)>]) -> Vec<usize> {
+        let m = s_rows.len();
+        let mut graph: Vec<BTreeSet<usize>> = s_rows
+            .iter()
+            .enumerate()
+            .map(|(i, row)| row.iter().map(|&(k, _)| k).filter(|&k| k != i).collect())
+            .collect();
+        let mut eliminated = vec![false; m];
+        let mut heap: BinaryHeap<Reverse<(usize, usize)>> =
+            (0..m).map(|i| Reverse((graph[i].len(), i))).collect();
+        let mut perm = Vec::with_capacity(m);
+        while let Some(Reverse((degree, node))) = heap.pop() {
+            // skip outdated entries of the heap
+            if eliminated[node] || degree != graph[node].len() {
+                continue;
+            }
+            eliminated[node] = true;
+            perm.push(node);
+            // the neighbours of the eliminated node become a clique
+            let neighbours: Vec<usize> = graph[node].iter().cloned().collect();
+            for &u in neighbours.iter() {
+                graph[u].remove(&node);
+                for &v in neighbours.iter() {
+                    if v != u {
+                        graph[u].insert(v);
+                    }
+                }
+                heap.push(Reverse((graph[u].len(), u)));
+            }
+            graph[node].clear();
+        }
+        perm
+    }
+
+    /// Computes the fill-reducing ordering and the sparse Cholesky factorisation
+    /// of $PAA^\intercal P^\intercal$ (up-looking algorithm)
+    fn factorise(&mut self) {
+        let m = self.n_rows;
+        let s_rows = self.a_times_a_t();
+        let perm = SparseAffineSpace::minimum_degree_ordering(&s_rows);
+        let mut perm_inv = vec![0; m];
+        perm.iter().enumerate().for_each(|(k, &i)| perm_inv[i] = k);
+
+        // Upper triangular part of C = PSP' by columns: column k contains
+        // the elements (i, k) of C with i <= k
+        let mut c_columns: Vec<Vec<(usize, f64)>> = vec![Vec::new(); m];
+        for (i, row) in s_rows.iter().enumerate() {
+            for &(k, s_ik) in row.iter() {
+                let (pi, pk) = (perm_inv[i], perm_inv[k]);
+                if pi <= pk {
+                    c_columns[pk].push((pi, s_ik));
+                }
+            }
+        }
+
+        // Elimination tree of C
+        let mut parent = vec![NONE; m];
+        let mut ancestor = vec![NONE; m];
+        for k in 0..m {
+            for &(i, _) in c_columns[k].iter() {
+                let mut i = i;
+                while i != NONE && i < k {
+                    let i_next = ancestor[i];
+                    ancestor[i] = k;
+                    if i_next == NONE {
+                        parent[i] = k;
+                    }
+                    i = i_next;
+                }
+            }
+        }
+
+        // Symbolic factorisation: column counts of L
+        let mut flag = vec![NONE; m];
+        let mut stack = vec![0; m];
+        let mut col_counts = vec![1; m];
+        for k in 0..m {
+            let top =
+                SparseAffineSpace::row_pattern(k, &c_columns[k], &parent, &mut flag, &mut stack);
+            stack[top..].iter().for_each(|&j| col_counts[j] += 1);
+        }
+        let mut l_col_ptr = vec![0; m + 1];
+        for k in 0..m {
+            l_col_ptr[k + 1] = l_col_ptr[k] + col_counts[k];
+        }
+        let nnz_l = l_col_ptr[m];
+        let mut l_row_idx = vec![0; nnz_l];
+        let mut l_values = vec![0.0; nnz_l];
+
+        // Numeric factorisation; the k-th row of L is computed by solving a
+        // sparse triangular system
+        let mut next = l_col_ptr.clone();
+        let mut x = vec![0.0; m];
+        flag.iter_mut().for_each(|f| *f = NONE);
+        for k in 0..m {
+            let top =
+                SparseAffineSpace::row_pattern(k, &c_columns[k], &parent, &mut flag, &mut stack);
+            c_columns[k].iter().for_each(|&(i, c_ik)| x[i] += c_ik);
+            let c_kk = x[k];
+            let mut d = c_kk;
+            x[k] = 0.0;
+            for &j in stack[top..].iter() {
+                let l_kj = x[j] / l_values[l_col_ptr[j]];
+                x[j] = 0.0;
+                for p in l_col_ptr[j] + 1..next[j] {
+                    x[l_row_idx[p]] -= l_values[p] * l_kj;
+                }
+                d -= l_kj * l_kj;
+                l_row_idx[next[j]] = k;
+                l_values[next[j]] = l_kj;
+                next[j] += 1;
+            }
+            assert!(d > RANK_TOLERANCE * c_kk, "A must have full row rank");
+            l_row_idx[next[k]] = k;
+            l_values[next[k]] = d.sqrt();
+            next[k] += 1;
+        }
+
+        self.perm = perm;
+        self.l_col_ptr = l_col_ptr;
+        self.l_row_idx = l_row_idx;
+        self.l_values = l_values;
+    }
+
+    /// Computes the nonzero pattern of the `k`-th row of $L$ (except for the
+    /// diagonal), which is stored in `stack[top..]`, in topological order;
+    /// returns `top`
+    fn row_pattern(
+        k: usize,
+        c_column_k: &[(usize, f64)],
+        parent: &[usize],
+        flag: &mut [usize],
+        stack: &mut [usize],
+    ) -> usize {
+        let m = stack.len();
+        let mut top = m;
+        let mut path = Vec::new();
+        flag[k] = k;
+        for &(i, _) in c_column_k.iter() {
+            let mut i = i;
+            // traverse the elimination tree from i up to an already marked node
+            while flag[i] != k {
+                path.push(i);
+                flag[i] = k;
+                i = parent[i];
+            }
+            while let Some(j) = path.pop() {
+                top -= 1;
+                stack[top] = j;
+            }
+        }
+        top
+    }
+}
+
+impl Constraint for SparseAffineSpace {
+    /// Projection onto the set $E = \\{x: Ax = b\\}$, which is computed by
+    /// $$P_E(x) = x - A^\intercal z(x),$$
+    /// where $z$ is the solution of the linear system
+    /// $$(AA^\intercal)z = Ax - b,$$
+    /// which is solved using the sparse Cholesky factorisation of $AA^\intercal$
+    /// that was computed at construction
+    ///
+    /// ## Arguments
+    ///
+    /// - `x`: The given vector $x$ is updated with the projection on the set
+    ///
+    fn project(&self, x: &mut [f64]) {
+        let mut work = vec![0.0; self.workspace_size(x.len())];
+        self.project_with_workspace(x, &mut work);
+    }
+
+    /// The projection needs a workspace of $2m$ floats, where $m$ is the
+    /// number of rows of $A$
+    fn workspace_size(&self, _n: usize) -> usize {
+        2 * self.n_rows
+    }
+
+    /// Projection onto the affine space (see `project`); the vectors $Ax-b$
+    /// and $z$ are stored in `work`
+    fn project_with_workspace(&self, x: &mut [f64], work: &mut [f64]) {
+        let m = self.n_rows;
+        let (l_col_ptr, l_row_idx, l_values) = (&self.l_col_ptr, &self.l_row_idx, &self.l_values);
+
+        assert!(x.len() == self.n_cols, "x has wrong dimension");
+        assert!(work.len() >= 2 * m, "workspace is too small");
+        let (err_z, y) = work.split_at_mut(m);
+
+        // Step 0: err = Ax - b
+        err_z.iter_mut().enumerate().for_each(|(i, err_i)| {
+            *err_i = (self.a_row_ptr[i]..self.a_row_ptr[i + 1]).fold(-self.b_vec[i], |sum, p| {
+                sum + self.a_values[p] * x[self.a_col_idx[p]]
+            });
+        });
+
+        // Step 1: y = P err
+        y.iter_mut()
+            .zip(self.perm.iter())
+            .for_each(|(y_k, &i)| *y_k = err_z[i]);
+
+        // Step 2: Solve Lw = y (w overwrites y)
+        for j in 0..m {
+            y[j] /= l_values[l_col_ptr[j]];
+            for p in l_col_ptr[j] + 1..l_col_ptr[j + 1] {
+                y[l_row_idx[p]] -= l_values[p] * y[j];
+            }
+        }
+
+        // Step 3: Solve L'v = w (v overwrites y)
+        for j in (0..m).rev() {
+            for p in l_col_ptr[j] + 1..l_col_ptr[j + 1] {
+                y[j] -= l_values[p] * y[l_row_idx[p]];
+            }
+            y[j] /= l_values[l_col_ptr[j]];
+        }
+
+        // Step 4: z = P'v (`err` is overwritten by `z`)
+        let z = err_z;
+        self.perm
+            .iter()
+            .zip(y.iter())
+            .for_each(|(&i, &v_k)| z[i] = v_k);
+
+        // Step 5: x <-- x - A' * z
+        for (i, z_i) in z.iter().enumerate() {
+            for p in self.a_row_ptr[i]..self.a_row_ptr[i + 1] {
+                x[self.a_col_idx[p]] -= self.a_values[p] * z_i;
+            }
+        }
+    }
+
+    /// Affine sets are convex.
+    fn is_convex(&self) -> bool {
+        true
+    }
+}
@@ -1,23 +1,24 @@
 use super::Constraint;
+use crate::Scalar;
 
 #[derive(Copy, Clone)]
 /// A Euclidean sphere, that is, a set given by $S_2^r = \\{x \in \mathbb{R}^n {}:{} \Vert{}x{}\Vert = r\\}$
 /// or a Euclidean sphere centered at a point $x_c$, that is, $S_2^{x_c, r} = \\{x \in \mathbb{R}^n {}:{} \Vert{}x-x_c{}\Vert = r\\}$
-pub struct Sphere2<'a> {
-    center: Option<&'a [f64]>,
-    radius: f64,
+pub struct Sphere2<'a, T = f64> {
+    center: Option<&'a [T]>,
+    radius: T,
 }
 
-impl<'a> Sphere2<'a> {
+impl<'a, T: Scalar> Sphere2<'a, T> {
     /// Construct a new Euclidean sphere with given center and radius
     /// If no `center` is given, then it is assumed to be in the origin
-    pub fn new(center: Option<&'a [f64]>, radius: f64) -> Self {
-        assert!(radius > 0.0);
+    pub fn new(center: Option<&'a [T]>, radius: T) -> Self {
+        assert!(radius > T::zero());
         Sphere2 { center, radius }
     }
 }
 
-impl<'a> Constraint for Sphere2<'a> {
+impl<'a, T: Scalar> Constraint<T> for Sphere2<'a, T> {
     /// Projection onto the sphere, $S_{r, c}$ with radius $r$ and center $c$.
     /// If $x\neq c$, the projection is uniquely defined by
     ///
@@ -33,8 +34,8 @@ impl<'a> Constraint for Sphere2<'a> {
     ///
     /// - `x`: The given vector $x$ is updated with the projection on the set
     ///
-    fn project(&self, x: &mut [f64]) {
-        let epsilon = 1e-12;
+    fn project(&self, x: &mut [T]) {
+        let epsilon = T::from_f64(1e-12);
         if let Some(center) = &self.center {
             let norm_difference = crate::matrix_operations::norm2_squared_diff(x, center).sqrt();
             if norm_difference <= epsilon {
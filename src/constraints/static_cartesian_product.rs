@@ -0,0 +1,354 @@
+use super::Constraint;
+use crate::Scalar;
+
+/// Tuple of sets which make up a [`StaticCartesianProduct`](struct.StaticCartesianProduct.html)
+///
+/// This trait is implemented for tuples of up to 12 elements which implement
+/// [`Constraint`](trait.Constraint.html); larger products can be constructed by
+/// nesting (a `StaticCartesianProduct` is itself a `Constraint`).
+pub trait ConstraintTuple<S: Scalar = f64> {
+    /// Number of sets in the tuple
+    const LEN: usize;
+
+    /// Projects `x` on the Cartesian product of the sets, where `idx` are the
+    /// indices at which `x` is split (see `CartesianProduct::add_constraint`)
+    fn project_all(&self, idx: &[usize], x: &mut [S], work: &mut [S]);
+
+    /// Projects `source` on the Cartesian product of the sets and stores the
+    /// result in `x` (see `Constraint::project_from`)
+    fn project_all_from(&self, idx: &[usize], source: &[S], x: &mut [S], work: &mut [S]);
+
+    /// Projects the subvector `x_k` (only) on the `k`-th set of the tuple
+    fn project_block(&self, k: usize, x_k: &mut [S], work: &mut [S]);
+
+    /// Workspace size of the `k`-th set for a subvector of dimension `n_k`
+    fn block_workspace_size(&self, k: usize, n_k: usize) -> usize;
+
+    /// Whether all sets of the tuple are convex
+    fn all_convex(&self) -> bool;
+}
+
+macro_rules! impl_constraint_tuple {
+    ($len:expr; $($k:tt : $set:ident),+) => {
+        impl<S: Scalar, $($set: Constraint<S>),+> ConstraintTuple<S> for ($($set,)+) {
+            const LEN: usize = $len;
+
+            #[inline]
+            fn project_all(&self, idx: &[usize], x: &mut [S], work: &mut [S]) {
+                let mut start = 0;
+                $(
+                    self.$k.project_with_workspace(&mut x[start..idx[$k]], work);
+                    start = idx[$k];
+                )+
+                let _ = start;
+            }
+
+            #[inline]
+            fn project_all_from(
+                &self,
+                idx: &[usize],
+                source: &[S],
+                x: &mut [S],
+                work: &mut [S],
+            ) {
+                let mut start = 0;
+                $(
+                    self.$k.project_from(&source[start..idx[$k]], &mut x[start..idx[$k]], work);
+                    start = idx[$k];
+                )+
+                let _ = start;
+            }
+
+            #[inline]
+            fn project_block(&self, k: usize, x_k: &mut [S], work: &mut [S]) {
+                match k {
+                    $($k => self.$k.project_with_workspace(x_k, work),)+
+                    _ => panic!("block index out of range"),
+                }
+            }
+
+            fn block_workspace_size(&self, k: usize, n_k: usize) -> usize {
+                match k {
+                    $($k => self.$k.workspace_size(n_k),)+
+                    _ => panic!("block index out of range"),
+                }
+            }
+
+            fn all_convex(&self) -> bool {
+                true $(&& self.$k.is_convex())+
+            }
+        }
+    };
+}
+
+impl_constraint_tuple!(1; 0: C0);
+impl_constraint_tuple!(2; 0: C0, 1: C1);
+impl_constraint_tuple!(3; 0: C0, 1: C1, 2: C2);
+impl_constraint_tuple!(4; 0: C0, 1: C1, 2: C2, 3: C3);
+impl_constraint_tuple!(5; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4);
+impl_constraint_tuple!(6; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5);
+impl_constraint_tuple!(7; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5, 6: C6);
+impl_constraint_tuple!(8; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5, 6: C6, 7: C7);
+impl_constraint_tuple!(9; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5, 6: C6, 7: C7, 8: C8);
+impl_constraint_tuple!(10; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5, 6: C6, 7: C7, 8: C8, 9: C9);
+impl_constraint_tuple!(11; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5, 6: C6, 7: C7, 8: C8, 9: C9, 10: C10);
+impl_constraint_tuple!(12; 0: C0, 1: C1, 2: C2, 3: C3, 4: C4, 5: C5, 6: C6, 7: C7, 8: C8, 9: C9, 10: C10, 11: C11);
+
+/// Parallel projection on a static Cartesian product
+#[derive(Clone)]
+struct ParallelProjection<T: ConstraintTuple<S>, S: Scalar> {
+    /// The blocks `chunks[c]..chunks[c+1]` are projected by the `c`-th thread
+    chunks: Vec<usize>,
+    /// Projection function (which is only available if `T: Sync`)
+    project: fn(&StaticCartesianProduct<T, S>, &mut [S], &mut [S]),
+}
+
+/// Cartesian product of constraints with static dispatch
+///
+/// This is the same set as [`CartesianProduct`](struct.CartesianProduct.html),
+///
+/// $$
+/// C = C_0 \times C_1 \times \ldots \times C_{n-1},
+/// $$
+///
+/// but the sets $C_i$ are given as a tuple, so their types are known at compile
+/// time; the projections on the sets do not involve virtual calls and they can be
+/// inlined. Products of more than 12 sets are constructed by nesting.
+///
+/// Optionally, the projection can be computed in parallel, by splitting the sets
+/// across threads (see `with_parallel_projection`).
+///
+/// # Example
+///
+/// ```rust
+/// use optimization_engine::constraints::*;
+///
+/// // x = (x0, x1, x2), with x0 in a ball (dimension 3), x1 in a rectangle
+/// // (dimension 2) and x2 in a simplex (dimension 4)
+/// let xmin = [-1.0, -1.0];
+/// let xmax = [1.0, 1.0];
+/// let cart_prod = StaticCartesianProduct::new(
+///     &[3, 5, 9],
+///     (
+///         Ball2::new(None, 1.0),
+///         Rectangle::new(Some(&xmin), Some(&xmax)),
+///         Simplex::new(1.0),
+///     ),
+/// );
+/// let mut x = [1.0, 2.0, 3.0, -5.0, 0.5, 1.0, 2.0, 3.0, 4.0];
+/// cart_prod.project(&mut x);
+/// ```
+///
+#[derive(Clone)]
+pub struct StaticCartesianProduct<T: ConstraintTuple<S>, S: Scalar = f64> {
+    idx: Vec<usize>,
+    sets: T,
+    parallel: Option<ParallelProjection<T, S>>,
+}
+
+impl<T: ConstraintTuple<S>, S: Scalar> StaticCartesianProduct<T, S> {
+    /// Constructs a new Cartesian product of the given sets
+    ///
+    /// # Arguments
+    ///
+    /// - `idx`: indices at which a vector `x` is split, that is, `x(i)` is the
+    ///   subvector of `x` with indices `idx[i-1]..idx[i]` (see
+    ///   `CartesianProduct::add_constraint`)
+    /// - `sets`: tuple of sets
+    ///
+    /// # Panics
+    ///
+    /// The method panics if the length of `idx` is not equal to the number of
+    /// sets, or if `idx` is not strictly increasing, or if `idx[0]` is zero
+    ///
+    pub fn new(idx: &[usize], sets: T) -> Self {
+        assert!(
+            idx.len() == T::LEN,
+            "idx and sets have incompatible lengths"
+        );
+        assert!(
+            idx[0] > 0 && idx.windows(2).all(|w| w[0] < w[1]),
+            "idx must be strictly increasing with positive elements"
+        );
+        StaticCartesianProduct {
+            idx: idx.to_vec(),
+            sets,
+            parallel: None,
+        }
+    }
+
+    /// Dimension of the current constraints
+    pub fn dimension(&self) -> usize {
+        self.idx[T::LEN - 1]
+    }
+
+    /// Start and end (exclusive) of the subvector of block `k`
+    fn block_range(&self, k: usize) -> (usize, usize) {
+        let start = if k == 0 { 0 } else { self.idx[k - 1] };
+        (start, self.idx[k])
+    }
+
+    /// Workspace size needed to project the blocks `from..to` sequentially
+    fn chunk_workspace_size(&self, from: usize, to: usize) -> usize {
+        (from..to)
+            .map(|k| {
+                let (start, end) = self.block_range(k);
+                self.sets.block_workspace_size(k, end - start)
+            })
+            .max()
+            .unwrap_or(0)
+    }
+}
+
+impl<T: ConstraintTuple<S> + Sync, S: Scalar> StaticCartesianProduct<T, S> {
+    /// Activates the parallel projection, provided the dimension of the
+    /// Cartesian product is at least `min_dimension`
+    ///
+    /// The sets are split into (at most) `num_threads` groups of consecutive
+    /// sets with about the same total dimension; every projection then spawns
+    /// a (scoped) thread per group. Because of the cost of spawning threads,
+    /// this pays off only for high-dimensional products (typically, with
+    /// dimension larger than a few tens of thousands).
+    ///
+    /// The projection is always sequential on `wasm32`.
+    ///
+    /// # Arguments
+    ///
+    /// - `num_threads`: maximum number of threads
+    /// - `min_dimension`: the projection is computed in parallel only if the
+    ///   dimension of the product is at least `min_dimension`
+    ///
+    /// # Panics
+    ///
+    /// The method panics if `num_threads` is zero
+    ///
+    pub fn with_parallel_projection(mut self, num_threads: usize, min_dimension: usize) -> Self {
+        assert!(num_threads > 0, "num_threads must be positive");
+        let num_chunks = usize::min(num_threads, T::LEN);
+        if cfg!(target_arch = "wasm32") || num_chunks < 2 || self.dimension() < min_dimension {
+            self.parallel = None;
+            return self;
+        }
+        // split the blocks so that every chunk has dimension about n/num_chunks
+        let n = self.dimension();
+        let mut chunks = vec![0];
+        for k in 0..T::LEN {
+            let num_assigned = chunks.len() - 1;
+            let target_end = (num_assigned + 1) * n / num_chunks;
+            if self.idx[k] >= target_end && num_assigned < num_chunks - 1 && k + 1 < T::LEN {
+                chunks.push(k + 1);
+            }
+        }
+        chunks.push(T::LEN);
+        self.parallel = Some(ParallelProjection {
+            chunks,
+            project: StaticCartesianProduct::project_in_parallel,
+        });
+        self
+    }
+
+    /// Projects the chunks of blocks on separate threads
+    fn project_in_parallel(&self, x: &mut [S], work: &mut [S]) {
+        let chunks = match &self.parallel {
+            Some(parallel) => &parallel.chunks,
+            None => unreachable!(),
+        };
+        std::thread::scope(|scope| {
+            let mut x_rest = x;
+            let mut work_rest = work;
+            let mut offset = 0;
+            for c in 0..chunks.len() - 1 {
+                let (from, to) = (chunks[c], chunks[c + 1]);
+                let chunk_end = self.idx[to - 1];
+                let (x_chunk, x_next) = x_rest.split_at_mut(chunk_end - offset);
+                let (work_chunk, work_next) =
+                    work_rest.split_at_mut(self.chunk_workspace_size(from, to));
+                let chunk_start = offset;
+                let mut project_chunk = move || {
+                    for k in from..to {
+                        let (start, end) = self.block_range(k);
+                        self.sets.project_block(
+                            k,
+                            &mut x_chunk[start - chunk_start..end - chunk_start],
+                            work_chunk,
+                        );
+                    }
+                };
+                if c + 2 == chunks.len() {
+                    // the last chunk is projected on the current thread
+                    project_chunk();
+                } else {
+                    scope.spawn(project_chunk);
+                }
+                x_rest = x_next;
+                work_rest = work_next;
+                offset = chunk_end;
+            }
+        });
+    }
+}
+
+impl<T: ConstraintTuple<S>, S: Scalar> Constraint<S> for StaticCartesianProduct<T, S> {
+    /// Project onto Cartesian product of constraints
+    ///
+    /// The given vector `x` is updated with the projection on the set
+    ///
+    /// # Panics
+    ///
+    /// The method will panic if the dimension of `x` is not equal to the
+    /// dimension of the Cartesian product (see `dimension()`)
+    fn project(&self, x: &mut [S]) {
+        let workspace_size = self.workspace_size(x.len());
+        if workspace_size > 0 {
+            let mut work = vec![S::zero(); workspace_size];
+            self.project_with_workspace(x, &mut work);
+        } else {
+            self.project_with_workspace(x, &mut []);
+        }
+    }
+
+    fn is_convex(&self) -> bool {
+        self.sets.all_convex()
+    }
+
+    /// The sets share the workspace, so the workspace size is the largest
+    /// workspace size of the sets; with the parallel projection, every
+    /// thread needs its own workspace
+    fn workspace_size(&self, _n: usize) -> usize {
+        match &self.parallel {
+            Some(parallel) => parallel
+                .chunks
+                .windows(2)
+                .map(|w| self.chunk_workspace_size(w[0], w[1]))
+                .sum(),
+            None => self.chunk_workspace_size(0, T::LEN),
+        }
+    }
+
+    /// Project onto Cartesian product of constraints using the scratch
+    /// workspace `work` (see `project`)
+    fn project_with_workspace(&self, x: &mut [S], work: &mut [S]) {
+        assert!(x.len() == self.dimension(), "x has wrong size");
+        match &self.parallel {
+            Some(parallel) => (parallel.project)(self, x, work),
+            None => self.sets.project_all(&self.idx, x, work),
+        }
+    }
+
+    /// Projects `source` onto the Cartesian product, block by block (see
+    /// `Constraint::project_from`)
+    fn project_from(&self, source: &[S], x: &mut [S], work: &mut [S]) {
+        assert!(x.len() == self.dimension(), "x has wrong size");
+        assert!(
+            source.len() == x.len(),
+            "source and x have different lengths"
+        );
+        match &self.parallel {
+            Some(parallel) => {
+                x.copy_from_slice(source);
+                (parallel.project)(self, x, work)
+            }
+            None => self.sets.project_all_from(&self.idx, source, x, work),
+        }
+    }
+}
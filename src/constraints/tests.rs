@@ -268,7 +268,7 @@ fn t_ball2_at_origin_different_radius_inside() {
 
 #[test]
 fn t_ball2_at_center_different_radius_outside() {
-    let radius = 1.2;
+    let radius = 1.2_f64;
     let mut x = [1.0, 1.0];
     let center = [-0.8, -1.1];
     let ball = Ball2::new(Some(&center), radius);
@@ -430,7 +430,7 @@ fn t_second_order_cone_case_ii() {
 
 #[test]
 fn t_second_order_cone_case_iii() {
-    let alpha = 1.5;
+    let alpha = 1.5_f64;
     let soc = SecondOrderCone::new(alpha);
     let mut x = vec![1.0, 1.0, 0.1];
     soc.project(&mut x);
@@ -615,7 +615,7 @@ fn t_is_convex_soc() {
 #[test]
 fn t_is_convex_zero() {
     let zero = Zero::new();
-    assert!(zero.is_convex());
+    assert!(Constraint::<f64>::is_convex(&zero));
 }
 
 #[test]
@@ -922,6 +922,170 @@ fn t_epigraph_squared_norm_correctness() {
     );
 }
 
+#[test]
+fn t_epigraph_squared_norm_optimality() {
+    // the projection, (w, tau), satisfies ||w||^2 = tau and the optimality
+    // condition z - w = 2 (tau - t) w, also in the extreme cases
+    let epi = EpigraphSquaredNorm::new();
+    let cases: [(f64, f64); 8] = [
+        (1.0, 0.0),
+        (1e-3, 0.7),
+        (1e-8, 0.51),
+        (1e-8, -1e6),
+        (1e5, 0.0),
+        (1e5, 1e3),
+        (3.0, -20.0),
+        (0.5, 0.5),
+    ];
+    for &(scale, t) in cases.iter() {
+        for n in 1..=5 {
+            let mut x = vec![0.0; n + 1];
+            x[..n]
+                .iter_mut()
+                .for_each(|xi| *xi = scale * (2. * rand::random::<f64>() - 1.));
+            x[n] = t;
+            let z = x[..n].to_vec();
+            if matrix_operations::norm2_squared(&z) <= t {
+                continue;
+            }
+            epi.project(&mut x);
+            let tau = x[n];
+            let norm_w_sq = matrix_operations::norm2_squared(&x[..n]);
+            assert!((norm_w_sq - tau).abs() <= 1e-12 * tau.max(1.));
+            assert!(tau >= t);
+            z.iter().zip(x[..n].iter()).for_each(|(zi, wi)| {
+                let residual = zi - wi - 2. * (tau - t) * wi;
+                assert!(residual.abs() <= 1e-10 * zi.abs().max(1.));
+            });
+        }
+    }
+}
+
+#[test]
+fn t_epigraph_squared_norm_large_t() {
+    // for a large t and ||z||^2 slightly larger than t, the scaling of the
+    // projection, s = z / w, is much smaller than |1 - 2t|; it must still
+    // solve the cubic equation s^2 (s - 1 + 2t) = 2 ||z||^2 accurately
+    let epi = EpigraphSquaredNorm::new();
+    let cases: [(f64, f64); 5] = [
+        (1e4, 1e-6),
+        (8e7, 1e-12),
+        (8e7, 1e-6),
+        (1e10, 1e-9),
+        (1e12, 1e-2),
+    ];
+    for &(t, excess) in cases.iter() {
+        let zi = (0.5 * t * (1. + excess)).sqrt();
+        let mut x = [zi, zi, t];
+        let norm_z_sq = 2. * zi * zi;
+        epi.project(&mut x);
+        assert!(x[2] >= t);
+        let s = zi / x[0];
+        let residual = s * s * (s - 1. + 2. * t) - 2. * norm_z_sq;
+        assert!(
+            residual.abs() <= 1e-12 * norm_z_sq,
+            "wrong projection on epigraph of squared norm (t = {})",
+            t
+        );
+    }
+}
+
+#[test]
+fn t_small_dimension_projections() {
+    // the unrolled kernels (dimensions up to 4) agree with the general case
+    let ball = Ball2::new(None, 0.7);
+    let soc = SecondOrderCone::new(0.8);
+    for n in 1..=8 {
+        for _ in 0..20 {
+            let x: Vec<f64> = (0..n).map(|_| 2. * rand::random::<f64>() - 1.).collect();
+            let mut x_ball = x.clone();
+            ball.project(&mut x_ball);
+            let norm_x = matrix_operations::norm2(&x);
+            let expected: Vec<f64> = x.iter().map(|xi| xi * f64::min(1., 0.7 / norm_x)).collect();
+            unit_test_utils::assert_nearly_equal_array(&expected, &x_ball, 1e-12, 1e-14, "ball2");
+            if n >= 2 {
+                let mut x_soc = x.clone();
+                soc.project(&mut x_soc);
+                let norm_z = matrix_operations::norm2(&x_soc[..n - 1]);
+                assert!(norm_z <= 0.8 * x_soc[n - 1] + 1e-12);
+            }
+        }
+    }
+}
+
+/// Checks that `project_blocks` agrees with the projection of every block
+fn check_project_blocks<C: Constraint + BlockProjection>(set: &C, dim: usize, num_blocks: usize) {
+    let x: Vec<f64> = (0..dim * num_blocks)
+        .map(|_| 3. * (2. * rand::random::<f64>() - 1.))
+        .collect();
+    let mut x_blocks = x.clone();
+    set.project_blocks(&mut x_blocks, num_blocks);
+    for k in 0..num_blocks {
+        let mut block: Vec<f64> = (0..dim).map(|j| x[j * num_blocks + k]).collect();
+        set.project(&mut block);
+        let projected_block: Vec<f64> = (0..dim).map(|j| x_blocks[j * num_blocks + k]).collect();
+        unit_test_utils::assert_nearly_equal_array(
+            &block,
+            &projected_block,
+            1e-12,
+            1e-14,
+            "wrong projection of block",
+        );
+    }
+}
+
+#[test]
+fn t_project_blocks() {
+    let center = [0.5, -0.5, 1.0, 0.0, 2.0];
+    for &num_blocks in [1, 7, 8, 19].iter() {
+        for dim in 2..=5 {
+            check_project_blocks(&Ball2::new(None, 1.5), dim, num_blocks);
+            check_project_blocks(&Ball2::new(Some(&center[..dim]), 1.5), dim, num_blocks);
+            check_project_blocks(&SecondOrderCone::new(0.5), dim, num_blocks);
+            check_project_blocks(&SecondOrderCone::new(2.0), dim, num_blocks);
+            check_project_blocks(&EpigraphSquaredNorm::new(), dim, num_blocks);
+        }
+        check_project_blocks(&Ball2::new(None, 1.5), 1, num_blocks);
+    }
+}
+
+#[test]
+fn t_homogeneous_cartesian_product() {
+    let cones = HomogeneousCartesianProduct::new(SecondOrderCone::new(1.0), 3);
+    assert_eq!(3, cones.num_blocks());
+    assert!(cones.is_convex());
+    let mut x = [
+        1.0, 0.0, 3.0, // first component of the three blocks
+        0.0, 1.0, 4.0, // second component
+        2.0, -2.0, 0.0, // third component
+    ];
+    cones.project(&mut x);
+    let beta = 2.5;
+    unit_test_utils::assert_nearly_equal_array(
+        &[1.0, 0.0, 0.6 * beta, 0.0, 0.0, 0.8 * beta, 2.0, 0.0, beta],
+        &x,
+        1e-12,
+        1e-14,
+        "wrong projection on the product of cones",
+    );
+}
+
+#[test]
+#[should_panic]
+fn t_homogeneous_cartesian_product_wrong_dimension() {
+    let balls = HomogeneousCartesianProduct::new(Ball2::new(None, 1.0), 3);
+    let mut x = [0.0; 7];
+    balls.project(&mut x);
+}
+
+#[test]
+#[should_panic]
+fn t_project_blocks_wrong_center() {
+    let center = [0.0; 2];
+    let mut x = [0.0; 9];
+    Ball2::new(Some(&center), 1.0).project_blocks(&mut x, 3);
+}
+
 #[test]
 fn t_affine_space() {
     let a = vec![
@@ -989,3 +1153,437 @@ fn t_affine_space_wrong_dimensions() {
     let b = vec![1., 2., -0.5];
     let _ = AffineSpace::new(a, b);
 }
+
+#[test]
+fn t_project_with_workspace() {
+    let n = 4;
+    let center = [0.5, -1.0, 0.2, 1.5];
+    let a = vec![
+        0.5, 0.1, 0.2, -0.3, -0.6, 0.3, 0., 0.5, 1.0, 0.1, -1.0, -0.4,
+    ];
+    let b = vec![1., 2., -0.5];
+    let simplex = Simplex::new(1.5);
+    let ball1 = Ball1::new(None, 0.7);
+    let ball1_at_center = Ball1::new(Some(&center), 0.7);
+    let affine_set = AffineSpace::new(a, b);
+    let cart_prod = CartesianProduct::new()
+        .add_constraint(2, Ball1::new(None, 0.3))
+        .add_constraint(n + 2, Simplex::new(2.0))
+        .add_constraint(n + 4, Ball2::new(None, 1.0));
+    let sets: [&dyn Constraint; 4] = [&simplex, &ball1, &ball1_at_center, &affine_set];
+    // the workspace may be larger than needed
+    let mut work = vec![0.0; 100];
+    for _ in 0..20 {
+        let mut x = vec![0.0; n + 4];
+        x.iter_mut()
+            .for_each(|xi| *xi = 4. * (2. * rand::random::<f64>() - 1.));
+        for set in sets.iter() {
+            let size = set.workspace_size(n);
+            let mut x_proj = x[..n].to_vec();
+            let mut x_proj_work = x[..n].to_vec();
+            set.project(&mut x_proj);
+            set.project_with_workspace(&mut x_proj_work, &mut work[..size]);
+            unit_test_utils::assert_nearly_equal_array(
+                &x_proj,
+                &x_proj_work,
+                1e-12,
+                1e-14,
+                "projection with workspace is wrong",
+            );
+        }
+        assert_eq!(2 * n, cart_prod.workspace_size(n + 4));
+        let mut x_proj = x.clone();
+        cart_prod.project(&mut x_proj);
+        cart_prod.project_with_workspace(&mut x, &mut work);
+        unit_test_utils::assert_nearly_equal_array(
+            &x_proj,
+            &x,
+            1e-12,
+            1e-14,
+            "projection with workspace is wrong",
+        );
+    }
+}
+
+#[test]
+#[should_panic]
+fn t_project_with_workspace_too_small() {
+    let simplex = Simplex::new(1.0);
+    let mut x = [1.0, 2.0, 3.0];
+    let mut work = [0.0; 5];
+    simplex.project_with_workspace(&mut x, &mut work);
+}
+
+#[test]
+fn t_project_from() {
+    let xmin = [-1.0, -2.0, 0.0, -1.0, -0.5, 0.0];
+    let xmax = [1.0, 0.5, 0.25, 2.0, 0.5, 3.0];
+    let xmin_short = [0.0, -1.0, 0.5];
+    let center = [0.5, -1.0, 0.2, 1.5, 0.0, 1.0];
+    let rectangle = Rectangle::new(Some(&xmin), Some(&xmax));
+    let rectangle_lower = Rectangle::new(Some(&xmin), None);
+    let rectangle_upper = Rectangle::new(None, Some(&xmax));
+    let rectangle_short = Rectangle::new(Some(&xmin_short), None);
+    let ball_inf = BallInf::new(None, 0.8);
+    let ball_inf_at_center = BallInf::new(Some(&center), 0.8);
+    let no_constraints = NoConstraints::new();
+    let zero = Zero::new();
+    let simplex = Simplex::new(1.5);
+    let cart_prod = CartesianProduct::new()
+        .add_constraint(2, Rectangle::new(Some(&xmin[..2]), Some(&xmax[..2])))
+        .add_constraint(4, Ball2::new(None, 1.0))
+        .add_constraint(6, BallInf::new(None, 0.1));
+    let static_cart_prod = StaticCartesianProduct::new(
+        &[3, 6],
+        (Rectangle::new(None, Some(&xmax[..3])), Simplex::new(1.0)),
+    );
+    let sets: [&dyn Constraint; 11] = [
+        &rectangle,
+        &rectangle_lower,
+        &rectangle_upper,
+        &rectangle_short,
+        &ball_inf,
+        &ball_inf_at_center,
+        &no_constraints,
+        &zero,
+        &simplex,
+        &cart_prod,
+        &static_cart_prod,
+    ];
+    let mut work = vec![0.0; 100];
+    for _ in 0..20 {
+        let source: Vec<f64> = (0..6)
+            .map(|_| 4. * (2. * rand::random::<f64>() - 1.))
+            .collect();
+        for set in sets.iter() {
+            let mut x_proj = source.clone();
+            set.project(&mut x_proj);
+            let mut x_proj_from = vec![std::f64::NAN; 6];
+            set.project_from(&source, &mut x_proj_from, &mut work);
+            assert_eq!(x_proj, x_proj_from, "projection from source is wrong");
+        }
+    }
+}
+
+#[test]
+#[should_panic]
+fn t_project_from_wrong_dimensions() {
+    let xmin = [-1.0, -2.0, 0.0];
+    let rectangle = Rectangle::new(Some(&xmin), None);
+    let mut x = [0.0; 2];
+    rectangle.project_from(&[1.0, 2.0, 3.0], &mut x, &mut []);
+}
+
+/// Banded matrix with `n_rows` rows and `n_rows + bandwidth` columns, row-wise
+fn banded_matrix(n_rows: usize, bandwidth: usize) -> Vec<f64> {
+    let n_cols = n_rows + bandwidth;
+    let mut a = vec![0.0; n_rows * n_cols];
+    for i in 0..n_rows {
+        for j in i..=i + bandwidth {
+            a[i * n_cols + j] = 2. * rand::random::<f64>() - 1. + if j == i { 3.0 } else { 0.0 };
+        }
+    }
+    a
+}
+
+/// Converts a dense row-wise matrix to CSR format
+fn dense_to_csr(a: &[f64], n_cols: usize) -> (Vec<usize>, Vec<usize>, Vec<f64>) {
+    let mut row_ptr = vec![0];
+    let mut col_idx = Vec::new();
+    let mut values = Vec::new();
+    a.chunks(n_cols).for_each(|row| {
+        row.iter()
+            .enumerate()
+            .filter(|(_, &a_ij)| a_ij != 0.0)
+            .for_each(|(j, &a_ij)| {
+                col_idx.push(j);
+                values.push(a_ij);
+            });
+        row_ptr.push(col_idx.len());
+    });
+    (row_ptr, col_idx, values)
+}
+
+#[test]
+fn t_sparse_affine_space() {
+    let a = vec![
+        0.5, 0.1, 0.2, -0.3, -0.6, 0.3, 0., 0.5, 1.0, 0.1, -1.0, -0.4,
+    ];
+    let b = vec![1., 2., -0.5];
+    let (row_ptr, col_idx, values) = dense_to_csr(&a, 4);
+    let affine_set = SparseAffineSpace::from_csr(4, row_ptr, col_idx, values, b);
+    let mut x = [1., -2., -0.3, 0.5];
+    affine_set.project(&mut x);
+    let x_correct = [
+        1.888564346697095,
+        5.629857182200888,
+        1.796204902230790,
+        2.888362906715977,
+    ];
+    unit_test_utils::assert_nearly_equal_array(
+        &x_correct,
+        &x,
+        1e-10,
+        1e-12,
+        "projection on sparse affine set is wrong",
+    );
+}
+
+#[test]
+fn t_sparse_affine_space_banded() {
+    let (n_rows, bandwidth) = (60, 3);
+    let n_cols = n_rows + bandwidth;
+    let a = banded_matrix(n_rows, bandwidth);
+    let b: Vec<f64> = (0..n_rows).map(|i| (i as f64).sin()).collect();
+    let (row_ptr, col_idx, values) = dense_to_csr(&a, n_cols);
+    let dense_set = AffineSpace::new(a.clone(), b.clone());
+    let sparse_set = SparseAffineSpace::from_csr(n_cols, row_ptr, col_idx, values, b.clone());
+    // AA' is banded, so the fill-reducing ordering leads to a banded factor
+    assert!(sparse_set.cholesky_nnz() <= n_rows * (bandwidth + 1));
+
+    let mut x_dense: Vec<f64> = (0..n_cols).map(|j| (j as f64).cos()).collect();
+    let mut x_sparse = x_dense.clone();
+    dense_set.project(&mut x_dense);
+    sparse_set.project(&mut x_sparse);
+    unit_test_utils::assert_nearly_equal_array(
+        &x_dense,
+        &x_sparse,
+        1e-8,
+        1e-10,
+        "sparse and dense projections differ",
+    );
+    // check that Ax = b
+    a.chunks(n_cols).zip(b.iter()).for_each(|(a_i, b_i)| {
+        unit_test_utils::assert_nearly_equal(
+            *b_i,
+            matrix_operations::inner_product(a_i, &x_sparse),
+            1e-8,
+            1e-10,
+            "Ax != b",
+        );
+    });
+}
+
+#[test]
+fn t_sparse_affine_space_csc() {
+    // A = [1 0 2; 0 3 1] in CSC format
+    let col_ptr = vec![0, 1, 2, 4];
+    let row_idx = vec![0, 1, 0, 1];
+    let values = vec![1., 3., 2., 1.];
+    let b = vec![1., -1.];
+    let csc_set = SparseAffineSpace::from_csc(col_ptr, row_idx, values, b.clone());
+    let csr_set =
+        SparseAffineSpace::from_csr(3, vec![0, 2, 4], vec![0, 2, 1, 2], vec![1., 2., 3., 1.], b);
+    let mut x_csc = [0.5, 1.5, -2.0];
+    let mut x_csr = x_csc;
+    csc_set.project(&mut x_csc);
+    csr_set.project(&mut x_csr);
+    unit_test_utils::assert_nearly_equal_array(
+        &x_csr,
+        &x_csc,
+        1e-12,
+        1e-14,
+        "CSC and CSR projections differ",
+    );
+    unit_test_utils::assert_nearly_equal(1.0, x_csc[0] + 2.0 * x_csc[2], 1e-10, 1e-12, "Ax != b");
+}
+
+#[test]
+#[should_panic]
+fn t_sparse_affine_space_rank_deficient() {
+    // A = [1 1; 2 2]
+    let _ = SparseAffineSpace::from_csr(
+        2,
+        vec![0, 2, 4],
+        vec![0, 1, 0, 1],
+        vec![1., 1., 2., 2.],
+        vec![1., 2.],
+    );
+}
+
+#[test]
+fn t_indexed_finite_set() {
+    let data: &[&[f64]] = &[&[0.0, 0.0], &[1.0, 1.0], &[0.0, 1.0], &[1.0, 0.0]];
+    let finite_set = IndexedFiniteSet::new(data);
+    let mut x = [0.7, 0.2];
+    finite_set.project(&mut x);
+    assert_eq!([1.0, 0.0], x);
+    let mut x = [-0.7, 0.2];
+    finite_set.project(&mut x);
+    assert_eq!([0.0, 0.0], x);
+    assert!(!finite_set.is_convex());
+}
+
+#[test]
+fn t_indexed_finite_set_random_matches_brute_force() {
+    for &dim in [1, 2, 3, 6].iter() {
+        // points on a grid (many ties) and random points
+        let points: Vec<Vec<f64>> = (0..2000)
+            .map(|k| {
+                (0..dim)
+                    .map(|_| {
+                        if k % 2 == 0 {
+                            (10. * rand::random::<f64>()).floor()
+                        } else {
+                            10. * rand::random::<f64>()
+                        }
+                    })
+                    .collect()
+            })
+            .collect();
+        let data: Vec<&[f64]> = points.iter().map(|p| p.as_slice()).collect();
+        let finite_set = FiniteSet::new(&data);
+        let indexed_finite_set = IndexedFiniteSet::new(&data);
+        for k in 0..500 {
+            let mut x: Vec<f64> = (0..dim).map(|_| 12. * rand::random::<f64>() - 1.).collect();
+            if k % 5 == 0 {
+                x.iter_mut().for_each(|xi| *xi = xi.round() + 0.5);
+            }
+            let mut x_indexed = x.clone();
+            finite_set.project(&mut x);
+            indexed_finite_set.project(&mut x_indexed);
+            assert_eq!(x, x_indexed);
+        }
+    }
+}
+
+#[test]
+#[should_panic]
+fn t_indexed_finite_set_inconsistent_dimensions() {
+    let x1 = vec![1.0; 2];
+    let x2 = vec![0.0; 3];
+    let data: &[&[f64]] = &[&x1, &x2];
+    let _f = IndexedFiniteSet::new(data);
+}
+
+#[test]
+fn t_static_cartesian_product() {
+    let xmin = [-0.5; 3];
+    let xmax = [0.5; 3];
+    let dynamic_product = CartesianProduct::new()
+        .add_constraint(3, Ball2::new(None, 1.0))
+        .add_constraint(6, Rectangle::new(Some(&xmin), Some(&xmax)))
+        .add_constraint(10, Simplex::new(2.0))
+        .add_constraint(13, SecondOrderCone::new(1.0));
+    let static_product = StaticCartesianProduct::new(
+        &[3, 6, 10, 13],
+        (
+            Ball2::new(None, 1.0),
+            Rectangle::new(Some(&xmin), Some(&xmax)),
+            Simplex::new(2.0),
+            SecondOrderCone::new(1.0),
+        ),
+    );
+    assert_eq!(13, static_product.dimension());
+    assert_eq!(8, static_product.workspace_size(13));
+    assert!(static_product.is_convex());
+    for _ in 0..100 {
+        let mut x: Vec<f64> = (0..13).map(|_| 10. * rand::random::<f64>() - 5.).collect();
+        let mut x_static = x.clone();
+        dynamic_product.project(&mut x);
+        static_product.project(&mut x_static);
+        assert_eq!(x, x_static);
+    }
+}
+
+#[test]
+fn t_static_cartesian_product_nested() {
+    let inner = StaticCartesianProduct::new(&[2, 4], (Ball2::new(None, 1.0), Zero::new()));
+    let outer = StaticCartesianProduct::new(&[4, 5], (inner, Ball2::new(None, 0.5)));
+    let mut x = [3.0, 4.0, 1.0, 2.0, -2.0];
+    outer.project(&mut x);
+    unit_test_utils::assert_nearly_equal_array(
+        &[0.6, 0.8, 0.0, 0.0, -0.5],
+        &x,
+        1e-12,
+        1e-14,
+        "wrong projection on nested static Cartesian product",
+    );
+}
+
+#[test]
+fn t_static_cartesian_product_parallel() {
+    let build = || {
+        StaticCartesianProduct::new(
+            &[200, 600, 800, 1000, 1400],
+            (
+                Ball2::new(None, 1.0),
+                Simplex::new(2.0),
+                Ball1::new(None, 1.5),
+                NoConstraints::new(),
+                Simplex::new(0.5),
+            ),
+        )
+    };
+    let sequential = build();
+    let parallel = build().with_parallel_projection(3, 1000);
+    // with 3 threads: blocks {0, 1}, {2, 3} and {4}, each with its own workspace
+    assert_eq!(800 + 600 + 800, parallel.workspace_size(1400));
+    // the dimension is smaller than the threshold
+    let not_parallel = build().with_parallel_projection(3, 2000);
+    assert_eq!(800, not_parallel.workspace_size(1400));
+    for _ in 0..10 {
+        let mut x: Vec<f64> = (0..1400)
+            .map(|_| 10. * rand::random::<f64>() - 5.)
+            .collect();
+        let mut x_parallel = x.clone();
+        sequential.project(&mut x);
+        parallel.project(&mut x_parallel);
+        assert_eq!(x, x_parallel);
+    }
+}
+
+#[test]
+#[should_panic]
+fn t_static_cartesian_product_wrong_indices() {
+    let _ = StaticCartesianProduct::new(&[3, 3], (Ball2::new(None, 1.0), Zero::new()));
+}
+
+#[test]
+fn t_projections_single_precision() {
+    let (xmin_single, xmax_single) = ([-1.0_f32; 2], [1.0_f32; 2]);
+    let (xmin_double, xmax_double) = ([-1.0_f64; 2], [1.0_f64; 2]);
+    let sets: [(&dyn Constraint<f32>, &dyn Constraint<f64>); 4] = [
+        (
+            &Rectangle::new(Some(&xmin_single), Some(&xmax_single)),
+            &Rectangle::new(Some(&xmin_double), Some(&xmax_double)),
+        ),
+        (&Ball2::new(None, 0.5), &Ball2::new(None, 0.5)),
+        (&BallInf::new(None, 0.5), &BallInf::new(None, 0.5)),
+        (&Simplex::new(1.0), &Simplex::new(1.0)),
+    ];
+    for (set_single, set_double) in sets.iter() {
+        let mut x_single = [3.0_f32, -0.25];
+        let mut x_double = [3.0_f64, -0.25];
+        set_single.project(&mut x_single);
+        set_double.project(&mut x_double);
+        unit_test_utils::assert_nearly_equal_array(
+            &x_double,
+            &[x_single[0] as f64, x_single[1] as f64],
+            1e-6,
+            1e-7,
+            "single-precision projection",
+        );
+    }
+}
+
+#[test]
+fn t_cartesian_product_single_precision() {
+    let product = CartesianProduct::new()
+        .add_constraint(2, Ball2::new(None, 1.0_f32))
+        .add_constraint(4, Zero::new());
+    let static_product =
+        StaticCartesianProduct::new(&[2, 4], (Ball2::new(None, 1.0_f32), Zero::new()));
+    let mut x = [3.0_f32, 4.0, 5.0, 6.0];
+    let mut y = x;
+    product.project(&mut x);
+    static_product.project(&mut y);
+    assert_eq!(x, y);
+    unit_test_utils::assert_nearly_equal_array(
+        &[0.6, 0.8, 0.0, 0.0],
+        &[x[0] as f64, x[1] as f64, x[2] as f64, x[3] as f64],
+        1e-6,
+        1e-7,
+        "projection",
+    );
+}
@@ -1,4 +1,5 @@
 use super::Constraint;
+use crate::Scalar;
 
 #[derive(Clone, Copy, Default)]
 /// Set Zero, $\\{0\\}$
@@ -11,11 +12,19 @@ impl Zero {
     }
 }
 
-impl Constraint for Zero {
+impl<T: Scalar> Constraint<T> for Zero {
     /// Computes the projection on $\\{0\\}$, that is, $\Pi_{\\{0\\}}(x) = 0$
     /// for all $x$
-    fn project(&self, x: &mut [f64]) {
-        x.iter_mut().for_each(|xi| *xi = 0.0);
+    fn project(&self, x: &mut [T]) {
+        x.iter_mut().for_each(|xi| *xi = T::zero());
+    }
+
+    fn project_from(&self, source: &[T], x: &mut [T], _work: &mut [T]) {
+        assert!(
+            source.len() == x.len(),
+            "source and x have different lengths"
+        );
+        self.project(x);
     }
 
     fn is_convex(&self) -> bool {
@@ -0,0 +1,310 @@
+//! Anderson acceleration of fixed-point iterations
+//!
+//! Both FBS and PANOC are fixed-point iterations, $u^{k+1} = g(u^k)$, where
+//! $g(u) = \Pi_U(u - \gamma \nabla f(u))$ is the forward-backward map.
+//! Anderson acceleration (AA) with memory $m$ combines the last $m$ values of
+//! $g$: given the residual $f_k = g(u^k) - u^k$ and the matrices
+//! $\Delta F_k$ and $\Delta G_k$ whose columns are the differences of the last
+//! $m$ consecutive residuals and values of $g$, respectively, the accelerated
+//! iterate is
+//!
+//! $$
+//! u^{k+1}_{\rm AA} = g(u^k) - \Delta G_k \gamma^k,
+//! \quad
+//! \gamma^k = \mathrm{argmin}_\gamma \Vert f_k - \Delta F_k \gamma \Vert^2
+//!            + \lambda \Vert \Delta F_k \Vert_F^2 \Vert\gamma\Vert^2,
+//! $$
+//!
+//! where $\lambda$ is a (small) regularisation parameter. The coefficients
+//! $\gamma^k$ are computed by a Cholesky factorisation of the (regularised)
+//! $m\times m$ Gram matrix $\Delta F_k^\top \Delta F_k$, which is updated by one
+//! row and column per iteration.
+//!
+//! AA is often more effective than L-BFGS on strongly convex, badly scaled
+//! problems. It is used by FBS (see `FBSCache::with_anderson_acceleration`),
+//! with a safeguard, and by PANOC (see `PANOCCache::with_anderson_acceleration`),
+//! where $u^k - u^{k+1}_{\rm AA}$ replaces the L-BFGS direction.
+//!
+use crate::{matrix_operations, Scalar};
+
+/// Default regularisation parameter of the least squares problem
+const DEFAULT_REGULARIZATION: f64 = 1e-10;
+
+/// Anderson acceleration memory
+///
+/// This structure allocates, once, all the memory that is needed to compute
+/// Anderson-accelerated iterates, namely `(2 * memory + 3) * problem_size`
+/// floats for the differences of the residuals and of the values of the
+/// fixed-point map, and `2 * memory^2 + memory` floats for the least squares
+/// problem
+#[derive(Debug, Clone)]
+pub struct AndersonCache<T: Scalar = f64> {
+    /// Differences of consecutive residuals (circular buffer)
+    df: Vec<Vec<T>>,
+    /// Differences of consecutive values of the fixed-point map (circular buffer)
+    dg: Vec<Vec<T>>,
+    /// Current residual
+    f: Vec<T>,
+    /// Previous residual
+    f_previous: Vec<T>,
+    /// Previous value of the fixed-point map
+    g_previous: Vec<T>,
+    /// Whether `f_previous` and `g_previous` are available
+    has_previous: bool,
+    /// Number of differences in the buffer
+    active_size: usize,
+    /// Position of the next difference in the circular buffer
+    next: usize,
+    /// Gram matrix of the differences of the residuals (`memory` x `memory`, row-major)
+    gram: Vec<T>,
+    /// Cholesky factor of the regularised Gram matrix (`memory` x `memory`, row-major)
+    factor: Vec<T>,
+    /// Coefficients of the differences in the accelerated iterate
+    coefficients: Vec<T>,
+    /// Regularisation parameter
+    regularization: T,
+}
+
+impl<T: Scalar> AndersonCache<T> {
+    /// Constructs a new Anderson acceleration memory
+    ///
+    /// ## Arguments
+    ///
+    /// - `problem_size`: dimension of the fixed-point iteration
+    /// - `memory`: number of differences that are kept (typically, 3 to 10)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `problem_size` or `memory` is zero
+    ///
+    pub fn new(problem_size: usize, memory: usize) -> Self {
+        assert!(problem_size > 0, "problem_size must be positive");
+        assert!(memory > 0, "memory must be positive");
+        AndersonCache {
+            df: vec![vec![T::zero(); problem_size]; memory],
+            dg: vec![vec![T::zero(); problem_size]; memory],
+            f: vec![T::zero(); problem_size],
+            f_previous: vec![T::zero(); problem_size],
+            g_previous: vec![T::zero(); problem_size],
+            has_previous: false,
+            active_size: 0,
+            next: 0,
+            gram: vec![T::zero(); memory * memory],
+            factor: vec![T::zero(); memory * memory],
+            coefficients: vec![T::zero(); memory],
+            regularization: T::from_f64(DEFAULT_REGULARIZATION),
+        }
+    }
+
+    /// Sets the regularisation parameter, `lambda`, of the least squares
+    /// problem (the default value is `1e-10`)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `regularization` is negative
+    ///
+    pub fn with_regularization(mut self, regularization: T) -> Self {
+        assert!(
+            regularization >= T::zero(),
+            "regularization must be nonnegative"
+        );
+        self.regularization = regularization;
+        self
+    }
+
+    /// Number of differences that are kept
+    pub fn memory(&self) -> usize {
+        self.df.len()
+    }
+
+    /// Empties the memory
+    pub fn reset(&mut self) {
+        self.has_previous = false;
+        self.active_size = 0;
+        self.next = 0;
+    }
+
+    /// Value of the fixed-point map that was given in the previous call of
+    /// `accelerate` (if any)
+    pub(crate) fn previous_fixed_point_step(&self) -> Option<&[T]> {
+        if self.has_previous {
+            Some(&self.g_previous)
+        } else {
+            None
+        }
+    }
+
+    /// Stores the pair `(u, g)`, where `g` is the value of the fixed-point map
+    /// at `u`, and computes the accelerated iterate
+    ///
+    /// ## Arguments
+    ///
+    /// - `u`: current iterate
+    /// - `g`: value of the fixed-point map at `u`
+    /// - `u_accelerated`: on exit, the accelerated iterate
+    ///
+    /// ## Returns
+    ///
+    /// `true` if the iterate is accelerated; `false` if `u_accelerated` is
+    /// equal to `g`, which is the case when the memory is empty, or when the
+    /// least squares problem is ill-conditioned (then, the memory is emptied)
+    ///
+    pub fn accelerate(&mut self, u: &[T], g: &[T], u_accelerated: &mut [T]) -> bool {
+        // f ← g - u
+        self.f
+            .iter_mut()
+            .zip(g.iter())
+            .zip(u.iter())
+            .for_each(|((f, &g), &u)| *f = g - u);
+
+        if self.has_previous {
+            let memory = self.memory();
+            let j = self.next;
+            self.df[j]
+                .iter_mut()
+                .zip(self.f.iter())
+                .zip(self.f_previous.iter())
+                .for_each(|((df, &f), &f_prev)| *df = f - f_prev);
+            self.dg[j]
+                .iter_mut()
+                .zip(g.iter())
+                .zip(self.g_previous.iter())
+                .for_each(|((dg, &g), &g_prev)| *dg = g - g_prev);
+            self.active_size = usize::min(self.active_size + 1, memory);
+            // new row and column of the Gram matrix
+            for i in 0..self.active_size {
+                let gram_ij = matrix_operations::inner_product(&self.df[i], &self.df[j]);
+                self.gram[i * memory + j] = gram_ij;
+                self.gram[j * memory + i] = gram_ij;
+            }
+            self.next = (j + 1) % memory;
+        }
+        self.f_previous.copy_from_slice(&self.f);
+        self.g_previous.copy_from_slice(g);
+        self.has_previous = true;
+
+        if self.active_size == 0 || !self.solve_least_squares() {
+            u_accelerated.copy_from_slice(g);
+            return false;
+        }
+
+        // u_accelerated ← g - dG * coefficients
+        u_accelerated.copy_from_slice(g);
+        for (dg, &c) in self
+            .dg
+            .iter()
+            .zip(self.coefficients.iter())
+            .take(self.active_size)
+        {
+            u_accelerated
+                .iter_mut()
+                .zip(dg.iter())
+                .for_each(|(u, &dg)| *u -= c * dg);
+        }
+        true
+    }
+
+    /// Computes the coefficients of the differences by solving the
+    /// regularised normal equations; returns `false` (and empties the
+    /// memory) if the Gram matrix is numerically singular
+    fn solve_least_squares(&mut self) -> bool {
+        let memory = self.memory();
+        let k = self.active_size;
+        let trace = (0..k).map(|i| self.gram[i * memory + i]).sum::<T>();
+        if !(trace > T::zero()) || !trace.is_finite() {
+            self.reset();
+            return false;
+        }
+        let shift = self.regularization * trace;
+
+        // Cholesky factorisation: factor * factor' = gram + shift * I
+        for i in 0..k {
+            for j in 0..=i {
+                let mut s = self.gram[i * memory + j];
+                for l in 0..j {
+                    s -= self.factor[i * memory + l] * self.factor[j * memory + l];
+                }
+                if i == j {
+                    s += shift;
+                    if !(s > T::epsilon() * trace) {
+                        self.reset();
+                        return false;
+                    }
+                    self.factor[i * memory + i] = s.sqrt();
+                } else {
+                    self.factor[i * memory + j] = s / self.factor[j * memory + j];
+                }
+            }
+        }
+
+        // coefficients ← (factor * factor') \ (dF' f)
+        for i in 0..k {
+            let mut s = matrix_operations::inner_product(&self.df[i], &self.f);
+            for l in 0..i {
+                s -= self.factor[i * memory + l] * self.coefficients[l];
+            }
+            self.coefficients[i] = s / self.factor[i * memory + i];
+        }
+        for i in (0..k).rev() {
+            let mut s = self.coefficients[i];
+            for l in i + 1..k {
+                s -= self.factor[l * memory + i] * self.coefficients[l];
+            }
+            self.coefficients[i] = s / self.factor[i * memory + i];
+        }
+        true
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+
+    use super::*;
+
+    /// Affine contraction g(u) = Au + b, with fixed point u* = (1, 2, 3)
+    fn affine_map(u: &[f64], g: &mut [f64]) {
+        g[0] = 0.9 * u[0] + 0.1;
+        g[1] = 0.5 * u[1] + 0.2 * u[2] + 0.4;
+        g[2] = -0.3 * u[1] + 0.95 * u[2] + 0.75;
+    }
+
+    #[test]
+    fn t_anderson_first_step() {
+        let mut anderson = AndersonCache::new(3, 2);
+        let u = [0.0; 3];
+        let mut g = [0.0; 3];
+        let mut u_next = [0.0; 3];
+        affine_map(&u, &mut g);
+        // with an empty memory, the iterate is the fixed-point step
+        assert!(!anderson.accelerate(&u, &g, &mut u_next));
+        assert_eq!(g, u_next);
+        assert_eq!(Some(&g[..]), anderson.previous_fixed_point_step());
+        anderson.reset();
+        assert!(anderson.previous_fixed_point_step().is_none());
+    }
+
+    #[test]
+    fn t_anderson_affine_map() {
+        // for an affine map, AA with memory n terminates in at most n + 1 steps
+        let mut anderson = AndersonCache::new(3, 3);
+        let mut u = [0.0; 3];
+        let mut g = [0.0; 3];
+        let mut u_next = [0.0; 3];
+        for _ in 0..5 {
+            affine_map(&u, &mut g);
+            anderson.accelerate(&u, &g, &mut u_next);
+            u.copy_from_slice(&u_next);
+        }
+        unit_test_utils::assert_nearly_equal_array(&[1.0, 2.0, 3.0], &u, 1e-6, 1e-8, "u");
+
+        // the plain fixed-point iteration is still far from the fixed point
+        let mut u_plain = [0.0; 3];
+        for _ in 0..5 {
+            affine_map(&u_plain.clone(), &mut u_plain);
+        }
+        assert!((u_plain[0] - 1.0).abs() > 0.1);
+    }
+}
@@ -0,0 +1,164 @@
+//! Deadlines of hard real-time (anytime) solves
+//!
+//! With `with_max_duration`, the solvers read the clock at every iteration
+//! and stop as soon as the maximum duration has been exceeded, so a solve may
+//! overrun by up to one iteration. With `with_deadline`, the solvers
+//! instead use a prediction of the time per iteration, $t_{\rm it}$, so that
+//! the solver stops before the deadline:
+//!
+//! - the clock is read only every $k$ iterations, where $k$ is chosen so that
+//!   the next $k$ iterations are predicted to use at most half of the
+//!   remaining time (so, $k$ is large far from the deadline and becomes $1$
+//!   close to it),
+//! - the solver stops when the remaining time is less than $2 t_{\rm it}$,
+//!   which leaves the time of one iteration to finish the solve.
+//!
+//! The prediction is an exponential moving average of the measured time per
+//! iteration (which jumps up immediately when iterations become slower), and
+//! it is stored in `PANOCCache`, so it is learnt across solves. As a result,
+//! the solve does not exceed the deadline unless an iteration takes more than
+//! twice the predicted time.
+//!
+use instant::Instant;
+use std::time::Duration;
+
+/// Weight of the latest measurement in the moving average of the time per iteration
+const ITERATION_TIME_WEIGHT: f64 = 0.2;
+
+/// Maximum number of iterations between two consecutive clock reads
+const MAX_ITERATIONS_BETWEEN_CHECKS: usize = 64;
+
+/// Deadline of a solve, with a prediction of the time per iteration
+/// (see the module documentation)
+#[derive(Debug, Clone, Copy)]
+pub(crate) struct Deadline {
+    /// Available time, measured from `start`
+    budget: Duration,
+    /// Start of the solve (`None` until the deadline is started)
+    start: Option<Instant>,
+    /// Time of the last clock read
+    last_check: Option<Instant>,
+    /// Iterations since the last clock read
+    iterations_since_check: usize,
+    /// Iterations until the next clock read
+    iterations_to_next_check: usize,
+}
+
+impl Deadline {
+    /// New deadline, `budget` after the time it is started
+    pub(crate) fn new(budget: Duration) -> Self {
+        Deadline {
+            budget,
+            start: None,
+            last_check: None,
+            iterations_since_check: 0,
+            iterations_to_next_check: 1,
+        }
+    }
+
+    /// Starts the clock, unless the deadline has already been started, and
+    /// plans the first clock read using the predicted time per iteration
+    /// (in seconds; zero if there is no prediction yet)
+    pub(crate) fn start(&mut self, iteration_time: f64) {
+        let now = Instant::now();
+        if self.start.is_none() {
+            self.start = Some(now);
+        }
+        self.last_check = Some(now);
+        self.iterations_since_check = 0;
+        self.iterations_to_next_check = 1;
+        if iteration_time > 0.0 {
+            self.plan_next_check(self.remaining_seconds(now), iteration_time);
+        }
+    }
+
+    /// Time left until the deadline (in seconds) at time `now`
+    fn remaining_seconds(&self, now: Instant) -> f64 {
+        let elapsed = self.start.map_or(0.0, |start| (now - start).as_secs_f64());
+        self.budget.as_secs_f64() - elapsed
+    }
+
+    fn plan_next_check(&mut self, remaining: f64, iteration_time: f64) {
+        let iterations = (0.5 * remaining / iteration_time) as usize;
+        self.iterations_to_next_check = iterations.clamp(1, MAX_ITERATIONS_BETWEEN_CHECKS);
+    }
+
+    /// Whether the time left is enough for `iterations` iterations, which
+    /// are predicted to take `iteration_time` seconds each (reads the clock)
+    pub(crate) fn has_time_for(&self, iterations: usize, iteration_time: f64) -> bool {
+        self.remaining_seconds(Instant::now()) >= iterations as f64 * iteration_time
+    }
+
+    /// Called once per iteration; returns `true` if the solver must stop to
+    /// meet the deadline
+    ///
+    /// The clock is only read when the planned number of iterations since the
+    /// last read has been performed; then, the predicted time per iteration,
+    /// `iteration_time` (in seconds), is updated.
+    pub(crate) fn should_stop(&mut self, iteration_time: &mut f64) -> bool {
+        self.iterations_since_check += 1;
+        if self.iterations_since_check < self.iterations_to_next_check {
+            return false;
+        }
+        let now = Instant::now();
+        let since_check = self
+            .last_check
+            .map_or(0.0, |last| (now - last).as_secs_f64());
+        let measured = since_check / self.iterations_since_check as f64;
+        *iteration_time = if *iteration_time > 0.0 {
+            f64::max(
+                measured,
+                (1.0 - ITERATION_TIME_WEIGHT) * *iteration_time + ITERATION_TIME_WEIGHT * measured,
+            )
+        } else {
+            measured
+        };
+        self.last_check = Some(now);
+        self.iterations_since_check = 0;
+
+        let remaining = self.remaining_seconds(now);
+        if remaining < 2.0 * *iteration_time {
+            return true;
+        }
+        self.plan_next_check(remaining, *iteration_time);
+        false
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+
+    use super::*;
+
+    #[test]
+    fn t_deadline_clock_reads() {
+        // with a prediction of 1us per iteration and a budget of 1s, the clock
+        // is read only every MAX_ITERATIONS_BETWEEN_CHECKS iterations
+        let mut deadline = Deadline::new(Duration::from_secs(1));
+        deadline.start(1e-6);
+        let mut iteration_time = 1e-6;
+        for _ in 1..MAX_ITERATIONS_BETWEEN_CHECKS {
+            assert!(!deadline.should_stop(&mut iteration_time));
+        }
+        assert_eq!(1e-6, iteration_time);
+        assert!(!deadline.should_stop(&mut iteration_time));
+        // the (much shorter) measured time per iteration lowers the prediction
+        assert!(iteration_time < 1e-6);
+        assert!(deadline.has_time_for(2, iteration_time));
+    }
+
+    #[test]
+    fn t_deadline_expired() {
+        let mut deadline = Deadline::new(Duration::from_millis(5));
+        deadline.start(0.0);
+        let mut iteration_time = 0.0;
+        std::thread::sleep(Duration::from_millis(3));
+        // the iteration took about 3ms, so there is no time for another one
+        assert!(deadline.should_stop(&mut iteration_time));
+        assert!(iteration_time >= 3e-3);
+        assert!(!deadline.has_time_for(2, iteration_time));
+    }
+}
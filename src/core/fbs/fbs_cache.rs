@@ -1,19 +1,28 @@
 //! FBS Cache
 //!
+use crate::{constraints::Constraint, core::anderson::AndersonCache, Scalar};
 use std::num::NonZeroUsize;
 
 /// Cache for the forward-backward splitting (FBS), or projected gradient, algorithm
 ///
-/// This struct allocates memory needed for the FBS algorithm
-pub struct FBSCache {
-    pub(crate) work_gradient_u: Vec<f64>,
-    pub(crate) work_u_previous: Vec<f64>,
-    pub(crate) gamma: f64,
-    pub(crate) tolerance: f64,
-    pub(crate) norm_fpr: f64,
+/// This struct allocates memory needed for the FBS algorithm; the decision
+/// variables are of type `T`, which is `f64` by default
+pub struct FBSCache<T: Scalar = f64> {
+    pub(crate) work_gradient_u: Vec<T>,
+    pub(crate) work_u_previous: Vec<T>,
+    pub(crate) gamma: T,
+    pub(crate) tolerance: T,
+    pub(crate) norm_fpr: T,
+    pub(crate) projection_workspace: Vec<T>,
+    /// Anderson acceleration memory (if the iterations are accelerated)
+    pub(crate) anderson: Option<AndersonCache<T>>,
+    /// Whether the current iterate is an accelerated one
+    pub(crate) accelerated: bool,
+    /// Norm of the fixed-point residual at the previous iterate
+    pub(crate) norm_fpr_previous: T,
 }
 
-impl FBSCache {
+impl<T: Scalar> FBSCache<T> {
     /// Construct a new instance of `FBSCache`
     ///
     /// ## Arguments
@@ -37,13 +46,65 @@ impl FBSCache {
     /// This method will panic if there is no available memory for the required allocation
     /// (capacity overflow)
     ///
-    pub fn new(n: NonZeroUsize, gamma: f64, tolerance: f64) -> FBSCache {
+    pub fn new(n: NonZeroUsize, gamma: T, tolerance: T) -> FBSCache<T> {
         FBSCache {
-            work_gradient_u: vec![0.0; n.get()],
-            work_u_previous: vec![0.0; n.get()],
+            work_gradient_u: vec![T::zero(); n.get()],
+            work_u_previous: vec![T::zero(); n.get()],
             gamma,
             tolerance,
-            norm_fpr: std::f64::INFINITY,
+            norm_fpr: T::infinity(),
+            projection_workspace: Vec::new(),
+            anderson: None,
+            accelerated: false,
+            norm_fpr_previous: T::infinity(),
+        }
+    }
+
+    /// Accelerates the iterations using Anderson acceleration
+    /// (see [`AndersonCache`](../anderson/struct.AndersonCache.html))
+    ///
+    /// The accelerated iterates are projected on the set of constraints, so
+    /// all iterates are feasible. An accelerated iterate is rejected, and the
+    /// memory is emptied, if its fixed-point residual is larger than that of
+    /// the previous iterate; then, the algorithm takes a plain forward-backward
+    /// step from the previous iterate instead.
+    ///
+    /// ## Arguments
+    ///
+    /// - `memory`: number of previous iterates that are combined
+    ///
+    /// ## Memory allocation
+    ///
+    /// This method allocates `(2 * memory + 3) * n + 2 * memory^2 + memory` floats
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `memory` is zero
+    ///
+    pub fn with_anderson_acceleration(mut self, memory: usize) -> Self {
+        let n = self.work_gradient_u.len();
+        self.anderson = Some(AndersonCache::new(n, memory));
+        self
+    }
+
+    /// Allocates the scratch workspace needed to project on the given set
+    /// of constraints, so that no memory is allocated by the solver
+    /// (see `Constraint::project_with_workspace`)
+    ///
+    /// ## Arguments
+    ///
+    /// - `constraints`: set of constraints of the optimization problem
+    ///
+    pub fn with_projection_workspace<C: Constraint<T> + ?Sized>(mut self, constraints: &C) -> Self {
+        let size = constraints.workspace_size(self.work_gradient_u.len());
+        self.reserve_projection_workspace(size);
+        self
+    }
+
+    /// Makes sure that the projection workspace has at least `size` elements
+    pub(crate) fn reserve_projection_workspace(&mut self, size: usize) {
+        if self.projection_workspace.len() < size {
+            self.projection_workspace.resize(size, T::zero());
         }
     }
 }
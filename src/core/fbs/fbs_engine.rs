@@ -3,27 +3,29 @@
 use crate::{
     constraints,
     core::{fbs::FBSCache, AlgorithmEngine, Problem},
-    matrix_operations, FunctionCallResult, SolverError,
+    matrix_operations, FunctionCallResult, Scalar, SolverError,
 };
 
 /// The FBE Engine defines the steps of the FBE algorithm and the termination criterion
 ///
-pub struct FBSEngine<'a, GradientType, ConstraintType, CostType>
+pub struct FBSEngine<'a, GradientType, ConstraintType, CostType, T = f64>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
-    pub(crate) problem: Problem<'a, GradientType, ConstraintType, CostType>,
-    pub(crate) cache: &'a mut FBSCache,
+    pub(crate) problem: Problem<'a, GradientType, ConstraintType, CostType, T>,
+    pub(crate) cache: &'a mut FBSCache<T>,
 }
 
-impl<'a, GradientType, ConstraintType, CostType>
-    FBSEngine<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T>
+    FBSEngine<'a, GradientType, ConstraintType, CostType, T>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// Constructor for instances of `FBSEngine`
     ///
@@ -36,13 +38,15 @@ where
     ///
     /// An new instance of `FBSEngine`
     pub fn new(
-        problem: Problem<'a, GradientType, ConstraintType, CostType>,
-        cache: &'a mut FBSCache,
-    ) -> FBSEngine<'a, GradientType, ConstraintType, CostType> {
+        problem: Problem<'a, GradientType, ConstraintType, CostType, T>,
+        cache: &'a mut FBSCache<T>,
+    ) -> FBSEngine<'a, GradientType, ConstraintType, CostType, T> {
+        let n = cache.work_gradient_u.len();
+        cache.reserve_projection_workspace(problem.constraints.workspace_size(n));
         FBSEngine { problem, cache }
     }
 
-    fn gradient_step(&mut self, u_current: &mut [f64]) {
+    fn gradient_step(&mut self, u_current: &mut [T]) {
         assert_eq!(
             Ok(()),
             (self.problem.gradf)(u_current, &mut self.cache.work_gradient_u),
@@ -56,17 +60,70 @@ where
             .for_each(|(u, w)| *u -= self.cache.gamma * *w);
     }
 
-    fn projection_step(&mut self, u_current: &mut [f64]) {
-        self.problem.constraints.project(u_current);
+    fn projection_step(&mut self, u_current: &mut [T]) {
+        self.problem
+            .constraints
+            .project_with_workspace(u_current, &mut self.cache.projection_workspace);
+    }
+
+    /// Takes a forward-backward step from `work_u_previous`, that is,
+    /// `u_current ← g(work_u_previous)`, and computes the norm of the FPR
+    fn fixed_point_step(&mut self, u_current: &mut [T]) {
+        u_current.copy_from_slice(&self.cache.work_u_previous);
+        self.gradient_step(u_current); // compute the gradient
+        self.projection_step(u_current); // project
+        self.cache.norm_fpr =
+            matrix_operations::solver::norm_inf_diff(u_current, &self.cache.work_u_previous);
+    }
+
+    /// Accelerated step (see `FBSCache::with_anderson_acceleration`)
+    fn accelerated_step(&mut self, u_current: &mut [T]) -> bool {
+        self.cache.work_u_previous.copy_from_slice(u_current);
+        self.fixed_point_step(u_current);
+
+        // safeguard: if the residual at the accelerated iterate is larger than
+        // at the previous iterate, continue from the plain forward-backward
+        // step of the previous iterate instead
+        if self.cache.accelerated && self.cache.norm_fpr > self.cache.norm_fpr_previous {
+            let cache = &mut *self.cache;
+            if let Some(anderson) = cache.anderson.as_mut() {
+                if let Some(g_previous) = anderson.previous_fixed_point_step() {
+                    cache.work_u_previous.copy_from_slice(g_previous);
+                }
+                anderson.reset();
+            }
+            self.fixed_point_step(u_current);
+        }
+        self.cache.norm_fpr_previous = self.cache.norm_fpr;
+        if self.cache.norm_fpr <= self.cache.tolerance {
+            // the solution is the (feasible) forward-backward step
+            self.cache.accelerated = false;
+            return false;
+        }
+
+        // u_current ← projection(AA(work_u_previous, u_current)); the gradient
+        // buffer is used as a workspace, as it is recomputed in the next step
+        let cache = &mut *self.cache;
+        if let Some(anderson) = cache.anderson.as_mut() {
+            cache.accelerated = anderson.accelerate(
+                &cache.work_u_previous,
+                u_current,
+                &mut cache.work_gradient_u,
+            );
+            u_current.copy_from_slice(&cache.work_gradient_u);
+        }
+        self.projection_step(u_current);
+        true
     }
 }
 
-impl<'a, GradientType, ConstraintType, CostType> AlgorithmEngine
-    for FBSEngine<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T> AlgorithmEngine<T>
+    for FBSEngine<'a, GradientType, ConstraintType, CostType, T>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult + 'a,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult + 'a,
-    ConstraintType: constraints::Constraint + 'a,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult + 'a,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult + 'a,
+    ConstraintType: constraints::Constraint<T> + 'a,
 {
     /// Take a forward-backward step and check whether the algorithm should terminate
     ///
@@ -83,17 +140,25 @@ where
     ///
     /// The method may panick if the computation of the gradient of the cost function
     /// or the cost function panics.
-    fn step(&mut self, u_current: &mut [f64]) -> Result<bool, SolverError> {
+    fn step(&mut self, u_current: &mut [T]) -> Result<bool, SolverError> {
+        if self.cache.anderson.is_some() {
+            return Ok(self.accelerated_step(u_current));
+        }
         self.cache.work_u_previous.copy_from_slice(u_current); // cache the previous step
         self.gradient_step(u_current); // compute the gradient
         self.projection_step(u_current); // project
         self.cache.norm_fpr =
-            matrix_operations::norm_inf_diff(u_current, &self.cache.work_u_previous);
+            matrix_operations::solver::norm_inf_diff(u_current, &self.cache.work_u_previous);
 
         Ok(self.cache.norm_fpr > self.cache.tolerance)
     }
 
-    fn init(&mut self, _u_current: &mut [f64]) -> FunctionCallResult {
+    fn init(&mut self, _u_current: &mut [T]) -> FunctionCallResult {
+        if let Some(anderson) = self.cache.anderson.as_mut() {
+            anderson.reset();
+        }
+        self.cache.accelerated = false;
+        self.cache.norm_fpr_previous = T::infinity();
         Ok(())
     }
 }
@@ -6,7 +6,7 @@ use crate::{
         fbs::fbs_engine::FBSEngine, fbs::FBSCache, AlgorithmEngine, ExitStatus, Optimizer, Problem,
         SolverStatus,
     },
-    matrix_operations, FunctionCallResult, SolverError,
+    matrix_operations, FunctionCallResult, Scalar, SolverError,
 };
 use std::time;
 
@@ -21,24 +21,28 @@ const MAX_ITER: usize = 100_usize;
 /// The `FBSEngine` is supposed to be updated whenever you need to solve
 /// a different optimization problem.
 ///
+/// The decision variables are of type `T`, which is `f64` by default
+/// (see [`Scalar`](crate::Scalar))
 ///
-pub struct FBSOptimizer<'a, GradientType, ConstraintType, CostType>
+pub struct FBSOptimizer<'a, GradientType, ConstraintType, CostType, T = f64>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
-    fbs_engine: FBSEngine<'a, GradientType, ConstraintType, CostType>,
+    fbs_engine: FBSEngine<'a, GradientType, ConstraintType, CostType, T>,
     max_iter: usize,
     max_duration: Option<time::Duration>,
 }
 
-impl<'a, GradientType, ConstraintType, CostType>
-    FBSOptimizer<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T>
+    FBSOptimizer<'a, GradientType, ConstraintType, CostType, T>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// Constructs a new instance of `FBSOptimizer`
     ///
@@ -47,8 +51,8 @@ where
     /// - `problem`: problem definition
     /// - `cache`: instance of `FBSCache`
     pub fn new(
-        problem: Problem<'a, GradientType, ConstraintType, CostType>,
-        cache: &'a mut FBSCache,
+        problem: Problem<'a, GradientType, ConstraintType, CostType, T>,
+        cache: &'a mut FBSCache<T>,
     ) -> Self {
         FBSOptimizer {
             fbs_engine: FBSEngine::new(problem, cache),
@@ -64,9 +68,9 @@ where
     /// The method panics if the specified tolerance is not positive
     pub fn with_tolerance(
         self,
-        tolerance: f64,
-    ) -> FBSOptimizer<'a, GradientType, ConstraintType, CostType> {
-        assert!(tolerance > 0.0);
+        tolerance: T,
+    ) -> FBSOptimizer<'a, GradientType, ConstraintType, CostType, T> {
+        assert!(tolerance > T::zero());
 
         self.fbs_engine.cache.tolerance = tolerance;
         self
@@ -76,7 +80,7 @@ where
     pub fn with_max_iter(
         mut self,
         max_iter: usize,
-    ) -> FBSOptimizer<'a, GradientType, ConstraintType, CostType> {
+    ) -> FBSOptimizer<'a, GradientType, ConstraintType, CostType, T> {
         self.max_iter = max_iter;
         self
     }
@@ -85,20 +89,21 @@ where
     pub fn with_max_duration(
         mut self,
         max_duration: time::Duration,
-    ) -> FBSOptimizer<'a, GradientType, ConstraintType, CostType> {
+    ) -> FBSOptimizer<'a, GradientType, ConstraintType, CostType, T> {
         self.max_duration = Some(max_duration);
         self
     }
 }
 
-impl<'life, GradientType, ConstraintType, CostType> Optimizer
-    for FBSOptimizer<'life, GradientType, ConstraintType, CostType>
+impl<'life, GradientType, ConstraintType, CostType, T> Optimizer<T>
+    for FBSOptimizer<'life, GradientType, ConstraintType, CostType, T>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult + 'life,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult + 'life,
-    ConstraintType: constraints::Constraint + 'life,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult + 'life,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult + 'life,
+    ConstraintType: constraints::Constraint<T> + 'life,
 {
-    fn solve(&mut self, u: &mut [f64]) -> Result<SolverStatus, SolverError> {
+    fn solve(&mut self, u: &mut [T]) -> Result<SolverStatus, SolverError> {
         let now = instant::Instant::now();
 
         // Initialize - propagate error upstream, if any
@@ -120,7 +125,7 @@ where
         }
 
         // cost at the solution [propagate error upstream]
-        let mut cost_value: f64 = 0.0;
+        let mut cost_value = T::zero();
         (self.fbs_engine.problem.cost)(u, &mut cost_value)?;
 
         if !matrix_operations::is_finite(u) || !cost_value.is_finite() {
@@ -136,8 +141,8 @@ where
             },
             num_iter,
             now.elapsed(),
-            self.fbs_engine.cache.norm_fpr,
-            cost_value,
+            self.fbs_engine.cache.norm_fpr.as_f64(),
+            cost_value.as_f64(),
         ))
     }
 }
@@ -147,3 +147,43 @@ fn t_solve_fbs_many_times() {
         assert!(status.norm_fpr() < tolerance);
     }
 }
+
+#[test]
+fn t_solve_fbs_anderson() {
+    // badly scaled quadratic, f(u) = 0.5 * sum_i d_i (u_i - 1)^2, on a box
+    let d = [1.0, 10.0, 100.0, 1000.0];
+    let cost = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = 0.5
+            * u.iter()
+                .zip(d.iter())
+                .map(|(u, d)| d * (u - 1.0).powi(2))
+                .sum::<f64>();
+        Ok(())
+    };
+    let gradient = |u: &[f64], g: &mut [f64]| -> FunctionCallResult {
+        g.iter_mut()
+            .zip(u.iter().zip(d.iter()))
+            .for_each(|(g, (u, d))| *g = d * (u - 1.0));
+        Ok(())
+    };
+    let bounds = constraints::Rectangle::new(Some(&[-2.0; 4]), Some(&[5.0, 5.0, 5.0, 0.5]));
+    let n = NonZeroUsize::new(4).unwrap();
+    let (gamma, tolerance) = (1e-3, 1e-8);
+
+    let solve = |fbs_cache: &mut FBSCache| {
+        let mut u = [-1.0, 3.0, 0.0, -2.0];
+        let problem = Problem::new(&bounds, gradient, cost);
+        let mut optimizer = FBSOptimizer::new(problem, fbs_cache).with_max_iter(100_000);
+        let status = optimizer.solve(&mut u).unwrap();
+        assert!(status.has_converged());
+        unit_test_utils::assert_nearly_equal_array(&[1.0, 1.0, 1.0, 0.5], &u, 1e-5, 1e-6, "u");
+        status.iterations()
+    };
+
+    let iterations_plain = solve(&mut FBSCache::new(n, gamma, tolerance));
+    let mut fbs_cache = FBSCache::new(n, gamma, tolerance).with_anderson_acceleration(5);
+    let iterations_anderson = solve(&mut fbs_cache);
+    assert!(10 * iterations_anderson < iterations_plain);
+    // the same cache can be reused
+    assert_eq!(iterations_anderson, solve(&mut fbs_cache));
+}
@@ -0,0 +1,258 @@
+//! Instrumentation of the phases of the solvers
+//!
+//! When OpEn is compiled with the feature `instrumentation`, PANOC and the
+//! ALM/PM method count how many times each [Phase](enum.Phase.html) of the
+//! algorithm is executed; with `instrumentation-timing`, they also measure
+//! the time spent in each phase. The result is a
+//! [SolverStatistics](struct.SolverStatistics.html) object, which is returned
+//! as part of the solver status.
+//!
+//! Without these features, `SolverStatistics` is a zero-sized type, nothing
+//! is recorded and all counts and times are equal to zero.
+//!
+//! Note that phases may be nested; for example, the projection which is
+//! computed in the line search counts both as a [Phase::HalfStep] and
+//! (as part of) a [Phase::Linesearch]. The time of a phase includes the time
+//! of its nested phases.
+//!
+use std::time;
+
+/// Number of phases (see [Phase](enum.Phase.html))
+pub const NUM_PHASES: usize = 9;
+
+/// Phase of an algorithm which is instrumented
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Phase {
+    /// Evaluation of the cost function
+    CostEvaluation = 0,
+    /// Evaluation of the gradient of the cost function
+    GradientEvaluation = 1,
+    /// Estimation of the initial local Lipschitz constant of the gradient
+    LipschitzEstimation = 2,
+    /// Iteration of the update (backtracking) of the Lipschitz constant
+    LipschitzUpdate = 3,
+    /// Half step, that is, projection on the set of constraints
+    HalfStep = 4,
+    /// Update of the L-BFGS buffer and computation of the L-BFGS direction
+    /// (or, with Anderson acceleration, computation of the Anderson direction)
+    LbfgsDirection = 5,
+    /// Iteration of the line search
+    Linesearch = 6,
+    /// Evaluation of the mapping `F1` (ALM-type constraints)
+    F1Evaluation = 7,
+    /// Evaluation of the mapping `F2` (PM-type constraints)
+    F2Evaluation = 8,
+}
+
+impl Phase {
+    /// All phases, in the order of their indices
+    pub const ALL: [Phase; NUM_PHASES] = [
+        Phase::CostEvaluation,
+        Phase::GradientEvaluation,
+        Phase::LipschitzEstimation,
+        Phase::LipschitzUpdate,
+        Phase::HalfStep,
+        Phase::LbfgsDirection,
+        Phase::Linesearch,
+        Phase::F1Evaluation,
+        Phase::F2Evaluation,
+    ];
+
+    /// Name of the phase in snake case (e.g., `cost_evaluation`)
+    pub fn name(self) -> &'static str {
+        match self {
+            Phase::CostEvaluation => "cost_evaluation",
+            Phase::GradientEvaluation => "gradient_evaluation",
+            Phase::LipschitzEstimation => "lipschitz_estimation",
+            Phase::LipschitzUpdate => "lipschitz_update",
+            Phase::HalfStep => "half_step",
+            Phase::LbfgsDirection => "lbfgs_direction",
+            Phase::Linesearch => "linesearch",
+            Phase::F1Evaluation => "f1_evaluation",
+            Phase::F2Evaluation => "f2_evaluation",
+        }
+    }
+}
+
+/// Number of executions and (optionally) duration of each phase of an algorithm
+///
+/// See the [module-level documentation](index.html) for details.
+///
+#[derive(Debug, Clone, Copy, PartialEq, Default)]
+pub struct SolverStatistics {
+    #[cfg(feature = "instrumentation")]
+    counts: [usize; NUM_PHASES],
+    #[cfg(feature = "instrumentation-timing")]
+    times: [time::Duration; NUM_PHASES],
+}
+
+impl SolverStatistics {
+    /// Constructs a new instance of `SolverStatistics` with all counts
+    /// and times equal to zero
+    pub fn new() -> SolverStatistics {
+        SolverStatistics::default()
+    }
+
+    /// Whether the counts are recorded (feature `instrumentation`)
+    pub const fn is_enabled() -> bool {
+        cfg!(feature = "instrumentation")
+    }
+
+    /// Whether the times are recorded (feature `instrumentation-timing`)
+    pub const fn is_timing_enabled() -> bool {
+        cfg!(feature = "instrumentation-timing")
+    }
+
+    /// Number of times the given phase was executed; always zero if
+    /// instrumentation is not enabled
+    pub fn count(&self, phase: Phase) -> usize {
+        #[cfg(feature = "instrumentation")]
+        {
+            self.counts[phase as usize]
+        }
+        #[cfg(not(feature = "instrumentation"))]
+        {
+            let _ = phase;
+            0
+        }
+    }
+
+    /// Total time spent in the given phase; always zero if timing is
+    /// not enabled
+    pub fn time(&self, phase: Phase) -> time::Duration {
+        #[cfg(feature = "instrumentation-timing")]
+        {
+            self.times[phase as usize]
+        }
+        #[cfg(not(feature = "instrumentation-timing"))]
+        {
+            let _ = phase;
+            time::Duration::from_secs(0)
+        }
+    }
+
+    /// Sets all counts and times to zero
+    pub(crate) fn reset(&mut self) {
+        *self = SolverStatistics::default();
+    }
+
+    /// Records one execution of `phase`, which started at `timer`
+    #[inline(always)]
+    pub(crate) fn record(&mut self, phase: Phase, timer: PhaseTimer) {
+        #[cfg(feature = "instrumentation")]
+        {
+            self.counts[phase as usize] += 1;
+        }
+        #[cfg(feature = "instrumentation-timing")]
+        {
+            self.times[phase as usize] += timer.start.elapsed();
+        }
+        let _ = (phase, timer);
+    }
+
+    /// Records `n` executions of `phase` without timing them
+    #[inline(always)]
+    pub(crate) fn add_count(&mut self, phase: Phase, n: usize) {
+        #[cfg(feature = "instrumentation")]
+        {
+            self.counts[phase as usize] += n;
+        }
+        let _ = (phase, n);
+    }
+
+    /// Adds the counts and times of `other` to those of `self`
+    #[inline(always)]
+    pub(crate) fn accumulate(&mut self, other: &SolverStatistics) {
+        #[cfg(feature = "instrumentation")]
+        {
+            self.counts
+                .iter_mut()
+                .zip(other.counts.iter())
+                .for_each(|(c, o)| *c += o);
+        }
+        #[cfg(feature = "instrumentation-timing")]
+        {
+            self.times
+                .iter_mut()
+                .zip(other.times.iter())
+                .for_each(|(t, o)| *t += *o);
+        }
+        let _ = other;
+    }
+}
+
+/// Start time of a phase; this is a zero-sized type unless the
+/// feature `instrumentation-timing` is enabled
+#[derive(Clone, Copy)]
+pub(crate) struct PhaseTimer {
+    #[cfg(feature = "instrumentation-timing")]
+    start: instant::Instant,
+}
+
+impl PhaseTimer {
+    /// Starts timing a phase
+    #[inline(always)]
+    pub(crate) fn start() -> PhaseTimer {
+        PhaseTimer {
+            #[cfg(feature = "instrumentation-timing")]
+            start: instant::Instant::now(),
+        }
+    }
+}
+
+/// Evaluates `$body` and records it as an execution of `$phase` in the
+/// statistics `$stats`; returns the value of `$body`
+macro_rules! instrumented {
+    ($stats:expr, $phase:expr, $body:expr) => {{
+        let timer = $crate::core::instrumentation::PhaseTimer::start();
+        let result = $body;
+        $stats.record($phase, timer);
+        result
+    }};
+}
+
+pub(crate) use instrumented;
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn t_statistics_record() {
+        let mut stats = SolverStatistics::new();
+        let x = instrumented!(stats, Phase::HalfStep, 1 + 1);
+        stats.record(Phase::HalfStep, PhaseTimer::start());
+        stats.add_count(Phase::GradientEvaluation, 2);
+        assert_eq!(2, x);
+        let expected = |n: usize| if SolverStatistics::is_enabled() { n } else { 0 };
+        assert_eq!(expected(2), stats.count(Phase::HalfStep));
+        assert_eq!(expected(2), stats.count(Phase::GradientEvaluation));
+        assert_eq!(0, stats.count(Phase::CostEvaluation));
+
+        let mut total = SolverStatistics::new();
+        total.accumulate(&stats);
+        total.accumulate(&stats);
+        assert_eq!(expected(4), total.count(Phase::HalfStep));
+        assert!(total.time(Phase::HalfStep) >= stats.time(Phase::HalfStep));
+
+        total.reset();
+        assert_eq!(SolverStatistics::new(), total);
+    }
+
+    #[test]
+    fn t_statistics_phase_indices() {
+        for (i, phase) in Phase::ALL.iter().enumerate() {
+            assert_eq!(i, *phase as usize);
+        }
+    }
+
+    #[cfg(not(feature = "instrumentation"))]
+    #[test]
+    fn t_statistics_zero_sized() {
+        assert_eq!(0, std::mem::size_of::<SolverStatistics>());
+        assert_eq!(0, std::mem::size_of::<PhaseTimer>());
+    }
+}
@@ -3,14 +3,21 @@
 //!
 //!
 
+pub mod anderson;
+pub(crate) mod deadline;
 pub mod fbs;
+pub mod instrumentation;
+pub mod multistart;
 pub mod panoc;
 pub mod problem;
 pub mod solver_status;
+pub mod trace;
 
-pub use crate::{constraints, FunctionCallResult, SolverError};
+pub use crate::{constraints, FunctionCallResult, Scalar, SolverError};
+pub use instrumentation::{Phase, SolverStatistics};
 pub use problem::Problem;
 pub use solver_status::SolverStatus;
+pub use trace::{IterationTrace, TraceRecord};
 
 /// Exit status of an algorithm (not algorithm specific)
 ///
@@ -29,12 +36,14 @@ pub enum ExitStatus {
 }
 
 /// A general optimizer
-pub trait Optimizer {
+///
+/// The decision variables are of type `T`, which is `f64` by default
+pub trait Optimizer<T: Scalar = f64> {
     /// solves a given problem and updates the initial estimate `u` with the solution
     ///
     /// Returns the solver status
     ///
-    fn solve(&mut self, u: &mut [f64]) -> Result<SolverStatus, SolverError>;
+    fn solve(&mut self, u: &mut [T]) -> Result<SolverStatus, SolverError>;
 }
 
 /// Engine supporting an algorithm
@@ -46,10 +55,10 @@ pub trait Optimizer {
 /// It defines what the algorithm does at every step (see `step`) and whether
 /// the specified termination criterion is satisfied
 ///
-pub trait AlgorithmEngine {
+pub trait AlgorithmEngine<T: Scalar = f64> {
     /// Take a step of the algorithm and return `Ok(true)` only if the iterations should continue
-    fn step(&mut self, u: &mut [f64]) -> Result<bool, SolverError>;
+    fn step(&mut self, u: &mut [T]) -> Result<bool, SolverError>;
 
     /// Initializes the algorithm
-    fn init(&mut self, u: &mut [f64]) -> FunctionCallResult;
+    fn init(&mut self, u: &mut [T]) -> FunctionCallResult;
 }
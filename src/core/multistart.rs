@@ -0,0 +1,462 @@
+//! Multi-start solving of nonconvex problems
+//!
+//! A nonconvex problem may have several local minimisers, and the solution
+//! that PANOC or ALM/PM returns depends on the initial guess. [`MultiStart`]
+//! solves a problem from several initial guesses concurrently, each with its
+//! own cache, and returns the best solution. The starts share the cost of the
+//! best feasible (converged) solution found so far, and a start whose cost
+//! exceeds it clearly (see [`MultiStart::with_margin`]) is abandoned early.
+//!
+//! # Example
+//!
+//! ```
+//! use optimization_engine::{constraints::*, multistart::*, panoc::*, *};
+//!
+//! // a nonconvex cost with a local minimiser at about -0.65 and the global
+//! // minimiser at about 0.75
+//! let cost = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+//!     *c = u[0].powi(4) - u[0].powi(2) - 0.2 * u[0];
+//!     Ok(())
+//! };
+//! let gradient = |u: &[f64], g: &mut [f64]| -> FunctionCallResult {
+//!     g[0] = 4.0 * u[0].powi(3) - 2.0 * u[0] - 0.2;
+//!     Ok(())
+//! };
+//! let bounds = Rectangle::new(Some(&[-2.0]), Some(&[2.0]));
+//!
+//! let mut caches: Vec<PANOCCache> = (0..2).map(|_| PANOCCache::new(1, 1e-8, 5)).collect();
+//! let mut initial_guesses = [-1.0, 1.0];
+//! let status = MultiStart::new().solve(&mut caches, &mut initial_guesses, 1, |cache, u, early_stop| {
+//!     let problem = Problem::new(&bounds, gradient, cost);
+//!     PANOCOptimizer::new(problem, cache)
+//!         .with_early_stop(early_stop)
+//!         .solve(u)
+//! });
+//! let best = status.best_index().unwrap();
+//! assert_eq!(1, best);
+//! assert!((initial_guesses[best] - 0.7526).abs() < 1e-3);
+//! ```
+//!
+use crate::{
+    core::{ExitStatus, SolverStatus},
+    SolverError,
+};
+use std::cell::Cell;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// Default margin of `MultiStart` (see `MultiStart::with_margin`)
+const DEFAULT_MARGIN: f64 = 0.1;
+
+/// Outcome of a solver that can be compared with the outcomes of other starts
+pub trait StartStatus {
+    /// Whether the solver has converged (to a feasible point)
+    fn is_converged(&self) -> bool;
+
+    /// Cost at the solution
+    fn cost_value(&self) -> f64;
+}
+
+impl StartStatus for SolverStatus {
+    fn is_converged(&self) -> bool {
+        self.has_converged()
+    }
+
+    fn cost_value(&self) -> f64 {
+        SolverStatus::cost_value(self)
+    }
+}
+
+/// Cost of the best feasible solution, which is shared by all starts
+struct BestCost {
+    /// Bits of the best cost (an `f64`)
+    bits: AtomicU64,
+    margin: f64,
+}
+
+impl BestCost {
+    fn get(&self) -> f64 {
+        f64::from_bits(self.bits.load(Ordering::Relaxed))
+    }
+
+    /// Replaces the best cost with `cost` if the latter is lower
+    fn update(&self, cost: f64) {
+        let mut current = self.bits.load(Ordering::Relaxed);
+        while cost < f64::from_bits(current) {
+            match self.bits.compare_exchange_weak(
+                current,
+                cost.to_bits(),
+                Ordering::Relaxed,
+                Ordering::Relaxed,
+            ) {
+                Ok(_) => break,
+                Err(actual) => current = actual,
+            }
+        }
+    }
+}
+
+/// Early-stopping criterion of one start
+///
+/// The optimizers check this criterion at every (outer) iteration; see
+/// `PANOCOptimizer::with_early_stop` and `AlmOptimizer::with_early_stop`
+pub struct EarlyStop<'a> {
+    best: &'a BestCost,
+    abandoned: Cell<bool>,
+}
+
+impl<'a> EarlyStop<'a> {
+    /// Cost of the best feasible solution that another start has found so
+    /// far (infinity if there is none)
+    pub fn best_cost(&self) -> f64 {
+        self.best.get()
+    }
+
+    /// Returns `true` iff a start at a point with the given cost should be
+    /// abandoned, that is, another start has found a feasible solution whose
+    /// cost is lower by more than the margin; the start is then marked as
+    /// abandoned
+    pub fn should_stop(&self, cost: f64) -> bool {
+        let best = self.best.get();
+        let dominated = cost > best + self.best.margin * f64::max(best.abs(), 1.0);
+        if dominated {
+            self.abandoned.set(true);
+        }
+        dominated
+    }
+
+    /// Whether this start has been abandoned
+    pub fn is_abandoned(&self) -> bool {
+        self.abandoned.get()
+    }
+}
+
+/// Result of one start
+#[derive(Debug)]
+pub struct StartOutcome<S> {
+    status: Result<S, SolverError>,
+    abandoned: bool,
+}
+
+impl<S> StartOutcome<S> {
+    /// Status returned by the solver (or the error)
+    pub fn status(&self) -> &Result<S, SolverError> {
+        &self.status
+    }
+
+    /// Whether the start was abandoned because another start found a clearly
+    /// better feasible solution; the solver then reports that it did not
+    /// converge (`ExitStatus::NotConvergedIterations`)
+    pub fn is_abandoned(&self) -> bool {
+        self.abandoned
+    }
+}
+
+/// Result of a multi-start solve
+#[derive(Debug)]
+pub struct MultiStartStatus<S> {
+    outcomes: Vec<StartOutcome<S>>,
+    best: Option<usize>,
+}
+
+impl<S> MultiStartStatus<S> {
+    /// Index of the best start: the converged start with the lowest cost or,
+    /// if no start has converged, the successful start with the lowest cost;
+    /// `None` if all starts have failed
+    pub fn best_index(&self) -> Option<usize> {
+        self.best
+    }
+
+    /// Status of the best start (see `best_index`)
+    pub fn best(&self) -> Option<&S> {
+        self.best
+            .and_then(|i| self.outcomes[i].status.as_ref().ok())
+    }
+
+    /// Outcomes of all starts, in the order of the initial guesses
+    pub fn outcomes(&self) -> &[StartOutcome<S>] {
+        &self.outcomes
+    }
+
+    /// Number of abandoned starts
+    pub fn num_abandoned(&self) -> usize {
+        self.outcomes.iter().filter(|o| o.abandoned).count()
+    }
+}
+
+/// Multi-start solver
+///
+/// Solves a problem from several initial guesses (see the [module-level
+/// documentation](index.html))
+#[derive(Debug, Clone, Copy)]
+pub struct MultiStart {
+    margin: f64,
+}
+
+impl Default for MultiStart {
+    fn default() -> Self {
+        MultiStart::new()
+    }
+}
+
+impl MultiStart {
+    /// Constructs a new multi-start solver
+    pub fn new() -> Self {
+        MultiStart {
+            margin: DEFAULT_MARGIN,
+        }
+    }
+
+    /// Sets the margin of the early-stopping criterion
+    ///
+    /// A start is abandoned when its cost exceeds `f + margin * max(|f|, 1)`,
+    /// where `f` is the cost of the best feasible solution found by another
+    /// start. Since the cost of a start may still decrease afterwards, this
+    /// is a heuristic; use `f64::INFINITY` to never abandon any start.
+    ///
+    /// ## Arguments
+    ///
+    /// - `margin`: nonnegative margin (default: `0.1`)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `margin` is negative or NaN
+    ///
+    pub fn with_margin(mut self, margin: f64) -> Self {
+        assert!(margin >= 0.0, "margin must be nonnegative");
+        self.margin = margin;
+        self
+    }
+
+    /// Solves the problem from all initial guesses
+    ///
+    /// The starts run on `min(caches.len(), number of starts)` threads; every
+    /// thread uses one of the caches and, when a start is finished, picks up
+    /// the next pending one.
+    ///
+    /// ## Arguments
+    ///
+    /// - `caches`: caches of the solver (at least one)
+    /// - `initial_guesses`: (on entry) initial guesses, (on exit) solutions of
+    ///   all starts, stored contiguously
+    /// - `num_decision_variables`: number of decision variables
+    /// - `solve_start`: solves the problem using the given cache and initial
+    ///   guess, and the given early-stopping criterion
+    ///
+    /// ## Returns
+    ///
+    /// The outcomes of all starts and the index of the best start
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if there is no cache, if `num_decision_variables` is
+    /// zero, or if the length of `initial_guesses` is not a multiple of it
+    ///
+    pub fn solve<T, C, S, F>(
+        &self,
+        caches: &mut [C],
+        initial_guesses: &mut [T],
+        num_decision_variables: usize,
+        solve_start: F,
+    ) -> MultiStartStatus<S>
+    where
+        T: Send,
+        C: Send,
+        S: StartStatus + Send,
+        F: Fn(&mut C, &mut [T], &EarlyStop) -> Result<S, SolverError> + Sync,
+    {
+        assert!(!caches.is_empty(), "there must be at least one cache");
+        assert!(
+            num_decision_variables > 0,
+            "num_decision_variables must be positive"
+        );
+        assert_eq!(
+            initial_guesses.len() % num_decision_variables,
+            0,
+            "wrong length of initial_guesses"
+        );
+        let num_starts = initial_guesses.len() / num_decision_variables;
+        let best = BestCost {
+            bits: AtomicU64::new(f64::INFINITY.to_bits()),
+            margin: self.margin,
+        };
+
+        // Queue of pending starts: (index, initial guess)
+        let pending = std::sync::Mutex::new(
+            initial_guesses
+                .chunks_mut(num_decision_variables)
+                .enumerate(),
+        );
+        let worker = |cache: &mut C| {
+            let mut finished = Vec::new();
+            loop {
+                let next = pending.lock().unwrap().next();
+                match next {
+                    Some((i, u)) => {
+                        let early_stop = EarlyStop {
+                            best: &best,
+                            abandoned: Cell::new(false),
+                        };
+                        let status = solve_start(cache, u, &early_stop);
+                        if let Ok(s) = &status {
+                            if s.is_converged() {
+                                best.update(s.cost_value());
+                            }
+                        }
+                        finished.push((
+                            i,
+                            StartOutcome {
+                                status,
+                                abandoned: early_stop.is_abandoned(),
+                            },
+                        ));
+                    }
+                    None => return finished,
+                }
+            }
+        };
+
+        let mut outcomes: Vec<Option<StartOutcome<S>>> = (0..num_starts).map(|_| None).collect();
+        let num_threads = usize::min(caches.len(), num_starts);
+        if cfg!(target_arch = "wasm32") || num_threads < 2 {
+            for (i, outcome) in worker(&mut caches[0]) {
+                outcomes[i] = Some(outcome);
+            }
+        } else {
+            let worker = &worker;
+            std::thread::scope(|scope| {
+                let handles: Vec<_> = caches
+                    .iter_mut()
+                    .take(num_threads)
+                    .map(|cache| scope.spawn(move || worker(cache)))
+                    .collect();
+                for handle in handles {
+                    for (i, outcome) in handle.join().unwrap() {
+                        outcomes[i] = Some(outcome);
+                    }
+                }
+            });
+        }
+        let outcomes: Vec<StartOutcome<S>> = outcomes.into_iter().map(Option::unwrap).collect();
+
+        // the best start: converged starts first, then the lowest cost
+        let best = outcomes
+            .iter()
+            .enumerate()
+            .filter_map(|(i, o)| o.status.as_ref().ok().map(|s| (i, s)))
+            .min_by(|(_, a), (_, b)| {
+                b.is_converged()
+                    .cmp(&a.is_converged())
+                    .then(a.cost_value().total_cmp(&b.cost_value()))
+            })
+            .map(|(i, _)| i);
+        MultiStartStatus { outcomes, best }
+    }
+}
+
+/// Exit status of an abandoned start
+pub(crate) const ABANDONED_EXIT_STATUS: ExitStatus = ExitStatus::NotConvergedIterations;
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+
+    use super::*;
+    use crate::{constraints::Rectangle, panoc::*, FunctionCallResult, Optimizer, Problem};
+
+    /// Solves `min u^4 - u^2 - 0.2u` on [-2, 2] from the given initial guesses
+    /// using PANOC (this has a local minimiser at -0.6505 and the global one at
+    /// 0.7526)
+    fn solve_quartic(
+        multistart: MultiStart,
+        num_caches: usize,
+        initial_guesses: &mut [f64],
+    ) -> MultiStartStatus<SolverStatus> {
+        let cost = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+            *c = u[0].powi(4) - u[0].powi(2) - 0.2 * u[0];
+            Ok(())
+        };
+        let gradient = |u: &[f64], g: &mut [f64]| -> FunctionCallResult {
+            g[0] = 4.0 * u[0].powi(3) - 2.0 * u[0] - 0.2;
+            Ok(())
+        };
+        let bounds = Rectangle::new(Some(&[-2.0]), Some(&[2.0]));
+        let mut caches: Vec<PANOCCache> = (0..num_caches)
+            .map(|_| PANOCCache::new(1, 1e-10, 5))
+            .collect();
+        multistart.solve(&mut caches, initial_guesses, 1, |cache, u, early_stop| {
+            let problem = Problem::new(&bounds, gradient, cost);
+            PANOCOptimizer::new(problem, cache)
+                .with_early_stop(early_stop)
+                .solve(u)
+        })
+    }
+
+    #[test]
+    fn t_multistart_panoc() {
+        let mut initial_guesses = [-1.5, -0.5, 0.5, 1.5];
+        let status = solve_quartic(
+            MultiStart::new().with_margin(f64::INFINITY),
+            3,
+            &mut initial_guesses,
+        );
+        assert_eq!(0, status.num_abandoned());
+        assert_eq!(4, status.outcomes().len());
+        assert!(status
+            .outcomes()
+            .iter()
+            .all(|o| o.status().as_ref().unwrap().has_converged()));
+        let best = status.best_index().unwrap();
+        assert!(best >= 2);
+        unit_test_utils::assert_nearly_equal(
+            0.752_618_571_771_696_7,
+            initial_guesses[best],
+            1e-6,
+            1e-8,
+            "u",
+        );
+        unit_test_utils::assert_nearly_equal(
+            initial_guesses[2],
+            initial_guesses[3],
+            1e-6,
+            1e-8,
+            "u",
+        );
+        unit_test_utils::assert_nearly_equal(-0.650_487_994, initial_guesses[0], 1e-6, 1e-8, "u");
+    }
+
+    #[test]
+    fn t_multistart_panoc_early_stop() {
+        // a single cache: the starts are solved in order, so the second start
+        // is abandoned once it is clearly worse than the first one
+        let mut initial_guesses = [1.0, -1.0];
+        let status = solve_quartic(MultiStart::new(), 1, &mut initial_guesses);
+        assert_eq!(Some(0), status.best_index());
+        assert!(status.best().unwrap().has_converged());
+        assert!(!status.outcomes()[0].is_abandoned());
+        assert!(status.outcomes()[1].is_abandoned());
+        let abandoned = status.outcomes()[1].status().as_ref().unwrap();
+        assert_eq!(ExitStatus::NotConvergedIterations, abandoned.exit_status());
+        assert_eq!(1, status.num_abandoned());
+    }
+
+    #[test]
+    fn t_best_cost_update() {
+        let best = BestCost {
+            bits: AtomicU64::new(f64::INFINITY.to_bits()),
+            margin: 0.1,
+        };
+        best.update(3.0);
+        best.update(5.0);
+        assert_eq!(3.0, best.get());
+        let early_stop = EarlyStop {
+            best: &best,
+            abandoned: Cell::new(false),
+        };
+        assert!(!early_stop.should_stop(3.2));
+        assert!(!early_stop.is_abandoned());
+        assert!(early_stop.should_stop(3.5));
+        assert!(early_stop.is_abandoned());
+    }
+}
@@ -0,0 +1,217 @@
+//! L-BFGS buffers of PANOC
+//!
+//! In double precision, PANOC uses the `lbfgs` crate; this module provides
+//! the same limited-memory BFGS method (with the C-BFGS update rule of
+//! Li and Fukushima) for any floating-point type, which PANOC uses in
+//! single precision.
+//!
+use crate::{matrix_operations, Scalar};
+
+/// An L-BFGS buffer, that is, a limited-memory approximation of the inverse
+/// Hessian of the cost function
+pub trait LbfgsBuffer<T>: std::fmt::Debug + Send {
+    /// Constructs a new buffer for vectors of dimension `problem_size`
+    /// with memory `memory_size`
+    fn new_buffer(problem_size: usize, memory_size: usize) -> Self;
+
+    /// Sets the C-BFGS parameters `alpha` and `epsilon` and the tolerance
+    /// `sy_epsilon` on the curvature `s'y`
+    fn with_cbfgs_parameters(self, alpha: T, epsilon: T, sy_epsilon: T) -> Self;
+
+    /// Empties the buffer
+    fn reset(&mut self);
+
+    /// Updates the buffer with the gradient `g` at `state`; returns `false`
+    /// if the update is rejected
+    fn update_hessian(&mut self, g: &[T], state: &[T]) -> bool;
+
+    /// Applies the inverse Hessian approximation on `q`
+    fn apply_hessian(&mut self, q: &mut [T]);
+}
+
+impl LbfgsBuffer<f64> for lbfgs::Lbfgs {
+    fn new_buffer(problem_size: usize, memory_size: usize) -> Self {
+        lbfgs::Lbfgs::new(problem_size, memory_size)
+    }
+
+    fn with_cbfgs_parameters(self, alpha: f64, epsilon: f64, sy_epsilon: f64) -> Self {
+        self.with_cbfgs_alpha(alpha)
+            .with_cbfgs_epsilon(epsilon)
+            .with_sy_epsilon(sy_epsilon)
+    }
+
+    fn reset(&mut self) {
+        lbfgs::Lbfgs::reset(self);
+    }
+
+    fn update_hessian(&mut self, g: &[f64], state: &[f64]) -> bool {
+        lbfgs::Lbfgs::update_hessian(self, g, state) == lbfgs::UpdateStatus::UpdateOk
+    }
+
+    fn apply_hessian(&mut self, q: &mut [f64]) {
+        lbfgs::Lbfgs::apply_hessian(self, q);
+    }
+}
+
+/// L-BFGS buffer for any floating-point type
+///
+/// The pairs $(s_k, y_k)$, with $s_k = u_{k+1} - u_k$ and
+/// $y_k = g_{k+1} - g_k$, are stored in a circular buffer, and the inverse
+/// Hessian is applied using the two-loop recursion with initial
+/// approximation $H_0 = \gamma_k I$, $\gamma_k = s_k^\top y_k / y_k^\top y_k$.
+/// A pair is rejected if $s_k^\top y_k \leq \epsilon_{sy}$ or (C-BFGS)
+/// if $s_k^\top y_k / \Vert s_k \Vert^2 \leq \epsilon \Vert g_{k+1}\Vert^\alpha$.
+#[derive(Debug, Clone)]
+pub struct Lbfgs<T> {
+    /// Number of pairs in the buffer
+    active_size: usize,
+    /// Scaling of the initial inverse Hessian
+    gamma: T,
+    /// `s[0]` and `y[0]` are the most recent pairs; `s[memory]` and
+    /// `y[memory]` hold the candidate pair
+    s: Vec<Vec<T>>,
+    y: Vec<Vec<T>>,
+    alpha: Vec<T>,
+    rho: Vec<T>,
+    cbfgs_alpha: T,
+    cbfgs_epsilon: T,
+    sy_epsilon: T,
+    old_state: Vec<T>,
+    old_g: Vec<T>,
+    first_old: bool,
+}
+
+impl<T: Scalar> LbfgsBuffer<T> for Lbfgs<T> {
+    fn new_buffer(problem_size: usize, memory_size: usize) -> Self {
+        assert!(problem_size > 0, "problem_size must be positive");
+        assert!(memory_size > 0, "memory_size must be positive");
+        Lbfgs {
+            active_size: 0,
+            gamma: T::one(),
+            s: vec![vec![T::zero(); problem_size]; memory_size + 1],
+            y: vec![vec![T::zero(); problem_size]; memory_size + 1],
+            alpha: vec![T::zero(); memory_size],
+            rho: vec![T::zero(); memory_size + 1],
+            cbfgs_alpha: T::zero(),
+            cbfgs_epsilon: T::zero(),
+            sy_epsilon: T::zero(),
+            old_state: vec![T::zero(); problem_size],
+            old_g: vec![T::zero(); problem_size],
+            first_old: true,
+        }
+    }
+
+    fn with_cbfgs_parameters(mut self, alpha: T, epsilon: T, sy_epsilon: T) -> Self {
+        assert!(alpha > T::zero(), "alpha must be positive");
+        assert!(epsilon > T::zero(), "epsilon must be positive");
+        assert!(sy_epsilon >= T::zero(), "sy_epsilon must be nonnegative");
+        self.cbfgs_alpha = alpha;
+        self.cbfgs_epsilon = epsilon;
+        self.sy_epsilon = sy_epsilon;
+        self
+    }
+
+    fn reset(&mut self) {
+        self.active_size = 0;
+        self.first_old = true;
+    }
+
+    fn update_hessian(&mut self, g: &[T], state: &[T]) -> bool {
+        if self.first_old {
+            self.first_old = false;
+            self.old_state.copy_from_slice(state);
+            self.old_g.copy_from_slice(g);
+            return true;
+        }
+        let memory_size = self.alpha.len();
+        let (s, y) = (&mut self.s[memory_size], &mut self.y[memory_size]);
+        s.iter_mut()
+            .zip(state.iter())
+            .zip(self.old_state.iter())
+            .for_each(|((s, &x), &x_old)| *s = x - x_old);
+        y.iter_mut()
+            .zip(g.iter())
+            .zip(self.old_g.iter())
+            .for_each(|((y, &g), &g_old)| *y = g - g_old);
+        let ys = matrix_operations::inner_product(s, y);
+        let norm_s_squared = matrix_operations::norm2_squared(s);
+        let norm_g = matrix_operations::norm2(g);
+        if ys <= self.sy_epsilon
+            || (self.cbfgs_epsilon > T::zero()
+                && ys / norm_s_squared <= self.cbfgs_epsilon * norm_g.powf(self.cbfgs_alpha))
+        {
+            return false;
+        }
+        self.old_state.copy_from_slice(state);
+        self.old_g.copy_from_slice(g);
+        self.rho[memory_size] = T::one() / ys;
+        self.gamma = ys / matrix_operations::norm2_squared(y);
+        // the candidate pair becomes the most recent one
+        self.s.rotate_right(1);
+        self.y.rotate_right(1);
+        self.rho.rotate_right(1);
+        self.active_size = usize::min(self.active_size + 1, memory_size);
+        true
+    }
+
+    fn apply_hessian(&mut self, q: &mut [T]) {
+        let k = self.active_size;
+        if k == 0 {
+            return;
+        }
+        for i in 0..k {
+            let a = self.rho[i] * matrix_operations::inner_product(&self.s[i], q);
+            self.alpha[i] = a;
+            q.iter_mut()
+                .zip(self.y[i].iter())
+                .for_each(|(q, &y)| *q -= a * y);
+        }
+        let gamma = self.gamma;
+        q.iter_mut().for_each(|q| *q *= gamma);
+        for i in (0..k).rev() {
+            let b = self.rho[i] * matrix_operations::inner_product(&self.y[i], q);
+            let a = self.alpha[i];
+            q.iter_mut()
+                .zip(self.s[i].iter())
+                .for_each(|(q, &s)| *q += (a - b) * s);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+
+    use super::*;
+
+    #[test]
+    fn t_lbfgs_secant_condition() {
+        // gradient of the quadratic 0.5 * u'Au with A = diag(1, 2, 4)
+        let gradient = |u: &[f32]| [u[0], 2.0 * u[1], 4.0 * u[2]];
+        let mut lbfgs = Lbfgs::<f32>::new_buffer(3, 5).with_cbfgs_parameters(1.0, 1e-8, 1e-10);
+        let states: [[f32; 3]; 3] = [[1.0, 1.0, 1.0], [0.5, 0.8, -0.2], [0.1, -0.3, 0.4]];
+        for u in states.iter() {
+            assert!(lbfgs.update_hessian(&gradient(u), u));
+        }
+        // the inverse Hessian approximation maps the last y onto the last s
+        let s = [-0.4, -1.1, 0.6];
+        let mut q = [-0.4, -2.2, 2.4];
+        lbfgs.apply_hessian(&mut q);
+        for (q_i, s_i) in q.iter().zip(s.iter()) {
+            assert!((q_i - s_i).abs() < 1e-5, "secant condition violated");
+        }
+    }
+
+    #[test]
+    fn t_lbfgs_rejection() {
+        let mut lbfgs = Lbfgs::<f32>::new_buffer(2, 3).with_cbfgs_parameters(1.0, 1e-8, 1e-10);
+        assert!(lbfgs.update_hessian(&[1.0, 1.0], &[0.0, 0.0]));
+        // negative curvature: the pair is rejected and the buffer stays empty
+        assert!(!lbfgs.update_hessian(&[0.0, 0.0], &[1.0, 1.0]));
+        let mut q = [3.0_f32, -1.0];
+        lbfgs.apply_hessian(&mut q);
+        assert_eq!([3.0, -1.0], q);
+    }
+}
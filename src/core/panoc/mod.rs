@@ -2,11 +2,14 @@
 
 #![deny(missing_docs)]
 
+mod lbfgs;
 mod panoc_cache;
 mod panoc_engine;
 mod panoc_optimizer;
 
-pub use panoc_cache::PANOCCache;
+#[doc(hidden)]
+pub use lbfgs::{Lbfgs, LbfgsBuffer};
+pub use panoc_cache::{PANOCCache, WarmStartPolicy};
 pub use panoc_optimizer::PANOCOptimizer;
 
 #[cfg(test)]
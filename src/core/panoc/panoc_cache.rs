@@ -1,7 +1,37 @@
+use super::LbfgsBuffer;
+use crate::constraints::Constraint;
+use crate::core::anderson::AndersonCache;
+use crate::core::{IterationTrace, SolverStatistics};
+use crate::Scalar;
+
 const DEFAULT_SY_EPSILON: f64 = 1e-10;
 const DEFAULT_CBFGS_EPSILON: f64 = 1e-8;
 const DEFAULT_CBFGS_ALPHA: f64 = 1.0;
 
+/// Information that PANOC keeps from one solve to the next one (warm start)
+///
+/// By default, every solve starts cold: the L-BFGS buffer is emptied and the
+/// Lipschitz constant of the gradient is estimated anew, which costs two
+/// gradient evaluations. With a warm start, PANOC keeps the L-BFGS pairs, the
+/// Lipschitz constant and the step size (gamma) of the previous solve on the
+/// same cache, provided that solve converged.
+///
+/// The L-BFGS pairs of the previous solve are discarded if the pair that links
+/// the previous solve to the new one is rejected; as usual, the L-BFGS buffer
+/// is also emptied whenever the Lipschitz constant is increased.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum WarmStartPolicy {
+    /// Every solve starts cold (default)
+    Cold,
+    /// The inner problems of ALM/PM are warm started from one outer iteration
+    /// to the next, but `AlmOptimizer::solve` starts cold; when PANOC is used
+    /// on its own, this is the same as `AcrossSolves`
+    AcrossOuterIterations,
+    /// As `AcrossOuterIterations`, and, additionally, `AlmOptimizer::solve` is
+    /// warm started from the previous call on the same cache
+    AcrossSolves,
+}
+
 /// Cache for PANOC
 ///
 /// This struct carries all the information needed at every step of the algorithm.
@@ -11,33 +41,54 @@ const DEFAULT_CBFGS_ALPHA: f64 = 1.0;
 ///
 /// Subsequently, a `PANOCEngine` is used to construct an instance of `PANOCAlgorithm`
 ///
+/// The cache is generic over the floating-point type, `T`, of the decision
+/// variables, which is `f64` by default (see [`Scalar`](crate::Scalar))
+///
 #[derive(Debug)]
-pub struct PANOCCache {
-    pub(crate) lbfgs: lbfgs::Lbfgs,
-    pub(crate) gradient_u: Vec<f64>,
+pub struct PANOCCache<T: Scalar = f64> {
+    pub(crate) lbfgs: T::Lbfgs,
+    pub(crate) gradient_u: Vec<T>,
     /// Stores the gradient of the cost at the previous iteration. This is
     /// an optional field because it is used (and needs to be allocated)
     /// only if we need to check the AKKT-specific termination conditions
-    pub(crate) gradient_u_previous: Option<Vec<f64>>,
-    pub(crate) u_half_step: Vec<f64>,
-    pub(crate) gradient_step: Vec<f64>,
-    pub(crate) direction_lbfgs: Vec<f64>,
-    pub(crate) u_plus: Vec<f64>,
-    pub(crate) rhs_ls: f64,
-    pub(crate) lhs_ls: f64,
-    pub(crate) gamma_fpr: Vec<f64>,
-    pub(crate) gamma: f64,
-    pub(crate) tolerance: f64,
-    pub(crate) norm_gamma_fpr: f64,
-    pub(crate) tau: f64,
-    pub(crate) lipschitz_constant: f64,
-    pub(crate) sigma: f64,
-    pub(crate) cost_value: f64,
+    pub(crate) gradient_u_previous: Option<Vec<T>>,
+    pub(crate) u_half_step: Vec<T>,
+    pub(crate) gradient_step: Vec<T>,
+    pub(crate) direction_lbfgs: Vec<T>,
+    pub(crate) u_plus: Vec<T>,
+    pub(crate) rhs_ls: T,
+    pub(crate) lhs_ls: T,
+    pub(crate) gamma_fpr: Vec<T>,
+    pub(crate) gamma: T,
+    pub(crate) tolerance: T,
+    pub(crate) norm_gamma_fpr: T,
+    pub(crate) tau: T,
+    pub(crate) lipschitz_constant: T,
+    pub(crate) sigma: T,
+    pub(crate) cost_value: T,
     pub(crate) iteration: usize,
-    pub(crate) akkt_tolerance: Option<f64>,
+    pub(crate) akkt_tolerance: Option<T>,
+    pub(crate) statistics: SolverStatistics,
+    /// Scratch workspace for the projection on the set of constraints
+    /// (see `Constraint::project_with_workspace`)
+    pub(crate) projection_workspace: Vec<T>,
+    pub(crate) warm_start: WarmStartPolicy,
+    /// Whether the L-BFGS buffer, the Lipschitz constant and gamma can be
+    /// used by the next solve (that is, the previous solve converged)
+    pub(crate) warm_start_available: bool,
+    /// Anderson acceleration memory; if available, PANOC uses Anderson
+    /// directions instead of L-BFGS directions
+    pub(crate) anderson: Option<AndersonCache<T>>,
+    /// Predicted time per iteration in seconds (zero if unknown), which is
+    /// learnt across solves with a deadline (see `PANOCOptimizer::with_deadline`)
+    pub(crate) iteration_time: f64,
+    /// Best iterate of a solve with a deadline (allocated by the first such solve)
+    pub(crate) best_iterate: Vec<T>,
+    /// Trace of the iterations of the last solve (see `with_trace`)
+    pub(crate) trace: Option<IterationTrace>,
 }
 
-impl PANOCCache {
+impl<T: Scalar> PANOCCache<T> {
     /// Construct a new instance of `PANOCCache`
     ///
     /// ## Arguments
@@ -57,34 +108,152 @@ impl PANOCCache {
     ///
     /// This constructor allocated memory using `vec!`.
     ///
-    /// It allocates a total of `8*problem_size + 2*lbfgs_memory_size*problem_size + 2*lbfgs_memory_size + 11` floats (`f64`)
+    /// It allocates a total of `8*problem_size + 2*lbfgs_memory_size*problem_size + 2*lbfgs_memory_size + 11` floats (of type `T`)
     ///
-    pub fn new(problem_size: usize, tolerance: f64, lbfgs_memory_size: usize) -> PANOCCache {
-        assert!(tolerance > 0., "tolerance must be positive");
+    pub fn new(problem_size: usize, tolerance: T, lbfgs_memory_size: usize) -> PANOCCache<T> {
+        assert!(tolerance > T::zero(), "tolerance must be positive");
 
         PANOCCache {
-            gradient_u: vec![0.0; problem_size],
+            gradient_u: vec![T::zero(); problem_size],
             gradient_u_previous: None,
-            u_half_step: vec![0.0; problem_size],
-            gamma_fpr: vec![0.0; problem_size],
-            direction_lbfgs: vec![0.0; problem_size],
-            gradient_step: vec![0.0; problem_size],
-            u_plus: vec![0.0; problem_size],
-            gamma: 0.0,
+            u_half_step: vec![T::zero(); problem_size],
+            gamma_fpr: vec![T::zero(); problem_size],
+            direction_lbfgs: vec![T::zero(); problem_size],
+            gradient_step: vec![T::zero(); problem_size],
+            u_plus: vec![T::zero(); problem_size],
+            gamma: T::zero(),
             tolerance,
-            norm_gamma_fpr: std::f64::INFINITY,
-            lbfgs: lbfgs::Lbfgs::new(problem_size, lbfgs_memory_size)
-                .with_cbfgs_alpha(DEFAULT_CBFGS_ALPHA)
-                .with_cbfgs_epsilon(DEFAULT_CBFGS_EPSILON)
-                .with_sy_epsilon(DEFAULT_SY_EPSILON),
-            lhs_ls: 0.0,
-            rhs_ls: 0.0,
-            tau: 1.0,
-            lipschitz_constant: 0.0,
-            sigma: 0.0,
-            cost_value: 0.0,
+            norm_gamma_fpr: T::infinity(),
+            lbfgs: T::Lbfgs::new_buffer(problem_size, lbfgs_memory_size).with_cbfgs_parameters(
+                T::from_f64(DEFAULT_CBFGS_ALPHA),
+                T::from_f64(DEFAULT_CBFGS_EPSILON),
+                T::from_f64(DEFAULT_SY_EPSILON),
+            ),
+            lhs_ls: T::zero(),
+            rhs_ls: T::zero(),
+            tau: T::one(),
+            lipschitz_constant: T::zero(),
+            sigma: T::zero(),
+            cost_value: T::zero(),
             iteration: 0,
             akkt_tolerance: None,
+            statistics: SolverStatistics::new(),
+            projection_workspace: Vec::new(),
+            warm_start: WarmStartPolicy::Cold,
+            warm_start_available: false,
+            anderson: None,
+            iteration_time: 0.0,
+            best_iterate: Vec::new(),
+            trace: None,
+        }
+    }
+
+    /// Records a trace of the iterations of every solve (see
+    /// [`trace`](../trace/index.html))
+    ///
+    /// ## Arguments
+    ///
+    /// - `capacity`: maximum number of records; once the trace is full, the
+    ///   oldest records are overwritten
+    ///
+    /// ## Memory allocation
+    ///
+    /// This method allocates `capacity` records (of 72 bytes each)
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `capacity` is zero
+    ///
+    pub fn with_trace(mut self, capacity: usize) -> Self {
+        self.trace = Some(IterationTrace::new(capacity));
+        self
+    }
+
+    /// Trace of the iterations of the last solve; returns `None` unless the
+    /// cache was constructed `with_trace`
+    pub fn trace(&self) -> Option<&IterationTrace> {
+        self.trace.as_ref()
+    }
+
+    /// Uses Anderson acceleration, instead of L-BFGS, to compute the directions
+    /// of PANOC (see [`AndersonCache`](../anderson/struct.AndersonCache.html))
+    ///
+    /// The direction at `u` is `u - u_aa`, where `u_aa` is the Anderson-accelerated
+    /// forward-backward step, so that the line search accepts `u_aa` if it
+    /// decreases the forward-backward envelope sufficiently. The memory is emptied
+    /// whenever the Lipschitz constant is updated and at the start of every solve.
+    ///
+    /// ## Arguments
+    ///
+    /// - `memory`: number of previous iterates that are combined
+    ///
+    /// ## Memory allocation
+    ///
+    /// This method allocates `(2 * memory + 3) * problem_size + 2 * memory^2 + memory` floats
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `memory` is zero
+    ///
+    pub fn with_anderson_acceleration(mut self, memory: usize) -> Self {
+        let n = self.gradient_u.len();
+        self.anderson = Some(AndersonCache::new(n, memory));
+        self
+    }
+
+    /// Sets the warm-start policy (see [`WarmStartPolicy`])
+    ///
+    /// ## Arguments
+    ///
+    /// - `warm_start`: which information is kept from one solve to the next
+    ///   (the default is `WarmStartPolicy::Cold`)
+    ///
+    pub fn with_warm_start(mut self, warm_start: WarmStartPolicy) -> Self {
+        self.warm_start = warm_start;
+        self.warm_start_available = false;
+        self
+    }
+
+    /// Predicted duration of an iteration, which is used by solves with a
+    /// deadline (see `PANOCOptimizer::with_deadline`); returns `None` if no
+    /// solve with a deadline has been performed on this cache
+    pub fn predicted_iteration_time(&self) -> Option<std::time::Duration> {
+        if self.iteration_time > 0.0 {
+            Some(std::time::Duration::from_secs_f64(self.iteration_time))
+        } else {
+            None
+        }
+    }
+
+    /// Returns `true` iff the next solve can be warm started
+    pub(crate) fn can_warm_start(&self) -> bool {
+        self.warm_start != WarmStartPolicy::Cold
+            && self.warm_start_available
+            && self.lipschitz_constant.is_finite()
+            && self.gamma > T::zero()
+    }
+
+    /// Allocates the scratch workspace needed to project on the given set
+    /// of constraints
+    ///
+    /// PANOC allocates this workspace (if needed) the first time it is
+    /// used with a set of constraints; use this method so that no memory
+    /// is allocated while solving the optimization problem
+    ///
+    /// ## Arguments
+    ///
+    /// - `constraints`: set of constraints of the optimization problem
+    ///
+    pub fn with_projection_workspace<C: Constraint<T> + ?Sized>(mut self, constraints: &C) -> Self {
+        let size = constraints.workspace_size(self.gradient_u.len());
+        self.reserve_projection_workspace(size);
+        self
+    }
+
+    /// Makes sure that the projection workspace has at least `size` elements
+    pub(crate) fn reserve_projection_workspace(&mut self, size: usize) {
+        if self.projection_workspace.len() < size {
+            self.projection_workspace.resize(size, T::zero());
         }
     }
 
@@ -99,10 +268,18 @@ impl PANOCCache {
     ///
     /// The method panics if `akkt_tolerance` is nonpositive
     ///
-    pub fn set_akkt_tolerance(&mut self, akkt_tolerance: f64) {
-        assert!(akkt_tolerance > 0.0, "akkt_tolerance must be positive");
+    pub fn set_akkt_tolerance(&mut self, akkt_tolerance: T) {
+        assert!(
+            akkt_tolerance > T::zero(),
+            "akkt_tolerance must be positive"
+        );
         self.akkt_tolerance = Some(akkt_tolerance);
-        self.gradient_u_previous = Some(vec![0.0; self.gradient_step.len()]);
+        // allocate the previous gradient only once (this method is called
+        // every time an `AlmOptimizer` is constructed)
+        match &mut self.gradient_u_previous {
+            Some(df_previous) => df_previous.iter_mut().for_each(|df_i| *df_i = T::zero()),
+            None => self.gradient_u_previous = Some(vec![T::zero(); self.gradient_step.len()]),
+        }
     }
 
     /// Copies the value of the current cost gradient to `gradient_u_previous`,
@@ -117,8 +294,8 @@ impl PANOCCache {
     }
 
     /// Computes the AKKT residual which is defined as `||gamma*(fpr + df - df_previous)||`
-    fn akkt_residual(&self) -> f64 {
-        let mut r = 0.0;
+    fn akkt_residual(&self) -> T {
+        let mut r = T::zero();
         if let Some(df_previous) = &self.gradient_u_previous {
             // Notation: gamma_fpr_i is the i-th element of gamma_fpr = gamma * fpr,
             // df_i is the i-th element of the gradient of the cost function at the
@@ -129,7 +306,7 @@ impl PANOCCache {
                 .iter()
                 .zip(self.gradient_u.iter())
                 .zip(df_previous.iter())
-                .fold(0.0, |mut sum, ((&gamma_fpr_i, &df_i), &dfp_i)| {
+                .fold(T::zero(), |mut sum, ((&gamma_fpr_i, &df_i), &dfp_i)| {
                     sum += (gamma_fpr_i + self.gamma * (df_i - dfp_i)).powi(2);
                     sum
                 })
@@ -173,16 +350,30 @@ impl PANOCCache {
     /// - Sets the internal variables `lhs_ls`, `rhs_ls`,
     ///   `lipschitz_constant`, `sigma`, `cost_value`
     ///   and `gamma` to 0.0
+    /// - Resets the solver statistics (see `core::instrumentation`)
+    ///
+    /// As a result, the next solve starts cold (see [`WarmStartPolicy`])
     pub fn reset(&mut self) {
         self.lbfgs.reset();
-        self.lhs_ls = 0.0;
-        self.rhs_ls = 0.0;
-        self.tau = 1.0;
-        self.lipschitz_constant = 0.0;
-        self.sigma = 0.0;
-        self.cost_value = 0.0;
+        self.lipschitz_constant = T::zero();
+        self.gamma = T::zero();
+        self.warm_start_available = false;
+        self.reset_iteration_state();
+    }
+
+    /// Resets the state of the iterations, except for the L-BFGS buffer,
+    /// the Lipschitz constant and gamma, which are kept for a warm start
+    pub(crate) fn reset_iteration_state(&mut self) {
+        self.lhs_ls = T::zero();
+        self.rhs_ls = T::zero();
+        self.tau = T::one();
+        self.sigma = T::zero();
+        self.cost_value = T::zero();
         self.iteration = 0;
-        self.gamma = 0.0;
+        self.statistics.reset();
+        if let Some(anderson) = self.anderson.as_mut() {
+            anderson.reset();
+        }
     }
 
     /// Sets the CBFGS parameters `alpha` and `epsilon`
@@ -202,12 +393,8 @@ impl PANOCCache {
     /// The method panics if alpha or epsilon are nonpositive and if sy_epsilon
     /// is negative.
     ///
-    pub fn with_cbfgs_parameters(mut self, alpha: f64, epsilon: f64, sy_epsilon: f64) -> Self {
-        self.lbfgs = self
-            .lbfgs
-            .with_cbfgs_alpha(alpha)
-            .with_cbfgs_epsilon(epsilon)
-            .with_sy_epsilon(sy_epsilon);
+    pub fn with_cbfgs_parameters(mut self, alpha: T, epsilon: T, sy_epsilon: T) -> Self {
+        self.lbfgs = self.lbfgs.with_cbfgs_parameters(alpha, epsilon, sy_epsilon);
         self
     }
 }
@@ -1,7 +1,12 @@
 use crate::{
     constraints,
-    core::{panoc::PANOCCache, AlgorithmEngine, Problem},
-    matrix_operations, FunctionCallResult, SolverError,
+    core::{
+        instrumentation::{instrumented, Phase, PhaseTimer},
+        panoc::{LbfgsBuffer, PANOCCache},
+        problem::CostAndGradientType,
+        AlgorithmEngine, Problem,
+    },
+    matrix_operations, FunctionCallResult, Scalar, SolverError,
 };
 
 /// Mimum estimated Lipschitz constant (initial estimate)
@@ -30,23 +35,79 @@ const MAX_LIPSCHITZ_CONSTANT: f64 = 1e9;
 /// Maximum number of linesearch iterations
 const MAX_LINESEARCH_ITERATIONS: u32 = 10;
 
+/// Delta in the estimation of the initial Lipschitz constant; this is
+/// `DELTA_LIPSCHITZ` in double precision and is larger in single precision,
+/// where a perturbation of `1e-12` would be lost to rounding
+#[inline]
+fn delta_lipschitz<T: Scalar>() -> T {
+    T::from_f64(DELTA_LIPSCHITZ).max(T::from_f64(1000.0) * T::epsilon())
+}
+
+/// Epsilon in the estimation of the initial Lipschitz constant
+/// (`EPSILON_LIPSCHITZ`, or the square root of the machine epsilon if larger)
+#[inline]
+fn epsilon_lipschitz<T: Scalar>() -> T {
+    T::from_f64(EPSILON_LIPSCHITZ).max(T::epsilon().sqrt())
+}
+
+/// Safety parameter of the update of the Lipschitz constant
+/// (`LIPSCHITZ_UPDATE_EPSILON`, or a hundred machine epsilons if larger)
+#[inline]
+fn lipschitz_update_epsilon<T: Scalar>() -> T {
+    T::from_f64(LIPSCHITZ_UPDATE_EPSILON).max(T::from_f64(100.0) * T::epsilon())
+}
+
+/// Computes `gradient_step ← u - gamma * gradient` and returns the squared norm
+/// of `gradient`, which is computed in the same pass
+#[inline]
+fn gradient_step_and_norm<T: Scalar>(
+    gradient_step: &mut [T],
+    u: &[T],
+    gradient: &[T],
+    gamma: T,
+) -> T {
+    let mut norm_gradient_squared = T::zero();
+    gradient_step
+        .iter_mut()
+        .zip(u.iter())
+        .zip(gradient.iter())
+        .for_each(|((grad_step, u), grad)| {
+            *grad_step = *u - gamma * *grad;
+            norm_gradient_squared += *grad * *grad;
+        });
+    if cfg!(feature = "simd") {
+        norm_gradient_squared = matrix_operations::solver::norm2_squared(gradient);
+    }
+    norm_gradient_squared
+}
+
 /// Engine for PANOC algorithm
-pub struct PANOCEngine<'a, GradientType, ConstraintType, CostType>
-where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+pub struct PANOCEngine<
+    'a,
+    GradientType,
+    ConstraintType,
+    CostType,
+    T = f64,
+    CostGradientType = CostAndGradientType<T>,
+> where
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
-    problem: Problem<'a, GradientType, ConstraintType, CostType>,
-    pub(crate) cache: &'a mut PANOCCache,
+    problem: Problem<'a, GradientType, ConstraintType, CostType, T, CostGradientType>,
+    pub(crate) cache: &'a mut PANOCCache<T>,
 }
 
-impl<'a, GradientType, ConstraintType, CostType>
-    PANOCEngine<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
+    PANOCEngine<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// Construct a new Engine for PANOC
     ///
@@ -60,82 +121,140 @@ where
     ///
     ///
     pub fn new(
-        problem: Problem<'a, GradientType, ConstraintType, CostType>,
-        cache: &'a mut PANOCCache,
-    ) -> PANOCEngine<'a, GradientType, ConstraintType, CostType> {
+        problem: Problem<'a, GradientType, ConstraintType, CostType, T, CostGradientType>,
+        cache: &'a mut PANOCCache<T>,
+    ) -> PANOCEngine<'a, GradientType, ConstraintType, CostType, T, CostGradientType> {
+        let n = cache.gradient_u.len();
+        cache.reserve_projection_workspace(problem.constraints.workspace_size(n));
         PANOCEngine { problem, cache }
     }
 
     /// Estimate the local Lipschitz constant at `u`
-    fn estimate_loc_lip(&mut self, u: &mut [f64]) -> FunctionCallResult {
+    fn estimate_loc_lip(&mut self, u: &mut [T]) -> FunctionCallResult {
         let mut lipest = crate::lipschitz_estimator::LipschitzEstimator::new(
             u,
             &self.problem.gradf,
             &mut self.cache.gradient_u,
         )
-        .with_delta(DELTA_LIPSCHITZ)
-        .with_epsilon(EPSILON_LIPSCHITZ);
-        self.cache.lipschitz_constant = lipest.estimate_local_lipschitz()?;
+        .with_delta(delta_lipschitz())
+        .with_epsilon(epsilon_lipschitz());
+        self.cache.lipschitz_constant = instrumented!(
+            self.cache.statistics,
+            Phase::LipschitzEstimation,
+            lipest.estimate_local_lipschitz()
+        )?;
+        // the estimator evaluates the gradient at `u` and at a perturbation of `u`
+        self.cache
+            .statistics
+            .add_count(Phase::GradientEvaluation, 2);
 
         Ok(())
     }
 
     /// Computes the FPR and its norm
-    fn compute_fpr(&mut self, u_current: &[f64]) {
-        // compute the FPR:
+    fn compute_fpr(&mut self, u_current: &[T]) {
+        // compute the FPR and (in the same pass) its squared norm:
         // fpr ← u - u_half_step
         let cache = &mut self.cache;
+        let mut norm_fpr_squared = T::zero();
         cache
             .gamma_fpr
             .iter_mut()
             .zip(u_current.iter())
             .zip(cache.u_half_step.iter())
-            .for_each(|((fpr, u), uhalf)| *fpr = u - uhalf);
-        // compute the norm of FPR
-        cache.norm_gamma_fpr = matrix_operations::norm2(&cache.gamma_fpr);
+            .for_each(|((fpr, u), uhalf)| {
+                *fpr = *u - *uhalf;
+                norm_fpr_squared += *fpr * *fpr;
+            });
+        // with the feature `simd`, the (reassociated) vectorised norm is used
+        if cfg!(feature = "simd") {
+            norm_fpr_squared = matrix_operations::solver::norm2_squared(&cache.gamma_fpr);
+        }
+        cache.norm_gamma_fpr = norm_fpr_squared.sqrt();
     }
 
     /// Computes a gradient step; does not compute the gradient
-    fn gradient_step(&mut self, u_current: &[f64]) {
+    fn gradient_step(&mut self, u_current: &[T]) {
         // take a gradient step:
         // gradient_step ← u_current - gamma * gradient
         let cache = &mut self.cache;
-        let gamma = cache.gamma;
-        cache
-            .gradient_step
-            .iter_mut()
-            .zip(u_current.iter())
-            .zip(cache.gradient_u.iter())
-            .for_each(|((grad_step, u), grad)| *grad_step = *u - gamma * *grad);
+        gradient_step_and_norm(
+            &mut cache.gradient_step,
+            u_current,
+            &cache.gradient_u,
+            cache.gamma,
+        );
     }
 
-    /// Takes a gradient step on u_plus
-    fn gradient_step_uplus(&mut self) {
+    /// Takes a gradient step on u_plus; returns the squared norm of the gradient
+    fn gradient_step_uplus(&mut self) -> T {
         // take a gradient step:
         // gradient_step ← u_plus - gamma * gradient
         let cache = &mut self.cache;
-        let gamma = cache.gamma;
-        cache
-            .gradient_step
-            .iter_mut()
-            .zip(cache.u_plus.iter())
-            .zip(cache.gradient_u.iter())
-            .for_each(|((grad_step, u), grad)| *grad_step = *u - gamma * *grad);
+        gradient_step_and_norm(
+            &mut cache.gradient_step,
+            &cache.u_plus,
+            &cache.gradient_u,
+            cache.gamma,
+        )
     }
 
     /// Computes a projection on `gradient_step`
     fn half_step(&mut self) {
         let cache = &mut self.cache;
         // u_half_step ← projection(gradient_step)
-        cache.u_half_step.copy_from_slice(&cache.gradient_step);
-        self.problem.constraints.project(&mut cache.u_half_step);
+        instrumented!(
+            cache.statistics,
+            Phase::HalfStep,
+            self.problem.constraints.project_from(
+                &cache.gradient_step,
+                &mut cache.u_half_step,
+                &mut cache.projection_workspace
+            )
+        );
+    }
+
+    /// Computes the direction of PANOC (an L-BFGS direction or, if the cache has
+    /// an Anderson acceleration memory, an Anderson direction)
+    fn compute_direction(&mut self, u_current: &[T]) {
+        if self.cache.anderson.is_some() {
+            self.anderson_direction(u_current);
+        } else {
+            self.lbfgs_direction(u_current);
+        }
+    }
+
+    /// Computes an Anderson direction, `u - AA(u, u_half_step)`; updates
+    /// `cache.direction_lbfgs`
+    fn anderson_direction(&mut self, u_current: &[T]) {
+        let timer = PhaseTimer::start();
+        let cache = &mut *self.cache;
+        if let Some(anderson) = cache.anderson.as_mut() {
+            // direction ← AA(u, T(u)), where T(u) = u_half_step
+            anderson.accelerate(u_current, &cache.u_half_step, &mut cache.direction_lbfgs);
+            // direction ← u - direction
+            cache
+                .direction_lbfgs
+                .iter_mut()
+                .zip(u_current.iter())
+                .for_each(|(d, &u)| *d = u - *d);
+        }
+        cache.statistics.record(Phase::LbfgsDirection, timer);
     }
 
     /// Computes an LBFGS direction; updates `cache.direction_lbfgs`
-    fn lbfgs_direction(&mut self, u_current: &[f64]) {
+    fn lbfgs_direction(&mut self, u_current: &[T]) {
+        let timer = PhaseTimer::start();
         let cache = &mut self.cache;
         // update the LBFGS buffer
-        cache.lbfgs.update_hessian(&cache.gamma_fpr, u_current);
+        let accepted = cache.lbfgs.update_hessian(&cache.gamma_fpr, u_current);
+        if !accepted && cache.iteration == 0 {
+            // after a warm start, the first pair links the last iterate of the
+            // previous solve to the current one; if it is rejected, the pairs
+            // of the previous solve are deemed stale and are discarded
+            cache.lbfgs.reset();
+            cache.lbfgs.update_hessian(&cache.gamma_fpr, u_current);
+        }
 
         // direction ← fpr
         if cache.iteration > 0 {
@@ -143,44 +262,58 @@ where
             // compute an LBFGS direction, that is direction ← H(fpr)
             cache.lbfgs.apply_hessian(&mut cache.direction_lbfgs);
         }
+        cache.statistics.record(Phase::LbfgsDirection, timer);
     }
 
     /// Returns the RHS of the Lipschitz update
     /// Computes rhs = cost + LIP_EPS * |f| - gamma * <gradfx, fpr> + (L/2/gamma) ||gamma * fpr||^2
-    fn lipschitz_check_rhs(&mut self) -> f64 {
+    fn lipschitz_check_rhs(&mut self) -> T {
         let cache = &mut self.cache;
         let gamma = cache.gamma;
         let cost_value = cache.cost_value;
         // inner_prod_grad_fpr ← <gradfx, gamma_fpr>
         let inner_prod_grad_fpr =
-            matrix_operations::inner_product(&cache.gradient_u, &cache.gamma_fpr);
+            matrix_operations::solver::inner_product(&cache.gradient_u, &cache.gamma_fpr);
 
         // rhs ← cost + LIP_EPS * |f| - <gradfx, gamma_fpr> + (L/2/gamma) ||gamma_fpr||^2
-        cost_value + LIPSCHITZ_UPDATE_EPSILON * cost_value.abs() - inner_prod_grad_fpr
-            + (GAMMA_L_COEFF / (2.0 * gamma)) * (cache.norm_gamma_fpr.powi(2))
+        let two = T::from_f64(2.0);
+        cost_value + lipschitz_update_epsilon::<T>() * cost_value.abs() - inner_prod_grad_fpr
+            + (T::from_f64(GAMMA_L_COEFF) / (two * gamma)) * (cache.norm_gamma_fpr.powi(2))
     }
 
     /// Updates the estimate of the Lipscthiz constant
-    fn update_lipschitz_constant(&mut self, u_current: &[f64]) -> FunctionCallResult {
-        let mut cost_u_half_step = 0.0;
+    fn update_lipschitz_constant(&mut self, u_current: &[T]) -> FunctionCallResult {
+        let mut cost_u_half_step = T::zero();
 
         // Compute the cost at the half step
-        (self.problem.cost)(&self.cache.u_half_step, &mut cost_u_half_step)?;
+        instrumented!(
+            self.cache.statistics,
+            Phase::CostEvaluation,
+            (self.problem.cost)(&self.cache.u_half_step, &mut cost_u_half_step)
+        )?;
 
         // Compute the cost at u_current (save it in `cache.cost_value`)
-        (self.problem.cost)(u_current, &mut self.cache.cost_value)?;
+        instrumented!(
+            self.cache.statistics,
+            Phase::CostEvaluation,
+            (self.problem.cost)(u_current, &mut self.cache.cost_value)
+        )?;
 
         let mut it_lipschitz_search = 0;
 
         while cost_u_half_step > self.lipschitz_check_rhs()
             && it_lipschitz_search < MAX_LIPSCHITZ_UPDATE_ITERATIONS
-            && self.cache.lipschitz_constant < MAX_LIPSCHITZ_CONSTANT
+            && self.cache.lipschitz_constant < T::from_f64(MAX_LIPSCHITZ_CONSTANT)
         {
+            let timer = PhaseTimer::start();
             self.cache.lbfgs.reset(); // invalidate the L-BFGS buffer
+            if let Some(anderson) = self.cache.anderson.as_mut() {
+                anderson.reset(); // the forward-backward map has changed
+            }
 
             // update L, sigma and gamma...
-            self.cache.lipschitz_constant *= 2.;
-            self.cache.gamma /= 2.;
+            self.cache.lipschitz_constant *= T::from_f64(2.0);
+            self.cache.gamma /= T::from_f64(2.0);
 
             // recompute the half step...
             self.gradient_step(u_current); // updates self.cache.gradient_step
@@ -188,23 +321,28 @@ where
 
             // recompute the cost at the half step
             // update `cost_u_half_step`
-            (self.problem.cost)(&self.cache.u_half_step, &mut cost_u_half_step)?;
+            instrumented!(
+                self.cache.statistics,
+                Phase::CostEvaluation,
+                (self.problem.cost)(&self.cache.u_half_step, &mut cost_u_half_step)
+            )?;
 
             // recompute the FPR and the square of its norm
             self.compute_fpr(u_current);
             it_lipschitz_search += 1;
+            self.cache.statistics.record(Phase::LipschitzUpdate, timer);
         }
-        self.cache.sigma = (1.0 - GAMMA_L_COEFF) / (4.0 * self.cache.gamma);
+        self.cache.sigma = T::from_f64(1.0 - GAMMA_L_COEFF) / (T::from_f64(4.0) * self.cache.gamma);
 
         Ok(())
     }
 
     /// Computes u_plus ← u - gamma * (1-tau) * fpr - tau * dir,
-    fn compute_u_plus(&mut self, u: &[f64]) {
+    fn compute_u_plus(&mut self, u: &[T]) {
         let cache = &mut self.cache;
         let _gamma = cache.gamma;
         let tau = cache.tau;
-        let temp_ = 1.0 - tau;
+        let temp_ = T::one() - tau;
         cache
             .u_plus
             .iter_mut()
@@ -222,21 +360,23 @@ where
 
         // dist squared ← norm(gradient step - u half step)^2
         let dist_squared =
-            matrix_operations::norm2_squared_diff(&cache.gradient_step, &cache.u_half_step);
+            matrix_operations::solver::norm2_squared_diff(&cache.gradient_step, &cache.u_half_step);
 
         // rhs_ls ← f - (gamma/2) * norm(gradf)^2
         //            + 0.5 * dist squared / gamma
         //            - sigma * norm_gamma_fpr^2
+        let half = T::from_f64(0.5);
         let fbe = cache.cost_value
-            - 0.5 * cache.gamma * matrix_operations::norm2_squared(&cache.gradient_u)
-            + 0.5 * dist_squared / cache.gamma;
+            - half * cache.gamma * matrix_operations::solver::norm2_squared(&cache.gradient_u)
+            + half * dist_squared / cache.gamma;
         let sigma_fpr_sq = cache.sigma * cache.norm_gamma_fpr.powi(2);
         cache.rhs_ls = fbe - sigma_fpr_sq;
     }
 
     /// Computes the left hand side of the line search condition and compares it with the RHS;
     /// returns `true` if and only if lhs > rhs (when the line search should continue)
-    fn line_search_condition(&mut self, u: &[f64]) -> Result<bool, SolverError> {
+    fn line_search_condition(&mut self, u: &[T]) -> Result<bool, SolverError> {
+        let timer = PhaseTimer::start();
         let gamma = self.cache.gamma;
 
         // u_plus ← u - (1-tau)*gamma_fpr + tau*direction
@@ -245,65 +385,97 @@ where
         // Note: Here `cache.cost_value` and `cache.gradient_u` are overwritten
         // with the values of the cost and its gradient at the next (candidate)
         // point `u_plus`
-        (self.problem.cost)(&self.cache.u_plus, &mut self.cache.cost_value)?;
-        (self.problem.gradf)(&self.cache.u_plus, &mut self.cache.gradient_u)?;
-
-        self.gradient_step_uplus(); // gradient_step ← u_plus - gamma * gradient_u
+        let cache = &mut *self.cache;
+        self.problem.evaluate_cost_and_gradient(
+            &cache.u_plus,
+            &mut cache.cost_value,
+            &mut cache.gradient_u,
+            &mut cache.statistics,
+        )?;
+
+        // gradient_step ← u_plus - gamma * gradient_u
+        let norm_gradient_squared = self.gradient_step_uplus();
         self.half_step(); // u_half_step ← project(gradient_step)
 
         // Compute: dist_squared ← norm(gradient_step - u_half_step)^2
-        let dist_squared = matrix_operations::norm2_squared_diff(
+        let dist_squared = matrix_operations::solver::norm2_squared_diff(
             &self.cache.gradient_step,
             &self.cache.u_half_step,
         );
 
         // Update the LHS of the line search condition
-        self.cache.lhs_ls = self.cache.cost_value
-            - 0.5 * gamma * matrix_operations::norm2_squared(&self.cache.gradient_u)
-            + 0.5 * dist_squared / self.cache.gamma;
+        let half = T::from_f64(0.5);
+        self.cache.lhs_ls = self.cache.cost_value - half * gamma * norm_gradient_squared
+            + half * dist_squared / self.cache.gamma;
 
+        self.cache.statistics.record(Phase::Linesearch, timer);
         Ok(self.cache.lhs_ls > self.cache.rhs_ls)
     }
 
     /// Update without performing a line search; this is executed at the first iteration
-    fn update_no_linesearch(&mut self, u_current: &mut [f64]) -> FunctionCallResult {
+    fn update_no_linesearch(&mut self, u_current: &mut [T]) -> FunctionCallResult {
         u_current.copy_from_slice(&self.cache.u_half_step); // set u_current ← u_half_step
-        (self.problem.cost)(u_current, &mut self.cache.cost_value)?; // cost value
-        (self.problem.gradf)(u_current, &mut self.cache.gradient_u)?; // compute gradient
+        let cache = &mut *self.cache;
+        // cost value and gradient at u_current
+        self.problem.evaluate_cost_and_gradient(
+            u_current,
+            &mut cache.cost_value,
+            &mut cache.gradient_u,
+            &mut cache.statistics,
+        )?;
         self.gradient_step(u_current); // updated self.cache.gradient_step
         self.half_step(); // updates self.cache.u_half_step
 
         Ok(())
     }
 
-    /// Performs a line search to select tau
-    fn linesearch(&mut self, u_current: &mut [f64]) -> FunctionCallResult {
+    /// Performs a line search to select tau; returns the number of times tau
+    /// was halved
+    fn linesearch(&mut self, u_current: &mut [T]) -> Result<u32, SolverError> {
         // perform line search
         self.compute_rhs_ls(); // compute the right hand side of the line search
-        self.cache.tau = 1.0; // initialise tau ← 1.0
+        self.cache.tau = T::one(); // initialise tau ← 1.0
         let mut num_ls_iters = 0;
         while self.line_search_condition(u_current)? && num_ls_iters < MAX_LINESEARCH_ITERATIONS {
-            self.cache.tau /= 2.0;
+            self.cache.tau /= T::from_f64(2.0);
             num_ls_iters += 1;
         }
         if num_ls_iters == MAX_LINESEARCH_ITERATIONS {
-            self.cache.tau = 0.;
+            self.cache.tau = T::zero();
             u_current.copy_from_slice(&self.cache.u_half_step);
         }
         // Sets `u_current` to `u_plus` (u_current ← u_plus)
         u_current.copy_from_slice(&self.cache.u_plus);
 
-        Ok(())
+        Ok(num_ls_iters)
+    }
+
+    /// Appends a record of the current iteration to the trace, if any
+    #[inline]
+    fn record_trace(&mut self, linesearch_backtracks: u32) {
+        let cache = &mut *self.cache;
+        if let Some(trace) = cache.trace.as_mut() {
+            trace.record(
+                cache.iteration,
+                cache.gamma.as_f64(),
+                cache.tau.as_f64(),
+                cache.norm_gamma_fpr.as_f64(),
+                cache.cost_value.as_f64(),
+                linesearch_backtracks as usize,
+            );
+        }
     }
 }
 
 /// Implementation of the `step` and `init` methods of [trait.AlgorithmEngine.html]
-impl<'a, GradientType, ConstraintType, CostType> AlgorithmEngine
-    for PANOCEngine<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T, CostGradientType> AlgorithmEngine<T>
+    for PANOCEngine<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// PANOC step
     ///
@@ -315,7 +487,7 @@ where
     ///   iterate of PANOC
     ///
     ///
-    fn step(&mut self, u_current: &mut [f64]) -> Result<bool, SolverError> {
+    fn step(&mut self, u_current: &mut [T]) -> Result<bool, SolverError> {
         // caches the previous gradient vector (copies df to df_previous)
         self.cache.cache_previous_gradient();
 
@@ -328,13 +500,15 @@ where
             return Ok(false);
         }
         self.update_lipschitz_constant(u_current)?; // update lipschitz constant
-        self.lbfgs_direction(u_current); // compute LBFGS direction (update LBFGS buffer)
-        if self.cache.iteration == 0 {
+        self.compute_direction(u_current); // compute LBFGS (or Anderson) direction
+        let linesearch_backtracks = if self.cache.iteration == 0 {
             // first iteration, no line search is performed
             self.update_no_linesearch(u_current)?;
+            0
         } else {
-            self.linesearch(u_current)?;
-        }
+            self.linesearch(u_current)?
+        };
+        self.record_trace(linesearch_backtracks);
 
         self.cache.iteration += 1;
         Ok(true)
@@ -349,12 +523,32 @@ where
     /// gradient of the cost at the initial point, initial estimates for `gamma` and `sigma`,
     /// a gradient step and a half step (projected gradient step)
     ///
-    fn init(&mut self, u_current: &mut [f64]) -> FunctionCallResult {
-        self.cache.reset();
-        (self.problem.cost)(u_current, &mut self.cache.cost_value)?; // cost value
-        self.estimate_loc_lip(u_current)?; // computes the gradient as well! (self.cache.gradient_u)
-        self.cache.gamma = GAMMA_L_COEFF / f64::max(self.cache.lipschitz_constant, MIN_L_ESTIMATE);
-        self.cache.sigma = (1.0 - GAMMA_L_COEFF) / (4.0 * self.cache.gamma);
+    /// In a warm start (see `WarmStartPolicy`), the Lipschitz constant, `gamma` and
+    /// the L-BFGS buffer of the previous solve are used instead, so only the cost and
+    /// its gradient are computed
+    ///
+    fn init(&mut self, u_current: &mut [T]) -> FunctionCallResult {
+        if self.cache.can_warm_start() {
+            self.cache.reset_iteration_state();
+            let cache = &mut *self.cache;
+            self.problem.evaluate_cost_and_gradient(
+                u_current,
+                &mut cache.cost_value,
+                &mut cache.gradient_u,
+                &mut cache.statistics,
+            )?;
+        } else {
+            self.cache.reset();
+            instrumented!(
+                self.cache.statistics,
+                Phase::CostEvaluation,
+                (self.problem.cost)(u_current, &mut self.cache.cost_value) // cost value
+            )?;
+            self.estimate_loc_lip(u_current)?; // computes the gradient as well! (self.cache.gradient_u)
+            self.cache.gamma = T::from_f64(GAMMA_L_COEFF)
+                / T::max(self.cache.lipschitz_constant, T::from_f64(MIN_L_ESTIMATE));
+        }
+        self.cache.sigma = T::from_f64(1.0 - GAMMA_L_COEFF) / (T::from_f64(4.0) * self.cache.gamma);
         self.gradient_step(u_current); // updated self.cache.gradient_step
         self.half_step(); // updates self.cache.u_half_step
 
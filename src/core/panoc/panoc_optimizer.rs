@@ -3,10 +3,14 @@
 use crate::{
     constraints,
     core::{
-        panoc::panoc_engine::PANOCEngine, panoc::PANOCCache, AlgorithmEngine, ExitStatus,
-        Optimizer, Problem, SolverStatus,
+        deadline::Deadline,
+        multistart::{self, EarlyStop},
+        panoc::panoc_engine::PANOCEngine,
+        panoc::PANOCCache,
+        problem::CostAndGradientType,
+        AlgorithmEngine, ExitStatus, Optimizer, Problem, SolverStatus,
     },
-    matrix_operations, FunctionCallResult, SolverError,
+    matrix_operations, FunctionCallResult, Scalar, SolverError,
 };
 use std::time;
 
@@ -14,24 +18,41 @@ const MAX_ITER: usize = 100_usize;
 
 /// Optimizer using the PANOC algorithm
 ///
+/// The decision variables are of type `T`, which is `f64` by default
+/// (see [`Scalar`](crate::Scalar))
 ///
-pub struct PANOCOptimizer<'a, GradientType, ConstraintType, CostType>
-where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+pub struct PANOCOptimizer<
+    'a,
+    GradientType,
+    ConstraintType,
+    CostType,
+    T = f64,
+    CostGradientType = CostAndGradientType<T>,
+> where
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
-    panoc_engine: PANOCEngine<'a, GradientType, ConstraintType, CostType>,
+    panoc_engine: PANOCEngine<'a, GradientType, ConstraintType, CostType, T, CostGradientType>,
     max_iter: usize,
     max_duration: Option<time::Duration>,
+    deadline: Option<Deadline>,
+    early_stop: Option<&'a EarlyStop<'a>>,
+    /// Outer iteration and penalty parameter of an inner problem of ALM/PM
+    /// (for the trace, if any)
+    outer_iteration: Option<(usize, f64)>,
 }
 
-impl<'a, GradientType, ConstraintType, CostType>
-    PANOCOptimizer<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
+    PANOCOptimizer<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// Constructor of `PANOCOptimizer`
     ///
@@ -44,13 +65,16 @@ where
     ///
     /// Does not panic
     pub fn new(
-        problem: Problem<'a, GradientType, ConstraintType, CostType>,
-        cache: &'a mut PANOCCache,
+        problem: Problem<'a, GradientType, ConstraintType, CostType, T, CostGradientType>,
+        cache: &'a mut PANOCCache<T>,
     ) -> Self {
         PANOCOptimizer {
             panoc_engine: PANOCEngine::new(problem, cache),
             max_iter: MAX_ITER,
             max_duration: None,
+            deadline: None,
+            early_stop: None,
+            outer_iteration: None,
         }
     }
 
@@ -62,8 +86,8 @@ where
     /// ## Panics
     ///
     /// The method panics if the specified tolerance is not positive
-    pub fn with_tolerance(self, tolerance: f64) -> Self {
-        assert!(tolerance > 0.0, "tolerance must be larger than 0");
+    pub fn with_tolerance(self, tolerance: T) -> Self {
+        assert!(tolerance > T::zero(), "tolerance must be larger than 0");
 
         self.panoc_engine.cache.tolerance = tolerance;
         self
@@ -90,8 +114,11 @@ where
     /// The method panics if the provided value of the AKKT-specific tolerance is
     /// not positive.
     ///
-    pub fn with_akkt_tolerance(self, akkt_tolerance: f64) -> Self {
-        assert!(akkt_tolerance > 0.0, "akkt_tolerance must be positive");
+    pub fn with_akkt_tolerance(self, akkt_tolerance: T) -> Self {
+        assert!(
+            akkt_tolerance > T::zero(),
+            "akkt_tolerance must be positive"
+        );
         self.panoc_engine.cache.set_akkt_tolerance(akkt_tolerance);
         self
     }
@@ -113,17 +140,96 @@ where
         self.max_duration = Some(max_duation);
         self
     }
+
+    /// Sets a deadline, for hard real-time applications (anytime mode)
+    ///
+    /// Unlike `with_max_duration`, the clock is not read at every iteration;
+    /// instead, PANOC predicts the duration of an iteration (the prediction
+    /// is stored in the cache and refined from one solve to the next, see
+    /// `PANOCCache::predicted_iteration_time`) and stops so as to return
+    /// before the deadline. If the deadline is hit, the solver returns the best
+    /// iterate found so far, that is, the one with the smallest fixed-point
+    /// residual, and reports `ExitStatus::NotConvergedOutOfTime`.
+    ///
+    /// If a deadline is set, the maximum duration is not used.
+    ///
+    /// ## Arguments
+    ///
+    /// - `deadline`: available time, measured from the start of `solve`
+    ///
+    pub fn with_deadline(mut self, deadline: time::Duration) -> Self {
+        self.deadline = Some(Deadline::new(deadline));
+        self
+    }
+
+    /// Shares the (possibly running) deadline of an outer solver
+    pub(crate) fn with_shared_deadline(mut self, deadline: Deadline) -> Self {
+        self.deadline = Some(deadline);
+        self
+    }
+
+    /// Marks the problem as the inner problem of the given outer iteration of
+    /// ALM/PM, so that the trace of the cache (if any) is not cleared and its
+    /// records store the outer iteration and the penalty parameter
+    pub(crate) fn with_outer_iteration(mut self, outer_iteration: usize, penalty: f64) -> Self {
+        self.outer_iteration = Some((outer_iteration, penalty));
+        self
+    }
+
+    /// Sets the early-stopping criterion of a multi-start solve (see
+    /// [`multistart`](crate::core::multistart))
+    ///
+    /// The criterion is checked at every iteration with the current cost; if
+    /// the solver stops early, it reports `ExitStatus::NotConvergedIterations`
+    pub fn with_early_stop(mut self, early_stop: &'a EarlyStop<'a>) -> Self {
+        self.early_stop = Some(early_stop);
+        self
+    }
+
+    /// Whether the solver should stop because another start of a multi-start
+    /// solve has found a clearly better solution
+    fn is_dominated(&self) -> bool {
+        self.early_stop.map_or(false, |early_stop| {
+            early_stop.should_stop(self.panoc_engine.cache.cost_value.as_f64())
+        })
+    }
+
+    /// Stores the current (feasible) iterate, `u_half_step`, if it has a
+    /// smaller fixed-point residual than the best iterate so far, whose
+    /// residual and cost are `best`
+    fn keep_best_iterate(&mut self, best: &mut (T, T)) {
+        let cache = &mut self.panoc_engine.cache;
+        if cache.norm_gamma_fpr < best.0 {
+            cache.best_iterate.copy_from_slice(&cache.u_half_step);
+            *best = (cache.norm_gamma_fpr, cache.cost_value);
+        }
+    }
 }
 
-impl<'life, GradientType, ConstraintType, CostType> Optimizer
-    for PANOCOptimizer<'life, GradientType, ConstraintType, CostType>
+impl<'life, GradientType, ConstraintType, CostType, T, CostGradientType> Optimizer<T>
+    for PANOCOptimizer<'life, GradientType, ConstraintType, CostType, T, CostGradientType>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult + 'life,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint + 'life,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult + 'life,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T> + 'life,
 {
-    fn solve(&mut self, u: &mut [f64]) -> Result<SolverStatus, SolverError> {
+    fn solve(&mut self, u: &mut [T]) -> Result<SolverStatus, SolverError> {
         let now = instant::Instant::now();
+        let mut deadline = self.deadline;
+        if let Some(deadline) = deadline.as_mut() {
+            deadline.start(self.panoc_engine.cache.iteration_time);
+        }
+
+        if let Some(trace) = self.panoc_engine.cache.trace.as_mut() {
+            match self.outer_iteration {
+                Some((outer_iteration, penalty)) => {
+                    trace.set_outer_iteration(outer_iteration, penalty)
+                }
+                None => trace.clear(),
+            }
+        }
 
         /*
          * Initialise [call panoc_engine.init()]
@@ -135,20 +241,40 @@ where
         let mut num_iter: usize = 0;
         let mut continue_num_iters = true;
         let mut continue_runtime = true;
+        let mut dominated = false;
 
         let mut step_flag = self.panoc_engine.step(u)?;
-        if let Some(dur) = self.max_duration {
-            while step_flag && continue_num_iters && continue_runtime {
+        let mut best = (T::infinity(), T::zero());
+        if let Some(deadline) = deadline.as_mut() {
+            // the first solve with a deadline allocates memory for the best iterate
+            let n = u.len();
+            self.panoc_engine.cache.best_iterate.resize(n, T::zero());
+            self.keep_best_iterate(&mut best);
+            while step_flag && continue_num_iters && continue_runtime && !dominated {
+                continue_runtime =
+                    !deadline.should_stop(&mut self.panoc_engine.cache.iteration_time);
+                if continue_runtime {
+                    num_iter += 1;
+                    continue_num_iters = num_iter < self.max_iter;
+                    step_flag = self.panoc_engine.step(u)?;
+                    dominated = step_flag && self.is_dominated();
+                    self.keep_best_iterate(&mut best);
+                }
+            }
+        } else if let Some(dur) = self.max_duration {
+            while step_flag && continue_num_iters && continue_runtime && !dominated {
                 num_iter += 1;
                 continue_num_iters = num_iter < self.max_iter;
                 continue_runtime = now.elapsed() <= dur;
                 step_flag = self.panoc_engine.step(u)?;
+                dominated = step_flag && self.is_dominated();
             }
         } else {
-            while step_flag && continue_num_iters {
+            while step_flag && continue_num_iters && !dominated {
                 num_iter += 1;
                 continue_num_iters = num_iter < self.max_iter;
                 step_flag = self.panoc_engine.step(u)?;
+                dominated = step_flag && self.is_dominated();
             }
         }
 
@@ -162,6 +288,8 @@ where
             ExitStatus::NotConvergedIterations
         } else if !continue_runtime {
             ExitStatus::NotConvergedOutOfTime
+        } else if dominated {
+            multistart::ABANDONED_EXIT_STATUS
         } else {
             ExitStatus::Converged
         };
@@ -170,14 +298,26 @@ where
         // because it's always feasible, while u may violate the constraints)
         u.copy_from_slice(&self.panoc_engine.cache.u_half_step);
 
+        // out of time: return the best iterate so far
+        let cache = &mut self.panoc_engine.cache;
+        if exit_status == ExitStatus::NotConvergedOutOfTime && best.0 < cache.norm_gamma_fpr {
+            u.copy_from_slice(&cache.best_iterate);
+            cache.norm_gamma_fpr = best.0;
+            cache.cost_value = best.1;
+        }
+
+        // only a converged solve can be used as a warm start
+        self.panoc_engine.cache.warm_start_available = exit_status == ExitStatus::Converged;
+
         // export solution status (exit status, num iterations and more)
         Ok(SolverStatus::new(
             exit_status,
             num_iter,
             now.elapsed(),
-            self.panoc_engine.cache.norm_gamma_fpr,
-            self.panoc_engine.cache.cost_value,
-        ))
+            self.panoc_engine.cache.norm_gamma_fpr.as_f64(),
+            self.panoc_engine.cache.cost_value.as_f64(),
+        )
+        .with_statistics(self.panoc_engine.cache.statistics))
     }
 }
 
@@ -141,6 +141,259 @@ fn t_test_panoc_rosenbrock() {
     println!("u = {:?}", u_solution);
 }
 
+#[test]
+fn t_test_panoc_anderson() {
+    let a_param = 1.0;
+    let b_param = 100.0;
+    let cost_gradient = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        mocks::rosenbrock_grad(a_param, b_param, u, grad);
+        Ok(())
+    };
+    let cost_function = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = mocks::rosenbrock_cost(a_param, b_param, u);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0);
+    let solve = |panoc_cache: &mut PANOCCache| {
+        let problem = Problem::new(&bounds, cost_gradient, cost_function);
+        let mut panoc = PANOCOptimizer::new(problem, panoc_cache).with_max_iter(500);
+        let mut u = [-1.5, 0.9];
+        let status = panoc.solve(&mut u).unwrap();
+        assert!(status.has_converged());
+        u
+    };
+    let u_lbfgs = solve(&mut PANOCCache::new(2, 1e-10, 5));
+    let mut panoc_cache = PANOCCache::new(2, 1e-10, 5).with_anderson_acceleration(3);
+    let u_anderson = solve(&mut panoc_cache);
+    assert!(panoc_cache.anderson.is_some());
+    unit_test_utils::assert_nearly_equal_array(&u_lbfgs, &u_anderson, 1e-6, 1e-8, "u");
+}
+
+#[test]
+fn t_test_panoc_trace() {
+    let a_param = 1.0;
+    let b_param = 100.0;
+    let cost_gradient = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        mocks::rosenbrock_grad(a_param, b_param, u, grad);
+        Ok(())
+    };
+    let cost_function = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = mocks::rosenbrock_cost(a_param, b_param, u);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0);
+    let mut panoc_cache = PANOCCache::new(2, 1e-10, 5).with_trace(500);
+    let mut u = [-1.5, 0.9];
+    let status = {
+        let problem = Problem::new(&bounds, cost_gradient, cost_function);
+        let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(500);
+        panoc.solve(&mut u).unwrap()
+    };
+    assert!(status.has_converged());
+    let trace = panoc_cache.trace().unwrap();
+    assert_eq!(status.iterations(), trace.len());
+    assert_eq!(0, trace.num_dropped());
+    for (k, record) in trace.iter().enumerate() {
+        assert_eq!(k, record.inner_iteration);
+        assert!(record.gamma > 0.0 && record.tau >= 0.0 && record.tau <= 1.0);
+        assert!(record.outer_iteration.is_none() && record.penalty.is_nan());
+    }
+    let first = trace.iter().next().unwrap();
+    assert_eq!((1.0, 0), (first.tau, first.linesearch_backtracks));
+    assert!(trace.iter().any(|record| record.linesearch_backtracks > 0));
+    assert!(trace.last().unwrap().norm_fpr < first.norm_fpr);
+
+    // a small trace keeps the last iterations of the solve
+    let mut panoc_cache = PANOCCache::new(2, 1e-10, 5).with_trace(4);
+    let problem = Problem::new(&bounds, cost_gradient, cost_function);
+    let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(500);
+    let mut u = [-1.5, 0.9];
+    let status = panoc.solve(&mut u).unwrap();
+    let trace = panoc_cache.trace().unwrap();
+    assert_eq!(4, trace.len());
+    assert_eq!(status.iterations(), trace.num_recorded());
+    assert_eq!(
+        status.iterations() - 1,
+        trace.last().unwrap().inner_iteration
+    );
+}
+
+#[test]
+fn t_test_panoc_deadline() {
+    let (a_param, b_param) = (1.0, 100.0);
+    // slow gradient, so that the deadline is hit after a few iterations
+    let cost_gradient = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        std::thread::sleep(std::time::Duration::from_micros(500));
+        mocks::rosenbrock_grad(a_param, b_param, u, grad);
+        Ok(())
+    };
+    let cost_function = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = mocks::rosenbrock_cost(a_param, b_param, u);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0);
+    let deadline = std::time::Duration::from_millis(10);
+    let mut panoc_cache = PANOCCache::new(2, 1e-14, 5);
+    assert!(panoc_cache.predicted_iteration_time().is_none());
+    for _ in 0..2 {
+        let problem = Problem::new(&bounds, cost_gradient, cost_function);
+        let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache)
+            .with_max_iter(10_000)
+            .with_deadline(deadline);
+        let mut u = [-1.5, 0.9];
+        let status = panoc.solve(&mut u).unwrap();
+        assert_eq!(ExitStatus::NotConvergedOutOfTime, status.exit_status());
+        assert!(status.iterations() > 0);
+        // the deadline is met with a (small) tolerance for the overhead of the tests
+        assert!(status.solve_time() < deadline + std::time::Duration::from_millis(2));
+        // the best iterate is feasible
+        assert!(crate::matrix_operations::norm2(&u) <= 1.0 + 1e-12);
+        assert!(status.norm_fpr().is_finite());
+        assert!(
+            panoc_cache.predicted_iteration_time().unwrap() > std::time::Duration::from_micros(500)
+        );
+    }
+}
+
+#[test]
+fn t_test_panoc_rosenbrock_cost_and_gradient() {
+    let (a_param, b_param) = (1.0, 100.0);
+    let num_cost_and_gradient_calls = std::cell::Cell::new(0);
+    let num_gradient_calls = std::cell::Cell::new(0);
+    let cost_gradient = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        num_gradient_calls.set(num_gradient_calls.get() + 1);
+        mocks::rosenbrock_grad(a_param, b_param, u, grad);
+        Ok(())
+    };
+    let cost_function = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = mocks::rosenbrock_cost(a_param, b_param, u);
+        Ok(())
+    };
+    let cost_and_gradient = |u: &[f64], c: &mut f64, grad: &mut [f64]| -> FunctionCallResult {
+        num_cost_and_gradient_calls.set(num_cost_and_gradient_calls.get() + 1);
+        *c = mocks::rosenbrock_cost(a_param, b_param, u);
+        mocks::rosenbrock_grad(a_param, b_param, u, grad);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0);
+
+    // solve using the combined function...
+    let problem = Problem::new(&bounds, cost_gradient, cost_function)
+        .with_cost_and_gradient(cost_and_gradient);
+    let mut panoc_cache = PANOCCache::new(2, 1e-10, 5);
+    let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(200);
+    let mut u = [-1.5, 0.9];
+    let status = panoc.solve(&mut u).unwrap();
+    assert!(status.has_converged());
+    // the gradient function is only used to estimate the initial Lipschitz constant
+    assert_eq!(2, num_gradient_calls.get());
+    assert!(num_cost_and_gradient_calls.get() >= status.iterations());
+
+    // ...and without it: the iterates are the same
+    let problem = Problem::new(&bounds, cost_gradient, cost_function);
+    let mut panoc_cache = PANOCCache::new(2, 1e-10, 5);
+    let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(200);
+    let mut u_separate = [-1.5, 0.9];
+    let status_separate = panoc.solve(&mut u_separate).unwrap();
+    assert_eq!(status.iterations(), status_separate.iterations());
+    assert_eq!(u, u_separate);
+}
+
+#[test]
+fn t_test_panoc_rosenbrock_warm_start() {
+    let a_param = 1.0;
+    let b_param = std::cell::Cell::new(100.0);
+    let num_gradient_calls = std::cell::Cell::new(0);
+    let cost_gradient = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        num_gradient_calls.set(num_gradient_calls.get() + 1);
+        mocks::rosenbrock_grad(a_param, b_param.get(), u, grad);
+        Ok(())
+    };
+    let cost_function = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = mocks::rosenbrock_cost(a_param, b_param.get(), u);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0);
+
+    // solves the problem with b = 100 and then, starting from its solution,
+    // the problem with b = 110; returns the solution and the number of gradient
+    // evaluations of the second solve
+    let solve = |warm_start: WarmStartPolicy| {
+        b_param.set(100.0);
+        let mut panoc_cache = PANOCCache::new(2, 1e-8, 5).with_warm_start(warm_start);
+        let mut u = [-1.5, 0.9];
+        {
+            let problem = Problem::new(&bounds, cost_gradient, cost_function);
+            let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(200);
+            assert!(panoc.solve(&mut u).unwrap().has_converged());
+        }
+        let lipschitz_constant = panoc_cache.lipschitz_constant;
+        b_param.set(110.0);
+        num_gradient_calls.set(0);
+        let problem = Problem::new(&bounds, cost_gradient, cost_function);
+        let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(200);
+        assert!(panoc.solve(&mut u).unwrap().has_converged());
+        if warm_start == WarmStartPolicy::Cold {
+            assert_ne!(lipschitz_constant, panoc_cache.lipschitz_constant);
+        } else {
+            // the Lipschitz constant is not estimated again; it can only increase
+            assert!(panoc_cache.lipschitz_constant >= lipschitz_constant);
+        }
+        (u, num_gradient_calls.get())
+    };
+
+    let (u_cold, num_gradient_calls_cold) = solve(WarmStartPolicy::Cold);
+    let (u_warm, num_gradient_calls_warm) = solve(WarmStartPolicy::AcrossSolves);
+    unit_test_utils::assert_nearly_equal_array(&u_cold, &u_warm, 1e-6, 1e-8, "u");
+    assert!(num_gradient_calls_warm < num_gradient_calls_cold);
+}
+
+#[test]
+fn t_test_panoc_rosenbrock_single_precision() {
+    let (a_param, b_param) = (1.0, 100.0);
+    let cost_gradient = |u: &[f32], grad: &mut [f32]| -> FunctionCallResult {
+        grad[0] = 2.0 * u[0] - 2.0 * a_param - 4.0 * b_param * u[0] * (u[1] - u[0].powi(2));
+        grad[1] = b_param * (2.0 * u[1] - 2.0 * u[0].powi(2));
+        Ok(())
+    };
+    let cost_function = |u: &[f32], c: &mut f32| -> FunctionCallResult {
+        *c = (a_param - u[0]).powi(2) + b_param * (u[1] - u[0].powi(2)).powi(2);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0_f32);
+    let problem = Problem::new(&bounds, cost_gradient, cost_function);
+    let tolerance = 1e-4_f32;
+    let mut panoc_cache = PANOCCache::new(2, tolerance, 5);
+    let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(200);
+    let mut u = [-1.5_f32, 0.9];
+    let status = panoc.solve(&mut u).unwrap();
+    assert!(status.has_converged());
+    assert!(status.norm_fpr() <= tolerance as f64);
+
+    // compare with the solution in double precision
+    let cost_gradient = |u: &[f64], grad: &mut [f64]| -> FunctionCallResult {
+        mocks::rosenbrock_grad(1.0, 100.0, u, grad);
+        Ok(())
+    };
+    let cost_function = |u: &[f64], c: &mut f64| -> FunctionCallResult {
+        *c = mocks::rosenbrock_cost(1.0, 100.0, u);
+        Ok(())
+    };
+    let bounds = constraints::Ball2::new(None, 1.0);
+    let problem = Problem::new(&bounds, cost_gradient, cost_function);
+    let mut panoc_cache = PANOCCache::new(2, 1e-10, 5);
+    let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(200);
+    let mut u_double = [-1.5, 0.9];
+    assert!(panoc.solve(&mut u_double).unwrap().has_converged());
+    unit_test_utils::assert_nearly_equal_array(
+        &u_double,
+        &[u[0] as f64, u[1] as f64],
+        1e-3,
+        1e-4,
+        "single-precision solution",
+    );
+}
+
 #[test]
 fn t_zero_gamma_l() {
     let tolerance = 1e-8;
@@ -216,3 +469,32 @@ fn t_zero_gamma_huber() {
     println!("iters = {}", panoc_cache.iteration);
     assert!(panoc_cache.norm_gamma_fpr <= tolerance);
 }
+
+#[test]
+fn t_panoc_statistics() {
+    let bounds = constraints::Ball2::new(None, 0.2);
+    let problem = Problem::new(&bounds, mocks::my_gradient, mocks::my_cost);
+    let mut panoc_cache = PANOCCache::new(2, 1e-9, 5);
+    let mut panoc = PANOCOptimizer::new(problem, &mut panoc_cache).with_max_iter(100);
+
+    let mut u = [0.0, 0.0];
+    let status = panoc.solve(&mut u).unwrap();
+    let stats = status.statistics();
+    if SolverStatistics::is_enabled() {
+        assert_eq!(1, stats.count(Phase::LipschitzEstimation));
+        assert!(stats.count(Phase::GradientEvaluation) >= status.iterations() + 2);
+        assert!(stats.count(Phase::HalfStep) >= status.iterations() + 1);
+        assert!(stats.count(Phase::Linesearch) + 1 >= status.iterations());
+        assert_eq!(status.iterations(), stats.count(Phase::LbfgsDirection));
+        assert_eq!(0, stats.count(Phase::F1Evaluation));
+    } else {
+        assert_eq!(SolverStatistics::new(), *stats);
+    }
+
+    // the statistics are reset when the solver is called again
+    let status_again = panoc.solve(&mut [0.0, 0.0]).unwrap();
+    assert_eq!(
+        stats.count(Phase::HalfStep),
+        status_again.statistics().count(Phase::HalfStep)
+    );
+}
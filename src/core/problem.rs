@@ -6,7 +6,15 @@
 //! Cost functions are user defined. They can either be defined in Rust or in
 //! C (and then invoked from Rust via an interface such as icasadi).
 //!
-use crate::{constraints, FunctionCallResult};
+use crate::{
+    constraints,
+    core::instrumentation::{instrumented, Phase, SolverStatistics},
+    FunctionCallResult, Scalar,
+};
+use std::marker::PhantomData;
+
+/// Type of a function which computes the cost and its gradient at the same point
+pub type CostAndGradientType<T = f64> = fn(&[T], &mut T, &mut [T]) -> FunctionCallResult;
 
 /// Definition of an optimisation problem
 ///
@@ -15,11 +23,27 @@ use crate::{constraints, FunctionCallResult};
 /// - the cost function
 /// - the set of constraints, which is described by implementations of
 ///   [Constraint](../../panoc_rs/constraints/trait.Constraint.html)
-pub struct Problem<'a, GradientType, ConstraintType, CostType>
-where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+///
+/// The decision variables are of type `T`, which is `f64` by default
+/// (see [`Scalar`](crate::Scalar))
+///
+/// Optionally, a function which computes the cost and its gradient at the same
+/// point can be provided (see `with_cost_and_gradient`); the solver then uses it
+/// where both are needed, so that the computations that the cost and its gradient
+/// have in common are carried out once
+pub struct Problem<
+    'a,
+    GradientType,
+    ConstraintType,
+    CostType,
+    T = f64,
+    CostGradientType = CostAndGradientType<T>,
+> where
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// constraints
     pub(crate) constraints: &'a ConstraintType,
@@ -27,13 +51,18 @@ where
     pub(crate) gradf: GradientType,
     /// cost function
     pub(crate) cost: CostType,
+    /// cost function and its gradient (optional)
+    pub(crate) cost_and_gradient: Option<CostGradientType>,
+    scalar: PhantomData<T>,
 }
 
-impl<'a, GradientType, ConstraintType, CostType> Problem<'a, GradientType, ConstraintType, CostType>
+impl<'a, GradientType, ConstraintType, CostType, T>
+    Problem<'a, GradientType, ConstraintType, CostType, T>
 where
-    GradientType: Fn(&[f64], &mut [f64]) -> FunctionCallResult,
-    CostType: Fn(&[f64], &mut f64) -> FunctionCallResult,
-    ConstraintType: constraints::Constraint,
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
 {
     /// Construct a new instance of an optimisation problem
     ///
@@ -50,11 +79,91 @@ where
         constraints: &'a ConstraintType,
         cost_gradient: GradientType,
         cost: CostType,
-    ) -> Problem<'a, GradientType, ConstraintType, CostType> {
+    ) -> Problem<'a, GradientType, ConstraintType, CostType, T> {
         Problem {
             constraints,
             gradf: cost_gradient,
             cost,
+            cost_and_gradient: None,
+            scalar: PhantomData,
+        }
+    }
+
+    /// Specifies a function which computes the cost and its gradient at the same point
+    ///
+    /// ## Arguments
+    ///
+    /// - `cost_and_gradient` function of the form `f(u, cost, gradient)` which computes
+    ///    the cost and its gradient at `u`
+    ///
+    /// ## Returns
+    ///
+    /// The problem with the given function (the cost and gradient functions which were
+    /// provided in `new` are still used where only one of the two is needed)
+    pub fn with_cost_and_gradient<CostGradientType>(
+        self,
+        cost_and_gradient: CostGradientType,
+    ) -> Problem<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
+    where
+        CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    {
+        self.with_optional_cost_and_gradient(Some(cost_and_gradient))
+    }
+
+    /// Same as `with_cost_and_gradient`, but the function is optional
+    pub(crate) fn with_optional_cost_and_gradient<CostGradientType>(
+        self,
+        cost_and_gradient: Option<CostGradientType>,
+    ) -> Problem<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
+    where
+        CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    {
+        Problem {
+            constraints: self.constraints,
+            gradf: self.gradf,
+            cost: self.cost,
+            cost_and_gradient,
+            scalar: PhantomData,
+        }
+    }
+}
+
+impl<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
+    Problem<'a, GradientType, ConstraintType, CostType, T, CostGradientType>
+where
+    T: Scalar,
+    GradientType: Fn(&[T], &mut [T]) -> FunctionCallResult,
+    CostType: Fn(&[T], &mut T) -> FunctionCallResult,
+    CostGradientType: Fn(&[T], &mut T, &mut [T]) -> FunctionCallResult,
+    ConstraintType: constraints::Constraint<T>,
+{
+    /// Computes the cost and its gradient at `u`
+    ///
+    /// If a combined function has been provided, it is called once and its execution
+    /// is counted as one evaluation of the cost and one of the gradient (the time is
+    /// attributed to the evaluation of the cost)
+    pub(crate) fn evaluate_cost_and_gradient(
+        &self,
+        u: &[T],
+        cost: &mut T,
+        gradient: &mut [T],
+        statistics: &mut SolverStatistics,
+    ) -> FunctionCallResult {
+        if let Some(cost_and_gradient) = &self.cost_and_gradient {
+            instrumented!(
+                statistics,
+                Phase::CostEvaluation,
+                cost_and_gradient(u, cost, gradient)
+            )?;
+            statistics.add_count(Phase::GradientEvaluation, 1);
+        } else {
+            instrumented!(statistics, Phase::CostEvaluation, (self.cost)(u, cost))?;
+            instrumented!(
+                statistics,
+                Phase::GradientEvaluation,
+                (self.gradf)(u, gradient)
+            )?;
         }
+        Ok(())
     }
 }
@@ -1,7 +1,7 @@
 //! Status of the result of a solver (number of iterations, etc)
 //!
 //!
-use crate::core::ExitStatus;
+use crate::core::{ExitStatus, SolverStatistics};
 use std::time;
 
 /// Solver status
@@ -21,6 +21,9 @@ pub struct SolverStatus {
     fpr_norm: f64,
     /// cost value at the candidate solution
     cost_value: f64,
+    /// number of executions and duration of the phases of the algorithm
+    /// (only recorded with the feature `instrumentation`)
+    statistics: SolverStatistics,
 }
 
 impl SolverStatus {
@@ -48,9 +51,16 @@ impl SolverStatus {
             solve_time,
             fpr_norm,
             cost_value,
+            statistics: SolverStatistics::new(),
         }
     }
 
+    /// Attaches the statistics of the phases of the algorithm to the status
+    pub(crate) fn with_statistics(mut self, statistics: SolverStatistics) -> SolverStatus {
+        self.statistics = statistics;
+        self
+    }
+
     /// whether the algorithm has converged
     pub fn has_converged(&self) -> bool {
         self.exit_status == ExitStatus::Converged
@@ -80,4 +90,11 @@ impl SolverStatus {
     pub fn exit_status(&self) -> ExitStatus {
         self.exit_status
     }
+
+    /// number of executions and duration of the phases of the algorithm;
+    /// all entries are zero unless OpEn is compiled with the feature
+    /// `instrumentation` (see `core::instrumentation`)
+    pub fn statistics(&self) -> &SolverStatistics {
+        &self.statistics
+    }
 }
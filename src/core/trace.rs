@@ -0,0 +1,263 @@
+//! Tracing of the iterates of the solvers
+//!
+//! A [`PANOCCache`](../panoc/struct.PANOCCache.html) (or an `AlmCache`) that
+//! is constructed with `with_trace(capacity)` records one [`TraceRecord`]
+//! per PANOC iteration into an [`IterationTrace`], that is, a ring buffer of
+//! `capacity` records which is allocated together with the cache. Recording
+//! a record copies a few scalars into the buffer, so there is no allocation
+//! on the hot path; once the buffer is full, the oldest records are
+//! overwritten.
+//!
+//! The trace is cleared at the start of every solve, so after a solve it
+//! contains the last `capacity` iterations of that solve, which can be read
+//! with [`IterationTrace::iter`] or copied into a preallocated buffer with
+//! [`IterationTrace::copy_to`] (e.g., by a telemetry thread, between solves).
+//! Within the ALM/PM method, the records of the inner iterations also store
+//! the outer iteration, the penalty parameter and the infeasibility of the
+//! outer iteration.
+//!
+//! Without `with_trace`, nothing is recorded.
+//!
+
+/// Record of one iteration of PANOC
+#[derive(Debug, Clone, Copy, PartialEq, Default)]
+pub struct TraceRecord {
+    /// Outer (ALM/PM) iteration, starting from zero; `None` if PANOC is used
+    /// on its own
+    pub outer_iteration: Option<usize>,
+    /// Iteration of PANOC (within the inner problem)
+    pub inner_iteration: usize,
+    /// Step size, $\gamma$
+    pub gamma: f64,
+    /// Step of the line search, $\tau$ (one at the first iteration)
+    pub tau: f64,
+    /// Norm of the fixed-point residual, $\Vert\gamma R_\gamma(u)\Vert$
+    pub norm_fpr: f64,
+    /// Cost (of the inner problem, within ALM/PM) at the next iterate
+    pub cost: f64,
+    /// Number of times the line search halved $\tau$
+    pub linesearch_backtracks: usize,
+    /// Penalty parameter of the outer iteration; `NaN` if PANOC is used on
+    /// its own or if there are no ALM/PM-type constraints
+    pub penalty: f64,
+    /// Infeasibility of the outer iteration,
+    /// $\max\\{\Vert y^+ - y\Vert / c, \Vert F_2(u)\Vert\\}$; `NaN` if PANOC is
+    /// used on its own or if the outer iteration is not complete
+    pub infeasibility: f64,
+}
+
+/// Ring buffer of [`TraceRecord`]s (see the [module documentation](index.html))
+#[derive(Debug, Clone)]
+pub struct IterationTrace {
+    /// Records (allocated once, with length equal to the capacity)
+    records: Vec<TraceRecord>,
+    /// Position of the next record
+    head: usize,
+    /// Number of records in the buffer
+    len: usize,
+    /// Number of records since the trace was cleared
+    num_recorded: usize,
+    /// Outer iteration and penalty parameter of the next records
+    outer_iteration: Option<usize>,
+    penalty: f64,
+}
+
+impl IterationTrace {
+    /// Constructs a new trace which can hold `capacity` records
+    ///
+    /// ## Panics
+    ///
+    /// The method panics if `capacity` is zero
+    ///
+    pub fn new(capacity: usize) -> IterationTrace {
+        assert!(capacity > 0, "the capacity of the trace must be positive");
+        IterationTrace {
+            records: vec![TraceRecord::default(); capacity],
+            head: 0,
+            len: 0,
+            num_recorded: 0,
+            outer_iteration: None,
+            penalty: f64::NAN,
+        }
+    }
+
+    /// Maximum number of records in the trace
+    pub fn capacity(&self) -> usize {
+        self.records.len()
+    }
+
+    /// Number of records in the trace
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Whether the trace is empty
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Number of records since the start of the last solve, including those
+    /// that have been overwritten
+    pub fn num_recorded(&self) -> usize {
+        self.num_recorded
+    }
+
+    /// Number of records of the last solve that have been overwritten
+    pub fn num_dropped(&self) -> usize {
+        self.num_recorded - self.len
+    }
+
+    /// Records in chronological order (oldest first)
+    pub fn iter(&self) -> impl Iterator<Item = &TraceRecord> {
+        // until the buffer is full, the records are `records[..len]`
+        let (older, newer) = if self.len < self.capacity() {
+            (&self.records[..0], &self.records[..self.len])
+        } else {
+            (&self.records[self.head..], &self.records[..self.head])
+        };
+        older.iter().chain(newer.iter())
+    }
+
+    /// Most recent record, if any
+    pub fn last(&self) -> Option<&TraceRecord> {
+        if self.len == 0 {
+            None
+        } else {
+            let capacity = self.capacity();
+            Some(&self.records[(self.head + capacity - 1) % capacity])
+        }
+    }
+
+    /// Copies the most recent records, in chronological order, into `out`
+    /// and returns the number of copied records, which is the minimum of
+    /// `out.len()` and `self.len()`; this method does not allocate memory
+    pub fn copy_to(&self, out: &mut [TraceRecord]) -> usize {
+        let n = out.len().min(self.len);
+        self.iter()
+            .skip(self.len - n)
+            .zip(out.iter_mut())
+            .for_each(|(record, o)| *o = *record);
+        n
+    }
+
+    /// Removes all records
+    pub fn clear(&mut self) {
+        self.head = 0;
+        self.len = 0;
+        self.num_recorded = 0;
+        self.outer_iteration = None;
+        self.penalty = f64::NAN;
+    }
+
+    /// Sets the outer iteration and the penalty parameter of the next records
+    pub(crate) fn set_outer_iteration(&mut self, outer_iteration: usize, penalty: f64) {
+        self.outer_iteration = Some(outer_iteration);
+        self.penalty = penalty;
+    }
+
+    /// Sets the infeasibility of the records of the current outer iteration
+    /// (that are still in the buffer)
+    pub(crate) fn set_infeasibility(&mut self, infeasibility: f64) {
+        let capacity = self.capacity();
+        for k in 1..=self.len {
+            let record = &mut self.records[(self.head + capacity - k) % capacity];
+            if record.outer_iteration != self.outer_iteration {
+                break;
+            }
+            record.infeasibility = infeasibility;
+        }
+    }
+
+    /// Appends a record of an iteration of PANOC, overwriting the oldest
+    /// record if the buffer is full
+    #[inline]
+    pub(crate) fn record(
+        &mut self,
+        inner_iteration: usize,
+        gamma: f64,
+        tau: f64,
+        norm_fpr: f64,
+        cost: f64,
+        linesearch_backtracks: usize,
+    ) {
+        self.records[self.head] = TraceRecord {
+            outer_iteration: self.outer_iteration,
+            inner_iteration,
+            gamma,
+            tau,
+            norm_fpr,
+            cost,
+            linesearch_backtracks,
+            penalty: self.penalty,
+            infeasibility: f64::NAN,
+        };
+        self.head += 1;
+        if self.head == self.records.len() {
+            self.head = 0;
+        }
+        self.len = (self.len + 1).min(self.records.len());
+        self.num_recorded += 1;
+    }
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          TESTS                                                               */
+/* ---------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn record(trace: &mut IterationTrace, k: usize) {
+        trace.record(k, 1.0, 1.0, 1.0 / (k as f64 + 1.0), 0.0, 0);
+    }
+
+    #[test]
+    fn t_trace_ring_buffer() {
+        let mut trace = IterationTrace::new(3);
+        assert!(trace.is_empty());
+        assert!(trace.last().is_none());
+        record(&mut trace, 0);
+        record(&mut trace, 1);
+        let iterations: Vec<usize> = trace.iter().map(|r| r.inner_iteration).collect();
+        assert_eq!(vec![0, 1], iterations);
+        for k in 2..5 {
+            record(&mut trace, k);
+        }
+        let iterations: Vec<usize> = trace.iter().map(|r| r.inner_iteration).collect();
+        assert_eq!(vec![2, 3, 4], iterations);
+        assert_eq!(4, trace.last().unwrap().inner_iteration);
+        assert_eq!(
+            (3, 5, 2),
+            (trace.len(), trace.num_recorded(), trace.num_dropped())
+        );
+
+        let mut out = [TraceRecord::default(); 2];
+        assert_eq!(2, trace.copy_to(&mut out));
+        assert_eq!((3, 4), (out[0].inner_iteration, out[1].inner_iteration));
+
+        trace.clear();
+        assert!(trace.is_empty());
+        assert_eq!(0, trace.copy_to(&mut out));
+    }
+
+    #[test]
+    fn t_trace_outer_iterations() {
+        let mut trace = IterationTrace::new(4);
+        trace.set_outer_iteration(0, 10.0);
+        record(&mut trace, 0);
+        record(&mut trace, 1);
+        trace.set_infeasibility(0.5);
+        trace.set_outer_iteration(1, 50.0);
+        record(&mut trace, 0);
+        trace.set_infeasibility(0.1);
+        record(&mut trace, 1);
+        let records: Vec<(Option<usize>, f64, f64)> = trace
+            .iter()
+            .map(|r| (r.outer_iteration, r.penalty, r.infeasibility))
+            .collect();
+        assert_eq!((Some(0), 10.0, 0.5), records[0]);
+        assert_eq!((Some(0), 10.0, 0.5), records[1]);
+        assert_eq!((Some(1), 50.0, 0.1), records[2]);
+        assert!(records[3].2.is_nan());
+    }
+}
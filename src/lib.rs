@@ -57,10 +57,15 @@ pub mod constraints;
 pub mod core;
 pub mod lipschitz_estimator;
 pub mod matrix_operations;
+pub mod scalar;
+pub mod static_memory;
 
+pub use crate::core::anderson;
 pub use crate::core::fbs;
+pub use crate::core::multistart;
 pub use crate::core::panoc;
 pub use crate::core::{AlgorithmEngine, Optimizer, Problem};
+pub use crate::scalar::Scalar;
 
 /* Use Jemalloc if the feature `jem` is activated */
 #[cfg(not(target_env = "msvc"))]
@@ -40,6 +40,21 @@ use num::{Float, Zero};
 use std::iter::Sum;
 use std::ops::Mul;
 
+pub mod simd;
+
+/// Reductions used by the solvers: with the feature `simd`, these are the
+/// vectorised kernels of [`simd`](simd/index.html), otherwise the functions
+/// of this module
+#[cfg(feature = "simd")]
+pub(crate) use simd as solver;
+
+#[cfg(not(feature = "simd"))]
+pub(crate) mod solver {
+    pub(crate) use super::{
+        inner_product, norm2, norm2_squared, norm2_squared_diff, norm_inf_diff,
+    };
+}
+
 /// Calculate the inner product of two vectors
 #[inline(always)]
 pub fn inner_product<T>(a: &[T], b: &[T]) -> T
@@ -241,4 +256,92 @@ mod tests {
         let norm2sq = matrix_operations::norm2_squared_diff(&x, &y);
         unit_test_utils::assert_nearly_equal(190., norm2sq, 1e-10, 1e-12, "norm sq diff");
     }
+
+    /// Bound on the error of the (reassociated) sum of the `terms`
+    fn summation_tolerance(terms: &[f64], eps: f64) -> f64 {
+        let n = terms.len() as f64;
+        2.0 * n * eps * terms.iter().map(|t| t.abs()).sum::<f64>() + 1e-300
+    }
+
+    #[test]
+    fn t_simd_matches_strict_f64() {
+        for n in 0..100 {
+            let a: Vec<f64> = (0..n).map(|_| 20. * rand::random::<f64>() - 10.).collect();
+            let b: Vec<f64> = (0..n).map(|_| 20. * rand::random::<f64>() - 10.).collect();
+            let ab: Vec<f64> = a.iter().zip(b.iter()).map(|(x, y)| x * y).collect();
+            let aa: Vec<f64> = a.iter().map(|x| x * x).collect();
+            let dd: Vec<f64> = a
+                .iter()
+                .zip(b.iter())
+                .map(|(x, y)| (x - y).powi(2))
+                .collect();
+            let eps = std::f64::EPSILON;
+            let err = matrix_operations::simd::inner_product(&a, &b)
+                - matrix_operations::inner_product(&a, &b);
+            assert!(err.abs() <= summation_tolerance(&ab, eps), "inner product");
+            let err =
+                matrix_operations::simd::norm2_squared(&a) - matrix_operations::norm2_squared(&a);
+            assert!(err.abs() <= summation_tolerance(&aa, eps), "norm2 squared");
+            let err = matrix_operations::simd::norm2_squared_diff(&a, &b)
+                - matrix_operations::norm2_squared_diff(&a, &b);
+            assert!(
+                err.abs() <= summation_tolerance(&dd, eps),
+                "norm2 squared diff"
+            );
+            let err = matrix_operations::simd::sum(&a) - matrix_operations::sum(&a);
+            assert!(err.abs() <= summation_tolerance(&a, eps), "sum");
+            assert_eq!(
+                matrix_operations::norm_inf(&a),
+                matrix_operations::simd::norm_inf(&a)
+            );
+            assert_eq!(
+                matrix_operations::norm_inf_diff(&a, &b),
+                matrix_operations::simd::norm_inf_diff(&a, &b)
+            );
+        }
+    }
+
+    #[test]
+    fn t_simd_matches_strict_f32() {
+        for n in 0..100 {
+            let a: Vec<f32> = (0..n).map(|_| 2. * rand::random::<f32>() - 1.).collect();
+            let b: Vec<f32> = (0..n).map(|_| 2. * rand::random::<f32>() - 1.).collect();
+            let ab: Vec<f64> = a
+                .iter()
+                .zip(b.iter())
+                .map(|(x, y)| (x * y) as f64)
+                .collect();
+            let eps = std::f32::EPSILON as f64;
+            let err = matrix_operations::simd::inner_product(&a, &b) as f64
+                - matrix_operations::inner_product(&a, &b) as f64;
+            assert!(err.abs() <= summation_tolerance(&ab, eps), "inner product");
+            let a64: Vec<f64> = a.iter().map(|&x| x as f64).collect();
+            let err = matrix_operations::simd::sum(&a) as f64 - matrix_operations::sum(&a) as f64;
+            assert!(err.abs() <= summation_tolerance(&a64, eps), "sum");
+            assert_eq!(
+                matrix_operations::norm_inf_diff(&a, &b),
+                matrix_operations::simd::norm_inf_diff(&a, &b)
+            );
+        }
+    }
+
+    #[test]
+    fn t_simd_norm_inf_ignores_nan() {
+        let mut a = [1.0, -7.0, 3.0, 2.0, -1.0, 0.5, 4.0, -2.0, 1.0, 6.5, 0.0];
+        for i in 0..a.len() {
+            let ai = a[i];
+            a[i] = std::f64::NAN;
+            assert_eq!(
+                matrix_operations::norm_inf(&a),
+                matrix_operations::simd::norm_inf(&a)
+            );
+            a[i] = ai;
+        }
+    }
+
+    #[test]
+    #[should_panic]
+    fn t_simd_inner_product_panic() {
+        matrix_operations::simd::inner_product(&[2.0, 3.0], &[1.0, 2.0, 3.0]);
+    }
 }
@@ -0,0 +1,689 @@
+//! # simd
+//!
+//! Vectorised reductions with runtime CPU dispatch
+//!
+//! The functions of this module compute the same quantities as the
+//! homonymous functions of [`matrix_operations`](../index.html), for `f64`
+//! and `f32` vectors, using explicit SIMD kernels which are selected
+//! at runtime:
+//!
+//! - on `x86_64`, AVX2 and FMA kernels are used if the CPU supports them
+//!   (this is detected once, on first use),
+//! - on `aarch64`, NEON kernels are used,
+//! - otherwise, a portable implementation is used, which keeps several
+//!   independent accumulators so that the compiler can vectorise it.
+//!
+//! # Accuracy
+//!
+//! The kernels of `inner_product`, `norm2`, `norm2_squared`,
+//! `norm2_squared_diff` and `sum` split the sums into several partial sums
+//! and may use fused multiply-adds, so their result is not bitwise
+//! identical to that of the (strictly sequential) functions of
+//! `matrix_operations`. Both are accurate up to the usual bound for
+//! recursive summation, that is, for the inner product of vectors of
+//! dimension $n$,
+//!
+//! $$
+//! |\mathrm{fl}(a^\top b) - a^\top b| \leq \gamma_{n} \sum_{i} |a_i b_i|,
+//! \quad \gamma_n = \frac{n\epsilon}{1-n\epsilon},
+//! $$
+//!
+//! where $\epsilon$ is the unit roundoff; in practice, the blocked
+//! summation is, if anything, more accurate. Results may also differ
+//! (within this bound) between different CPUs.
+//!
+//! The kernels of `norm_inf` and `norm_inf_diff` are exact, that is, they
+//! return the same value as their counterparts in `matrix_operations`
+//! (where NaN elements are ignored).
+//!
+//! The solvers use these kernels if the feature `simd` is enabled; by
+//! default they use the functions of `matrix_operations`, so that their
+//! results are reproducible across platforms.
+//!
+//! # Examples
+//!
+//! ```
+//! use optimization_engine::matrix_operations::simd;
+//!
+//! let a = [1.0f64, 2.0, 3.0, 4.0, 5.0];
+//! let b = [5.0, 4.0, 3.0, 2.0, 1.0];
+//! assert!((simd::inner_product(&a, &b) - 35.0).abs() < 1e-12);
+//! assert_eq!(4.0, simd::norm_inf_diff(&a, &b));
+//! ```
+//!
+
+use num::Float;
+
+/// Floating-point types with vectorised reductions (`f64` and `f32`)
+pub trait SimdFloat: Float + private::Sealed {
+    #[doc(hidden)]
+    fn simd_inner_product(a: &[Self], b: &[Self]) -> Self;
+    #[doc(hidden)]
+    fn simd_norm2_squared(a: &[Self]) -> Self;
+    #[doc(hidden)]
+    fn simd_norm2_squared_diff(a: &[Self], b: &[Self]) -> Self;
+    #[doc(hidden)]
+    fn simd_sum(a: &[Self]) -> Self;
+    #[doc(hidden)]
+    fn simd_norm_inf(a: &[Self]) -> Self;
+    #[doc(hidden)]
+    fn simd_norm_inf_diff(a: &[Self], b: &[Self]) -> Self;
+}
+
+mod private {
+    pub trait Sealed {}
+    impl Sealed for f64 {}
+    impl Sealed for f32 {}
+}
+
+/// Calculate the inner product of two vectors
+///
+/// # Panics
+///
+/// The function panics if `a` and `b` have different lengths
+#[inline]
+pub fn inner_product<T: SimdFloat>(a: &[T], b: &[T]) -> T {
+    assert!(a.len() == b.len());
+    T::simd_inner_product(a, b)
+}
+
+/// Calculate the 2-norm of a vector
+#[inline]
+pub fn norm2<T: SimdFloat>(a: &[T]) -> T {
+    T::simd_norm2_squared(a).sqrt()
+}
+
+/// Calculate the squared 2-norm of a vector
+#[inline]
+pub fn norm2_squared<T: SimdFloat>(a: &[T]) -> T {
+    T::simd_norm2_squared(a)
+}
+
+/// Calculate the squared 2-norm of the difference of two vectors
+///
+/// # Panics
+///
+/// The function panics if `a` and `b` have different lengths
+#[inline]
+pub fn norm2_squared_diff<T: SimdFloat>(a: &[T], b: &[T]) -> T {
+    assert!(a.len() == b.len());
+    T::simd_norm2_squared_diff(a, b)
+}
+
+/// Calculate the sum of all elements of a vector
+#[inline]
+pub fn sum<T: SimdFloat>(a: &[T]) -> T {
+    T::simd_sum(a)
+}
+
+/// Calculates the infinity-norm of a vector
+#[inline]
+pub fn norm_inf<T: SimdFloat>(a: &[T]) -> T {
+    T::simd_norm_inf(a)
+}
+
+/// Computes the infinity norm of the difference of two vectors
+///
+/// # Panics
+///
+/// The function panics if `a` and `b` have different lengths
+#[inline]
+pub fn norm_inf_diff<T: SimdFloat>(a: &[T], b: &[T]) -> T {
+    assert_eq!(a.len(), b.len());
+    T::simd_norm_inf_diff(a, b)
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          KERNELS                                                             */
+/* ---------------------------------------------------------------------------- */
+
+/// Number of independent vector accumulators of the kernels
+const NUM_ACCUMULATORS: usize = 4;
+
+/// A SIMD register of `LANES` floating-point numbers
+///
+/// The kernels below are written once in terms of this trait and are
+/// instantiated for every instruction set; all methods are unsafe because
+/// they may use instructions which are not supported by every CPU.
+trait Lanes: Copy {
+    type Scalar: Float;
+    const LANES: usize;
+
+    unsafe fn zero() -> Self;
+    unsafe fn load(p: *const Self::Scalar) -> Self;
+    unsafe fn add(self, other: Self) -> Self;
+    unsafe fn sub(self, other: Self) -> Self;
+    /// Computes `self + a * b`
+    unsafe fn mul_add(self, a: Self, b: Self) -> Self;
+    unsafe fn abs(self) -> Self;
+    /// Elementwise maximum, which returns `self` where `other` is NaN
+    unsafe fn max_ignore_nan(self, other: Self) -> Self;
+    unsafe fn horizontal_sum(self) -> Self::Scalar;
+    unsafe fn horizontal_max(self) -> Self::Scalar;
+}
+
+/// Reduces the elements `0..n` with `NUM_ACCUMULATORS` vector accumulators,
+/// which are updated with `step(acc, i)` for the elements `i..i+LANES`,
+/// combined with `combine` and `horizontal`; the remaining elements are
+/// reduced with the scalar `tail(acc, i)`
+#[inline(always)]
+unsafe fn reduce<V: Lanes>(
+    n: usize,
+    step: impl Fn(V, usize) -> V,
+    combine: impl Fn(V, V) -> V,
+    horizontal: impl Fn(V) -> V::Scalar,
+    tail: impl Fn(V::Scalar, usize) -> V::Scalar,
+) -> V::Scalar {
+    let block = NUM_ACCUMULATORS * V::LANES;
+    let mut acc = [V::zero(); NUM_ACCUMULATORS];
+    let mut i = 0;
+    while i + block <= n {
+        for (k, acc_k) in acc.iter_mut().enumerate() {
+            *acc_k = step(*acc_k, i + k * V::LANES);
+        }
+        i += block;
+    }
+    while i + V::LANES <= n {
+        acc[0] = step(acc[0], i);
+        i += V::LANES;
+    }
+    let mut s = horizontal(combine(combine(acc[0], acc[1]), combine(acc[2], acc[3])));
+    while i < n {
+        s = tail(s, i);
+        i += 1;
+    }
+    s
+}
+
+#[inline(always)]
+unsafe fn sum_of<V: Lanes>(
+    n: usize,
+    step: impl Fn(V, usize) -> V,
+    tail: impl Fn(V::Scalar, usize) -> V::Scalar,
+) -> V::Scalar {
+    reduce::<V>(n, step, |u, v| u.add(v), |v| v.horizontal_sum(), tail)
+}
+
+#[inline(always)]
+unsafe fn max_of<V: Lanes>(
+    n: usize,
+    step: impl Fn(V, usize) -> V,
+    tail: impl Fn(V::Scalar, usize) -> V::Scalar,
+) -> V::Scalar {
+    reduce::<V>(
+        n,
+        step,
+        |u, v| u.max_ignore_nan(v),
+        |v| v.horizontal_max(),
+        tail,
+    )
+}
+
+#[inline(always)]
+unsafe fn inner_product_kernel<V: Lanes>(a: &[V::Scalar], b: &[V::Scalar]) -> V::Scalar {
+    let (pa, pb) = (a.as_ptr(), b.as_ptr());
+    sum_of::<V>(
+        a.len(),
+        |acc, i| acc.mul_add(V::load(pa.add(i)), V::load(pb.add(i))),
+        |s, i| s + a[i] * b[i],
+    )
+}
+
+#[inline(always)]
+unsafe fn norm2_squared_kernel<V: Lanes>(a: &[V::Scalar]) -> V::Scalar {
+    let pa = a.as_ptr();
+    sum_of::<V>(
+        a.len(),
+        |acc, i| {
+            let x = V::load(pa.add(i));
+            acc.mul_add(x, x)
+        },
+        |s, i| s + a[i] * a[i],
+    )
+}
+
+#[inline(always)]
+unsafe fn norm2_squared_diff_kernel<V: Lanes>(a: &[V::Scalar], b: &[V::Scalar]) -> V::Scalar {
+    let (pa, pb) = (a.as_ptr(), b.as_ptr());
+    sum_of::<V>(
+        a.len(),
+        |acc, i| {
+            let d = V::load(pa.add(i)).sub(V::load(pb.add(i)));
+            acc.mul_add(d, d)
+        },
+        |s, i| s + (a[i] - b[i]) * (a[i] - b[i]),
+    )
+}
+
+#[inline(always)]
+unsafe fn sum_kernel<V: Lanes>(a: &[V::Scalar]) -> V::Scalar {
+    let pa = a.as_ptr();
+    sum_of::<V>(
+        a.len(),
+        |acc, i| acc.add(V::load(pa.add(i))),
+        |s, i| s + a[i],
+    )
+}
+
+#[inline(always)]
+unsafe fn norm_inf_kernel<V: Lanes>(a: &[V::Scalar]) -> V::Scalar {
+    let pa = a.as_ptr();
+    max_of::<V>(
+        a.len(),
+        |acc, i| acc.max_ignore_nan(V::load(pa.add(i)).abs()),
+        |m, i| a[i].abs().max(m),
+    )
+}
+
+#[inline(always)]
+unsafe fn norm_inf_diff_kernel<V: Lanes>(a: &[V::Scalar], b: &[V::Scalar]) -> V::Scalar {
+    let (pa, pb) = (a.as_ptr(), b.as_ptr());
+    max_of::<V>(
+        a.len(),
+        |acc, i| acc.max_ignore_nan(V::load(pa.add(i)).sub(V::load(pb.add(i))).abs()),
+        |m, i| (a[i] - b[i]).abs().max(m),
+    )
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          PORTABLE IMPLEMENTATION                                             */
+/* ---------------------------------------------------------------------------- */
+
+mod portable {
+    use super::Lanes;
+    use num::Float;
+
+    /// Four floating-point numbers, operated on elementwise
+    #[derive(Clone, Copy)]
+    pub(super) struct Portable<T>([T; 4]);
+
+    impl<T: Float> Portable<T> {
+        #[inline(always)]
+        fn map2(self, other: Self, f: impl Fn(T, T) -> T) -> Self {
+            let (a, b) = (self.0, other.0);
+            Portable([f(a[0], b[0]), f(a[1], b[1]), f(a[2], b[2]), f(a[3], b[3])])
+        }
+    }
+
+    impl<T: Float> Lanes for Portable<T> {
+        type Scalar = T;
+        const LANES: usize = 4;
+
+        #[inline(always)]
+        unsafe fn zero() -> Self {
+            Portable([T::zero(); 4])
+        }
+        #[inline(always)]
+        unsafe fn load(p: *const T) -> Self {
+            Portable([*p, *p.add(1), *p.add(2), *p.add(3)])
+        }
+        #[inline(always)]
+        unsafe fn add(self, other: Self) -> Self {
+            self.map2(other, |x, y| x + y)
+        }
+        #[inline(always)]
+        unsafe fn sub(self, other: Self) -> Self {
+            self.map2(other, |x, y| x - y)
+        }
+        #[inline(always)]
+        unsafe fn mul_add(self, a: Self, b: Self) -> Self {
+            self.add(a.map2(b, |x, y| x * y))
+        }
+        #[inline(always)]
+        unsafe fn abs(self) -> Self {
+            self.map2(self, |x, _| x.abs())
+        }
+        #[inline(always)]
+        unsafe fn max_ignore_nan(self, other: Self) -> Self {
+            self.map2(other, |acc, x| x.max(acc))
+        }
+        #[inline(always)]
+        unsafe fn horizontal_sum(self) -> T {
+            (self.0[0] + self.0[1]) + (self.0[2] + self.0[3])
+        }
+        #[inline(always)]
+        unsafe fn horizontal_max(self) -> T {
+            self.0[0].max(self.0[1]).max(self.0[2].max(self.0[3]))
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          AVX2 + FMA (x86_64)                                                 */
+/* ---------------------------------------------------------------------------- */
+
+#[cfg(target_arch = "x86_64")]
+mod avx2 {
+    use super::Lanes;
+    use std::arch::x86_64::*;
+
+    /// Whether the CPU supports AVX2 and FMA (the result of the detection
+    /// is cached by the standard library)
+    #[inline]
+    pub(super) fn is_available() -> bool {
+        is_x86_feature_detected!("avx2") && is_x86_feature_detected!("fma")
+    }
+
+    #[derive(Clone, Copy)]
+    pub(super) struct F64x4(__m256d);
+
+    impl Lanes for F64x4 {
+        type Scalar = f64;
+        const LANES: usize = 4;
+
+        #[inline(always)]
+        unsafe fn zero() -> Self {
+            F64x4(_mm256_setzero_pd())
+        }
+        #[inline(always)]
+        unsafe fn load(p: *const f64) -> Self {
+            F64x4(_mm256_loadu_pd(p))
+        }
+        #[inline(always)]
+        unsafe fn add(self, other: Self) -> Self {
+            F64x4(_mm256_add_pd(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn sub(self, other: Self) -> Self {
+            F64x4(_mm256_sub_pd(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn mul_add(self, a: Self, b: Self) -> Self {
+            F64x4(_mm256_fmadd_pd(a.0, b.0, self.0))
+        }
+        #[inline(always)]
+        unsafe fn abs(self) -> Self {
+            F64x4(_mm256_andnot_pd(_mm256_set1_pd(-0.0), self.0))
+        }
+        #[inline(always)]
+        unsafe fn max_ignore_nan(self, other: Self) -> Self {
+            // maxpd returns its second operand if either one is NaN
+            F64x4(_mm256_max_pd(other.0, self.0))
+        }
+        #[inline(always)]
+        unsafe fn horizontal_sum(self) -> f64 {
+            let mut v = [0.0; 4];
+            _mm256_storeu_pd(v.as_mut_ptr(), self.0);
+            (v[0] + v[1]) + (v[2] + v[3])
+        }
+        #[inline(always)]
+        unsafe fn horizontal_max(self) -> f64 {
+            let mut v = [0.0; 4];
+            _mm256_storeu_pd(v.as_mut_ptr(), self.0);
+            v[0].max(v[1]).max(v[2].max(v[3]))
+        }
+    }
+
+    #[derive(Clone, Copy)]
+    pub(super) struct F32x8(__m256);
+
+    impl Lanes for F32x8 {
+        type Scalar = f32;
+        const LANES: usize = 8;
+
+        #[inline(always)]
+        unsafe fn zero() -> Self {
+            F32x8(_mm256_setzero_ps())
+        }
+        #[inline(always)]
+        unsafe fn load(p: *const f32) -> Self {
+            F32x8(_mm256_loadu_ps(p))
+        }
+        #[inline(always)]
+        unsafe fn add(self, other: Self) -> Self {
+            F32x8(_mm256_add_ps(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn sub(self, other: Self) -> Self {
+            F32x8(_mm256_sub_ps(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn mul_add(self, a: Self, b: Self) -> Self {
+            F32x8(_mm256_fmadd_ps(a.0, b.0, self.0))
+        }
+        #[inline(always)]
+        unsafe fn abs(self) -> Self {
+            F32x8(_mm256_andnot_ps(_mm256_set1_ps(-0.0), self.0))
+        }
+        #[inline(always)]
+        unsafe fn max_ignore_nan(self, other: Self) -> Self {
+            F32x8(_mm256_max_ps(other.0, self.0))
+        }
+        #[inline(always)]
+        unsafe fn horizontal_sum(self) -> f32 {
+            let mut v = [0.0; 8];
+            _mm256_storeu_ps(v.as_mut_ptr(), self.0);
+            ((v[0] + v[1]) + (v[2] + v[3])) + ((v[4] + v[5]) + (v[6] + v[7]))
+        }
+        #[inline(always)]
+        unsafe fn horizontal_max(self) -> f32 {
+            let mut v = [0.0; 8];
+            _mm256_storeu_ps(v.as_mut_ptr(), self.0);
+            v.iter().fold(0.0, |m, &x| x.max(m))
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          NEON (aarch64)                                                      */
+/* ---------------------------------------------------------------------------- */
+
+#[cfg(target_arch = "aarch64")]
+mod neon {
+    use super::Lanes;
+    use std::arch::aarch64::*;
+
+    #[derive(Clone, Copy)]
+    pub(super) struct F64x2(float64x2_t);
+
+    impl Lanes for F64x2 {
+        type Scalar = f64;
+        const LANES: usize = 2;
+
+        #[inline(always)]
+        unsafe fn zero() -> Self {
+            F64x2(vdupq_n_f64(0.0))
+        }
+        #[inline(always)]
+        unsafe fn load(p: *const f64) -> Self {
+            F64x2(vld1q_f64(p))
+        }
+        #[inline(always)]
+        unsafe fn add(self, other: Self) -> Self {
+            F64x2(vaddq_f64(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn sub(self, other: Self) -> Self {
+            F64x2(vsubq_f64(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn mul_add(self, a: Self, b: Self) -> Self {
+            F64x2(vfmaq_f64(self.0, a.0, b.0))
+        }
+        #[inline(always)]
+        unsafe fn abs(self) -> Self {
+            F64x2(vabsq_f64(self.0))
+        }
+        #[inline(always)]
+        unsafe fn max_ignore_nan(self, other: Self) -> Self {
+            // fmaxnm returns the number if exactly one operand is NaN
+            F64x2(vmaxnmq_f64(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn horizontal_sum(self) -> f64 {
+            vaddvq_f64(self.0)
+        }
+        #[inline(always)]
+        unsafe fn horizontal_max(self) -> f64 {
+            vmaxnmvq_f64(self.0)
+        }
+    }
+
+    #[derive(Clone, Copy)]
+    pub(super) struct F32x4(float32x4_t);
+
+    impl Lanes for F32x4 {
+        type Scalar = f32;
+        const LANES: usize = 4;
+
+        #[inline(always)]
+        unsafe fn zero() -> Self {
+            F32x4(vdupq_n_f32(0.0))
+        }
+        #[inline(always)]
+        unsafe fn load(p: *const f32) -> Self {
+            F32x4(vld1q_f32(p))
+        }
+        #[inline(always)]
+        unsafe fn add(self, other: Self) -> Self {
+            F32x4(vaddq_f32(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn sub(self, other: Self) -> Self {
+            F32x4(vsubq_f32(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn mul_add(self, a: Self, b: Self) -> Self {
+            F32x4(vfmaq_f32(self.0, a.0, b.0))
+        }
+        #[inline(always)]
+        unsafe fn abs(self) -> Self {
+            F32x4(vabsq_f32(self.0))
+        }
+        #[inline(always)]
+        unsafe fn max_ignore_nan(self, other: Self) -> Self {
+            F32x4(vmaxnmq_f32(self.0, other.0))
+        }
+        #[inline(always)]
+        unsafe fn horizontal_sum(self) -> f32 {
+            vaddvq_f32(self.0)
+        }
+        #[inline(always)]
+        unsafe fn horizontal_max(self) -> f32 {
+            vmaxnmvq_f32(self.0)
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------- */
+/*          DISPATCH                                                            */
+/* ---------------------------------------------------------------------------- */
+
+/// Implements a method of `SimdFloat` for `$float` by dispatching to the
+/// kernel `$kernel` instantiated for the best available instruction set
+macro_rules! dispatch {
+    ($float:ty, $avx2:ty, $neon:ty, $avx2_fn:ident,
+     $method:ident, $kernel:ident, ($($arg:ident),+)) => {
+        #[inline]
+        fn $method($($arg: &[$float]),+) -> $float {
+            #[cfg(target_arch = "x86_64")]
+            {
+                #[target_feature(enable = "avx2,fma")]
+                unsafe fn $avx2_fn($($arg: &[$float]),+) -> $float {
+                    $kernel::<$avx2>($($arg),+)
+                }
+                if avx2::is_available() {
+                    // Safety: the CPU supports AVX2 and FMA
+                    return unsafe { $avx2_fn($($arg),+) };
+                }
+            }
+            #[cfg(target_arch = "aarch64")]
+            {
+                // Safety: NEON is mandatory on aarch64
+                return unsafe { $kernel::<$neon>($($arg),+) };
+            }
+            #[allow(unreachable_code)]
+            // Safety: the portable implementation only performs in-bounds reads
+            unsafe {
+                $kernel::<portable::Portable<$float>>($($arg),+)
+            }
+        }
+    };
+}
+
+macro_rules! impl_simd_float {
+    ($float:ty, $avx2:ty, $neon:ty) => {
+        impl SimdFloat for $float {
+            dispatch!(
+                $float,
+                $avx2,
+                $neon,
+                avx2_inner_product,
+                simd_inner_product,
+                inner_product_kernel,
+                (a, b)
+            );
+            dispatch!(
+                $float,
+                $avx2,
+                $neon,
+                avx2_norm2_squared,
+                simd_norm2_squared,
+                norm2_squared_kernel,
+                (a)
+            );
+            dispatch!(
+                $float,
+                $avx2,
+                $neon,
+                avx2_norm2_squared_diff,
+                simd_norm2_squared_diff,
+                norm2_squared_diff_kernel,
+                (a, b)
+            );
+            dispatch!($float, $avx2, $neon, avx2_sum, simd_sum, sum_kernel, (a));
+            dispatch!(
+                $float,
+                $avx2,
+                $neon,
+                avx2_norm_inf,
+                simd_norm_inf,
+                norm_inf_kernel,
+                (a)
+            );
+            dispatch!(
+                $float,
+                $avx2,
+                $neon,
+                avx2_norm_inf_diff,
+                simd_norm_inf_diff,
+                norm_inf_diff_kernel,
+                (a, b)
+            );
+        }
+    };
+}
+
+impl_simd_float!(f64, avx2::F64x4, neon::F64x2);
+impl_simd_float!(f32, avx2::F32x8, neon::F32x4);
+
+/* ---------------------------------------------------------------------------- */
+/*          TESTS                                                               */
+/* ---------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn t_portable_kernels() {
+        // the portable kernels are not used on CPUs with SIMD support
+        let a: Vec<f64> = (0..37).map(|i| (i as f64 - 17.5) / 3.0).collect();
+        let b: Vec<f64> = (0..37).map(|i| (i as f64).sin()).collect();
+        type P = portable::Portable<f64>;
+        unsafe {
+            let ip = inner_product_kernel::<P>(&a, &b);
+            assert!((ip - crate::matrix_operations::inner_product(&a, &b)).abs() < 1e-12);
+            let d = norm2_squared_diff_kernel::<P>(&a, &b);
+            assert!((d - crate::matrix_operations::norm2_squared_diff(&a, &b)).abs() < 1e-12);
+            assert!((sum_kernel::<P>(&a) - crate::matrix_operations::sum(&a)).abs() < 1e-12);
+            assert_eq!(
+                crate::matrix_operations::norm_inf(&a),
+                norm_inf_kernel::<P>(&a)
+            );
+            assert_eq!(
+                crate::matrix_operations::norm_inf_diff(&a, &b),
+                norm_inf_diff_kernel::<P>(&a, &b)
+            );
+        }
+    }
+}
@@ -0,0 +1,100 @@
+//! Floating-point types of the solvers
+//!
+//! The solvers, their caches and most constraints are generic over the
+//! floating-point type of the decision variables, which can be either `f64`
+//! (the default) or `f32`; the trait [`Scalar`](trait.Scalar.html) is
+//! implemented by these two types.
+//!
+//! Single precision halves the memory traffic of the solver and doubles the
+//! width of its SIMD kernels, so it can be beneficial on embedded devices,
+//! provided the tolerances are not too tight (typically, not below `1e-4`,
+//! since the machine epsilon of `f32` is about `1.2e-7`).
+//!
+//! # Example
+//!
+//! ```
+//! use optimization_engine::{constraints::*, panoc::*, *};
+//!
+//! let radius = 1.0_f32;
+//! let bounds = Ball2::new(None, radius);
+//! let cost = |u: &[f32], c: &mut f32| -> FunctionCallResult {
+//!     *c = (u[0] - 2.0).powi(2) + u[1].powi(2);
+//!     Ok(())
+//! };
+//! let gradient = |u: &[f32], g: &mut [f32]| -> FunctionCallResult {
+//!     g[0] = 2.0 * (u[0] - 2.0);
+//!     g[1] = 2.0 * u[1];
+//!     Ok(())
+//! };
+//! let problem = Problem::new(&bounds, gradient, cost);
+//! let mut cache = PANOCCache::new(2, 1e-4_f32, 5);
+//! let mut optimizer = PANOCOptimizer::new(problem, &mut cache);
+//! let mut u = [0.0_f32; 2];
+//! let status = optimizer.solve(&mut u).unwrap();
+//! assert!(status.has_converged());
+//! assert!((u[0] - 1.0).abs() < 1e-3);
+//! ```
+//!
+
+use crate::matrix_operations::simd::SimdFloat;
+use num::Float;
+use std::fmt::{Debug, Display};
+use std::iter::Sum;
+use std::ops::{AddAssign, DivAssign, MulAssign, SubAssign};
+
+/// Floating-point type of the decision variables (`f64` or `f32`)
+///
+/// This trait is sealed, that is, it cannot be implemented outside this crate
+pub trait Scalar:
+    Float
+    + SimdFloat
+    + Sum<Self>
+    + AddAssign
+    + SubAssign
+    + MulAssign
+    + DivAssign
+    + Debug
+    + Display
+    + Default
+    + Send
+    + Sync
+    + 'static
+{
+    /// L-BFGS buffer used by PANOC for this type
+    #[doc(hidden)]
+    type Lbfgs: crate::core::panoc::LbfgsBuffer<Self>;
+
+    /// Converts an `f64` to this type (rounding to the nearest number)
+    fn from_f64(x: f64) -> Self;
+
+    /// Converts this number to an `f64` (which is exact)
+    fn as_f64(self) -> f64;
+}
+
+impl Scalar for f64 {
+    type Lbfgs = lbfgs::Lbfgs;
+
+    #[inline(always)]
+    fn from_f64(x: f64) -> Self {
+        x
+    }
+
+    #[inline(always)]
+    fn as_f64(self) -> f64 {
+        self
+    }
+}
+
+impl Scalar for f32 {
+    type Lbfgs = crate::core::panoc::Lbfgs<f32>;
+
+    #[inline(always)]
+    fn from_f64(x: f64) -> Self {
+        x as f32
+    }
+
+    #[inline(always)]
+    fn as_f64(self) -> f64 {
+        self as f64
+    }
+}
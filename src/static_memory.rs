@@ -0,0 +1,454 @@
+//! Statically allocated memory for embedded targets
+//!
+//! On targets without a heap (or where a heap is not desirable),
+//! [`StaticArena`](struct.StaticArena.html) can be used as the global memory
+//! allocator: it serves all allocations from a buffer of `SIZE` bytes which
+//! lives in static memory, and returns a null pointer (which makes the program
+//! abort) when the buffer is exhausted.
+//!
+//! Every block which is freed is given back to the arena (adjacent free blocks
+//! are merged), so the memory in use is bounded by the largest amount of memory
+//! which is allocated at the same time, not by the number of allocations. The
+//! solvers allocate their memory when their caches are constructed; in each
+//! call, the augmented Lagrangian method allocates the vector of Lagrange
+//! multipliers of the returned `AlmOptimizerStatus`, which is given back when
+//! the status is dropped, so a cache can be reused in any number of solves.
+//!
+//! # Example
+//!
+//! ```
+//! use optimization_engine::static_memory::StaticArena;
+//!
+//! #[global_allocator]
+//! static ARENA: StaticArena<{ 1 << 20 }> = StaticArena::new();
+//!
+//! fn main() {
+//!     let v = vec![0.0_f64; 100];
+//!     assert!(ARENA.used() >= 800);
+//!     # drop(v);
+//! }
+//! ```
+//!
+
+use std::alloc::{GlobalAlloc, Layout};
+use std::cell::UnsafeCell;
+use std::ptr;
+use std::sync::atomic::{AtomicBool, Ordering};
+
+/// Blocks are handed out in multiples of `GRANULE` bytes, at offsets which are
+/// multiples of `GRANULE`, so that every free block can hold a `FreeBlock`
+const GRANULE: usize = 16;
+
+/// Header of a free block, which is stored in the block itself
+struct FreeBlock {
+    /// Size of the block in bytes (including the header)
+    size: usize,
+    /// Next free block (in increasing order of address)
+    next: *mut FreeBlock,
+}
+
+/// Buffer of the arena, whose alignment is `GRANULE`
+#[repr(C, align(16))]
+struct Buffer<const SIZE: usize>([u8; SIZE]);
+
+/// Bookkeeping of the arena; all offsets are relative to the first byte of
+/// the buffer
+struct ArenaState {
+    /// Offset of the first byte above all the blocks which have been handed
+    /// out; the memory above `top` has never been used (or has been given back)
+    top: usize,
+    /// Free blocks below `top`, in increasing order of address; adjacent free
+    /// blocks are always merged
+    free: *mut FreeBlock,
+    /// Number of bytes in use
+    used: usize,
+}
+
+/// Memory allocator over a statically allocated buffer of `SIZE` bytes
+///
+/// The arena can be used as a `#[global_allocator]`; allocations which do not
+/// fit in the remaining space fail (a null pointer is returned). Blocks are
+/// taken from the list of free blocks (first fit) or, if none is large enough,
+/// from the top of the used memory; every freed block is given back to the
+/// arena and merged with its free neighbours.
+pub struct StaticArena<const SIZE: usize> {
+    /// Memory from which the allocations are served
+    memory: UnsafeCell<Buffer<SIZE>>,
+    /// Bookkeeping of the arena (only accessed while `locked` is set)
+    state: UnsafeCell<ArenaState>,
+    /// Spin lock which protects `state`
+    locked: AtomicBool,
+}
+
+// The bookkeeping is only accessed while the spin lock is held and the buffer
+// is only accessed through the (disjoint) blocks handed out by `alloc`
+unsafe impl<const SIZE: usize> Sync for StaticArena<SIZE> {}
+
+/// Holds the spin lock of an arena; the lock is released on drop
+struct ArenaGuard<'a> {
+    locked: &'a AtomicBool,
+}
+
+impl Drop for ArenaGuard<'_> {
+    fn drop(&mut self) {
+        self.locked.store(false, Ordering::Release);
+    }
+}
+
+/// Size of a block of `size` bytes, rounded up to a multiple of `GRANULE`
+fn block_size(size: usize) -> usize {
+    (size.max(1) + GRANULE - 1) & !(GRANULE - 1)
+}
+
+/// Smallest offset which is at least `offset` and whose address is aligned
+/// to `align` (a power of two, at least `GRANULE`)
+fn aligned_offset(base: usize, offset: usize, align: usize) -> usize {
+    ((base + offset + align - 1) & !(align - 1)) - base
+}
+
+impl ArenaState {
+    /// Hands out a block of `size` bytes (a multiple of `GRANULE`) whose
+    /// address is aligned to `align`, or returns `None` if the arena is full
+    unsafe fn take(
+        &mut self,
+        base: usize,
+        capacity: usize,
+        size: usize,
+        align: usize,
+    ) -> Option<usize> {
+        let mut previous: *mut FreeBlock = ptr::null_mut();
+        let mut block = self.free;
+        while !block.is_null() {
+            let block_start = block as usize - base;
+            let block_end = block_start + (*block).size;
+            let start = aligned_offset(base, block_start, align);
+            if start + size <= block_end {
+                let next = (*block).next;
+                if previous.is_null() {
+                    self.free = next;
+                } else {
+                    (*previous).next = next;
+                }
+                // the memory before and after the new block remains free
+                if start > block_start {
+                    self.give_back(base, block_start, start - block_start);
+                }
+                if start + size < block_end {
+                    self.give_back(base, start + size, block_end - start - size);
+                }
+                self.used += size;
+                return Some(start);
+            }
+            previous = block;
+            block = (*block).next;
+        }
+        let start = aligned_offset(base, self.top, align);
+        let end = match start.checked_add(size) {
+            Some(end) if end <= capacity => end,
+            _ => return None,
+        };
+        let top = self.top;
+        self.top = end;
+        if start > top {
+            self.give_back(base, top, start - top);
+        }
+        self.used += size;
+        Some(start)
+    }
+
+    /// Gives the memory `[start, start + size)` back to the arena; `start` and
+    /// `size` are multiples of `GRANULE`
+    unsafe fn give_back(&mut self, base: usize, start: usize, size: usize) {
+        // find the free blocks immediately before and after the given memory
+        let mut before_previous: *mut FreeBlock = ptr::null_mut();
+        let mut before: *mut FreeBlock = ptr::null_mut();
+        let mut after = self.free;
+        while !after.is_null() && after as usize - base < start {
+            before_previous = before;
+            before = after;
+            after = (*after).next;
+        }
+        let mut size = size;
+        if !after.is_null() && start + size == after as usize - base {
+            size += (*after).size;
+            after = (*after).next;
+        }
+        let (block, previous) =
+            if !before.is_null() && before as usize - base + (*before).size == start {
+                (*before).size += size;
+                (before, before_previous)
+            } else {
+                let block = (base + start) as *mut FreeBlock;
+                block.write(FreeBlock {
+                    size,
+                    next: ptr::null_mut(),
+                });
+                if before.is_null() {
+                    self.free = block;
+                } else {
+                    (*before).next = block;
+                }
+                (block, before)
+            };
+        (*block).next = after;
+        // a free block at the top of the used memory is merged with the
+        // memory above the top (it is necessarily the last free block)
+        let block_start = block as usize - base;
+        if block_start + (*block).size == self.top {
+            self.top = block_start;
+            if previous.is_null() {
+                self.free = ptr::null_mut();
+            } else {
+                (*previous).next = ptr::null_mut();
+            }
+        }
+    }
+}
+
+impl<const SIZE: usize> StaticArena<SIZE> {
+    /// Constructs a new (empty) arena
+    ///
+    /// This is a `const` function, so the arena can be a `static` variable
+    pub const fn new() -> Self {
+        StaticArena {
+            memory: UnsafeCell::new(Buffer([0; SIZE])),
+            state: UnsafeCell::new(ArenaState {
+                top: 0,
+                free: ptr::null_mut(),
+                used: 0,
+            }),
+            locked: AtomicBool::new(false),
+        }
+    }
+
+    /// Number of bytes of the arena that are in use (allocations are
+    /// rounded up to a multiple of 16 bytes)
+    pub fn used(&self) -> usize {
+        let _guard = self.lock();
+        unsafe { (*self.state.get()).used }
+    }
+
+    /// Size of the arena in bytes
+    pub const fn capacity(&self) -> usize {
+        SIZE
+    }
+
+    /// Address of the first byte of the buffer
+    fn base(&self) -> usize {
+        self.memory.get() as usize
+    }
+
+    /// Acquires the spin lock which protects the bookkeeping of the arena
+    fn lock(&self) -> ArenaGuard<'_> {
+        while self
+            .locked
+            .compare_exchange_weak(false, true, Ordering::Acquire, Ordering::Relaxed)
+            .is_err()
+        {
+            std::hint::spin_loop();
+        }
+        ArenaGuard {
+            locked: &self.locked,
+        }
+    }
+}
+
+impl<const SIZE: usize> Default for StaticArena<SIZE> {
+    fn default() -> Self {
+        StaticArena::new()
+    }
+}
+
+unsafe impl<const SIZE: usize> GlobalAlloc for StaticArena<SIZE> {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        let base = self.base();
+        let align = layout.align().max(GRANULE);
+        let _guard = self.lock();
+        match (*self.state.get()).take(base, SIZE, block_size(layout.size()), align) {
+            Some(start) => (base + start) as *mut u8,
+            None => ptr::null_mut(),
+        }
+    }
+
+    unsafe fn dealloc(&self, block: *mut u8, layout: Layout) {
+        let base = self.base();
+        let size = block_size(layout.size());
+        let _guard = self.lock();
+        let state = &mut *self.state.get();
+        state.give_back(base, block as usize - base, size);
+        state.used -= size;
+    }
+
+    unsafe fn realloc(&self, block: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        let base = self.base();
+        let start = block as usize - base;
+        let size = block_size(layout.size());
+        let new_block_size = block_size(new_size);
+        {
+            let _guard = self.lock();
+            let state = &mut *self.state.get();
+            // a block shrinks in place (the rest of it is given back)...
+            if new_block_size <= size {
+                if new_block_size < size {
+                    state.give_back(base, start + new_block_size, size - new_block_size);
+                    state.used -= size - new_block_size;
+                }
+                return block;
+            }
+            // ...and the block at the top of the used memory grows in place
+            if start + size == state.top && start + new_block_size <= SIZE {
+                state.top = start + new_block_size;
+                state.used += new_block_size - size;
+                return block;
+            }
+        }
+        let new_layout = Layout::from_size_align_unchecked(new_size, layout.align());
+        let new_block = self.alloc(new_layout);
+        if !new_block.is_null() {
+            ptr::copy_nonoverlapping(block, new_block, layout.size());
+            self.dealloc(block, layout);
+        }
+        new_block
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*       TESTS                                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+#[cfg(test)]
+mod tests {
+
+    use super::*;
+
+    #[test]
+    fn t_static_arena_alloc_dealloc() {
+        let arena = StaticArena::<256>::new();
+        let layout = Layout::from_size_align(24, 8).unwrap();
+        unsafe {
+            let a = arena.alloc(layout);
+            let b = arena.alloc(layout);
+            assert!(!a.is_null() && !b.is_null());
+            assert_eq!(0, a as usize % 8);
+            assert_eq!(0, b as usize % 8);
+            assert!(b as usize >= a as usize + 24);
+            assert_eq!(64, arena.used());
+            // a block which is not the most recent one is reclaimed...
+            arena.dealloc(a, layout);
+            assert_eq!(32, arena.used());
+            // ...and reused
+            let c = arena.alloc(layout);
+            assert_eq!(a, c);
+            arena.dealloc(b, layout);
+            arena.dealloc(c, layout);
+            assert_eq!(0, arena.used());
+        }
+        assert_eq!(256, arena.capacity());
+    }
+
+    #[test]
+    fn t_static_arena_out_of_memory() {
+        let arena = StaticArena::<64>::new();
+        unsafe {
+            assert!(arena
+                .alloc(Layout::from_size_align(100, 1).unwrap())
+                .is_null());
+            assert!(!arena
+                .alloc(Layout::from_size_align(40, 1).unwrap())
+                .is_null());
+            assert!(arena
+                .alloc(Layout::from_size_align(40, 1).unwrap())
+                .is_null());
+        }
+    }
+
+    #[test]
+    fn t_static_arena_realloc() {
+        let arena = StaticArena::<128>::new();
+        let layout = Layout::from_size_align(16, 8).unwrap();
+        unsafe {
+            let a = arena.alloc(layout);
+            *a = 42;
+            // the last block grows in place
+            let a_grown = arena.realloc(a, layout, 32);
+            assert_eq!(a, a_grown);
+            let b = arena.alloc(layout);
+            // a block which is not the last one is moved
+            let a_moved = arena.realloc(a, Layout::from_size_align(32, 8).unwrap(), 48);
+            assert!(!a_moved.is_null() && a_moved != a && a_moved != b);
+            assert_eq!(42, *a_moved);
+            // a block shrinks in place
+            let a_shrunk = arena.realloc(a_moved, Layout::from_size_align(48, 8).unwrap(), 16);
+            assert_eq!(a_moved, a_shrunk);
+            assert_eq!(32, arena.used());
+        }
+    }
+
+    #[test]
+    fn t_static_arena_merge_free_blocks() {
+        let arena = StaticArena::<96>::new();
+        let layout = Layout::from_size_align(32, 8).unwrap();
+        unsafe {
+            let a = arena.alloc(layout);
+            let b = arena.alloc(layout);
+            let c = arena.alloc(layout);
+            assert!(!c.is_null());
+            assert!(arena.alloc(layout).is_null());
+            // the free blocks `a` and `b` are merged, so a block of twice the
+            // size fits in the arena
+            arena.dealloc(a, layout);
+            arena.dealloc(b, layout);
+            let d = arena.alloc(Layout::from_size_align(64, 8).unwrap());
+            assert_eq!(a, d);
+            arena.dealloc(c, layout);
+            arena.dealloc(d, Layout::from_size_align(64, 8).unwrap());
+            assert_eq!(0, arena.used());
+            assert!(!arena
+                .alloc(Layout::from_size_align(96, 8).unwrap())
+                .is_null());
+        }
+    }
+
+    #[test]
+    fn t_static_arena_alignment() {
+        let arena = StaticArena::<256>::new();
+        unsafe {
+            let a = arena.alloc(Layout::from_size_align(8, 8).unwrap());
+            let b = arena.alloc(Layout::from_size_align(8, 64).unwrap());
+            assert!(!a.is_null() && !b.is_null());
+            assert_eq!(0, b as usize % 64);
+            arena.dealloc(b, Layout::from_size_align(8, 64).unwrap());
+            arena.dealloc(a, Layout::from_size_align(8, 8).unwrap());
+            assert_eq!(0, arena.used());
+        }
+    }
+
+    #[test]
+    fn t_static_arena_repeated_allocations() {
+        // long-lived blocks and short-lived blocks which are freed in a
+        // different order than they are allocated (as in repeated solves)
+        let arena = StaticArena::<1024>::new();
+        let cache = Layout::from_size_align(200, 8).unwrap();
+        let small = Layout::from_size_align(24, 8).unwrap();
+        let large = Layout::from_size_align(72, 8).unwrap();
+        unsafe {
+            let cache_block = arena.alloc(cache);
+            assert!(!cache_block.is_null());
+            let used = arena.used();
+            for _ in 0..10_000 {
+                let x = arena.alloc(small);
+                let y = arena.alloc(large);
+                let z = arena.alloc(small);
+                assert!(!x.is_null() && !y.is_null() && !z.is_null());
+                arena.dealloc(x, small);
+                let w = arena.alloc(large);
+                assert!(!w.is_null());
+                arena.dealloc(z, small);
+                arena.dealloc(y, large);
+                arena.dealloc(w, large);
+                assert_eq!(used, arena.used());
+            }
+            arena.dealloc(cache_block, cache);
+        }
+        assert_eq!(0, arena.used());
+    }
+}